@@ -7,7 +7,15 @@
 
 # SHADOW library source files.
 set( SHADOW_SOURCES
-     "${CMAKE_CURRENT_LIST_DIR}/source/shadow.c" )
+     "${CMAKE_CURRENT_LIST_DIR}/source/shadow.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/shadow_registry.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/shadow_mqtt.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/shadow_topic_cache.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/shadow_reserved_topic.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/shadow_payload.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/shadow_version_cache.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/shadow_delta.c"
+     "${CMAKE_CURRENT_LIST_DIR}/source/shadow_request.c" )
 
 # SHADOW library Public Include directories.
 set( SHADOW_INCLUDE_PUBLIC_DIRS
@@ -107,9 +107,175 @@ typedef enum ShadowStatus
     SHADOW_THINGNAME_PARSE_FAILED,    /**< @brief Could not parse the thing name. */
     SHADOW_MESSAGE_TYPE_PARSE_FAILED, /**< @brief Could not parse the shadow type. */
     SHADOW_ROOT_PARSE_FAILED,         /**< @brief Could not parse the classic or named shadow root. */
-    SHADOW_SHADOWNAME_PARSE_FAILED    /**< @brief Could not parse the shadow name (in the case of a named shadow topic). */
+    SHADOW_SHADOWNAME_PARSE_FAILED,   /**< @brief Could not parse the shadow name (in the case of a named shadow topic). */
+    SHADOW_NOT_FOUND,                 /**< @brief The requested item, such as a registered Thing and Shadow name, was not found. */
+    SHADOW_PAYLOAD_PARSE_FAILED,      /**< @brief Could not parse the JSON document of a shadow message. */
+    SHADOW_VERSION_STALE              /**< @brief The shadow message is older than the last message applied. */
 } ShadowStatus_t;
 
+/**
+ * @ingroup shadow_struct_types
+ * @brief A topic string to be matched by Shadow_MatchTopicBatch().
+ */
+typedef struct ShadowTopic
+{
+    const char * pTopic;  /**< @brief Pointer to the topic string. */
+    uint16_t topicLength; /**< @brief Length of the topic string. */
+} ShadowTopic_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief The result of matching one topic string.
+ *
+ * The name offsets are relative to the first character of the matched topic
+ * string. The message type, name offsets and name lengths are only valid
+ * when status is #SHADOW_SUCCESS.
+ */
+typedef struct ShadowMatchResult
+{
+    ShadowStatus_t status;           /**< @brief #SHADOW_SUCCESS if the topic is a Shadow topic, otherwise the error code. */
+    ShadowMessageType_t messageType; /**< @brief Type of the Shadow message. */
+    uint16_t thingNameOffset;        /**< @brief Offset of the Thing name in the topic string. */
+    uint8_t thingNameLength;         /**< @brief Length of the Thing name. */
+    uint16_t shadowNameOffset;       /**< @brief Offset of the Shadow name in the topic string. Zero for a Classic shadow. */
+    uint8_t shadowNameLength;        /**< @brief Length of the Shadow name. Zero for a Classic shadow. */
+} ShadowMatchResult_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief Hashes of the names in a Shadow topic, for routing messages with
+ * application hash tables.
+ *
+ * The hashes are stable: the same names always give the same hashes, on any
+ * platform. Shadow_MatchTopicHash() computes them while it matches a topic,
+ * and Shadow_HashNames() computes the same hashes from the names.
+ */
+typedef struct ShadowTopicHash
+{
+    uint32_t thingNameHash;  /**< @brief 32-bit FNV-1a hash of the Thing name. */
+    uint32_t shadowNameHash; /**< @brief 32-bit FNV-1a hash of the Shadow name. The hash of an empty string for a Classic shadow. */
+    uint32_t keyHash;        /**< @brief Hash of the Thing and Shadow names together. */
+} ShadowTopicHash_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief State kept between the chunks of a topic string matched with
+ * Shadow_MatchTopicChunk().
+ *
+ * The members are only used by the Shadow library. Set them with
+ * Shadow_MatchTopicStart() before the first chunk of each topic.
+ */
+typedef struct ShadowMatchContext
+{
+    uint8_t state;               /**< @brief Current parser state. */
+    ShadowStatus_t failedStatus; /**< @brief Status to report once the topic is known not to be a Shadow topic. */
+    uint16_t literalIndex;       /**< @brief Number of bytes matched of the current literal. */
+    uint16_t nameLength;         /**< @brief Number of bytes scanned of the current name. */
+    uint8_t thingNameLength;     /**< @brief Length of the Thing name. */
+    uint8_t shadowNameLength;    /**< @brief Length of the Shadow name. */
+    uint8_t operationIndex;      /**< @brief Index of the candidate Shadow operation. */
+    ShadowTopicHash_t * pHash;   /**< @brief Hashes of the names, or NULL if they are not hashed. */
+} ShadowMatchContext_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief The position of one topic string in a buffer filled by
+ * Shadow_AssembleAllTopics() or Shadow_AssembleTopicsBulk(), or of one topic
+ * filter in a buffer filled by Shadow_AssembleWildcardFilters().
+ */
+typedef struct ShadowTopicSpan
+{
+    uint32_t offset; /**< @brief Offset of the first character of the topic string in the buffer. */
+    uint16_t length; /**< @brief Length of the topic string. */
+} ShadowTopicSpan_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief The Thing and Shadow names of one shadow, for Shadow_AssembleTopicsBulk().
+ */
+typedef struct ShadowNames
+{
+    const char * pThingName;  /**< @brief Thing name. Does not have to be null-terminated. */
+    const char * pShadowName; /**< @brief Shadow name. Does not have to be null-terminated. #SHADOW_NAME_CLASSIC for a Classic shadow. */
+    uint8_t thingNameLength;  /**< @brief Length of the Thing name. */
+    uint8_t shadowNameLength; /**< @brief Length of the Shadow name. Zero for a Classic shadow. */
+} ShadowNames_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief Scratch space of Shadow_AssembleWildcardFilters(), one entry per
+ * shadow.
+ *
+ * The entries are provided by the application and used while the topic
+ * filters are assembled. The application should not access the members
+ * directly.
+ */
+typedef struct ShadowWildcardEntry
+{
+    uint32_t nameIndex; /**< @brief Index of the shadow in the names. */
+    uint8_t flags;      /**< @brief Which name of its topic filters is a wildcard, and whether it is the first shadow of its topic filters. */
+} ShadowWildcardEntry_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief One slot of the hash index of a #ShadowFilterIndex_t.
+ *
+ * The slots are provided by the application and managed by the index. The
+ * application should not access the members directly.
+ */
+typedef struct ShadowFilterSlot
+{
+    uint32_t filterIndex; /**< @brief Index of the topic filter, or UINT32_MAX if the slot is empty. */
+    uint32_t hash;        /**< @brief Hash of the Thing name level of the topic filter. */
+} ShadowFilterSlot_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief An index of MQTT topic filters by their Thing name level, held in
+ * application-provided memory, for Shadow_MatchTopicFilters().
+ *
+ * Topic filters that start with #SHADOW_PREFIX and a Thing name are found by
+ * the hash of the Thing name. The others, such as those with a wildcard in
+ * place of the Thing name, are kept together under the hash of the '+'
+ * wildcard. Initialize with Shadow_FilterIndexInit(). The application should
+ * not access the members directly.
+ */
+typedef struct ShadowFilterIndex
+{
+    const char * pFilterBuffer;            /**< @brief Buffer holding the topic filters. */
+    const ShadowTopicSpan_t * pFilterSpans; /**< @brief Positions of the topic filters in pFilterBuffer. */
+    uint32_t filterCount;                  /**< @brief Number of topic filters. */
+    ShadowFilterSlot_t * pSlots;           /**< @brief Application-provided slots. */
+    uint32_t slotCount;                    /**< @brief Number of slots. A power of two. */
+} ShadowFilterIndex_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief One piece of a topic string returned by Shadow_AssembleTopicSegments().
+ */
+typedef struct ShadowTopicSegment
+{
+    const char * pSegment; /**< @brief Characters of the segment. Not null-terminated. */
+    uint16_t length;       /**< @brief Length of the segment. */
+} ShadowTopicSegment_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief Description of the end of the topic strings of one
+ * #ShadowTopicStringType_t, after the Shadow root or Shadow name.
+ *
+ * The entries of #ShadowTopicDescriptors are indexed by #ShadowTopicStringType_t.
+ * The string of a response topic, such as "/update/accepted", is the string of
+ * the operation, "/update", followed by the suffix, "/accepted".
+ */
+typedef struct ShadowTopicDescriptor
+{
+    const char * pString;            /**< @brief The operation and suffix, such as "/update/accepted". Null-terminated. */
+    uint16_t length;                 /**< @brief Length of pString. */
+    uint16_t operationLength;        /**< @brief Length of the operation at the start of pString. The suffix takes the rest of pString. */
+    ShadowMessageType_t messageType; /**< @brief The message type of a response topic, or #ShadowMessageTypeMaxNum for a request topic. */
+} ShadowTopicDescriptor_t;
+
 /*------------------------ Shadow library constants -------------------------*/
 
 /**
@@ -271,6 +437,29 @@ typedef enum ShadowStatus
  */
 #define SHADOW_NAME_CLASSIC_LENGTH     ( ( uint16_t ) ( sizeof( SHADOW_NAME_CLASSIC ) - 1U ) )
 
+/**
+ * @ingroup shadow_constants
+ * @brief The 32-bit FNV-1a offset basis, the hash of an empty string.
+ */
+#define SHADOW_HASH_OFFSET_BASIS       ( 2166136261U )
+
+/**
+ * @ingroup shadow_constants
+ * @brief The 32-bit FNV-1a prime.
+ */
+#define SHADOW_HASH_PRIME              ( 16777619U )
+
+/**
+ * @ingroup shadow_constants
+ * @brief Add one byte to a 32-bit FNV-1a hash, as for the hashes of
+ *        #ShadowTopicHash_t.
+ *
+ * @param[in] hash The hash of the preceding bytes.
+ * @param[in] byte The byte to add.
+ */
+#define SHADOW_HASH_BYTE( hash, byte ) \
+    ( ( uint32_t ) ( ( ( uint32_t ) ( hash ) ^ ( uint32_t ) ( uint8_t ) ( byte ) ) * SHADOW_HASH_PRIME ) )
+
 /**
  * @ingroup shadow_constants
  * @brief Compute shadow topic length.
@@ -478,6 +667,110 @@ typedef enum ShadowStatus
 #define SHADOW_TOPIC_LEN_MAX( thingNameLength, shadowNameLength ) \
     SHADOW_TOPIC_LEN( SHADOW_OP_UPDATE_LENGTH, SHADOW_SUFFIX_DOCUMENTS_LENGTH, thingNameLength, shadowNameLength )
 
+/**
+ * @ingroup shadow_constants
+ * @brief The length of the shortest topic that Shadow_MatchTopicString() can match.
+ *
+ * This is the length of "$aws/things/<thingName>/shadow/get/accepted" with a
+ * Thing name of one character. No Shadow message type has a shorter operation
+ * and suffix than "/get/accepted".
+ */
+#define SHADOW_TOPIC_LEN_MIN \
+    SHADOW_TOPIC_LEN( SHADOW_OP_GET_LENGTH, SHADOW_SUFFIX_ACCEPTED_LENGTH, 1U, SHADOW_NAME_CLASSIC_LENGTH )
+
+/**
+ * @ingroup shadow_constants
+ * @brief Compute the size of the buffer needed by Shadow_AssembleAllTopics()
+ *        for all the topics of a shadow.
+ *
+ * The "get", "delete" and "update" topics are the first characters of the
+ * corresponding "accepted" topics, so only the other eight topics take space
+ * in the buffer.
+ *
+ * @param[in] thingNameLength Length of the thingName excluding the ending NULL.
+ * @param[in] shadowNameLength Length of the shadowName excluding the ending NULL. Zero for classic shadow.
+ *
+ * @return Size of the buffer in bytes.
+ */
+#define SHADOW_TOPIC_LEN_ALL( thingNameLength, shadowNameLength ) \
+    ( SHADOW_TOPIC_LEN_GET_ACC( thingNameLength, shadowNameLength ) +     \
+      SHADOW_TOPIC_LEN_GET_REJ( thingNameLength, shadowNameLength ) +     \
+      SHADOW_TOPIC_LEN_DELETE_ACC( thingNameLength, shadowNameLength ) +  \
+      SHADOW_TOPIC_LEN_DELETE_REJ( thingNameLength, shadowNameLength ) +  \
+      SHADOW_TOPIC_LEN_UPDATE_ACC( thingNameLength, shadowNameLength ) +  \
+      SHADOW_TOPIC_LEN_UPDATE_REJ( thingNameLength, shadowNameLength ) +  \
+      SHADOW_TOPIC_LEN_UPDATE_DOCS( thingNameLength, shadowNameLength ) + \
+      SHADOW_TOPIC_LEN_UPDATE_DELTA( thingNameLength, shadowNameLength ) )
+
+/**
+ * @ingroup shadow_constants
+ * @brief The bit of a #ShadowTopicStringType_t in a topic type mask of
+ *        Shadow_AssembleTopicsBulk().
+ *
+ * @param[in] topicType The topic type.
+ */
+#define SHADOW_TOPIC_TYPE_BIT( topicType )    ( ( uint16_t ) ( ( uint16_t ) 1U << ( uint16_t ) ( topicType ) ) )
+
+/**
+ * @ingroup shadow_constants
+ * @brief The topic type mask of Shadow_AssembleTopicsBulk() that selects every
+ *        #ShadowTopicStringType_t.
+ */
+#define SHADOW_TOPIC_TYPE_ALL                 ( ( uint16_t ) ( SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeMaxNum ) - 1U ) )
+
+/**
+ * @ingroup shadow_constants
+ * @brief The maximum number of segments of a topic string returned by
+ *        Shadow_AssembleTopicSegments(): the prefix, Thing name, root,
+ *        Shadow name and operation.
+ */
+#define SHADOW_TOPIC_SEGMENT_COUNT_MAX        ( 5U )
+
+/**
+ * @ingroup shadow_constants
+ * @brief The maximum number of topic filters returned by
+ *        Shadow_AssembleWildcardFilters() for a number of shadows: one per
+ *        topic type, for each shadow.
+ *
+ * @param[in] nameCount The number of shadows.
+ */
+#define SHADOW_WILDCARD_FILTER_COUNT_MAX( nameCount )    ( ( nameCount ) * ( uint32_t ) ShadowTopicStringTypeMaxNum )
+
+/**
+ * @ingroup shadow_constants
+ * @brief The number of bytes that an MQTT SUBSCRIBE payload adds to each topic
+ *        filter: the two bytes of its length, and the subscription options.
+ */
+#define SHADOW_SUBSCRIBE_ENTRY_OVERHEAD       ( 3U )
+
+/**
+ * @ingroup shadow_constants
+ * @brief The number of bytes that an MQTT UNSUBSCRIBE payload adds to each
+ *        topic filter: the two bytes of its length.
+ */
+#define SHADOW_UNSUBSCRIBE_ENTRY_OVERHEAD     ( 2U )
+
+/**
+ * @ingroup shadow_constants
+ * @brief Compute the size of the MQTT SUBSCRIBE payload of all the topics of
+ *        one shadow, as serialized by Shadow_SerializeSubscribePayload().
+ *
+ * Unlike in #SHADOW_TOPIC_LEN_ALL, the "get", "delete" and "update" topics
+ * take space of their own. The UNSUBSCRIBE payload of the same topics is
+ * smaller.
+ *
+ * @param[in] thingNameLength Length of the thingName excluding the ending NULL.
+ * @param[in] shadowNameLength Length of the shadowName excluding the ending NULL. Zero for classic shadow.
+ *
+ * @return Size of the payload in bytes.
+ */
+#define SHADOW_SUBSCRIBE_PAYLOAD_LEN_ALL( thingNameLength, shadowNameLength ) \
+    ( SHADOW_TOPIC_LEN_ALL( thingNameLength, shadowNameLength ) +               \
+      SHADOW_TOPIC_LEN_GET( thingNameLength, shadowNameLength ) +               \
+      SHADOW_TOPIC_LEN_DELETE( thingNameLength, shadowNameLength ) +            \
+      SHADOW_TOPIC_LEN_UPDATE( thingNameLength, shadowNameLength ) +            \
+      ( SHADOW_SUBSCRIBE_ENTRY_OVERHEAD * ( uint32_t ) ShadowTopicStringTypeMaxNum ) )
+
 /**
  * @ingroup shadow_constants
  * @brief Assemble constant shadow topic strings when Thing Name is known at compile time.
@@ -653,6 +946,19 @@ typedef enum ShadowStatus
 #define SHADOW_TOPIC_STR_DELETE_REJ( thingName, shadowName ) \
     SHADOW_TOPIC_STR( thingName, shadowName, SHADOW_OP_DELETE, SHADOW_SUFFIX_REJECTED )
 
+/**
+ * @ingroup shadow_constants
+ * @brief The descriptions of the end of the topic strings of every
+ *        #ShadowTopicStringType_t, indexed by topic type.
+ *
+ * Used by the Shadow library to assemble and match topic strings, and by
+ * applications to get the length of a topic string without a function call.
+ * For example, the length of the "update/delta" topic of a shadow is
+ * <code>SHADOW_TOPIC_LEN( ShadowTopicDescriptors[ ShadowTopicStringTypeUpdateDelta ].length,
+ * 0U, thingNameLength, shadowNameLength )</code>.
+ */
+extern const ShadowTopicDescriptor_t ShadowTopicDescriptors[ ShadowTopicStringTypeMaxNum ];
+
 /*------------------------ Shadow library functions -------------------------*/
 
 /**
@@ -802,6 +1108,839 @@ ShadowStatus_t Shadow_MatchTopicString( const char * pTopic,
                                         uint8_t * pShadowNameLength );
 /* @[declare_shadow_matchtopicstring] */
 
+/**
+ * @brief Match an array of incoming topic strings in one call. Each topic is
+ *        parsed exactly as Shadow_MatchTopicString() would parse it, and the
+ *        outcome is written to the result with the same index.
+ *
+ * The array parameters are validated once for the whole batch, which makes this
+ * function cheaper than calling Shadow_MatchTopicString() in a loop when many
+ * messages arrive at once.
+ *
+ * @param[in]  pTopics Array of topic strings to match.
+ * @param[in]  topicCount Number of entries in pTopics and pResults.
+ * @param[out] pResults Caller-supplied array of topicCount entries for returning
+ *             the match results. The status member of each entry is #SHADOW_SUCCESS
+ *             if the topic is a Shadow topic, #SHADOW_BAD_PARAMETER if the entry
+ *             has a NULL or empty topic, or the error code that
+ *             Shadow_MatchTopicString() would return for that topic.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the batch was processed. The status of each
+ *               topic is returned in its result entry.
+ *             - #SHADOW_BAD_PARAMETER if pTopics or pResults is NULL, or
+ *               topicCount is zero.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * ShadowTopic_t topics[ 2 ];
+ * ShadowMatchResult_t results[ 2 ];
+ * ShadowStatus_t shadowStatus;
+ *
+ * // Fill topics[] with the topic strings received from the MQTT stack.
+ *
+ * shadowStatus = Shadow_MatchTopicBatch( topics, 2U, results );
+ *
+ * if( ( shadowStatus == SHADOW_SUCCESS ) && ( results[ 0 ].status == SHADOW_SUCCESS ) )
+ * {
+ *      // topics[ 0 ] is a device shadow message of type results[ 0 ].messageType.
+ *      // The Thing name starts at &( topics[ 0 ].pTopic[ results[ 0 ].thingNameOffset ] ).
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_matchtopicbatch] */
+ShadowStatus_t Shadow_MatchTopicBatch( const ShadowTopic_t * pTopics,
+                                       uint32_t topicCount,
+                                       ShadowMatchResult_t * pResults );
+/* @[declare_shadow_matchtopicbatch] */
+
+/**
+ * @brief Quickly check whether an incoming topic string can be a Shadow topic.
+ *
+ * Only the length of the topic and its first #SHADOW_PREFIX_LENGTH characters
+ * are checked, so this function rejects most non-Shadow topics, such as
+ * telemetry or jobs topics, in a few instructions. A topic that passes still
+ * has to be matched with Shadow_MatchTopicString() to tell whether it is a
+ * Shadow topic, and of which type.
+ *
+ * Shadow_MatchTopicString() and Shadow_MatchTopicBatch() do the same prefix check
+ * before parsing, so calling this function first is only useful to skip other
+ * work done for Shadow topics.
+ *
+ * @param[in]  pTopic Pointer to the MQTT topic string. Does not have to be null-terminated.
+ * @param[in]  topicLength Length of the MQTT topic string.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic can be a Shadow topic;
+ *             - #SHADOW_FAIL if the topic is shorter than #SHADOW_TOPIC_LEN_MIN or
+ *               does not start with #SHADOW_PREFIX;
+ *             - #SHADOW_BAD_PARAMETER if pTopic is NULL or topicLength is zero.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * char * pTopicName; //usually supplied by MQTT stack
+ * uint16_t topicNameLength; //usually supplied by MQTT stack
+ *
+ * if( Shadow_PrefilterTopic( pTopicName, topicNameLength ) != SHADOW_SUCCESS )
+ * {
+ *      // Not a device shadow message. Pass it to the other topic handlers.
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_prefiltertopic] */
+ShadowStatus_t Shadow_PrefilterTopic( const char * pTopic,
+                                      uint16_t topicLength );
+/* @[declare_shadow_prefiltertopic] */
+
+/**
+ * @brief Classify an incoming topic string by its last characters, without
+ *        parsing the Thing and Shadow names.
+ *
+ * The message type of a Shadow topic is given by its operation and suffix at
+ * the end of the topic, such as "/update/delta". This function checks the
+ * #SHADOW_PREFIX and then reads the topic from its end, so it takes the same
+ * time whatever the length of the Thing name. An application that only
+ * handles some message types can drop the others without parsing them, and
+ * call Shadow_MatchTopicString() only for the topics it handles.
+ *
+ * The classic shadow root, or the named shadow root and a Shadow name, must
+ * come right before the operation, so that topics of other services, such as
+ * "$aws/things/myThing/jobs/get/accepted", are rejected. The Thing name is
+ * not checked, so this function classifies some topics that
+ * Shadow_MatchTopicString() rejects, such as
+ * "$aws/things/my/Thing/shadow/update/delta". It never rejects a topic that
+ * Shadow_MatchTopicString() matches, and always gives it the same message type.
+ *
+ * @param[in]  pTopic Pointer to the MQTT topic string. Does not have to be null-terminated.
+ * @param[in]  topicLength Length of the MQTT topic string.
+ * @param[out] pMessageType Pointer to caller-supplied memory for returning the type of the shadow message.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic ends with a Shadow operation and suffix;
+ *             - #SHADOW_FAIL if the topic is shorter than #SHADOW_TOPIC_LEN_MIN or
+ *               does not start with #SHADOW_PREFIX;
+ *             - #SHADOW_MESSAGE_TYPE_PARSE_FAILED if the topic does not end with a
+ *               Shadow operation and suffix;
+ *             - #SHADOW_ROOT_PARSE_FAILED if no Shadow root comes before the
+ *               operation;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL or topicLength is zero.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * char * pTopicName; //usually supplied by MQTT stack
+ * uint16_t topicNameLength; //usually supplied by MQTT stack
+ * ShadowMessageType_t messageType;
+ * const char * pThingName;
+ * uint8_t thingNameLength;
+ *
+ * if( ( Shadow_ClassifyTopic( pTopicName, topicNameLength, &messageType ) == SHADOW_SUCCESS ) &&
+ *     ( messageType == ShadowMessageTypeUpdateDelta ) &&
+ *     ( Shadow_MatchTopicString( pTopicName, topicNameLength, &messageType,
+ *                                &pThingName, &thingNameLength, NULL, NULL ) == SHADOW_SUCCESS ) )
+ * {
+ *      // Apply the delta for the Thing pThingName.
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_classifytopic] */
+ShadowStatus_t Shadow_ClassifyTopic( const char * pTopic,
+                                     uint16_t topicLength,
+                                     ShadowMessageType_t * pMessageType );
+/* @[declare_shadow_classifytopic] */
+
+/**
+ * @brief Match an incoming topic string, and hash its Thing and Shadow names
+ *        while they are scanned.
+ *
+ * The topic is matched exactly as Shadow_MatchTopicString() would match it. The
+ * names are hashed one byte at a time as the parser looks for their ends, so
+ * the application does not have to read them again to look them up in a hash
+ * table. #SHADOW_NAME_SCAN does not apply to this function.
+ *
+ * @param[in]  pTopic Pointer to the MQTT topic string. Does not have to be null-terminated.
+ * @param[in]  topicLength Length of the MQTT topic string.
+ * @param[out] pResult Pointer to caller-supplied memory for returning the match
+ *             result, as filled by Shadow_MatchTopicBatch().
+ * @param[out] pHash Pointer to caller-supplied memory for returning the hashes of
+ *             the names. Only valid if #SHADOW_SUCCESS is returned.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic is a Shadow topic;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL or topicLength is zero;
+ *             - The error code that Shadow_MatchTopicString() would return if the
+ *               topic is not a Shadow topic.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * char * pTopicName; //usually supplied by MQTT stack
+ * uint16_t topicNameLength; //usually supplied by MQTT stack
+ * ShadowMatchResult_t result;
+ * ShadowTopicHash_t hash;
+ *
+ * if( Shadow_MatchTopicHash( pTopicName, topicNameLength, &result, &hash ) == SHADOW_SUCCESS )
+ * {
+ *      // Look up the context of the Thing and Shadow names with hash.keyHash.
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_matchtopichash] */
+ShadowStatus_t Shadow_MatchTopicHash( const char * pTopic,
+                                      uint16_t topicLength,
+                                      ShadowMatchResult_t * pResult,
+                                      ShadowTopicHash_t * pHash );
+/* @[declare_shadow_matchtopichash] */
+
+/**
+ * @brief Compute the hashes of a Thing and Shadow name pair, as
+ *        Shadow_MatchTopicHash() computes them for a topic with these names.
+ *
+ * @param[in]  pThingName Thing name. Does not have to be null-terminated.
+ * @param[in]  thingNameLength Length of the Thing name.
+ * @param[in]  pShadowName Shadow name, or #SHADOW_NAME_CLASSIC for a Classic shadow.
+ *             Does not have to be null-terminated. May be NULL if
+ *             @p shadowNameLength is zero.
+ * @param[in]  shadowNameLength Length of the Shadow name. Zero for a Classic shadow.
+ * @param[out] pHash Pointer to caller-supplied memory for returning the hashes.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the hashes are computed;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, or the Thing name
+ *               length is zero.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * ShadowTopicHash_t hash;
+ * ShadowStatus_t shadowStatus;
+ *
+ * shadowStatus = Shadow_HashNames( "myThing", 7U, "myShadow", 8U, &hash );
+ *
+ * if( shadowStatus == SHADOW_SUCCESS )
+ * {
+ *      // Insert the context of myThing/myShadow in a hash table with hash.keyHash.
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_hashnames] */
+ShadowStatus_t Shadow_HashNames( const char * pThingName,
+                                 uint8_t thingNameLength,
+                                 const char * pShadowName,
+                                 uint8_t shadowNameLength,
+                                 ShadowTopicHash_t * pHash );
+/* @[declare_shadow_hashnames] */
+
+/**
+ * @brief Start matching a topic string that is received in chunks.
+ *
+ * Some transports deliver the topic of a PUBLISH packet in several pieces, for
+ * example when it wraps around the end of a ring buffer or spans chained
+ * network buffers. Instead of copying the pieces into one buffer for
+ * Shadow_MatchTopicString(), call this function, then Shadow_MatchTopicChunk()
+ * once per piece in order, then Shadow_MatchTopicFinish(). Each byte of the
+ * topic is read once and none of the chunks are kept, so a chunk's buffer can
+ * be reused as soon as Shadow_MatchTopicChunk() returns.
+ *
+ * @param[out] pContext Pointer to caller-supplied memory for the matching state.
+ * @param[out] pHash NULL, or pointer to caller-supplied memory for returning
+ *             the hashes of the names, as computed by Shadow_MatchTopicHash().
+ *             Only valid once Shadow_MatchTopicFinish() returns #SHADOW_SUCCESS.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the context is ready for the first chunk;
+ *             - #SHADOW_BAD_PARAMETER if pContext is NULL.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * // The topic wraps around the end of a ring buffer.
+ * char * pTopicTail; // Part of the topic before the end of the ring buffer.
+ * uint16_t topicTailLength;
+ * char * pTopicHead; // Rest of the topic, at the start of the ring buffer.
+ * uint16_t topicHeadLength;
+ * ShadowMatchContext_t context;
+ * ShadowMatchResult_t result;
+ *
+ * ( void ) Shadow_MatchTopicStart( &context, NULL );
+ *
+ * if( Shadow_MatchTopicChunk( &context, pTopicTail, topicTailLength ) == SHADOW_SUCCESS )
+ * {
+ *      ( void ) Shadow_MatchTopicChunk( &context, pTopicHead, topicHeadLength );
+ * }
+ *
+ * if( Shadow_MatchTopicFinish( &context, &result ) == SHADOW_SUCCESS )
+ * {
+ *      // It is a device shadow message of type result.messageType.
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_matchtopicstart] */
+ShadowStatus_t Shadow_MatchTopicStart( ShadowMatchContext_t * pContext,
+                                       ShadowTopicHash_t * pHash );
+/* @[declare_shadow_matchtopicstart] */
+
+/**
+ * @brief Match the next chunk of a topic string.
+ *
+ * See Shadow_MatchTopicStart(). The chunks may be of any length, including
+ * zero and a single byte.
+ *
+ * @param[in,out] pContext The matching state set by Shadow_MatchTopicStart().
+ * @param[in]  pChunk Pointer to the next bytes of the topic string.
+ * @param[in]  chunkLength Length of pChunk.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic matched so far can still be a Shadow topic;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL;
+ *             - The error code that Shadow_MatchTopicFinish() will return, once
+ *               the topic is known not to be a Shadow topic. The rest of the topic
+ *               does not have to be fed.
+ */
+/* @[declare_shadow_matchtopicchunk] */
+ShadowStatus_t Shadow_MatchTopicChunk( ShadowMatchContext_t * pContext,
+                                       const char * pChunk,
+                                       uint16_t chunkLength );
+/* @[declare_shadow_matchtopicchunk] */
+
+/**
+ * @brief Get the result of matching a topic string fed in chunks.
+ *
+ * See Shadow_MatchTopicStart(). The result is the one Shadow_MatchTopicBatch()
+ * gives for all the chunks put together, and the name offsets are relative to
+ * the first byte of the first chunk.
+ *
+ * @param[in]  pContext The matching state after the last chunk.
+ * @param[out] pResult Pointer to caller-supplied memory for returning the match
+ *             result, as filled by Shadow_MatchTopicBatch().
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic is a Shadow topic;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, or no bytes of the
+ *               topic were fed;
+ *             - The error code that Shadow_MatchTopicString() would return if the
+ *               topic is not a Shadow topic.
+ */
+/* @[declare_shadow_matchtopicfinish] */
+ShadowStatus_t Shadow_MatchTopicFinish( const ShadowMatchContext_t * pContext,
+                                        ShadowMatchResult_t * pResult );
+/* @[declare_shadow_matchtopicfinish] */
+
+/**
+ * @brief Assemble all the topic strings of a shadow into one buffer.
+ *
+ * Writes the topic string of every #ShadowTopicStringType_t for the given Thing
+ * and Shadow names into one caller-supplied buffer, and returns the position of
+ * each topic string in the buffer. The prefix, Thing name, root and Shadow name
+ * are read from the arguments once and then copied within the buffer. A topic
+ * string that is the beginning of another one, such as "get" of "get/accepted",
+ * is not written again: its span points at the beginning of the longer one.
+ *
+ * The topic strings are not NULL-terminated.
+ *
+ * @param[in]  pThingName Thing Name string. No need to be null terminated. Must not be NULL.
+ * @param[in]  thingNameLength Length of Thing Name string pointed to by pThingName. Must not be zero.
+ * @param[in]  pShadowName Shadow Name string. No need to be null terminated. Must not be NULL. Empty string for classic shadow.
+ * @param[in]  shadowNameLength Length of Shadow Name string pointed to by pShadowName. Zero for Classic shadow.
+ * @param[out] pTopicBuffer Pointer to buffer for returning the topic strings.
+ *             Caller is responsible for supplying memory pointed to by pTopicBuffer.
+ *             This function does not fill in the terminating null character.
+ * @param[in]  bufferSize Length of pTopicBuffer. The buffer needs
+ *             #SHADOW_TOPIC_LEN_ALL( thingNameLength, shadowNameLength ) bytes.
+ * @param[out] pTopicSpans Caller-supplied array of #ShadowTopicStringTypeMaxNum
+ *             entries, indexed by #ShadowTopicStringType_t, for returning the
+ *             position of each topic string in pTopicBuffer.
+ * @param[out] pOutLength Pointer to caller-supplied memory for returning the
+ *             number of bytes written to pTopicBuffer.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic strings are assembled;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, or a name length is
+ *               not valid, as for Shadow_AssembleTopicString();
+ *             - #SHADOW_BUFFER_TOO_SMALL if the buffer cannot hold the topic strings.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * static char topicBuffer[ SHADOW_TOPIC_LEN_ALL( 7U, 8U ) ];
+ * static ShadowTopicSpan_t topicSpans[ ShadowTopicStringTypeMaxNum ];
+ * ShadowStatus_t shadowStatus;
+ * uint16_t outLength;
+ *
+ * shadowStatus = Shadow_AssembleAllTopics( "myThing", 7U,
+ *                                          "myShadow", 8U,
+ *                                          topicBuffer,
+ *                                          sizeof( topicBuffer ),
+ *                                          topicSpans,
+ *                                          &outLength );
+ *
+ * if( shadowStatus == SHADOW_SUCCESS )
+ * {
+ *      // The update topic is topicSpans[ ShadowTopicStringTypeUpdate ].length
+ *      // characters at &( topicBuffer[ topicSpans[ ShadowTopicStringTypeUpdate ].offset ] ).
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_assemblealltopics] */
+ShadowStatus_t Shadow_AssembleAllTopics( const char * pThingName,
+                                         uint8_t thingNameLength,
+                                         const char * pShadowName,
+                                         uint8_t shadowNameLength,
+                                         char * pTopicBuffer,
+                                         uint16_t bufferSize,
+                                         ShadowTopicSpan_t * pTopicSpans,
+                                         uint16_t * pOutLength );
+/* @[declare_shadow_assemblealltopics] */
+
+/**
+ * @brief Assemble a set of topic strings for each of many shadows into one buffer.
+ *
+ * For each entry of @p pNames, writes the topic strings of the topic types
+ * selected by @p topicTypeMask into the buffer, as Shadow_AssembleAllTopics()
+ * does for all the topic types of one shadow. The topics of each shadow follow
+ * those of the previous shadow in the buffer.
+ *
+ * The position of each topic string is returned in @p pTopicSpans, which holds
+ * one entry per shadow and selected topic type, ordered by shadow and then by
+ * topic type. With N topic types selected, the span of the k-th selected topic
+ * type of shadow i is pTopicSpans[ ( i * N ) + k ].
+ *
+ * The topic strings are not NULL-terminated.
+ *
+ * @param[in]  pNames Array of the Thing and Shadow names of the shadows.
+ * @param[in]  nameCount Number of entries in pNames. Must not be zero.
+ * @param[in]  topicTypeMask The topic types to assemble for each shadow. A bitwise
+ *             OR of #SHADOW_TOPIC_TYPE_BIT of each topic type, or #SHADOW_TOPIC_TYPE_ALL.
+ * @param[out] pTopicBuffer Pointer to buffer for returning the topic strings.
+ * @param[in]  bufferSize Length of pTopicBuffer.
+ * @param[out] pTopicSpans Caller-supplied array of nameCount times the number of
+ *             selected topic types entries, for returning the position of each
+ *             topic string in pTopicBuffer.
+ * @param[out] pOutLength Pointer to caller-supplied memory for returning the
+ *             number of bytes written to pTopicBuffer, or the number of bytes
+ *             needed if #SHADOW_BUFFER_TOO_SMALL is returned.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic strings are assembled;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, nameCount is zero or
+ *               too large for the length of the topics to fit in 32 bits,
+ *               topicTypeMask selects no topic type or an invalid one, or a name
+ *               is not valid, as for Shadow_AssembleTopicString();
+ *             - #SHADOW_BUFFER_TOO_SMALL if the buffer cannot hold the topic strings.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * ShadowNames_t names[ 2 ] =
+ * {
+ *     { "thingOne", SHADOW_NAME_CLASSIC, 8U, SHADOW_NAME_CLASSIC_LENGTH },
+ *     { "thingTwo", SHADOW_NAME_CLASSIC, 8U, SHADOW_NAME_CLASSIC_LENGTH }
+ * };
+ * static char topicBuffer[ 512 ];
+ * static ShadowTopicSpan_t topicSpans[ 2 * 2 ];
+ * ShadowStatus_t shadowStatus;
+ * uint32_t outLength;
+ *
+ * // Assemble the update and update/delta topics of both shadows.
+ * shadowStatus = Shadow_AssembleTopicsBulk( names, 2U,
+ *                                           SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdate ) |
+ *                                           SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta ),
+ *                                           topicBuffer, sizeof( topicBuffer ),
+ *                                           topicSpans, &outLength );
+ *
+ * if( shadowStatus == SHADOW_SUCCESS )
+ * {
+ *      // The update/delta topic of thingTwo is topicSpans[ 3 ].
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_assembletopicsbulk] */
+ShadowStatus_t Shadow_AssembleTopicsBulk( const ShadowNames_t * pNames,
+                                          uint32_t nameCount,
+                                          uint16_t topicTypeMask,
+                                          char * pTopicBuffer,
+                                          uint32_t bufferSize,
+                                          ShadowTopicSpan_t * pTopicSpans,
+                                          uint32_t * pOutLength );
+/* @[declare_shadow_assembletopicsbulk] */
+
+/**
+ * @brief Assemble MQTT topic filters with wildcards that cover the topics of
+ * many shadows, to subscribe to them with a few subscriptions.
+ *
+ * The shadows are grouped by Thing first: the Shadow name of the named
+ * shadows of a Thing that has more than one is replaced with the '+'
+ * wildcard, such as "$aws/things/myThing/shadow/name/+/update/delta". Of the
+ * shadows that are left, those of different Things with the same Shadow name,
+ * or Classic shadows of different Things, get the '+' wildcard in place of
+ * the Thing name. A topic filter never has both names replaced, so it does
+ * not cover every shadow of the account, which a per-Thing IoT policy would
+ * not allow. Topic types that make up all the topics of a topic level are
+ * covered with one topic filter, such as "update/+" for the four responses to
+ * "update", and "+/+" for every response.
+ *
+ * The topic filters cover every selected topic of the given shadows, and may
+ * also cover topics of other shadows when a name is replaced with a wildcard.
+ * A topic may match more than one of the topic filters. The topic filters are
+ * in the order of the first shadow that each one covers, and are not
+ * NULL-terminated. The shadows are grouped by sorting them in @p pScratch, so
+ * the time taken grows with nameCount times its logarithm.
+ *
+ * @param[in]  pNames Array of the Thing and Shadow names of the shadows.
+ * @param[in]  nameCount Number of entries in pNames. Must not be zero.
+ * @param[in]  topicTypeMask The topic types to cover for each shadow. A bitwise
+ *             OR of #SHADOW_TOPIC_TYPE_BIT of each topic type, or #SHADOW_TOPIC_TYPE_ALL.
+ * @param[in]  pScratch Caller-supplied array of nameCount entries, used while
+ *             the shadows are grouped.
+ * @param[out] pFilterBuffer Pointer to buffer for returning the topic filters.
+ * @param[in]  bufferSize Length of pFilterBuffer.
+ * @param[out] pFilterSpans Caller-supplied array for returning the position of
+ *             each topic filter in pFilterBuffer.
+ *             #SHADOW_WILDCARD_FILTER_COUNT_MAX( nameCount ) entries are always enough.
+ * @param[in]  spanCount Number of entries in pFilterSpans.
+ * @param[out] pFilterCount Pointer to caller-supplied memory for returning the
+ *             number of topic filters, which is also the number of spans
+ *             needed if #SHADOW_BUFFER_TOO_SMALL is returned.
+ * @param[out] pOutLength Pointer to caller-supplied memory for returning the
+ *             number of bytes written to pFilterBuffer, or the number of bytes
+ *             needed if #SHADOW_BUFFER_TOO_SMALL is returned.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic filters are assembled;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, nameCount is zero or
+ *               too large for the length of the topic filters to fit in 32 bits,
+ *               topicTypeMask selects no topic type or an invalid one, or a name
+ *               is not valid, as for Shadow_AssembleTopicString();
+ *             - #SHADOW_BUFFER_TOO_SMALL if pFilterSpans has fewer entries than
+ *               there are topic filters, or the buffer cannot hold them. Nothing
+ *               is written to pFilterSpans or pFilterBuffer then.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * ShadowNames_t names[ 2 ] =
+ * {
+ *     { "thingOne", "config", 8U, 6U },
+ *     { "thingTwo", "config", 8U, 6U }
+ * };
+ * static ShadowWildcardEntry_t scratch[ 2 ];
+ * static char filterBuffer[ 128 ];
+ * static ShadowTopicSpan_t filterSpans[ SHADOW_WILDCARD_FILTER_COUNT_MAX( 2U ) ];
+ * ShadowStatus_t shadowStatus;
+ * uint32_t filterCount;
+ * uint32_t outLength;
+ *
+ * shadowStatus = Shadow_AssembleWildcardFilters( names, 2U,
+ *                                                SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta ),
+ *                                                scratch,
+ *                                                filterBuffer, sizeof( filterBuffer ),
+ *                                                filterSpans, SHADOW_WILDCARD_FILTER_COUNT_MAX( 2U ),
+ *                                                &filterCount, &outLength );
+ *
+ * if( shadowStatus == SHADOW_SUCCESS )
+ * {
+ *      // filterCount is 1, and the topic filter is
+ *      // "$aws/things/+/shadow/name/config/update/delta".
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_assemblewildcardfilters] */
+ShadowStatus_t Shadow_AssembleWildcardFilters( const ShadowNames_t * pNames,
+                                               uint32_t nameCount,
+                                               uint16_t topicTypeMask,
+                                               ShadowWildcardEntry_t * pScratch,
+                                               char * pFilterBuffer,
+                                               uint32_t bufferSize,
+                                               ShadowTopicSpan_t * pFilterSpans,
+                                               uint32_t spanCount,
+                                               uint32_t * pFilterCount,
+                                               uint32_t * pOutLength );
+/* @[declare_shadow_assemblewildcardfilters] */
+
+/**
+ * @brief Index a set of MQTT topic filters by their Thing name level, for
+ * Shadow_MatchTopicFilters().
+ *
+ * The topic filters may hold the '+' and '#' wildcards, and are usually those
+ * returned by Shadow_AssembleWildcardFilters(). Each topic filter takes one
+ * slot. Lookups take a constant number of steps on average while fewer than
+ * three quarters of the slots are used, so allocate about twice as many slots
+ * as topic filters. The index keeps pointers to the topic filters and their
+ * spans, not copies of them.
+ *
+ * @param[out] pIndex The index to initialize.
+ * @param[in]  pFilterBuffer Buffer holding the topic filters.
+ * @param[in]  pFilterSpans Array of the positions of the topic filters in pFilterBuffer.
+ * @param[in]  filterCount Number of entries in pFilterSpans.
+ * @param[in]  pSlots Array of @p slotCount slots for the index to use. The
+ *             array must remain valid for as long as the index is used.
+ * @param[in]  slotCount Number of slots in @p pSlots. Must be a power of two.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic filters are indexed;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, or slotCount is
+ *               not a power of two;
+ *             - #SHADOW_BUFFER_TOO_SMALL if slotCount is less than filterCount.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * static ShadowFilterSlot_t filterSlots[ 16 ];
+ * static ShadowFilterIndex_t filterIndex;
+ * ShadowStatus_t shadowStatus;
+ *
+ * // filterBuffer, filterSpans and filterCount were filled by
+ * // Shadow_AssembleWildcardFilters().
+ * shadowStatus = Shadow_FilterIndexInit( &filterIndex, filterBuffer, filterSpans,
+ *                                        filterCount, filterSlots, 16U );
+ *
+ * @endcode
+ */
+/* @[declare_shadow_filterindexinit] */
+ShadowStatus_t Shadow_FilterIndexInit( ShadowFilterIndex_t * pIndex,
+                                       const char * pFilterBuffer,
+                                       const ShadowTopicSpan_t * pFilterSpans,
+                                       uint32_t filterCount,
+                                       ShadowFilterSlot_t * pSlots,
+                                       uint32_t slotCount );
+/* @[declare_shadow_filterindexinit] */
+
+/**
+ * @brief Find the first of a set of MQTT topic filters that an incoming topic
+ * string matches.
+ *
+ * As in MQTT, a topic starting with '$' is not matched by a topic filter
+ * starting with a wildcard. Only the topic filters with the Thing name of the
+ * topic, and those without a Thing name, are compared with the topic, so the
+ * time taken does not grow with the number of topic filters of other Things.
+ *
+ * @param[in]  pIndex The topic filters, indexed with Shadow_FilterIndexInit().
+ * @param[in]  pTopic Pointer to the MQTT topic string. Does not have to be null-terminated.
+ * @param[in]  topicLength Length of the MQTT topic string.
+ * @param[out] pFilterIndex Pointer to caller-supplied memory for returning the
+ *             index of the first topic filter that the topic matches.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic matches a topic filter;
+ *             - #SHADOW_NOT_FOUND if the topic matches no topic filter;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL or topicLength is zero.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * char * pTopicName; //usually supplied by MQTT stack
+ * uint16_t topicNameLength; //usually supplied by MQTT stack
+ * uint32_t matchIndex;
+ *
+ * // filterIndex was initialized with Shadow_FilterIndexInit().
+ * if( Shadow_MatchTopicFilters( &filterIndex, pTopicName, topicNameLength,
+ *                               &matchIndex ) == SHADOW_SUCCESS )
+ * {
+ *      // The topic was received for the subscription to filter matchIndex.
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_matchtopicfilters] */
+ShadowStatus_t Shadow_MatchTopicFilters( const ShadowFilterIndex_t * pIndex,
+                                         const char * pTopic,
+                                         uint16_t topicLength,
+                                         uint32_t * pFilterIndex );
+/* @[declare_shadow_matchtopicfilters] */
+
+/**
+ * @brief Serialize the topic strings of many shadows into the payload of an
+ * MQTT SUBSCRIBE packet.
+ *
+ * For each entry of @p pNames, and each topic type selected by @p topicTypeMask,
+ * writes the length of the topic string as two bytes, most significant byte
+ * first, then the topic string, then @p qos as the subscription options byte.
+ * The entries are ordered by shadow and then by topic type, as the topic
+ * strings of Shadow_AssembleTopicsBulk(). The topic strings are written
+ * straight into the payload, without being assembled in another buffer first.
+ *
+ * The payload does not include the fixed header and packet identifier of the
+ * SUBSCRIBE packet. To get the size of the payload without writing it, call
+ * this function with a bufferSize of zero: it returns #SHADOW_BUFFER_TOO_SMALL
+ * with the size in @p pOutLength.
+ *
+ * @param[in]  pNames Array of the Thing and Shadow names of the shadows.
+ * @param[in]  nameCount Number of entries in pNames. Must not be zero.
+ * @param[in]  topicTypeMask The topic types to subscribe to for each shadow. A bitwise
+ *             OR of #SHADOW_TOPIC_TYPE_BIT of each topic type, or #SHADOW_TOPIC_TYPE_ALL.
+ * @param[in]  qos The requested QoS of every subscription: 0, 1 or 2.
+ * @param[out] pBuffer Pointer to buffer for returning the payload.
+ * @param[in]  bufferSize Length of pBuffer.
+ * @param[out] pOutLength Pointer to caller-supplied memory for returning the
+ *             number of bytes written to pBuffer, or the number of bytes
+ *             needed if #SHADOW_BUFFER_TOO_SMALL is returned.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the payload is serialized;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, nameCount is zero or
+ *               too large for the length of the payload to fit in 32 bits,
+ *               topicTypeMask selects no topic type or an invalid one, qos is
+ *               larger than 2, or a name is not valid, as for
+ *               Shadow_AssembleTopicString();
+ *             - #SHADOW_BUFFER_TOO_SMALL if the buffer cannot hold the payload.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * ShadowNames_t names[ 2 ] =
+ * {
+ *     { "thingOne", SHADOW_NAME_CLASSIC, 8U, SHADOW_NAME_CLASSIC_LENGTH },
+ *     { "thingTwo", SHADOW_NAME_CLASSIC, 8U, SHADOW_NAME_CLASSIC_LENGTH }
+ * };
+ * static uint8_t payload[ 2 * ( SHADOW_TOPIC_LEN_UPDATE_DELTA( 8U, 0U ) + SHADOW_SUBSCRIBE_ENTRY_OVERHEAD ) ];
+ * ShadowStatus_t shadowStatus;
+ * uint32_t payloadLength;
+ *
+ * shadowStatus = Shadow_SerializeSubscribePayload( names, 2U,
+ *                                                  SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta ),
+ *                                                  1U, payload, sizeof( payload ),
+ *                                                  &payloadLength );
+ *
+ * if( shadowStatus == SHADOW_SUCCESS )
+ * {
+ *      // Send the SUBSCRIBE fixed header, packet identifier, and then
+ *      // the payloadLength bytes of payload.
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_serializesubscribepayload] */
+ShadowStatus_t Shadow_SerializeSubscribePayload( const ShadowNames_t * pNames,
+                                                 uint32_t nameCount,
+                                                 uint16_t topicTypeMask,
+                                                 uint8_t qos,
+                                                 uint8_t * pBuffer,
+                                                 uint32_t bufferSize,
+                                                 uint32_t * pOutLength );
+/* @[declare_shadow_serializesubscribepayload] */
+
+/**
+ * @brief Serialize the topic strings of many shadows into the payload of an
+ * MQTT UNSUBSCRIBE packet.
+ *
+ * Works as Shadow_SerializeSubscribePayload(), except that the topic strings
+ * are not followed by a subscription options byte.
+ *
+ * @param[in]  pNames Array of the Thing and Shadow names of the shadows.
+ * @param[in]  nameCount Number of entries in pNames. Must not be zero.
+ * @param[in]  topicTypeMask The topic types to unsubscribe from for each shadow. A bitwise
+ *             OR of #SHADOW_TOPIC_TYPE_BIT of each topic type, or #SHADOW_TOPIC_TYPE_ALL.
+ * @param[out] pBuffer Pointer to buffer for returning the payload.
+ * @param[in]  bufferSize Length of pBuffer.
+ * @param[out] pOutLength Pointer to caller-supplied memory for returning the
+ *             number of bytes written to pBuffer, or the number of bytes
+ *             needed if #SHADOW_BUFFER_TOO_SMALL is returned.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the payload is serialized;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, nameCount is zero or
+ *               too large for the length of the payload to fit in 32 bits,
+ *               topicTypeMask selects no topic type or an invalid one, or a
+ *               name is not valid, as for Shadow_AssembleTopicString();
+ *             - #SHADOW_BUFFER_TOO_SMALL if the buffer cannot hold the payload.
+ */
+/* @[declare_shadow_serializeunsubscribepayload] */
+ShadowStatus_t Shadow_SerializeUnsubscribePayload( const ShadowNames_t * pNames,
+                                                   uint32_t nameCount,
+                                                   uint16_t topicTypeMask,
+                                                   uint8_t * pBuffer,
+                                                   uint32_t bufferSize,
+                                                   uint32_t * pOutLength );
+/* @[declare_shadow_serializeunsubscribepayload] */
+
+/**
+ * @brief Describe a topic string as a list of segments instead of copying it
+ * into a buffer.
+ *
+ * Returns the same topic string as Shadow_AssembleTopicString(), as segments
+ * that point to the constant prefix, root and operation strings of the library
+ * and to the caller's Thing and Shadow names. The topic string is the
+ * segments joined in order. An MQTT library that sends scatter/gather I/O
+ * vectors can send the segments without assembling the topic.
+ *
+ * A Classic shadow topic has four segments and a named shadow topic five.
+ *
+ * @note The Thing and Shadow name segments point into pThingName and
+ *       pShadowName, which must remain valid as long as the segments are used.
+ *
+ * @param[in]  topicType Indicates what topic will be written.
+ * @param[in]  pThingName Thing Name string. Must not be NULL.
+ * @param[in]  thingNameLength Length of Thing Name string pointed to by pThingName.
+ * @param[in]  pShadowName Shadow Name string. #SHADOW_NAME_CLASSIC for a Classic shadow.
+ * @param[in]  shadowNameLength Length of Shadow Name string pointed to by pShadowName.
+ *             Zero for a Classic shadow.
+ * @param[out] pSegments Caller-supplied array of #SHADOW_TOPIC_SEGMENT_COUNT_MAX
+ *             entries for returning the segments.
+ * @param[out] pSegmentCount Pointer to caller-supplied memory for returning the
+ *             number of segments.
+ * @param[out] pOutLength Pointer to caller-supplied memory for returning the
+ *             length of the topic string.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the segments are returned;
+ *             - #SHADOW_BAD_PARAMETER if any of the parameters is invalid.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * ShadowTopicSegment_t segments[ SHADOW_TOPIC_SEGMENT_COUNT_MAX ];
+ * uint8_t segmentCount = 0;
+ * uint16_t topicLength = 0;
+ * ShadowStatus_t shadowStatus;
+ *
+ * shadowStatus = Shadow_AssembleTopicSegments( ShadowTopicStringTypeUpdate,
+ *                                              "TestThingName", 13U,
+ *                                              SHADOW_NAME_CLASSIC, SHADOW_NAME_CLASSIC_LENGTH,
+ *                                              segments, &segmentCount, &topicLength );
+ *
+ * if( shadowStatus == SHADOW_SUCCESS )
+ * {
+ *      // Publish to the topic of topicLength bytes made of the
+ *      // segmentCount segments in segments.
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_assembletopicsegments] */
+ShadowStatus_t Shadow_AssembleTopicSegments( ShadowTopicStringType_t topicType,
+                                             const char * pThingName,
+                                             uint8_t thingNameLength,
+                                             const char * pShadowName,
+                                             uint8_t shadowNameLength,
+                                             ShadowTopicSegment_t * pSegments,
+                                             uint8_t * pSegmentCount,
+                                             uint16_t * pOutLength );
+/* @[declare_shadow_assembletopicsegments] */
+
 /*------------- Shadow library backwardly-compatible constants -------------*/
 
 /**
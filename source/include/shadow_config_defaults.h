@@ -54,6 +54,112 @@
     #define SHADOW_DO_NOT_USE_CUSTOM_CONFIG
 #endif
 
+/**
+ * @brief Select the single-pass topic matcher for Shadow_MatchTopicString().
+ *
+ * When set to 1, Shadow_MatchTopicString() and the other topic matching
+ * functions parse the topic with a state machine that reads each byte of the
+ * topic once, instead of matching the prefix, names, root and operation with
+ * separate string comparisons. Both matchers accept the same topics and return
+ * the same #ShadowStatus_t codes. Shadow_MatchTopicChunk() always uses the
+ * state machine, since it has to stop and resume anywhere in the topic.
+ *
+ * <b>Possible values:</b> 0 or 1 <br>
+ * <b>Default value:</b> 0
+ */
+#ifndef SHADOW_SINGLE_PASS_MATCH
+    #define SHADOW_SINGLE_PASS_MATCH    ( 0 )
+#endif
+
+/**
+ * @brief Value of #SHADOW_NAME_SCAN that looks for the '/' ending a Thing or
+ * Shadow name one byte at a time.
+ */
+#define SHADOW_NAME_SCAN_BYTEWISE    ( 0 )
+
+/**
+ * @brief Value of #SHADOW_NAME_SCAN that looks for the '/' ending a Thing or
+ * Shadow name with the C library's memchr().
+ *
+ * Most C libraries for x86-64 and AArch64 implement memchr() with SSE2, AVX2
+ * or NEON instructions.
+ */
+#define SHADOW_NAME_SCAN_MEMCHR      ( 1 )
+
+/**
+ * @brief Value of #SHADOW_NAME_SCAN that looks for the '/' ending a Thing or
+ * Shadow name 8 bytes at a time in a 64-bit integer.
+ *
+ * Only uses portable C, for targets where memchr() is not vectorized.
+ */
+#define SHADOW_NAME_SCAN_SWAR        ( 2 )
+
+/**
+ * @brief Select how the Shadow library looks for the '/' that ends a Thing or
+ * Shadow name when matching a topic string.
+ *
+ * All methods give the same results. Thing names can be up to 128 bytes long,
+ * so topics with long Thing names match faster with a method that checks
+ * several bytes at once.
+ *
+ * <b>Possible values:</b> #SHADOW_NAME_SCAN_BYTEWISE, #SHADOW_NAME_SCAN_MEMCHR
+ * or #SHADOW_NAME_SCAN_SWAR <br>
+ * <b>Default value:</b> #SHADOW_NAME_SCAN_BYTEWISE
+ */
+#ifndef SHADOW_NAME_SCAN
+    #define SHADOW_NAME_SCAN    SHADOW_NAME_SCAN_BYTEWISE
+#endif
+
+/**
+ * @brief The Thing name of a device that only ever uses one Thing name,
+ * as a string literal.
+ *
+ * When defined, the topic matching functions compare the topic with the
+ * precomputed string "$aws/things/<SHADOW_FIXED_THING_NAME>/shadow" in one
+ * memcmp(), and only parse the rest of it. Topics of other Things are still
+ * matched, with the generic parser, so the results of the matching functions
+ * do not change.
+ *
+ * The Thing name must be 1 to 128 characters long and must not contain a
+ * forward slash.
+ *
+ * <b>Possible values:</b> A string literal, such as "myThing". <br>
+ * <b>Default value:</b> Not defined
+ */
+#ifdef DOXYGEN
+    #define SHADOW_FIXED_THING_NAME    "myThing"
+#endif
+
+/**
+ * @brief Maximum length of a topic string that a #ShadowTopicCache_t keeps.
+ *
+ * Each entry of a topic cache holds a copy of a topic string of up to this
+ * many characters. Longer topics are matched, but not cached. Shadow topics of
+ * a Thing name of up to 40 characters fit in the default length.
+ *
+ * <b>Possible values:</b> Any positive 16 bit integer. <br>
+ * <b>Default value:</b> 128
+ */
+#ifndef SHADOW_CACHED_TOPIC_LENGTH_MAX
+    #define SHADOW_CACHED_TOPIC_LENGTH_MAX    ( 128U )
+#endif
+
+/**
+ * @brief Maximum number of levels of the key path of a changed key returned by
+ * Shadow_DeltaParserNext().
+ *
+ * Objects in the "state" of an update/delta document that are nested deeper
+ * than this are returned as a single value, with the key path of the object.
+ * Each level takes the space of one #ShadowPayloadView_t in a
+ * #ShadowDeltaParser_t.
+ *
+ * <b>Possible values:</b> Any positive 8 bit integer. <br>
+ * <b>Default value:</b> 8
+ */
+#ifndef SHADOW_DELTA_DEPTH_MAX
+    #define SHADOW_DELTA_DEPTH_MAX    ( 8U )
+#endif
+
 /**
  * @brief Macro that is called in the Shadow library for logging "Error" level
  * messages.
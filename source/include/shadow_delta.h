@@ -0,0 +1,199 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file shadow_delta.h
+ * @brief User-facing functions of the Shadow delta engine, which finds the
+ * keys of a desired state that differ from a reported state.
+ */
+
+#ifndef SHADOW_DELTA_H_
+#define SHADOW_DELTA_H_
+
+/* Shadow includes. */
+#include "shadow_payload.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/*------------------------- Shadow delta types --------------------------*/
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief A state held in the "state" object of a shadow document.
+ *
+ * The state is either the whole "state" object, as in
+ * `{"state":{"color":"red"}}`, or one of its members, as the "desired" and
+ * "reported" members of a get/accepted document.
+ */
+typedef struct ShadowDeltaDocument
+{
+    const char * pPayload;  /**< @brief The document. Does not have to be null-terminated. */
+    uint32_t payloadLength; /**< @brief Length of the document. */
+    const char * pSection;  /**< @brief The key of the member of "state" that holds the state, such as "desired", or NULL for the whole "state" object. */
+    uint32_t sectionLength; /**< @brief Length of the key, or zero if pSection is NULL. */
+} ShadowDeltaDocument_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief An entry of the index of a reported state, held in
+ * application-provided memory.
+ *
+ * The application should not access the members directly.
+ */
+typedef struct ShadowDeltaEntry
+{
+    ShadowPayloadView_t key;   /**< @brief The key, in the reported document. */
+    ShadowPayloadView_t value; /**< @brief The value of the key, if it is not an object. */
+    uint32_t parent;           /**< @brief Index of the entry of the object holding the key, or the entry count for a key of the state. */
+    uint32_t hash;             /**< @brief Hash of the key and parent. */
+    uint8_t kind;              /**< @brief Whether the entry is empty, or holds an object or a value. */
+} ShadowDeltaEntry_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief The state of a computation of the delta between a desired and a
+ * reported state.
+ *
+ * Initialize with Shadow_DeltaEngineInit(). The application should not access
+ * the members directly.
+ */
+typedef struct ShadowDeltaEngine
+{
+    ShadowDeltaParser_t parser;                     /**< @brief Parser of the desired document. */
+    const char * pDesiredSection;                   /**< @brief Key of the desired state in "state", or NULL. */
+    uint32_t desiredSectionLength;                  /**< @brief Length of the key of the desired state. */
+    const char * pReported;                         /**< @brief The reported document. */
+    ShadowDeltaEntry_t * pEntries;                  /**< @brief Application-provided index of the reported state. */
+    uint32_t entryCount;                            /**< @brief Number of entries. A power of two. */
+    uint32_t pathEntries[ SHADOW_DELTA_DEPTH_MAX ]; /**< @brief Entry of each key of the last key path looked up. */
+    uint32_t pathOffsets[ SHADOW_DELTA_DEPTH_MAX ]; /**< @brief Offset of each key of the last key path looked up. */
+    uint8_t pathDepth;                              /**< @brief Number of valid levels of pathEntries and pathOffsets. */
+} ShadowDeltaEngine_t;
+
+/*----------------------- Shadow delta functions ------------------------*/
+
+/**
+ * @brief Start computing the delta between a desired and a reported state,
+ * as the service computes the document of an update/delta message.
+ *
+ * Reads the reported document once, and indexes each of its keys in
+ * @p pEntries with a hash table. The keys of the desired state that differ
+ * are then returned by Shadow_DeltaEngineNext(), which reads the desired
+ * document once. Both documents are read in place, and must stay in their
+ * buffers until the engine is no longer used.
+ *
+ * @param[out] pEngine The engine to initialize.
+ * @param[in]  pDesired The desired state.
+ * @param[in]  pReported The reported state. May be in the same payload as
+ *             the desired state, in another member of "state".
+ * @param[in]  pEntries Array of @p entryCount entries for the index. The array
+ *             must remain valid for as long as the engine is used.
+ * @param[in]  entryCount Number of entries. Must be a power of two, and more
+ *             than the number of keys in the reported state, counting the keys
+ *             of nested objects. Twice that number keeps lookups short.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the reported state is indexed;
+ *             - #SHADOW_BUFFER_TOO_SMALL if the reported state has too many keys;
+ *             - #SHADOW_PAYLOAD_PARSE_FAILED if the reported document is not a
+ *               JSON object;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, a payload is
+ *               empty, a section length does not match its pointer, or
+ *               entryCount is not a power of two.
+ */
+/* @[declare_shadow_deltaengineinit] */
+ShadowStatus_t Shadow_DeltaEngineInit( ShadowDeltaEngine_t * pEngine,
+                                       const ShadowDeltaDocument_t * pDesired,
+                                       const ShadowDeltaDocument_t * pReported,
+                                       ShadowDeltaEntry_t * pEntries,
+                                       uint32_t entryCount );
+/* @[declare_shadow_deltaengineinit] */
+
+/**
+ * @brief Return the next key of the desired state whose value differs from
+ * the reported state.
+ *
+ * A key differs if the reported state does not have it, or has another value
+ * for it. As in the update/delta document of the service, keys of nested
+ * objects are compared one by one, and keys that are only in the reported
+ * state are not part of the delta. Keys whose desired value is null are
+ * skipped, since the service deletes them.
+ *
+ * Keys and values are compared as they are written in the documents: strings
+ * with their escape sequences, and numbers with their digits, so 1 and 1.0
+ * differ. Arrays, and objects deeper than #SHADOW_DELTA_DEPTH_MAX, are
+ * compared as a whole.
+ *
+ * @param[in]  pEngine The engine, initialized with Shadow_DeltaEngineInit().
+ * @param[out] pToken Pointer to caller-supplied memory for returning the key
+ *             and its desired value. The key path starts at the key in the
+ *             desired state, and the views are into the desired document.
+ *             The field of the token is #ShadowDeltaFieldKey.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if a key is returned;
+ *             - #SHADOW_NOT_FOUND if there are no more keys that differ;
+ *             - #SHADOW_PAYLOAD_PARSE_FAILED if the desired document is not a
+ *               JSON object;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * // The reported state is kept in the document last sent to the update topic.
+ * ShadowDeltaDocument_t desired = { pDesiredDocument, desiredLength, NULL, 0U };
+ * ShadowDeltaDocument_t reported = { pReportedDocument, reportedLength, "reported", 8U };
+ * static ShadowDeltaEntry_t entries[ 64 ];
+ * ShadowDeltaEngine_t engine;
+ * ShadowDeltaToken_t token;
+ *
+ * if( Shadow_DeltaEngineInit( &engine, &desired, &reported, entries, 64U ) == SHADOW_SUCCESS )
+ * {
+ *      while( Shadow_DeltaEngineNext( &engine, &token ) == SHADOW_SUCCESS )
+ *      {
+ *          // Apply the desired value at &( pDesiredDocument[ token.value.offset ] ),
+ *          // and report it.
+ *      }
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_deltaenginenext] */
+ShadowStatus_t Shadow_DeltaEngineNext( ShadowDeltaEngine_t * pEngine,
+                                       ShadowDeltaToken_t * pToken );
+/* @[declare_shadow_deltaenginenext] */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* ifndef SHADOW_DELTA_H_ */
@@ -0,0 +1,291 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file shadow_mqtt.h
+ * @brief User-facing functions that match Shadow topics in received MQTT
+ * packets.
+ */
+
+#ifndef SHADOW_MQTT_H_
+#define SHADOW_MQTT_H_
+
+/* Shadow includes. */
+#include "shadow.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/*-------------------------- Shadow MQTT constants ---------------------------*/
+
+/**
+ * @ingroup shadow_constants
+ * @brief Protocol level of MQTT 3.1.1, for Shadow_MatchPublishPacket().
+ */
+#define SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1    ( 4U )
+
+/**
+ * @ingroup shadow_constants
+ * @brief Protocol level of MQTT 5, for Shadow_MatchPublishPacket().
+ */
+#define SHADOW_MQTT_PROTOCOL_LEVEL_5        ( 5U )
+
+/*---------------------------- Shadow MQTT types -----------------------------*/
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief The topic and payload of an MQTT PUBLISH packet, and the result of
+ * matching its topic.
+ *
+ * The topic and payload offsets are relative to the first byte of the packet.
+ * The name offsets in @p match are relative to the first character of the
+ * topic.
+ */
+typedef struct ShadowPublishInfo
+{
+    ShadowMatchResult_t match; /**< @brief Result of matching the topic. */
+    uint32_t topicOffset;      /**< @brief Offset of the topic name in the packet. */
+    uint16_t topicLength;      /**< @brief Length of the topic name. */
+    uint32_t payloadOffset;    /**< @brief Offset of the payload in the packet. */
+    uint32_t payloadLength;    /**< @brief Length of the payload. */
+} ShadowPublishInfo_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief The results of matching the topics of the MQTT 5 topic aliases of a
+ * connection, so that messages that only carry a topic alias can be matched
+ * without their topic.
+ *
+ * Initialize with Shadow_TopicAliasInit(). The application should not access
+ * the members directly.
+ */
+typedef struct ShadowTopicAliasTable
+{
+    ShadowMatchResult_t * pEntries; /**< @brief Application-provided entries. Entry i holds topic alias i + 1. */
+    uint16_t entryCount;            /**< @brief Number of entries. */
+} ShadowTopicAliasTable_t;
+
+/*-------------------------- Shadow MQTT functions ---------------------------*/
+
+/**
+ * @brief Find the topic and payload of a received MQTT PUBLISH packet, and
+ * match the topic in place.
+ *
+ * Decodes the fixed header, topic name and, for QoS 1 and 2, the packet
+ * identifier. For MQTT 5, the properties are skipped. Nothing is copied: the
+ * topic and payload are returned as offsets into @p pPacket.
+ *
+ * @p pPacket may hold more bytes than the PUBLISH packet, such as the start of
+ * the next packet in a receive buffer. The payload ends where the remaining
+ * length of the fixed header says the packet ends.
+ *
+ * An MQTT 5 packet that uses a topic alias can have an empty topic name. Its
+ * topic is not matched, and #SHADOW_BAD_PARAMETER is returned with a
+ * topicLength of zero in @p pPublishInfo. Use Shadow_MatchPublishPacketAlias()
+ * to match such packets.
+ *
+ * @param[in]  pPacket The packet, starting with the first byte of its fixed header.
+ * @param[in]  packetLength Number of bytes available at pPacket.
+ * @param[in]  protocolLevel #SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1 or
+ *             #SHADOW_MQTT_PROTOCOL_LEVEL_5.
+ * @param[out] pPublishInfo Pointer to caller-supplied memory for returning the
+ *             topic, payload and match result.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic is a Shadow topic;
+ *             - #SHADOW_BAD_PARAMETER if a parameter is invalid, or the packet
+ *               is not a well-formed PUBLISH packet that fits in packetLength;
+ *             - the error code of Shadow_MatchTopicString() if the topic is not
+ *               a Shadow topic. The topic and payload in @p pPublishInfo are
+ *               still valid, so that the packet can be passed to other handlers.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * const uint8_t * pPacket; // A PUBLISH packet received from the network.
+ * uint32_t packetLength;
+ * ShadowPublishInfo_t publishInfo;
+ *
+ * if( Shadow_MatchPublishPacket( pPacket, packetLength,
+ *                                SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1,
+ *                                &publishInfo ) == SHADOW_SUCCESS )
+ * {
+ *      // The message type is publishInfo.match.messageType, and the payload
+ *      // is the publishInfo.payloadLength bytes at
+ *      // &( pPacket[ publishInfo.payloadOffset ] ).
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_matchpublishpacket] */
+ShadowStatus_t Shadow_MatchPublishPacket( const uint8_t * pPacket,
+                                          uint32_t packetLength,
+                                          uint8_t protocolLevel,
+                                          ShadowPublishInfo_t * pPublishInfo );
+/* @[declare_shadow_matchpublishpacket] */
+
+/**
+ * @brief Initialize a topic alias table with application-provided entries.
+ *
+ * The broker uses topic aliases up to the Topic Alias Maximum that the client
+ * sends in its CONNECT packet. Provide one entry per topic alias.
+ *
+ * @param[out] pAliasTable The table to initialize.
+ * @param[in]  pEntries Array of @p entryCount entries for the table to use. The
+ *             array must remain valid for as long as the table is used.
+ * @param[in]  entryCount Number of entries in @p pEntries, the Topic Alias Maximum.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the table was initialized;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL or entryCount is zero.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * static ShadowMatchResult_t aliasEntries[ 16 ];
+ * static ShadowTopicAliasTable_t aliasTable;
+ * ShadowStatus_t shadowStatus;
+ *
+ * shadowStatus = Shadow_TopicAliasInit( &aliasTable, aliasEntries, 16U );
+ *
+ * @endcode
+ */
+/* @[declare_shadow_topicaliasinit] */
+ShadowStatus_t Shadow_TopicAliasInit( ShadowTopicAliasTable_t * pAliasTable,
+                                      ShadowMatchResult_t * pEntries,
+                                      uint16_t entryCount );
+/* @[declare_shadow_topicaliasinit] */
+
+/**
+ * @brief Forget every topic alias of a topic alias table.
+ *
+ * Topic aliases only last for one network connection, so call this function
+ * whenever the MQTT connection is established again.
+ *
+ * @param[in]  pAliasTable The table.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the table was reset;
+ *             - #SHADOW_BAD_PARAMETER if the table is NULL or not initialized.
+ */
+/* @[declare_shadow_topicaliasreset] */
+ShadowStatus_t Shadow_TopicAliasReset( ShadowTopicAliasTable_t * pAliasTable );
+/* @[declare_shadow_topicaliasreset] */
+
+/**
+ * @brief Match the topic of a message with a topic alias.
+ *
+ * If the message has a topic, the topic is matched, and the result is kept
+ * for the topic alias. If the message has an empty topic, the result kept for
+ * the topic alias is returned with a single array lookup.
+ *
+ * @note The name offsets in the result are relative to the first character of
+ *       the topic that set the topic alias. The MQTT client keeps that topic to
+ *       deliver messages that only carry the topic alias.
+ *
+ * @param[in]  pAliasTable The table.
+ * @param[in]  topicAlias The topic alias of the message, from 1 to the entry
+ *             count of the table.
+ * @param[in]  pTopic The topic of the message. May be NULL if topicLength is zero.
+ * @param[in]  topicLength Length of the topic. Zero if the message only has
+ *             a topic alias.
+ * @param[out] pResult Pointer to caller-supplied memory for returning the
+ *             result of the match.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic is a Shadow topic;
+ *             - #SHADOW_NOT_FOUND if the topic is empty and the topic alias
+ *               has not been set;
+ *             - #SHADOW_BAD_PARAMETER if a parameter is invalid;
+ *             - the error code of Shadow_MatchTopicString() if the topic is not
+ *               a Shadow topic.
+ */
+/* @[declare_shadow_topicaliasmatch] */
+ShadowStatus_t Shadow_TopicAliasMatch( ShadowTopicAliasTable_t * pAliasTable,
+                                       uint16_t topicAlias,
+                                       const char * pTopic,
+                                       uint16_t topicLength,
+                                       ShadowMatchResult_t * pResult );
+/* @[declare_shadow_topicaliasmatch] */
+
+/**
+ * @brief Find the topic and payload of a received MQTT 5 PUBLISH packet, and
+ * match its topic, using the packet's topic alias.
+ *
+ * Works as Shadow_MatchPublishPacket() for #SHADOW_MQTT_PROTOCOL_LEVEL_5. If
+ * the packet has a Topic Alias property, the topic is matched with
+ * Shadow_TopicAliasMatch(), so a packet with an empty topic is matched from
+ * the result kept for its topic alias.
+ *
+ * @param[in]  pPacket The packet, starting with the first byte of its fixed header.
+ * @param[in]  packetLength Number of bytes available at pPacket.
+ * @param[in]  pAliasTable The topic alias table of the connection.
+ * @param[out] pPublishInfo Pointer to caller-supplied memory for returning the
+ *             topic, payload and match result.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic is a Shadow topic;
+ *             - #SHADOW_NOT_FOUND if the topic is empty and its topic alias
+ *               has not been set;
+ *             - #SHADOW_BAD_PARAMETER if a parameter is invalid, or the packet
+ *               is not a well-formed PUBLISH packet that fits in packetLength;
+ *             - the error code of Shadow_MatchTopicString() if the topic is not
+ *               a Shadow topic.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * const uint8_t * pPacket; // A PUBLISH packet received from the network.
+ * uint32_t packetLength;
+ * ShadowPublishInfo_t publishInfo;
+ *
+ * // aliasTable was initialized with Shadow_TopicAliasInit().
+ * if( Shadow_MatchPublishPacketAlias( pPacket, packetLength,
+ *                                     &aliasTable, &publishInfo ) == SHADOW_SUCCESS )
+ * {
+ *      // The message type is publishInfo.match.messageType.
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_matchpublishpacketalias] */
+ShadowStatus_t Shadow_MatchPublishPacketAlias( const uint8_t * pPacket,
+                                               uint32_t packetLength,
+                                               ShadowTopicAliasTable_t * pAliasTable,
+                                               ShadowPublishInfo_t * pPublishInfo );
+/* @[declare_shadow_matchpublishpacketalias] */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* ifndef SHADOW_MQTT_H_ */
@@ -0,0 +1,471 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file shadow_payload.h
+ * @brief User-facing functions of the Shadow payload parser and writer, which
+ * read and write the JSON documents of shadow messages in place.
+ */
+
+#ifndef SHADOW_PAYLOAD_H_
+#define SHADOW_PAYLOAD_H_
+
+/* Standard includes. */
+#include <stdbool.h>
+
+/* Shadow includes. */
+#include "shadow.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/*------------------------ Shadow payload types -------------------------*/
+
+/**
+ * @ingroup shadow_enum_types
+ * @brief The part of an update/delta document that a #ShadowDeltaToken_t
+ * describes.
+ */
+typedef enum ShadowDeltaField
+{
+    ShadowDeltaFieldKey = 0,    /**< @brief A changed key in "state", and its value. */
+    ShadowDeltaFieldState,      /**< @brief The whole "state" object, after all of its changed keys. */
+    ShadowDeltaFieldVersion,    /**< @brief The "version" number. */
+    ShadowDeltaFieldTimestamp,  /**< @brief The "timestamp" number. */
+    ShadowDeltaFieldClientToken /**< @brief The "clientToken" string. */
+} ShadowDeltaField_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief The position of a part of a JSON document in the payload that holds it.
+ */
+typedef struct ShadowPayloadView
+{
+    uint32_t offset; /**< @brief Offset of the first character in the payload. */
+    uint32_t length; /**< @brief Number of characters. */
+} ShadowPayloadView_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief One part of an update/delta document returned by Shadow_DeltaParserNext().
+ *
+ * The value of a string is returned without its quotes, and with its escape
+ * sequences as they are in the payload. Numbers, true, false, null, arrays and
+ * objects are returned as they are in the payload.
+ */
+typedef struct ShadowDeltaToken
+{
+    ShadowDeltaField_t field;          /**< @brief The part of the document. */
+    ShadowPayloadView_t value;         /**< @brief The value. */
+    const ShadowPayloadView_t * pKeys; /**< @brief For #ShadowDeltaFieldKey, the key path: the key in "state", then the key in each nested object. Valid until the next call to Shadow_DeltaParserNext(). */
+    uint8_t keyCount;                  /**< @brief Number of keys in pKeys. Zero for the other fields. */
+} ShadowDeltaToken_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief The state of a parser of an update/delta document.
+ *
+ * Initialize with Shadow_DeltaParserInit(). The application should not access
+ * the members directly.
+ */
+typedef struct ShadowDeltaParser
+{
+    const char * pPayload;                           /**< @brief The document. */
+    uint32_t payloadLength;                          /**< @brief Length of the document. */
+    uint32_t index;                                  /**< @brief Offset of the next character to read. */
+    uint32_t stateOffset;                            /**< @brief Offset of the "state" object. */
+    ShadowPayloadView_t keys[ SHADOW_DELTA_DEPTH_MAX ]; /**< @brief The key of each object being read in "state". */
+    uint8_t depth;                                   /**< @brief Zero at the top level of the document, or the number of objects being read in "state". */
+    uint8_t phase;                                   /**< @brief What the parser expects next. */
+} ShadowDeltaParser_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief The state of a writer of an update document.
+ *
+ * Initialize with Shadow_DocumentWriterInit(). The application should not
+ * access the members directly.
+ */
+typedef struct ShadowDocumentWriter
+{
+    char * pBuffer;        /**< @brief The buffer the document is written to, or NULL to only compute its length. */
+    uint32_t bufferSize;   /**< @brief Size of the buffer. */
+    uint32_t length;       /**< @brief Length of the document so far, including any part that did not fit in the buffer. */
+    ShadowStatus_t status; /**< @brief The first error, or #SHADOW_SUCCESS. */
+    uint8_t depth;         /**< @brief Number of objects opened with Shadow_DocumentBeginObject() and not yet closed. */
+    bool needComma;        /**< @brief Whether a ',' must be written before the next member. */
+} ShadowDocumentWriter_t;
+
+/**
+ * @ingroup shadow_constants
+ * @brief The maximum number of decimals of a number written with
+ * Shadow_DocumentAppendFloat().
+ */
+#define SHADOW_DOCUMENT_DECIMALS_MAX    ( 6U )
+
+/*---------------------- Shadow payload functions -----------------------*/
+
+/**
+ * @brief Initialize a parser of the JSON document of an update/delta message.
+ *
+ * The parser reads the document in place, in one pass, and does not copy
+ * it or allocate memory. The document must stay in the payload buffer until
+ * the parser is no longer used.
+ *
+ * @param[out] pParser The parser to initialize.
+ * @param[in]  pPayload The payload of the update/delta message. Does not have
+ *             to be null-terminated.
+ * @param[in]  payloadLength Length of the payload.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the parser is initialized;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL or payloadLength is zero.
+ */
+/* @[declare_shadow_deltaparserinit] */
+ShadowStatus_t Shadow_DeltaParserInit( ShadowDeltaParser_t * pParser,
+                                       const char * pPayload,
+                                       uint32_t payloadLength );
+/* @[declare_shadow_deltaparserinit] */
+
+/**
+ * @brief Read the next part of an update/delta document.
+ *
+ * Returns the "version", "timestamp" and "clientToken" members of the
+ * document, and each changed key in its "state", in the order they appear in
+ * the document. A key whose value is an object is not returned itself: the
+ * keys of the object are returned instead, with a longer key path. After the
+ * keys of "state", the whole "state" object is returned. Other members, such
+ * as "metadata", are skipped.
+ *
+ * Values that are skipped or returned as a whole, such as arrays, are only
+ * checked for balanced brackets and terminated strings.
+ *
+ * @param[in]  pParser The parser, initialized with Shadow_DeltaParserInit().
+ * @param[out] pToken Pointer to caller-supplied memory for returning the part
+ *             of the document.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if a part of the document is returned;
+ *             - #SHADOW_NOT_FOUND if the end of the document has been reached;
+ *             - #SHADOW_PAYLOAD_PARSE_FAILED if the payload is not a JSON object.
+ *               The parser returns it again on every later call;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * const char * pPayload; // The payload of an update/delta message.
+ * uint32_t payloadLength;
+ * ShadowDeltaParser_t parser;
+ * ShadowDeltaToken_t token;
+ *
+ * ( void ) Shadow_DeltaParserInit( &parser, pPayload, payloadLength );
+ *
+ * while( Shadow_DeltaParserNext( &parser, &token ) == SHADOW_SUCCESS )
+ * {
+ *      if( ( token.field == ShadowDeltaFieldKey ) && ( token.keyCount == 1U ) &&
+ *          ( token.pKeys[ 0 ].length == 5U ) &&
+ *          ( strncmp( &( pPayload[ token.pKeys[ 0 ].offset ] ), "color", 5U ) == 0 ) )
+ *      {
+ *          // The new color is at &( pPayload[ token.value.offset ] ).
+ *      }
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_deltaparsernext] */
+ShadowStatus_t Shadow_DeltaParserNext( ShadowDeltaParser_t * pParser,
+                                       ShadowDeltaToken_t * pToken );
+/* @[declare_shadow_deltaparsernext] */
+
+/**
+ * @brief Read the version number of a shadow document, without parsing the
+ * rest of the document.
+ *
+ * Finds the "version" member of an accepted or update/delta document, or the
+ * "version" member of the "current" object of an update/documents document.
+ * Other members are skipped as a whole, without being descended into, so a
+ * "version" key in the state of the document is not mistaken for the version
+ * of the document. The document is not read past the version number.
+ *
+ * @param[in]  pPayload The payload of the shadow message. Does not have to be
+ *             null-terminated.
+ * @param[in]  payloadLength Length of the payload.
+ * @param[out] pVersion Pointer to caller-supplied memory for returning the
+ *             version number.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the version number is returned;
+ *             - #SHADOW_NOT_FOUND if the document has no version number;
+ *             - #SHADOW_PAYLOAD_PARSE_FAILED if the payload is not a JSON
+ *               object, or the version is not an integer from 0 to 4294967295;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL or payloadLength is zero.
+ */
+/* @[declare_shadow_payloadgetversion] */
+ShadowStatus_t Shadow_PayloadGetVersion( const char * pPayload,
+                                         uint32_t payloadLength,
+                                         uint32_t * pVersion );
+/* @[declare_shadow_payloadgetversion] */
+
+/**
+ * @brief Read the client token of a shadow document, without parsing the rest
+ * of the document.
+ *
+ * Finds the "clientToken" member at the top level of an accepted, rejected or
+ * update/delta document. Objects such as "state" are skipped as a whole, and
+ * the document is not read past the client token.
+ *
+ * @param[in]  pPayload The payload of the shadow message. Does not have to be
+ *             null-terminated.
+ * @param[in]  payloadLength Length of the payload.
+ * @param[out] pClientToken Pointer to caller-supplied memory for returning the
+ *             position of the client token in the payload, without its quotes.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the client token is returned;
+ *             - #SHADOW_NOT_FOUND if the document has no client token;
+ *             - #SHADOW_PAYLOAD_PARSE_FAILED if the payload is not a JSON object;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL or payloadLength is zero.
+ */
+/* @[declare_shadow_payloadgetclienttoken] */
+ShadowStatus_t Shadow_PayloadGetClientToken( const char * pPayload,
+                                             uint32_t payloadLength,
+                                             ShadowPayloadView_t * pClientToken );
+/* @[declare_shadow_payloadgetclienttoken] */
+
+/**
+ * @brief Start writing the JSON document of an update message that reports
+ * the state of a device.
+ *
+ * Writes the start of `{"state":{"reported":{...}},"clientToken":"..."}`.
+ * The members of the reported state are then added with the
+ * Shadow_DocumentAppend functions and Shadow_DocumentBeginObject(), and the
+ * document is ended with Shadow_DocumentWriterFinish(). The document is
+ * written without printf() or memory allocation, and is not null-terminated.
+ *
+ * With a NULL buffer, nothing is written, and Shadow_DocumentWriterFinish()
+ * returns the exact length of the document. This can be used to size the
+ * buffer before writing the same document again.
+ *
+ * When the document does not fit in the buffer, the writer stops writing to
+ * the buffer, and Shadow_DocumentWriterFinish() returns
+ * #SHADOW_BUFFER_TOO_SMALL with the length the document needs.
+ *
+ * @param[out] pWriter The writer to initialize.
+ * @param[in]  pBuffer The buffer to write the document to, or NULL to only
+ *             compute the length of the document.
+ * @param[in]  bufferSize Size of the buffer. Must be zero if pBuffer is NULL.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the writer is initialized;
+ *             - #SHADOW_BUFFER_TOO_SMALL if the start of the document does
+ *               not fit in the buffer;
+ *             - #SHADOW_BAD_PARAMETER if pWriter is NULL, or pBuffer is NULL
+ *               and bufferSize is not zero.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * char buffer[ 128 ];
+ * ShadowDocumentWriter_t writer;
+ * uint32_t documentLength = 0;
+ * ShadowStatus_t shadowStatus;
+ *
+ * ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+ * ( void ) Shadow_DocumentAppendBool( &writer, "on", 2, true );
+ * ( void ) Shadow_DocumentBeginObject( &writer, "sensor", 6 );
+ * ( void ) Shadow_DocumentAppendFloat( &writer, "temperature", 11, 21.5f, 1 );
+ * ( void ) Shadow_DocumentEndObject( &writer );
+ * shadowStatus = Shadow_DocumentWriterFinish( &writer, "token-1", 7, &documentLength );
+ *
+ * if( shadowStatus == SHADOW_SUCCESS )
+ * {
+ *      // buffer holds the first documentLength characters of
+ *      // {"state":{"reported":{"on":true,"sensor":{"temperature":21.5}}},"clientToken":"token-1"}
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_documentwriterinit] */
+ShadowStatus_t Shadow_DocumentWriterInit( ShadowDocumentWriter_t * pWriter,
+                                          char * pBuffer,
+                                          uint32_t bufferSize );
+/* @[declare_shadow_documentwriterinit] */
+
+/**
+ * @brief Add an integer member to the object being written.
+ *
+ * A writer that has failed with an error other than #SHADOW_BUFFER_TOO_SMALL
+ * does not add any more members, so the status of a whole document can be
+ * checked once, with Shadow_DocumentWriterFinish().
+ *
+ * @param[in] pWriter The writer.
+ * @param[in] pKey The key of the member. Quotes, backslashes and control
+ *            characters in it are escaped.
+ * @param[in] keyLength Length of the key.
+ * @param[in] value The value of the member.
+ *
+ * @return #SHADOW_SUCCESS, #SHADOW_BUFFER_TOO_SMALL or the first error of
+ * the writer; #SHADOW_BAD_PARAMETER if a pointer is NULL or keyLength is zero.
+ */
+/* @[declare_shadow_documentappendint] */
+ShadowStatus_t Shadow_DocumentAppendInt( ShadowDocumentWriter_t * pWriter,
+                                         const char * pKey,
+                                         uint16_t keyLength,
+                                         int32_t value );
+/* @[declare_shadow_documentappendint] */
+
+/**
+ * @brief Add a true or false member to the object being written.
+ *
+ * @param[in] pWriter The writer.
+ * @param[in] pKey The key of the member.
+ * @param[in] keyLength Length of the key.
+ * @param[in] value The value of the member.
+ *
+ * @return See Shadow_DocumentAppendInt().
+ */
+/* @[declare_shadow_documentappendbool] */
+ShadowStatus_t Shadow_DocumentAppendBool( ShadowDocumentWriter_t * pWriter,
+                                          const char * pKey,
+                                          uint16_t keyLength,
+                                          bool value );
+/* @[declare_shadow_documentappendbool] */
+
+/**
+ * @brief Add a number member with a fixed number of decimals to the object
+ * being written.
+ *
+ * The number is rounded to the given number of decimals, and written without
+ * an exponent, for example `-21.50`.
+ *
+ * @param[in] pWriter The writer.
+ * @param[in] pKey The key of the member.
+ * @param[in] keyLength Length of the key.
+ * @param[in] value The value of the member. Its magnitude must be less than
+ *            4294967296, and it must not be NaN. The value is rounded in
+ *            single precision.
+ * @param[in] decimals The number of decimals, up to
+ *            #SHADOW_DOCUMENT_DECIMALS_MAX.
+ *
+ * @return See Shadow_DocumentAppendInt(). #SHADOW_BAD_PARAMETER is also
+ * returned if value or decimals is out of range.
+ */
+/* @[declare_shadow_documentappendfloat] */
+ShadowStatus_t Shadow_DocumentAppendFloat( ShadowDocumentWriter_t * pWriter,
+                                           const char * pKey,
+                                           uint16_t keyLength,
+                                           float value,
+                                           uint8_t decimals );
+/* @[declare_shadow_documentappendfloat] */
+
+/**
+ * @brief Add a string member to the object being written.
+ *
+ * @param[in] pWriter The writer.
+ * @param[in] pKey The key of the member.
+ * @param[in] keyLength Length of the key.
+ * @param[in] pValue The value of the member. Quotes, backslashes and control
+ *            characters in it are escaped. May be NULL if valueLength is zero.
+ * @param[in] valueLength Length of the value.
+ *
+ * @return See Shadow_DocumentAppendInt().
+ */
+/* @[declare_shadow_documentappendstring] */
+ShadowStatus_t Shadow_DocumentAppendString( ShadowDocumentWriter_t * pWriter,
+                                            const char * pKey,
+                                            uint16_t keyLength,
+                                            const char * pValue,
+                                            uint32_t valueLength );
+/* @[declare_shadow_documentappendstring] */
+
+/**
+ * @brief Add an object member to the object being written, and start
+ * writing its members.
+ *
+ * @param[in] pWriter The writer.
+ * @param[in] pKey The key of the member.
+ * @param[in] keyLength Length of the key.
+ *
+ * @return See Shadow_DocumentAppendInt(). #SHADOW_BAD_PARAMETER is also
+ * returned if 255 objects are already open.
+ */
+/* @[declare_shadow_documentbeginobject] */
+ShadowStatus_t Shadow_DocumentBeginObject( ShadowDocumentWriter_t * pWriter,
+                                           const char * pKey,
+                                           uint16_t keyLength );
+/* @[declare_shadow_documentbeginobject] */
+
+/**
+ * @brief End the object started by the last call to
+ * Shadow_DocumentBeginObject() that has not been ended.
+ *
+ * @param[in] pWriter The writer.
+ *
+ * @return See Shadow_DocumentAppendInt(). #SHADOW_BAD_PARAMETER is also
+ * returned if no object is open.
+ */
+/* @[declare_shadow_documentendobject] */
+ShadowStatus_t Shadow_DocumentEndObject( ShadowDocumentWriter_t * pWriter );
+/* @[declare_shadow_documentendobject] */
+
+/**
+ * @brief End the document, with an optional client token.
+ *
+ * @param[in]  pWriter The writer.
+ * @param[in]  pClientToken The client token, or NULL to write the document
+ *             without one.
+ * @param[in]  clientTokenLength Length of the client token.
+ * @param[out] pDocumentLength The length of the document, when it is
+ *             written or does not fit in the buffer.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the document is written, or its length
+ *               is computed;
+ *             - #SHADOW_BUFFER_TOO_SMALL if the document does not fit in the
+ *               buffer. *pDocumentLength is the size the buffer needs;
+ *             - #SHADOW_BAD_PARAMETER if pWriter or pDocumentLength is NULL,
+ *               an object is still open, or the writer failed earlier with
+ *               this error;
+ *             - #SHADOW_FAIL if the document is longer than 4294967295 characters.
+ */
+/* @[declare_shadow_documentwriterfinish] */
+ShadowStatus_t Shadow_DocumentWriterFinish( ShadowDocumentWriter_t * pWriter,
+                                            const char * pClientToken,
+                                            uint16_t clientTokenLength,
+                                            uint32_t * pDocumentLength );
+/* @[declare_shadow_documentwriterfinish] */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* ifndef SHADOW_PAYLOAD_H_ */
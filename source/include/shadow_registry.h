@@ -0,0 +1,217 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file shadow_registry.h
+ * @brief User-facing functions of the Shadow registry, which maps incoming
+ * topic strings to registered Thing and Shadow names.
+ */
+
+#ifndef SHADOW_REGISTRY_H_
+#define SHADOW_REGISTRY_H_
+
+/* Shadow includes. */
+#include "shadow.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/*------------------------ Shadow registry types -------------------------*/
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief One slot of the hash index of a #ShadowRegistry_t.
+ *
+ * The slots are provided by the application and managed by the registry. The
+ * application should not access the members directly.
+ */
+typedef struct ShadowRegistrySlot
+{
+    const char * pThingName;  /**< @brief Thing name, or NULL if the slot is empty. */
+    const char * pShadowName; /**< @brief Shadow name. Not used for a Classic shadow. */
+    uint32_t hash;            /**< @brief #ShadowTopicHash_t.keyHash of the Thing and Shadow names. */
+    uint8_t thingNameLength;  /**< @brief Length of the Thing name. */
+    uint8_t shadowNameLength; /**< @brief Length of the Shadow name. Zero for a Classic shadow. */
+} ShadowRegistrySlot_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief A table of registered Thing and Shadow name pairs, indexed by an
+ * open-addressing hash table held in application-provided memory.
+ *
+ * Initialize with Shadow_RegistryInit(). The application should not access the
+ * members directly.
+ */
+typedef struct ShadowRegistry
+{
+    ShadowRegistrySlot_t * pSlots; /**< @brief Application-provided slots. */
+    uint32_t slotCount;            /**< @brief Number of slots. A power of two. */
+    uint32_t entryCount;           /**< @brief Number of registered pairs. */
+} ShadowRegistry_t;
+
+/*---------------------- Shadow registry functions -----------------------*/
+
+/**
+ * @brief Initialize a Shadow registry with application-provided slots.
+ *
+ * The registry holds at most @p slotCount Thing and Shadow name pairs. Lookups
+ * take a constant number of steps on average while fewer than three quarters
+ * of the slots are used, so allocate about twice as many slots as pairs to
+ * register.
+ *
+ * @param[out] pRegistry The registry to initialize.
+ * @param[in]  pSlots Array of @p slotCount slots for the registry to use. The
+ *             array must remain valid for as long as the registry is used.
+ * @param[in]  slotCount Number of slots in @p pSlots. Must be a power of two.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the registry was initialized;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, or slotCount is
+ *               not a power of two.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * static ShadowRegistrySlot_t slots[ 256 ];
+ * static ShadowRegistry_t registry;
+ * ShadowStatus_t shadowStatus;
+ *
+ * shadowStatus = Shadow_RegistryInit( &registry, slots, 256U );
+ *
+ * @endcode
+ */
+/* @[declare_shadow_registryinit] */
+ShadowStatus_t Shadow_RegistryInit( ShadowRegistry_t * pRegistry,
+                                    ShadowRegistrySlot_t * pSlots,
+                                    uint32_t slotCount );
+/* @[declare_shadow_registryinit] */
+
+/**
+ * @brief Register a Thing and Shadow name pair, and return its handle.
+ *
+ * The registry keeps pointers to the names, not copies of them, so the names
+ * must remain valid for as long as the registry is used. Registering a pair
+ * that is already registered returns its existing handle.
+ *
+ * @param[in]  pRegistry The registry.
+ * @param[in]  pThingName Thing name. Does not have to be null-terminated.
+ * @param[in]  thingNameLength Length of the Thing name.
+ * @param[in]  pShadowName Shadow name, or #SHADOW_NAME_CLASSIC for a Classic shadow.
+ *             Does not have to be null-terminated. May be NULL if
+ *             @p shadowNameLength is zero.
+ * @param[in]  shadowNameLength Length of the Shadow name. Zero for a Classic shadow.
+ * @param[out] pHandle Pointer to caller-supplied memory for returning the
+ *             handle of the pair. Handles are less than the slot count.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the pair is registered;
+ *             - #SHADOW_BUFFER_TOO_SMALL if every slot is used;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, the Thing name length
+ *               is zero, or a name is longer than #SHADOW_THINGNAME_LENGTH_MAX
+ *               or #SHADOW_NAME_LENGTH_MAX.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * uint32_t handle;
+ * ShadowStatus_t shadowStatus;
+ *
+ * shadowStatus = Shadow_RegistryAdd( &registry,
+ *                                    "myThing", 7U,
+ *                                    "myShadow", 8U,
+ *                                    &handle );
+ *
+ * if( shadowStatus == SHADOW_SUCCESS )
+ * {
+ *      // Keep the context of myThing/myShadow at index handle.
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_registryadd] */
+ShadowStatus_t Shadow_RegistryAdd( ShadowRegistry_t * pRegistry,
+                                   const char * pThingName,
+                                   uint8_t thingNameLength,
+                                   const char * pShadowName,
+                                   uint8_t shadowNameLength,
+                                   uint32_t * pHandle );
+/* @[declare_shadow_registryadd] */
+
+/**
+ * @brief Match an incoming topic string, and return the handle of its Thing and
+ * Shadow name pair along with the type of the Shadow message.
+ *
+ * @param[in]  pRegistry The registry.
+ * @param[in]  pTopic Pointer to the MQTT topic string. Does not have to be null-terminated.
+ * @param[in]  topicLength Length of the MQTT topic string.
+ * @param[out] pHandle Pointer to caller-supplied memory for returning the
+ *             handle of the pair.
+ * @param[out] pMessageType Pointer to caller-supplied memory for returning the
+ *             type of the Shadow message.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic is a Shadow topic of a registered pair;
+ *             - #SHADOW_NOT_FOUND if the topic is a Shadow topic, but its Thing and
+ *               Shadow names are not registered;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL or topicLength is zero;
+ *             - The error code returned by Shadow_MatchTopicString() if the topic
+ *               is not a Shadow topic.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * char * pTopicName; //usually supplied by MQTT stack
+ * uint16_t topicNameLength; //usually supplied by MQTT stack
+ * uint32_t handle;
+ * ShadowMessageType_t messageType;
+ *
+ * if( Shadow_RegistryMatchTopic( &registry, pTopicName, topicNameLength,
+ *                                &handle, &messageType ) == SHADOW_SUCCESS )
+ * {
+ *      // Pass the message to the context at index handle.
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_registrymatchtopic] */
+ShadowStatus_t Shadow_RegistryMatchTopic( const ShadowRegistry_t * pRegistry,
+                                          const char * pTopic,
+                                          uint16_t topicLength,
+                                          uint32_t * pHandle,
+                                          ShadowMessageType_t * pMessageType );
+/* @[declare_shadow_registrymatchtopic] */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* ifndef SHADOW_REGISTRY_H_ */
@@ -0,0 +1,281 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file shadow_request.h
+ * @brief User-facing functions of the Shadow request table, which generates
+ * the client tokens of get, update and delete requests and dispatches their
+ * responses.
+ */
+
+#ifndef SHADOW_REQUEST_H_
+#define SHADOW_REQUEST_H_
+
+/* Shadow includes. */
+#include "shadow.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/*------------------------ Shadow request types -------------------------*/
+
+/**
+ * @ingroup shadow_constants
+ * @brief Number of hexadecimal digits that follow the prefix in a client
+ * token generated by Shadow_RequestStart().
+ *
+ * The first four digits are the slot of the request in the table, and the
+ * last four are the number of times the slot has been used.
+ */
+#define SHADOW_REQUEST_TOKEN_DIGITS        ( 8U )
+
+/**
+ * @ingroup shadow_constants
+ * @brief The maximum length of the prefix of the client tokens of a
+ * #ShadowRequestTable_t.
+ *
+ * The AWS IoT Device Shadow service accepts client tokens of up to 64 bytes.
+ */
+#define SHADOW_REQUEST_PREFIX_LENGTH_MAX    ( 64U - SHADOW_REQUEST_TOKEN_DIGITS )
+
+/**
+ * @ingroup shadow_constants
+ * @brief The maximum number of slots of a #ShadowRequestTable_t.
+ */
+#define SHADOW_REQUEST_SLOT_COUNT_MAX       ( 0xFFFFU )
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief Function called with the response to a request.
+ *
+ * @param[in] pContext The context given to Shadow_RequestStart().
+ * @param[in] messageType The type of the response: the accepted or rejected
+ *            message of the operation of the request.
+ * @param[in] pPayload The payload of the response.
+ * @param[in] payloadLength Length of the payload.
+ */
+typedef void ( * ShadowRequestCallback_t )( void * pContext,
+                                            ShadowMessageType_t messageType,
+                                            const char * pPayload,
+                                            uint32_t payloadLength );
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief A slot of a #ShadowRequestTable_t, held in application-provided
+ * memory.
+ *
+ * The application should not access the members directly.
+ */
+typedef struct ShadowRequestSlot
+{
+    ShadowRequestCallback_t callback; /**< @brief The function to call with the response, or NULL if the slot is free. */
+    void * pContext;                  /**< @brief The context to call the function with. */
+    uint16_t generation;              /**< @brief Number of times the slot has been used, in the client token. */
+    uint16_t nextFree;                /**< @brief If the slot is free, the index of the next free slot, or #SHADOW_REQUEST_SLOT_COUNT_MAX. */
+    uint8_t operation;                /**< @brief The #ShadowTopicStringType_t of the request. */
+} ShadowRequestSlot_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief A table of the get, update and delete requests waiting for a
+ * response, indexed by the client tokens it generates.
+ *
+ * Initialize with Shadow_RequestTableInit(). The application should not
+ * access the members directly, except to read pendingCount.
+ */
+typedef struct ShadowRequestTable
+{
+    ShadowRequestSlot_t * pSlots; /**< @brief Application-provided slots. */
+    const char * pPrefix;         /**< @brief The prefix of the client tokens. */
+    uint16_t slotCount;           /**< @brief Number of slots. */
+    uint16_t firstFree;           /**< @brief Index of the first free slot, or #SHADOW_REQUEST_SLOT_COUNT_MAX if all are used. */
+    uint16_t pendingCount;        /**< @brief Number of requests waiting for a response. */
+    uint8_t prefixLength;         /**< @brief Length of the prefix. */
+} ShadowRequestTable_t;
+
+/*---------------------- Shadow request functions -----------------------*/
+
+/**
+ * @brief Initialize a request table with application-provided slots.
+ *
+ * The client tokens generated by the table are the prefix followed by
+ * #SHADOW_REQUEST_TOKEN_DIGITS hexadecimal digits. The accepted and rejected
+ * topics of a shadow are shared by all of its clients, so a prefix unique to
+ * the client, such as its MQTT client identifier, keeps the responses to the
+ * requests of other clients from matching a request of the table.
+ *
+ * @param[out] pTable The table to initialize.
+ * @param[in]  pSlots Array of @p slotCount slots for the table to use. The
+ *             array must remain valid for as long as the table is used.
+ * @param[in]  slotCount Number of slots, the maximum number of requests
+ *             waiting for a response. Less than #SHADOW_REQUEST_SLOT_COUNT_MAX.
+ * @param[in]  pPrefix The prefix of the client tokens. Must remain valid for
+ *             as long as the table is used. May be NULL if prefixLength is zero.
+ * @param[in]  prefixLength Length of the prefix, at most
+ *             #SHADOW_REQUEST_PREFIX_LENGTH_MAX.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the table was initialized;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, or a count or
+ *               length is out of range.
+ */
+/* @[declare_shadow_requesttableinit] */
+ShadowStatus_t Shadow_RequestTableInit( ShadowRequestTable_t * pTable,
+                                        ShadowRequestSlot_t * pSlots,
+                                        uint16_t slotCount,
+                                        const char * pPrefix,
+                                        uint8_t prefixLength );
+/* @[declare_shadow_requesttableinit] */
+
+/**
+ * @brief Add a request to the table, and generate its client token.
+ *
+ * The client token is to be sent in the "clientToken" member of the request
+ * document, such as with Shadow_DocumentWriterFinish() for an update request.
+ * Its slot is found and freed in constant time, and reused for a later request
+ * with another client token, so a late response to a cancelled request does
+ * not match the later request.
+ *
+ * @param[in]  pTable The table.
+ * @param[in]  operation The operation of the request:
+ *             #ShadowTopicStringTypeGet, #ShadowTopicStringTypeUpdate or
+ *             #ShadowTopicStringTypeDelete.
+ * @param[in]  callback The function to call with the response.
+ * @param[in]  pContext The context to call the function with. May be NULL.
+ * @param[out] pClientToken Buffer for the client token. It is not
+ *             null-terminated.
+ * @param[in]  bufferSize Size of the buffer. The client token is the length
+ *             of the prefix plus #SHADOW_REQUEST_TOKEN_DIGITS long.
+ * @param[out] pClientTokenLength Pointer to caller-supplied memory for
+ *             returning the length of the client token.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the request is added;
+ *             - #SHADOW_BUFFER_TOO_SMALL if all slots are used, or the client
+ *               token does not fit in the buffer;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, or the operation
+ *               is not a request.
+ */
+/* @[declare_shadow_requeststart] */
+ShadowStatus_t Shadow_RequestStart( ShadowRequestTable_t * pTable,
+                                    ShadowTopicStringType_t operation,
+                                    ShadowRequestCallback_t callback,
+                                    void * pContext,
+                                    char * pClientToken,
+                                    uint8_t bufferSize,
+                                    uint8_t * pClientTokenLength );
+/* @[declare_shadow_requeststart] */
+
+/**
+ * @brief Pass the response to a request to the callback of the request, and
+ * remove the request from the table.
+ *
+ * The client token of the response is read with
+ * Shadow_PayloadGetClientToken(), and decoded into the slot of its request,
+ * without comparing it with the tokens of the other requests. The request is
+ * removed before its callback is called, so the callback can start another
+ * request.
+ *
+ * @param[in]  pTable The table.
+ * @param[in]  messageType The type of the response, as returned by
+ *             Shadow_MatchTopicString().
+ * @param[in]  pPayload The payload of the response. Does not have to be
+ *             null-terminated.
+ * @param[in]  payloadLength Length of the payload.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the callback of the request is called;
+ *             - #SHADOW_NOT_FOUND if the message is not the response to a
+ *               request of the table, such as an update/delta message, or
+ *               the response to a request of another client;
+ *             - #SHADOW_PAYLOAD_PARSE_FAILED if the payload is not a JSON object;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL or payloadLength is zero.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * static ShadowRequestSlot_t slots[ 8 ];
+ * static ShadowRequestTable_t requests;
+ * char clientToken[ 16 ];
+ * uint8_t clientTokenLength;
+ * ShadowMessageType_t messageType;
+ *
+ * // The prefix is the MQTT client identifier, "sensor01".
+ * ( void ) Shadow_RequestTableInit( &requests, slots, 8U, "sensor01", 8U );
+ *
+ * if( Shadow_RequestStart( &requests, ShadowTopicStringTypeUpdate,
+ *                          onUpdateResponse, &updateContext,
+ *                          clientToken, sizeof( clientToken ),
+ *                          &clientTokenLength ) == SHADOW_SUCCESS )
+ * {
+ *      // Write the update document with the client token, and publish it.
+ * }
+ *
+ * // For each incoming message on an accepted or rejected topic:
+ * if( Shadow_MatchTopicString( pTopicName, topicNameLength, &messageType,
+ *                              NULL, NULL, NULL, NULL ) == SHADOW_SUCCESS )
+ * {
+ *      ( void ) Shadow_RequestDispatch( &requests, messageType, pPayload, payloadLength );
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_requestdispatch] */
+ShadowStatus_t Shadow_RequestDispatch( ShadowRequestTable_t * pTable,
+                                       ShadowMessageType_t messageType,
+                                       const char * pPayload,
+                                       uint32_t payloadLength );
+/* @[declare_shadow_requestdispatch] */
+
+/**
+ * @brief Remove a request from the table without calling its callback, such
+ * as when no response has been received in time.
+ *
+ * @param[in]  pTable The table.
+ * @param[in]  pClientToken The client token of the request.
+ * @param[in]  clientTokenLength Length of the client token.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the request is removed;
+ *             - #SHADOW_NOT_FOUND if no request of the table has the client token;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL.
+ */
+/* @[declare_shadow_requestcancel] */
+ShadowStatus_t Shadow_RequestCancel( ShadowRequestTable_t * pTable,
+                                     const char * pClientToken,
+                                     uint8_t clientTokenLength );
+/* @[declare_shadow_requestcancel] */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* ifndef SHADOW_REQUEST_H_ */
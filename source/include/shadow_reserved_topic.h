@@ -0,0 +1,270 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/**
+ * @file shadow_reserved_topic.h
+ * @brief User-facing functions of the reserved topic engine, which matches
+ * "$aws/things/<thingName>/..." topics of the Shadow service and of other
+ * AWS IoT services with tables of their operations.
+ */
+
+#ifndef SHADOW_RESERVED_TOPIC_H_
+#define SHADOW_RESERVED_TOPIC_H_
+
+/* Shadow includes. */
+#include "shadow.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/*-------------------- Reserved topic engine constants ----------------------*/
+
+/**
+ * @brief Index of the built-in table of the Shadow service.
+ *
+ * The operations of the table are in the order of #ShadowMessageType_t, so the
+ * operation index of a match of this table is its Shadow message type.
+ */
+#define SHADOW_RESERVED_TABLE_SHADOW    ( 0U )
+
+/**
+ * @brief Flag of a #ShadowReservedOperation_t that directly follows the root
+ * of its table, as in "$aws/things/<thingName>/shadow/update".
+ */
+#define SHADOW_RESERVED_OP_UNNAMED      ( 1U )
+
+/**
+ * @brief Flag of a #ShadowReservedOperation_t that follows a name after the
+ * root of its table, as in "$aws/things/<thingName>/shadow/name/<shadowName>/update".
+ */
+#define SHADOW_RESERVED_OP_NAMED        ( 2U )
+
+/*---------------------- Reserved topic engine types ------------------------*/
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief An operation of a #ShadowReservedTable_t, which is the rest of the
+ * topic after the root, or after the name, such as "update/delta".
+ */
+typedef struct ShadowReservedOperation
+{
+    const char * pOperation;  /**< @brief Operation, without a leading or trailing '/'. */
+    uint16_t operationLength; /**< @brief Length of the operation. */
+    uint8_t flags;            /**< @brief #SHADOW_RESERVED_OP_UNNAMED, #SHADOW_RESERVED_OP_NAMED, or both. */
+} ShadowReservedOperation_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief The topics of one service under "$aws/things/<thingName>/".
+ *
+ * The topics of a table are "$aws/things/<thingName>/<root>/<operation>" for its
+ * unnamed operations, and "$aws/things/<thingName>/<root>/<keyword>/<name>/<operation>"
+ * for its named operations. When the keyword length is zero, the name directly
+ * follows the root, as the job ID does in Jobs topics.
+ */
+typedef struct ShadowReservedTable
+{
+    const char * pRoot;                           /**< @brief Root, such as "shadow" or "jobs". */
+    uint16_t rootLength;                          /**< @brief Length of the root. */
+    const char * pNameKeyword;                    /**< @brief Keyword before the name, such as "name". May be NULL if the keyword length is zero. */
+    uint16_t nameKeywordLength;                   /**< @brief Length of the keyword before the name. */
+    uint8_t nameLengthMax;                        /**< @brief Maximum length of a name. Zero if the table has no named operations. */
+    const ShadowReservedOperation_t * pOperations; /**< @brief Operations of the table. */
+    uint16_t operationCount;                      /**< @brief Number of operations. */
+} ShadowReservedTable_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief The tables of a reserved topic engine, held in application-provided
+ * memory.
+ *
+ * Initialize with Shadow_ReservedTopicInit(), which registers the table of the
+ * Shadow service. The application should not access the members directly.
+ */
+typedef struct ShadowReservedTopicEngine
+{
+    const ShadowReservedTable_t ** ppTables; /**< @brief Application-provided array of registered tables. */
+    uint16_t tableCount;                     /**< @brief Number of registered tables. */
+    uint16_t tableCountMax;                  /**< @brief Number of elements of the array of tables. */
+} ShadowReservedTopicEngine_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief Result of matching a topic with a reserved topic engine.
+ *
+ * The Thing name starts at offset #SHADOW_PREFIX_LENGTH of the topic.
+ */
+typedef struct ShadowReservedMatch
+{
+    uint16_t tableIndex;      /**< @brief Index of the table of the topic. */
+    uint16_t operationIndex;  /**< @brief Index of the operation in the table. */
+    uint8_t thingNameLength;  /**< @brief Length of the Thing name. */
+    uint16_t nameOffset;      /**< @brief Offset of the name in the topic string. Zero for an unnamed operation. */
+    uint8_t nameLength;       /**< @brief Length of the name. Zero for an unnamed operation. */
+} ShadowReservedMatch_t;
+
+/*-------------------- Reserved topic engine functions ----------------------*/
+
+/**
+ * @brief Initialize a reserved topic engine with an application-provided array
+ * of tables, and register the table of the Shadow service in it.
+ *
+ * @param[out] pEngine The engine to initialize.
+ * @param[in]  ppTables Array of @p tableCountMax table pointers for the engine
+ *             to use. The array must remain valid for as long as the engine is used.
+ * @param[in]  tableCountMax Number of elements of @p ppTables. At least one.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the engine was initialized;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL or tableCountMax is zero.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * static const ShadowReservedTable_t * tables[ 2 ];
+ * static ShadowReservedTopicEngine_t engine;
+ * ShadowStatus_t shadowStatus;
+ *
+ * shadowStatus = Shadow_ReservedTopicInit( &engine, tables, 2U );
+ *
+ * @endcode
+ */
+/* @[declare_shadow_reservedtopicinit] */
+ShadowStatus_t Shadow_ReservedTopicInit( ShadowReservedTopicEngine_t * pEngine,
+                                         const ShadowReservedTable_t ** ppTables,
+                                         uint16_t tableCountMax );
+/* @[declare_shadow_reservedtopicinit] */
+
+/**
+ * @brief Register the table of another service, and return its index.
+ *
+ * The engine keeps a pointer to the table, not a copy of it, so the table
+ * and its operations must remain valid for as long as the engine is used.
+ * Tables are tried in the order they are registered, and the root of a table
+ * should not be the root of a table registered before it.
+ *
+ * @param[in]  pEngine The engine.
+ * @param[in]  pTable The table to register.
+ * @param[out] pTableIndex Pointer to caller-supplied memory for returning the
+ *             index of the table.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the table is registered;
+ *             - #SHADOW_BUFFER_TOO_SMALL if the array of tables is full;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, or the root, the
+ *               keyword or the operations of the table are missing.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * static const ShadowReservedOperation_t jobsOperations[] =
+ * {
+ *      { "notify",                7U, SHADOW_RESERVED_OP_UNNAMED },
+ *      { "notify-next",          11U, SHADOW_RESERVED_OP_UNNAMED },
+ *      { "get/accepted",         12U, SHADOW_RESERVED_OP_UNNAMED | SHADOW_RESERVED_OP_NAMED },
+ *      { "update/accepted",      15U, SHADOW_RESERVED_OP_NAMED }
+ * };
+ * static const ShadowReservedTable_t jobsTable =
+ * {
+ *      "jobs", 4U, NULL, 0U, 64U, jobsOperations, 4U
+ * };
+ * uint16_t jobsTableIndex;
+ * ShadowStatus_t shadowStatus;
+ *
+ * shadowStatus = Shadow_ReservedTopicRegister( &engine, &jobsTable, &jobsTableIndex );
+ *
+ * @endcode
+ */
+/* @[declare_shadow_reservedtopicregister] */
+ShadowStatus_t Shadow_ReservedTopicRegister( ShadowReservedTopicEngine_t * pEngine,
+                                             const ShadowReservedTable_t * pTable,
+                                             uint16_t * pTableIndex );
+/* @[declare_shadow_reservedtopicregister] */
+
+/**
+ * @brief Match an incoming topic string with the tables of an engine.
+ *
+ * The "$aws/things/" prefix and the Thing name are parsed once, and the rest
+ * of the topic is matched with the table whose root it starts with. The table
+ * of the Shadow service accepts the Shadow topics that Shadow_MatchTopicString()
+ * accepts.
+ *
+ * @param[in]  pEngine The engine.
+ * @param[in]  pTopic Pointer to the MQTT topic string. Does not have to be null-terminated.
+ * @param[in]  topicLength Length of the MQTT topic string.
+ * @param[out] pMatch Pointer to caller-supplied memory for returning the table,
+ *             the operation and the names of the topic.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic is a topic of a registered table;
+ *             - #SHADOW_FAIL if the topic does not start with "$aws/things/";
+ *             - #SHADOW_THINGNAME_PARSE_FAILED if the Thing name is empty, too
+ *               long, or not followed by a '/';
+ *             - #SHADOW_ROOT_PARSE_FAILED if the topic does not continue with
+ *               the root of a registered table;
+ *             - #SHADOW_SHADOWNAME_PARSE_FAILED if the name is empty or too long;
+ *             - #SHADOW_MESSAGE_TYPE_PARSE_FAILED if the rest of the topic is not
+ *               an operation of the table;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL or topicLength is zero.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * char * pTopicName; //usually supplied by MQTT stack
+ * uint16_t topicNameLength; //usually supplied by MQTT stack
+ * ShadowReservedMatch_t match;
+ *
+ * if( Shadow_ReservedTopicMatch( &engine, pTopicName, topicNameLength, &match ) == SHADOW_SUCCESS )
+ * {
+ *      if( match.tableIndex == SHADOW_RESERVED_TABLE_SHADOW )
+ *      {
+ *          // The Shadow message type is ( ShadowMessageType_t ) match.operationIndex.
+ *      }
+ *      else if( match.tableIndex == jobsTableIndex )
+ *      {
+ *          // Pass the message to the Jobs library.
+ *      }
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_reservedtopicmatch] */
+ShadowStatus_t Shadow_ReservedTopicMatch( const ShadowReservedTopicEngine_t * pEngine,
+                                          const char * pTopic,
+                                          uint16_t topicLength,
+                                          ShadowReservedMatch_t * pMatch );
+/* @[declare_shadow_reservedtopicmatch] */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* ifndef SHADOW_RESERVED_TOPIC_H_ */
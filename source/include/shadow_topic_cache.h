@@ -0,0 +1,171 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file shadow_topic_cache.h
+ * @brief User-facing functions of the Shadow topic cache, which keeps the
+ * results of matching recently received topic strings.
+ */
+
+#ifndef SHADOW_TOPIC_CACHE_H_
+#define SHADOW_TOPIC_CACHE_H_
+
+/* Shadow includes. */
+#include "shadow.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/*------------------------ Shadow topic cache types -------------------------*/
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief One entry of a #ShadowTopicCache_t.
+ *
+ * The entries are provided by the application and managed by the cache. The
+ * application should not access the members directly.
+ */
+typedef struct ShadowTopicCacheEntry
+{
+    ShadowMatchResult_t result;                    /**< @brief Result of matching the topic. */
+    uint32_t key;                                  /**< @brief Key of the topic, from its length and a few of its characters. */
+    uint16_t topicLength;                          /**< @brief Length of the topic. Zero if the entry is empty. */
+    char topic[ SHADOW_CACHED_TOPIC_LENGTH_MAX ]; /**< @brief Copy of the topic. */
+} ShadowTopicCacheEntry_t;
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief A cache of the results of matching recently received topic strings,
+ * held in application-provided memory.
+ *
+ * Each topic is kept in the entry selected by the low bits of its key, and
+ * replaces the topic that was kept there. The key is computed from the length
+ * of the topic, the eight characters after #SHADOW_PREFIX and the last eight
+ * characters, so that it does not take longer to compute for a longer topic. Initialize with
+ * Shadow_TopicCacheInit(). The application may read the hit and miss counts,
+ * and should not access the other members.
+ */
+typedef struct ShadowTopicCache
+{
+    ShadowTopicCacheEntry_t * pEntries; /**< @brief Application-provided entries. */
+    uint32_t entryCount;                /**< @brief Number of entries. A power of two. */
+    uint32_t hitCount;                  /**< @brief Number of topics found in the cache. */
+    uint32_t missCount;                 /**< @brief Number of topics not found in the cache. */
+} ShadowTopicCache_t;
+
+/*---------------------- Shadow topic cache functions -----------------------*/
+
+/**
+ * @brief Initialize a Shadow topic cache with application-provided entries.
+ *
+ * A device usually receives messages on a few topics, such as the update/delta
+ * and get/accepted topics of its shadows. Two topics may select the same
+ * entry, so allocate a few more entries than the topics that the device
+ * subscribes to, such as twice as many.
+ *
+ * @param[out] pCache The cache to initialize.
+ * @param[in]  pEntries Array of @p entryCount entries for the cache to use. The
+ *             array must remain valid for as long as the cache is used.
+ * @param[in]  entryCount Number of entries in @p pEntries. Must be a power of two.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the cache was initialized;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, or entryCount is zero
+ *               or not a power of two.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * static ShadowTopicCacheEntry_t cacheEntries[ 8 ];
+ * static ShadowTopicCache_t topicCache;
+ * ShadowStatus_t shadowStatus;
+ *
+ * shadowStatus = Shadow_TopicCacheInit( &topicCache, cacheEntries, 8U );
+ *
+ * @endcode
+ */
+/* @[declare_shadow_topiccacheinit] */
+ShadowStatus_t Shadow_TopicCacheInit( ShadowTopicCache_t * pCache,
+                                      ShadowTopicCacheEntry_t * pEntries,
+                                      uint32_t entryCount );
+/* @[declare_shadow_topiccacheinit] */
+
+/**
+ * @brief Match a topic string, using the result kept for the same topic if
+ * it was matched recently.
+ *
+ * The key of the topic is computed, and the topic is compared with the copy
+ * kept in the one entry that its key selects. If it is not in the cache, it is matched with
+ * Shadow_MatchTopicBatch(), and the result is kept in that entry in place of
+ * the topic kept there. Results of topics that are not Shadow topics are kept
+ * as well. Topics longer than #SHADOW_CACHED_TOPIC_LENGTH_MAX are matched, but
+ * not cached.
+ *
+ * @param[in]  pCache The cache.
+ * @param[in]  pTopic Pointer to the topic string.
+ * @param[in]  topicLength Length of the topic string.
+ * @param[out] pResult Pointer to caller-supplied memory for returning the
+ *             result of the match. The name offsets are relative to pTopic.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the topic is a Shadow topic;
+ *             - #SHADOW_BAD_PARAMETER if a parameter is invalid;
+ *             - the error code of Shadow_MatchTopicString() if the topic is not
+ *               a Shadow topic.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * const char * pTopicName; // The topic of an incoming message.
+ * uint16_t topicNameLength;
+ * ShadowMatchResult_t result;
+ *
+ * // topicCache was initialized with Shadow_TopicCacheInit().
+ * if( Shadow_TopicCacheMatch( &topicCache, pTopicName, topicNameLength,
+ *                             &result ) == SHADOW_SUCCESS )
+ * {
+ *      // The message type is result.messageType.
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_topiccachematch] */
+ShadowStatus_t Shadow_TopicCacheMatch( ShadowTopicCache_t * pCache,
+                                       const char * pTopic,
+                                       uint16_t topicLength,
+                                       ShadowMatchResult_t * pResult );
+/* @[declare_shadow_topiccachematch] */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* ifndef SHADOW_TOPIC_CACHE_H_ */
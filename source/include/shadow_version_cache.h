@@ -0,0 +1,194 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file shadow_version_cache.h
+ * @brief User-facing functions of the Shadow version cache, which keeps the
+ * version of the last message applied to each registered shadow and drops
+ * older messages.
+ */
+
+#ifndef SHADOW_VERSION_CACHE_H_
+#define SHADOW_VERSION_CACHE_H_
+
+/* Shadow includes. */
+#include "shadow_registry.h"
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    extern "C" {
+#endif
+/* *INDENT-ON* */
+
+/*---------------------- Shadow version cache types ----------------------*/
+
+/**
+ * @ingroup shadow_struct_types
+ * @brief The versions of the last messages applied to the shadows of a
+ * #ShadowRegistry_t, indexed by the handles of the registry.
+ *
+ * Initialize with Shadow_VersionCacheInit(). The application should not access
+ * the members directly, except to read the statistics.
+ */
+typedef struct ShadowVersionCache
+{
+    uint32_t * pVersions;  /**< @brief Application-provided versions, one per handle. Zero if no message with a version has been applied. */
+    uint32_t versionCount; /**< @brief Number of versions. */
+    uint32_t staleCount;   /**< @brief Number of messages dropped because they were older than the last one applied. */
+} ShadowVersionCache_t;
+
+/*-------------------- Shadow version cache functions --------------------*/
+
+/**
+ * @brief Initialize a version cache with application-provided memory.
+ *
+ * @param[out] pCache The cache to initialize.
+ * @param[in]  pVersions Array of @p versionCount versions for the cache to use.
+ *             The array must remain valid for as long as the cache is used.
+ * @param[in]  versionCount Number of versions in @p pVersions. Use the slot
+ *             count of the registry whose handles index the cache.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the cache was initialized;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL or versionCount is zero.
+ */
+/* @[declare_shadow_versioncacheinit] */
+ShadowStatus_t Shadow_VersionCacheInit( ShadowVersionCache_t * pCache,
+                                        uint32_t * pVersions,
+                                        uint32_t versionCount );
+/* @[declare_shadow_versioncacheinit] */
+
+/**
+ * @brief Record the version of a message about to be applied to a shadow,
+ * unless the message is older than the last one applied.
+ *
+ * A message with the version of the last message applied is not dropped: the
+ * service publishes update/accepted, update/documents and update/delta with
+ * the same version for one update, and each of them must be applied.
+ *
+ * @param[in] pCache The cache.
+ * @param[in] handle The handle of the shadow in its #ShadowRegistry_t.
+ * @param[in] version The version of the message.
+ *
+ * @return    One of the following:
+ *            - #SHADOW_SUCCESS if the message is not older, and its version is recorded;
+ *            - #SHADOW_VERSION_STALE if the message is older;
+ *            - #SHADOW_BAD_PARAMETER if pCache is NULL or handle is out of range.
+ */
+/* @[declare_shadow_versioncacheaccept] */
+ShadowStatus_t Shadow_VersionCacheAccept( ShadowVersionCache_t * pCache,
+                                          uint32_t handle,
+                                          uint32_t version );
+/* @[declare_shadow_versioncacheaccept] */
+
+/**
+ * @brief Forget the version of the last message applied to a shadow, so that
+ * the next message is applied whatever its version.
+ *
+ * For example, when a shadow is deleted and created again, the versions of
+ * its messages may start over.
+ *
+ * @param[in] pCache The cache.
+ * @param[in] handle The handle of the shadow in its #ShadowRegistry_t.
+ *
+ * @return #SHADOW_SUCCESS, or #SHADOW_BAD_PARAMETER if pCache is NULL or
+ * handle is out of range.
+ */
+/* @[declare_shadow_versioncachereset] */
+ShadowStatus_t Shadow_VersionCacheReset( ShadowVersionCache_t * pCache,
+                                         uint32_t handle );
+/* @[declare_shadow_versioncachereset] */
+
+/**
+ * @brief Match an incoming shadow message with a registry, and drop it if it
+ * is older than the last message applied to its shadow.
+ *
+ * The version is read with Shadow_PayloadGetVersion(), which skips the state
+ * of the document instead of parsing it. Messages without a version, such as
+ * rejected messages, are not dropped.
+ *
+ * @param[in]  pCache The cache, indexed by the handles of @p pRegistry.
+ * @param[in]  pRegistry The registry.
+ * @param[in]  pTopic Pointer to the MQTT topic string. Does not have to be null-terminated.
+ * @param[in]  topicLength Length of the MQTT topic string.
+ * @param[in]  pPayload The payload of the message. Does not have to be null-terminated.
+ * @param[in]  payloadLength Length of the payload.
+ * @param[out] pHandle Pointer to caller-supplied memory for returning the
+ *             handle of the shadow.
+ * @param[out] pMessageType Pointer to caller-supplied memory for returning the
+ *             type of the Shadow message.
+ *
+ * @return     One of the following:
+ *             - #SHADOW_SUCCESS if the message should be applied;
+ *             - #SHADOW_VERSION_STALE if the message is older than the
+ *               last message applied;
+ *             - #SHADOW_PAYLOAD_PARSE_FAILED if the version of the message
+ *               cannot be read;
+ *             - #SHADOW_BAD_PARAMETER if a pointer is NULL, the payload of an
+ *               accepted, update/delta or update/documents message is empty,
+ *               or the cache has fewer versions than the registry has slots;
+ *             - The error code returned by Shadow_RegistryMatchTopic() if the
+ *               topic does not match a registered shadow.
+ *
+ * <b>Example</b>
+ * @code{c}
+ *
+ * // Variables used in this example.
+ * static uint32_t versions[ 256 ];
+ * static ShadowVersionCache_t versionCache;
+ * uint32_t handle;
+ * ShadowMessageType_t messageType;
+ *
+ * // The registry has 256 slots.
+ * ( void ) Shadow_VersionCacheInit( &versionCache, versions, 256U );
+ *
+ * // For each incoming message:
+ * if( Shadow_VersionCacheMatch( &versionCache, &registry,
+ *                               pTopicName, topicNameLength,
+ *                               pPayload, payloadLength,
+ *                               &handle, &messageType ) == SHADOW_SUCCESS )
+ * {
+ *      // Parse and apply the message to the context at index handle.
+ * }
+ *
+ * @endcode
+ */
+/* @[declare_shadow_versioncachematch] */
+ShadowStatus_t Shadow_VersionCacheMatch( ShadowVersionCache_t * pCache,
+                                         const ShadowRegistry_t * pRegistry,
+                                         const char * pTopic,
+                                         uint16_t topicLength,
+                                         const char * pPayload,
+                                         uint32_t payloadLength,
+                                         uint32_t * pHandle,
+                                         ShadowMessageType_t * pMessageType );
+/* @[declare_shadow_versioncachematch] */
+
+/* *INDENT-OFF* */
+#ifdef __cplusplus
+    }
+#endif
+/* *INDENT-ON* */
+
+#endif /* ifndef SHADOW_VERSION_CACHE_H_ */
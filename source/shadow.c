@@ -28,6 +28,7 @@
  */
 
 /* Standard includes. */
+#include <stdbool.h>
 #include <string.h>
 
 /* Shadow includes. */
@@ -48,6 +49,110 @@
  */
 #define SHADOW_THINGNAME_MAX_LENGTH          ( 128U )
 
+/**
+ * @brief Maximum number of shadows for Shadow_AssembleTopicsBulk() and
+ * Shadow_AssembleWildcardFilters(), so that the length of their topics always
+ * fits in 32 bits. The topic filters of a shadow are no longer than its topics.
+ */
+#define SHADOW_BULK_NAME_COUNT_MAX \
+    ( UINT32_MAX / SHADOW_TOPIC_LEN_ALL( SHADOW_THINGNAME_MAX_LENGTH, SHADOW_NAME_MAX_LENGTH ) )
+
+/**
+ * @brief Flag of a #ShadowWildcardEntry_t whose topic filters have the '+'
+ * wildcard in place of the Shadow name.
+ */
+#define SHADOW_WILDCARD_FLAG_SHADOW_NAME     ( ( uint8_t ) 1U )
+
+/**
+ * @brief Flag of a #ShadowWildcardEntry_t whose topic filters have the '+'
+ * wildcard in place of the Thing name.
+ */
+#define SHADOW_WILDCARD_FLAG_THING_NAME      ( ( uint8_t ) 2U )
+
+/**
+ * @brief Flag of a #ShadowWildcardEntry_t of the first shadow in the names
+ * that its topic filters cover.
+ */
+#define SHADOW_WILDCARD_FLAG_FIRST           ( ( uint8_t ) 4U )
+
+/**
+ * @brief #ShadowFilterSlot_t.filterIndex of an empty slot.
+ */
+#define SHADOW_FILTER_SLOT_EMPTY             ( UINT32_MAX )
+
+/**
+ * @brief The hash that topic filters without a Thing name are indexed under in
+ * a #ShadowFilterIndex_t, which is the hash of #SHADOW_WILDCARD.
+ */
+#define SHADOW_FILTER_WILDCARD_HASH          SHADOW_HASH_BYTE( SHADOW_HASH_OFFSET_BASIS, '+' )
+
+/**
+ * @brief The MQTT single-level wildcard, which stands for a Thing name or a
+ * Shadow name in a topic filter of Shadow_AssembleWildcardFilters().
+ */
+#define SHADOW_WILDCARD                      "+"
+
+/**
+ * @brief The length of #SHADOW_WILDCARD.
+ */
+#define SHADOW_WILDCARD_LENGTH               ( ( uint8_t ) ( sizeof( SHADOW_WILDCARD ) - 1U ) )
+
+/**
+ * @brief A topic level that is the MQTT single-level wildcard.
+ */
+#define SHADOW_WILDCARD_LEVEL                "/" SHADOW_WILDCARD
+
+/**
+ * @brief The length of #SHADOW_WILDCARD_LEVEL.
+ */
+#define SHADOW_WILDCARD_LEVEL_LENGTH         ( ( uint16_t ) ( sizeof( SHADOW_WILDCARD_LEVEL ) - 1U ) )
+
+/**
+ * @brief The topic type mask of the "get", "delete" and "update" topics, which
+ * are published by devices.
+ */
+#define SHADOW_REQUEST_TYPES                                     \
+    ( ( uint16_t ) ( SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeGet ) |    \
+                     SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeDelete ) | \
+                     SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdate ) ) )
+
+/**
+ * @brief The topic type mask of the topics published by the Shadow service.
+ */
+#define SHADOW_RESPONSE_TYPES                ( ( uint16_t ) ( SHADOW_TOPIC_TYPE_ALL & ( uint16_t ) ~SHADOW_REQUEST_TYPES ) )
+
+/**
+ * @brief Maximum number of shadows for Shadow_SerializeSubscribePayload() and
+ * Shadow_SerializeUnsubscribePayload(), so that the length of the payload
+ * always fits in 32 bits.
+ */
+#define SHADOW_PAYLOAD_NAME_COUNT_MAX \
+    ( UINT32_MAX / SHADOW_SUBSCRIBE_PAYLOAD_LEN_ALL( SHADOW_THINGNAME_MAX_LENGTH, SHADOW_NAME_MAX_LENGTH ) )
+
+/**
+ * @brief The highest QoS that can be requested in an MQTT SUBSCRIBE packet.
+ */
+#define SHADOW_SUBSCRIBE_QOS_MAX             ( 2U )
+
+#ifdef SHADOW_FIXED_THING_NAME
+
+/**
+ * @brief The part of a topic of #SHADOW_FIXED_THING_NAME between #SHADOW_PREFIX
+ * and the Shadow name or operation.
+ */
+    #define SHADOW_FIXED_THING_ROOT           SHADOW_FIXED_THING_NAME SHADOW_CLASSIC_ROOT
+
+/**
+ * @brief The length of #SHADOW_FIXED_THING_NAME.
+ */
+    #define SHADOW_FIXED_THING_NAME_LENGTH    ( ( uint8_t ) ( sizeof( SHADOW_FIXED_THING_NAME ) - 1U ) )
+
+/**
+ * @brief The length of #SHADOW_FIXED_THING_ROOT.
+ */
+    #define SHADOW_FIXED_THING_ROOT_LENGTH    ( ( uint16_t ) ( sizeof( SHADOW_FIXED_THING_ROOT ) - 1U ) )
+#endif /* ifdef SHADOW_FIXED_THING_NAME */
+
 /**
  * @brief The string representing "/shadow/update/accepted".
  */
@@ -128,6 +233,72 @@
  */
 #define SHADOW_OP_DELETE_REJECTED_LENGTH     ( SHADOW_OP_DELETE_LENGTH + SHADOW_SUFFIX_REJECTED_LENGTH )
 
+/**
+ * @brief The operation part of a topic filter of Shadow_AssembleWildcardFilters(),
+ * which is an operation string followed by single-level wildcards.
+ */
+typedef struct WildcardFilterOperation
+{
+    const char * pOperation;  /**< @brief Operation string, such as "/update". May be empty. */
+    uint16_t operationLength; /**< @brief Length of the operation string. */
+    uint16_t wildcardCount;   /**< @brief Number of "/+" levels after the operation string. */
+} WildcardFilterOperation_t;
+
+/**
+ * @brief The orders that the scratch entries of
+ * Shadow_AssembleWildcardFilters() are sorted in to group the shadows.
+ */
+typedef enum WildcardOrder
+{
+    WildcardOrderThing = 0, /**< @brief By Thing name. */
+    WildcardOrderShadow,    /**< @brief Shadows with a wildcard Shadow name last, and the others by Shadow name. */
+    WildcardOrderFilter     /**< @brief By the names of their topic filters. */
+} WildcardOrder_t;
+
+/**
+ * @brief The operation string, lengths and message type of each topic type,
+ * in the order of #ShadowTopicStringType_t.
+ *
+ * The entries must stay indexed by #ShadowTopicStringType_t:
+ * #pMessageTopicTypes maps each #ShadowMessageType_t to the index of its entry,
+ * and #SHADOW_MESSAGE_DESCRIPTOR reads the entry at that index.
+ */
+const ShadowTopicDescriptor_t ShadowTopicDescriptors[ ShadowTopicStringTypeMaxNum ] =
+{
+    { SHADOW_OP_GET,              SHADOW_OP_GET_LENGTH,              SHADOW_OP_GET_LENGTH,    ShadowMessageTypeMaxNum },
+    { SHADOW_OP_GET_ACCEPTED,     SHADOW_OP_GET_ACCEPTED_LENGTH,     SHADOW_OP_GET_LENGTH,    ShadowMessageTypeGetAccepted },
+    { SHADOW_OP_GET_REJECTED,     SHADOW_OP_GET_REJECTED_LENGTH,     SHADOW_OP_GET_LENGTH,    ShadowMessageTypeGetRejected },
+    { SHADOW_OP_DELETE,           SHADOW_OP_DELETE_LENGTH,           SHADOW_OP_DELETE_LENGTH, ShadowMessageTypeMaxNum },
+    { SHADOW_OP_DELETE_ACCEPTED,  SHADOW_OP_DELETE_ACCEPTED_LENGTH,  SHADOW_OP_DELETE_LENGTH, ShadowMessageTypeDeleteAccepted },
+    { SHADOW_OP_DELETE_REJECTED,  SHADOW_OP_DELETE_REJECTED_LENGTH,  SHADOW_OP_DELETE_LENGTH, ShadowMessageTypeDeleteRejected },
+    { SHADOW_OP_UPDATE,           SHADOW_OP_UPDATE_LENGTH,           SHADOW_OP_UPDATE_LENGTH, ShadowMessageTypeMaxNum },
+    { SHADOW_OP_UPDATE_ACCEPTED,  SHADOW_OP_UPDATE_ACCEPTED_LENGTH,  SHADOW_OP_UPDATE_LENGTH, ShadowMessageTypeUpdateAccepted },
+    { SHADOW_OP_UPDATE_REJECTED,  SHADOW_OP_UPDATE_REJECTED_LENGTH,  SHADOW_OP_UPDATE_LENGTH, ShadowMessageTypeUpdateRejected },
+    { SHADOW_OP_UPDATE_DOCUMENTS, SHADOW_OP_UPDATE_DOCUMENTS_LENGTH, SHADOW_OP_UPDATE_LENGTH, ShadowMessageTypeUpdateDocuments },
+    { SHADOW_OP_UPDATE_DELTA,     SHADOW_OP_UPDATE_DELTA_LENGTH,     SHADOW_OP_UPDATE_LENGTH, ShadowMessageTypeUpdateDelta }
+};
+
+/**
+ * @brief Lookup table for the topic type of each Shadow message type, in the
+ * order of #ShadowMessageType_t.
+ */
+static const uint8_t pMessageTopicTypes[ ShadowMessageTypeMaxNum ] =
+{
+    ( uint8_t ) ShadowTopicStringTypeGetAccepted,
+    ( uint8_t ) ShadowTopicStringTypeGetRejected,
+    ( uint8_t ) ShadowTopicStringTypeDeleteAccepted,
+    ( uint8_t ) ShadowTopicStringTypeDeleteRejected,
+    ( uint8_t ) ShadowTopicStringTypeUpdateAccepted,
+    ( uint8_t ) ShadowTopicStringTypeUpdateRejected,
+    ( uint8_t ) ShadowTopicStringTypeUpdateDocuments,
+    ( uint8_t ) ShadowTopicStringTypeUpdateDelta
+};
+
+/**
+ * @brief The #ShadowTopicDescriptor_t of a Shadow message type.
+ */
+#define SHADOW_MESSAGE_DESCRIPTOR( messageType )    ( ShadowTopicDescriptors[ pMessageTopicTypes[ ( messageType ) ] ] )
+
 /**
  * @brief Check if Shadow_MatchTopicString has valid parameters.
  *
@@ -142,6 +313,22 @@ static ShadowStatus_t validateMatchTopicParameters( const char * pTopic,
                                                     uint16_t topicLength,
                                                     const ShadowMessageType_t * pMessageType );
 
+/**
+ * @brief Check if the Thing and Shadow names to assemble topic strings with are valid.
+ *
+ * @param[in]  pThingName Thing Name string.
+ * @param[in]  thingNameLength Length of Thing Name string pointed to by pThingName.
+ * @param[in]  pShadowName Shadow Name string.
+ * @param[in]  shadowNameLength Length of Shadow Name string pointed to by pShadowName.
+ *
+ * @return Return SHADOW_SUCCESS if the names are valid;
+ *         return SHADOW_BAD_PARAMETER if not.
+ */
+static ShadowStatus_t validateTopicNames( const char * pThingName,
+                                          uint8_t thingNameLength,
+                                          const char * pShadowName,
+                                          uint8_t shadowNameLength );
+
 /**
  * @brief Check if Shadow_AssembleTopicString has valid parameters.
  *
@@ -165,101 +352,347 @@ static ShadowStatus_t validateAssembleTopicParameters( ShadowTopicStringType_t t
                                                        const uint16_t * pOutLength );
 
 /**
- * @brief Determine if the string contains the substring.
+ * @brief Check if a topic string starts with #SHADOW_PREFIX.
  *
- * @param[in] pString Pointer to the string.
- * @param[in] stringLength Length of pString.
- * @param[in] pSubString Pointer to the substring.
- * @param[in] subStringLength Length of pSubString.
+ * The prefix is compared as one 64-bit and one 32-bit word, which rejects most
+ * non-Shadow topics in a few instructions.
+ *
+ * @param[in] pTopic Pointer to the topic string.
+ * @param[in] topicLength Length of pTopic.
  *
- * @return Return SHADOW_SUCCESS if it contains;
+ * @return Return SHADOW_SUCCESS if the topic starts with the prefix;
  *         return SHADOW_FAIL if not.
  */
-static ShadowStatus_t containsSubString( const char * pString,
-                                         uint16_t stringLength,
-                                         const char * pSubString,
-                                         uint16_t subStringLength );
+static ShadowStatus_t matchPrefixWords( const char * pTopic,
+                                        uint16_t topicLength );
+
+/**
+ * @brief Select the only Shadow operation that can end a topic string, from a
+ * few of its last characters.
+ *
+ * @param[in] pTopic Pointer to the topic string.
+ * @param[in] topicLength Length of pTopic. Must not be less than #SHADOW_TOPIC_LEN_MIN.
+ *
+ * @return Index of the operation in #pMessageTopicTypes, or #ShadowMessageTypeMaxNum
+ * if no operation can end the topic.
+ */
+static uint8_t findSuffixOperation( const char * pTopic,
+                                    uint16_t topicLength );
+
+/**
+ * @brief Check that the classic shadow root, or the named shadow root and a
+ * Shadow name, come right before the operation of a topic string.
+ *
+ * @param[in] pTopic Pointer to the topic string.
+ * @param[in] operationStart Index of the operation in pTopic. Must not be less
+ * than #SHADOW_PREFIX_LENGTH + 1 + #SHADOW_CLASSIC_ROOT_LENGTH.
+ *
+ * @return true if a Shadow root comes before the operation; false if not.
+ */
+static bool isShadowRootBefore( const char * pTopic,
+                                uint16_t operationStart );
 
 /**
- * @brief Check if the Thing or Shadow Name is valid.
+ * @brief Find the forward slash that ends a Thing or Shadow name.
+ *
+ * The search method is selected with #SHADOW_NAME_SCAN.
  *
  * @param[in] pString Pointer to the starting of a name.
  * @param[in] stringLength Length of pString.
- * @param[in] maxAllowedLength Maximum allowed length of the Thing or Shadow name.
- * @param[out] pNameLength Pointer to caller-supplied memory for returning the length of the Thing or Shadow Name.
  *
- * @return Return SHADOW_SUCCESS if it is valid;
- *         return SHADOW_FAIL if it is not.
+ * @return The index of the first forward slash in pString, or stringLength if
+ * pString does not contain one.
  */
-static ShadowStatus_t validateName( const char * pString,
-                                    uint16_t stringLength,
-                                    uint8_t maxAllowedLength,
-                                    uint8_t * pNameLength );
+static uint16_t findNameEnd( const char * pString,
+                             uint16_t stringLength );
 
 /**
- * @brief Extract the Shadow message type from a string.
+ * @brief Find the forward slash that ends a Thing or Shadow name, and hash the
+ * bytes of the name as they are compared.
  *
- * @param[in] pString Pointer to the string.
+ * @param[in] pString Pointer to the starting of a name, or of its remaining bytes.
  * @param[in] stringLength Length of pString.
- * @param[out] pMessageType Pointer to caller-supplied memory for returning the type of the shadow message.
+ * @param[in,out] pHash The FNV-1a hash of the bytes of the name before pString;
+ * updated with the bytes before the forward slash.
  *
- * @return Return SHADOW_SUCCESS if successfully extracted;
- *         return SHADOW_MESSAGE_TYPE_PARSE_FAILED if failed.
+ * @return The index of the first forward slash in pString, or stringLength if
+ * pString does not contain one.
  */
-static ShadowStatus_t extractShadowMessageType( const char * pString,
-                                                uint16_t stringLength,
-                                                ShadowMessageType_t * pMessageType );
+static uint16_t hashNameEnd( const char * pString,
+                             uint16_t stringLength,
+                             uint32_t * pHash );
 
 /**
- * @brief Extract the Thing name from a topic string.
+ * @brief Add bytes to a 32-bit FNV-1a hash.
  *
- * @param[in] pTopic Pointer to the topic string.
- * @param[in] topicLength Length of pTopic.
- * @param[in,out] pConsumedTopicLength Pointer to caller-supplied memory for returning the consumed topic length.
- * @param[out] pThingNameLength Pointer to caller-supplied memory for returning the Thing name length.
+ * @param[in] hash The hash of the preceding bytes.
+ * @param[in] pString The bytes to add.
+ * @param[in] length Number of bytes to add.
  *
- * @return Return SHADOW_SUCCESS if successfully extracted;
- *         return SHADOW_THINGNAME_PARSE_FAILED if Thing name parsing fails.
+ * @return The hash including the added bytes.
  */
-static ShadowStatus_t extractThingName( const char * pTopic,
-                                        uint16_t topicLength,
-                                        uint16_t * pConsumedTopicLength,
-                                        uint8_t * pThingNameLength );
+static uint32_t hashBytes( uint32_t hash,
+                           const char * pString,
+                           uint8_t length );
 
 /**
- * @brief Extract the classic shadow root OR the named shadow root and shadow name from a topic string.
+ * @brief Compute #ShadowTopicHash_t.keyHash from the hashes of the names.
  *
- * @param[in] pTopic Pointer to the topic string.
- * @param[in] topicLength Length of pTopic.
- * @param[in,out] pConsumedTopicLength Pointer to caller-supplied memory for returning the consumed topic length.
- * @param[out] pShadowNameLength Pointer to caller-supplied memory for returning the shadow name length.
+ * @param[in,out] pHash The hashes, with the name hashes set.
+ */
+static void hashKey( ShadowTopicHash_t * pHash );
+
+/**
+ * @brief States of the single-pass topic parser, kept in
+ * #ShadowMatchContext_t.state.
+ */
+typedef enum MatchState
+{
+    MatchStatePrefix = 0, /**< @brief Matching #SHADOW_PREFIX. */
+    MatchStateThingName,  /**< @brief Scanning the Thing name. */
+    MatchStateRoot,       /**< @brief Matching #SHADOW_CLASSIC_ROOT or #SHADOW_NAMED_ROOT. */
+    MatchStateShadowName, /**< @brief Scanning the Shadow name. */
+    MatchStateOperation,  /**< @brief Matching the Shadow operation and suffix. */
+    MatchStateFailed      /**< @brief The topic is known not to be a Shadow topic. */
+} MatchState_t;
+
+/**
+ * @brief Match bytes against a string literal, starting at a position in the literal.
+ *
+ * @param[in] pLiteral Pointer to the literal.
+ * @param[in] literalLength Length of pLiteral.
+ * @param[in,out] pLiteralIndex Position in pLiteral to match the first byte against;
+ * updated to the position after the last matching byte.
+ * @param[in] pBytes Pointer to the bytes to match.
+ * @param[in] length Length of pBytes.
  *
- * @return Return SHADOW_SUCCESS if successfully extracted;
- *         return SHADOW_ROOT_PARSE_FAILED shadow root parsing fails.
- *         return SHADOW_SHADOWNAME_PARSE_FAILED shadow name parsing fails.
+ * @return The number of bytes matched. Fewer than @p length bytes are matched
+ * when the end of the literal is reached or a byte does not match.
  */
-static ShadowStatus_t extractShadowRootAndName( const char * pTopic,
-                                                uint16_t topicLength,
-                                                uint16_t * pConsumedTopicLength,
-                                                uint8_t * pShadowNameLength );
+static uint16_t matchLiteral( const char * pLiteral,
+                              uint16_t literalLength,
+                              uint16_t * pLiteralIndex,
+                              const char * pBytes,
+                              uint16_t length );
+
+/**
+ * @brief Find the operation that continues the operation matched so far with
+ * another byte.
+ *
+ * @param[in] operationIndex Index of the operation matched so far.
+ * @param[in] literalIndex Number of bytes of the operation matched so far.
+ * @param[in] nextByte The next byte of the topic.
+ *
+ * @return Index of the operation in #pMessageTopicTypes, or #ShadowMessageTypeMaxNum
+ * if no operation continues with @p nextByte.
+ */
+static uint8_t findOperation( uint8_t operationIndex,
+                              uint16_t literalIndex,
+                              char nextByte );
+
+/**
+ * @brief Feed bytes to the parser while it is in #MatchStatePrefix.
+ *
+ * @param[in,out] pContext The parser state.
+ * @param[in] pBytes Pointer to the bytes.
+ * @param[in] length Length of pBytes.
+ *
+ * @return The number of bytes consumed.
+ */
+static uint16_t matchPrefix( ShadowMatchContext_t * pContext,
+                             const char * pBytes,
+                             uint16_t length );
+
+/**
+ * @brief Feed bytes to the parser while it is in #MatchStateThingName or
+ * #MatchStateShadowName.
+ *
+ * @param[in,out] pContext The parser state.
+ * @param[in] pBytes Pointer to the bytes.
+ * @param[in] length Length of pBytes.
+ *
+ * @return The number of bytes consumed.
+ */
+static uint16_t matchName( ShadowMatchContext_t * pContext,
+                           const char * pBytes,
+                           uint16_t length );
+
+/**
+ * @brief Feed bytes to the parser while it is in #MatchStateRoot.
+ *
+ * @param[in,out] pContext The parser state.
+ * @param[in] pBytes Pointer to the bytes.
+ * @param[in] length Length of pBytes.
+ *
+ * @return The number of bytes consumed.
+ */
+static uint16_t matchRoot( ShadowMatchContext_t * pContext,
+                           const char * pBytes,
+                           uint16_t length );
+
+/**
+ * @brief Feed bytes to the parser while it is in #MatchStateOperation.
+ *
+ * @param[in,out] pContext The parser state.
+ * @param[in] pBytes Pointer to the bytes.
+ * @param[in] length Length of pBytes.
+ *
+ * @return The number of bytes consumed.
+ */
+static uint16_t matchOperation( ShadowMatchContext_t * pContext,
+                                const char * pBytes,
+                                uint16_t length );
+
+/**
+ * @brief Feed the next bytes of a topic string to the parser.
+ *
+ * @param[in,out] pContext The parser state.
+ * @param[in] pBytes Pointer to the bytes.
+ * @param[in] length Length of pBytes.
+ */
+static void matchTopicBytes( ShadowMatchContext_t * pContext,
+                             const char * pBytes,
+                             uint16_t length );
 
 /**
- * @brief Get the shadow operation string for a given shadow topic type.
+ * @brief Get the result of parsing a topic string once all its bytes have been fed.
  *
- * @param[in] topicType The given shadow topic type.
+ * @param[in] pContext The parser state.
  *
- * @return The shadow operation string for the given shadow type.
+ * @return Return SHADOW_SUCCESS if the topic is a Shadow topic;
+ *         otherwise the error code of the part of the topic that failed to parse.
  */
-static const char * getShadowOperationString( ShadowTopicStringType_t topicType );
+static ShadowStatus_t finishTopic( const ShadowMatchContext_t * pContext );
+
+#if ( SHADOW_SINGLE_PASS_MATCH != 1 ) || defined( SHADOW_FIXED_THING_NAME )
+
+    /**
+     * @brief Determine if the string contains the substring.
+     *
+     * @param[in] pString Pointer to the string.
+     * @param[in] stringLength Length of pString.
+     * @param[in] pSubString Pointer to the substring.
+     * @param[in] subStringLength Length of pSubString.
+     *
+     * @return Return SHADOW_SUCCESS if it contains;
+     *         return SHADOW_FAIL if not.
+     */
+    static ShadowStatus_t containsSubString( const char * pString,
+                                             uint16_t stringLength,
+                                             const char * pSubString,
+                                             uint16_t subStringLength );
+
+    /**
+     * @brief Check if the Thing or Shadow Name is valid.
+     *
+     * @param[in] pString Pointer to the starting of a name.
+     * @param[in] stringLength Length of pString.
+     * @param[in] maxAllowedLength Maximum allowed length of the Thing or Shadow name.
+     * @param[out] pNameLength Pointer to caller-supplied memory for returning the length of the Thing or Shadow Name.
+     * @param[in,out] pNameHash NULL, or the hash to update with the name.
+     *
+     * @return Return SHADOW_SUCCESS if it is valid;
+     *         return SHADOW_FAIL if it is not.
+     */
+    static ShadowStatus_t validateName( const char * pString,
+                                        uint16_t stringLength,
+                                        uint8_t maxAllowedLength,
+                                        uint8_t * pNameLength,
+                                        uint32_t * pNameHash );
+
+    /**
+     * @brief Extract the Shadow message type from a string.
+     *
+     * @param[in] pString Pointer to the string.
+     * @param[in] stringLength Length of pString.
+     * @param[out] pMessageType Pointer to caller-supplied memory for returning the type of the shadow message.
+     *
+     * @return Return SHADOW_SUCCESS if successfully extracted;
+     *         return SHADOW_MESSAGE_TYPE_PARSE_FAILED if failed.
+     */
+    static ShadowStatus_t extractShadowMessageType( const char * pString,
+                                                    uint16_t stringLength,
+                                                    ShadowMessageType_t * pMessageType );
+
+#endif /* if ( SHADOW_SINGLE_PASS_MATCH != 1 ) || defined( SHADOW_FIXED_THING_NAME ) */
+
+#if ( SHADOW_SINGLE_PASS_MATCH != 1 )
+
+    /**
+     * @brief Extract the Thing name from a topic string.
+     *
+     * @param[in] pTopic Pointer to the topic string.
+     * @param[in] topicLength Length of pTopic.
+     * @param[in,out] pConsumedTopicLength Pointer to caller-supplied memory for returning the consumed topic length.
+     * @param[out] pThingNameLength Pointer to caller-supplied memory for returning the Thing name length.
+     * @param[in,out] pThingNameHash NULL, or the hash to update with the Thing name.
+     *
+     * @return Return SHADOW_SUCCESS if successfully extracted;
+     *         return SHADOW_THINGNAME_PARSE_FAILED if Thing name parsing fails.
+     */
+    static ShadowStatus_t extractThingName( const char * pTopic,
+                                            uint16_t topicLength,
+                                            uint16_t * pConsumedTopicLength,
+                                            uint8_t * pThingNameLength,
+                                            uint32_t * pThingNameHash );
+
+    /**
+     * @brief Extract the classic shadow root OR the named shadow root and shadow name from a topic string.
+     *
+     * @param[in] pTopic Pointer to the topic string.
+     * @param[in] topicLength Length of pTopic.
+     * @param[in,out] pConsumedTopicLength Pointer to caller-supplied memory for returning the consumed topic length.
+     * @param[out] pShadowNameLength Pointer to caller-supplied memory for returning the shadow name length.
+     * @param[in,out] pShadowNameHash NULL, or the hash to update with the shadow name.
+     *
+     * @return Return SHADOW_SUCCESS if successfully extracted;
+     *         return SHADOW_ROOT_PARSE_FAILED shadow root parsing fails.
+     *         return SHADOW_SHADOWNAME_PARSE_FAILED shadow name parsing fails.
+     */
+    static ShadowStatus_t extractShadowRootAndName( const char * pTopic,
+                                                    uint16_t topicLength,
+                                                    uint16_t * pConsumedTopicLength,
+                                                    uint8_t * pShadowNameLength,
+                                                    uint32_t * pShadowNameHash );
+
+#endif /* if ( SHADOW_SINGLE_PASS_MATCH != 1 ) */
 
 /**
- * @brief Get the shadow operation string length for a given shadow topic type.
+ * @brief Parse a topic string into the lengths of its names and its message type.
+ *
+ * @param[in] pTopic Pointer to the topic string. Must start with #SHADOW_PREFIX.
+ * @param[in] topicLength Length of pTopic. Must not be less than #SHADOW_PREFIX_LENGTH.
+ * @param[out] pThingNameLength Pointer to caller-supplied memory for returning the Thing name length.
+ * @param[out] pShadowNameLength Pointer to caller-supplied memory for returning the Shadow name length.
+ * @param[out] pMessageType Pointer to caller-supplied memory for returning the type of the shadow message.
+ * @param[in,out] pHash NULL, or the hashes to update with the names.
  *
- * @param[in] topicType The given shadow topic type.
+ * @return Return SHADOW_SUCCESS if the topic is a Shadow topic;
+ *         otherwise the error code of the part of the topic that failed to parse.
+ */
+static ShadowStatus_t parseTopic( const char * pTopic,
+                                  uint16_t topicLength,
+                                  uint8_t * pThingNameLength,
+                                  uint8_t * pShadowNameLength,
+                                  ShadowMessageType_t * pMessageType,
+                                  ShadowTopicHash_t * pHash );
+
+#ifdef SHADOW_FIXED_THING_NAME
+
+/**
+ * @brief Parse a topic string of #SHADOW_FIXED_THING_NAME with one comparison of
+ * the Thing name and classic shadow root, or any other topic string with
+ * parseTopic().
  *
- * @return The shadow operation string length for the given shadow type.
+ * The parameters and return value are those of parseTopic().
  */
-static uint16_t getShadowOperationLength( ShadowTopicStringType_t topicType );
+    static ShadowStatus_t parseFixedThingTopic( const char * pTopic,
+                                                uint16_t topicLength,
+                                                uint8_t * pThingNameLength,
+                                                uint8_t * pShadowNameLength,
+                                                ShadowMessageType_t * pMessageType,
+                                                ShadowTopicHash_t * pHash );
+#endif /* ifdef SHADOW_FIXED_THING_NAME */
 
 /**
  * @brief Creates a shadow topic string
@@ -278,175 +711,396 @@ static void createShadowTopicString( ShadowTopicStringType_t topicType,
                                      uint8_t shadowNameLength,
                                      char * pTopicBuffer );
 
-/*-----------------------------------------------------------*/
+/**
+ * @brief Check if a topic is written at the same offset as the next topic type,
+ * because the next topic starts with it.
+ *
+ * @param[in] topicType The topic type.
+ * @param[in] topicTypeMask The topic types being assembled.
+ *
+ * @return true if topicType is a request topic and the "accepted" topic of the
+ * same operation is also being assembled; false otherwise.
+ */
+static bool isTopicSharedWithNext( ShadowTopicStringType_t topicType,
+                                   uint16_t topicTypeMask );
 
-static ShadowStatus_t validateMatchTopicParameters( const char * pTopic,
-                                                    uint16_t topicLength,
-                                                    const ShadowMessageType_t * pMessageType )
-{
-    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+/**
+ * @brief Count the topic types selected by a topic type mask.
+ *
+ * @param[in] topicTypeMask The topic types being assembled.
+ *
+ * @return The number of topic types in topicTypeMask.
+ */
+static uint32_t countTopicTypes( uint16_t topicTypeMask );
 
-    if( ( pTopic == NULL ) ||
-        ( topicLength == 0U ) ||
-        ( pMessageType == NULL ) )
-    {
-        shadowStatus = SHADOW_BAD_PARAMETER;
-        LogError( ( "Invalid input parameters pTopic: %p, topicLength: %u, pMessageType: %p.",
-                    ( const void * ) pTopic,
-                    ( unsigned int ) topicLength,
-                    ( const void * ) pMessageType ) );
-    }
+/**
+ * @brief Get the number of bytes needed for the topics of one shadow.
+ *
+ * @param[in] pNames The Thing and Shadow names of the shadow.
+ * @param[in] topicTypeMask The topic types being assembled.
+ *
+ * @return The number of bytes needed for the topic strings.
+ */
+static uint32_t getShadowTopicsLength( const ShadowNames_t * pNames,
+                                       uint16_t topicTypeMask );
 
-    return shadowStatus;
-}
+/**
+ * @brief Write the topics of one shadow into a buffer whose size has already
+ * been checked.
+ *
+ * @param[in] pNames The Thing and Shadow names of the shadow.
+ * @param[in] topicTypeMask The topic types to assemble.
+ * @param[out] pTopicBuffer The buffer for the topic strings.
+ * @param[in] offset The offset in pTopicBuffer to write the first topic string at.
+ * @param[out] pTopicSpans One entry per topic type in topicTypeMask, for
+ * returning the position of each topic string.
+ *
+ * @return The offset in pTopicBuffer after the last topic string written.
+ */
+static uint32_t assembleShadowTopics( const ShadowNames_t * pNames,
+                                      uint16_t topicTypeMask,
+                                      char * pTopicBuffer,
+                                      uint32_t offset,
+                                      ShadowTopicSpan_t * pTopicSpans );
 
-/*-----------------------------------------------------------*/
+/**
+ * @brief Get the operation parts of the topic filters that cover the topic types
+ * of a topic type mask.
+ *
+ * Topic types that together make up all the topics of a topic level are
+ * replaced with a single-level wildcard: "/+/+" for every response topic,
+ * "/+" for every request topic, and "/<operation>/+" for every response of
+ * one operation.
+ *
+ * @param[in] topicTypeMask The topic types to cover.
+ * @param[out] pOperations Array of #ShadowTopicStringTypeMaxNum entries for
+ * returning the operation parts.
+ *
+ * @return The number of operation parts.
+ */
+static uint16_t getFilterOperations( uint16_t topicTypeMask,
+                                     WildcardFilterOperation_t * pOperations );
 
-static ShadowStatus_t validateAssembleTopicParameters( ShadowTopicStringType_t topicType,
-                                                       const char * pThingName,
-                                                       uint8_t thingNameLength,
-                                                       const char * pShadowName,
-                                                       uint8_t shadowNameLength,
-                                                       const char * pTopicBuffer,
-                                                       const uint16_t * pOutLength )
-{
-    ShadowStatus_t shadowStatus = SHADOW_BAD_PARAMETER;
+/**
+ * @brief Compare two Thing names, or two Shadow names, for sorting. Shorter
+ * names come first, and names of the same length are in the order of memcmp().
+ *
+ * @param[in] pName The first name.
+ * @param[in] nameLength Length of pName.
+ * @param[in] pOtherName The second name.
+ * @param[in] otherNameLength Length of pOtherName.
+ *
+ * @return Zero if the names are the same; less than zero if pName comes first;
+ * greater than zero if pOtherName comes first.
+ */
+static int32_t compareNames( const char * pName,
+                             uint8_t nameLength,
+                             const char * pOtherName,
+                             uint8_t otherNameLength );
 
-    if( ( pTopicBuffer == NULL ) ||
-        ( pThingName == NULL ) ||
-        ( thingNameLength == 0U ) ||
-        ( ( pShadowName == NULL ) && ( shadowNameLength > 0U ) ) ||
-        ( topicType >= ShadowTopicStringTypeMaxNum ) ||
-        ( pOutLength == NULL ) )
-    {
-        LogError( ( "Invalid input parameters pTopicBuffer: %p, pThingName: %p, thingNameLength: %u,\
-                    pShadowName: %p, shadowNameLength: %u, topicType: %d, pOutLength: %p.",
-                    ( const void * ) pTopicBuffer,
-                    ( const void * ) pThingName,
-                    ( unsigned int ) thingNameLength,
-                    ( const void * ) pShadowName,
-                    ( unsigned int ) shadowNameLength,
-                    ( int ) topicType,
-                    ( const void * ) pOutLength ) );
-    }
-    else if( thingNameLength > SHADOW_THINGNAME_MAX_LENGTH )
-    {
-        LogError( ( "Invalid thingNamelength. Thing name length of %u exceeds maximum allowed length %u.",
-                    ( unsigned int ) thingNameLength,
-                    ( unsigned int ) SHADOW_THINGNAME_MAX_LENGTH ) );
-    }
-    else if( shadowNameLength > SHADOW_NAME_MAX_LENGTH )
-    {
-        LogError( ( "Invalid shadowNameLength. Shadow name length of %u exceeds maximum allowed length %u.",
-                    ( unsigned int ) shadowNameLength,
-                    ( unsigned int ) SHADOW_NAME_MAX_LENGTH ) );
-    }
-    else
-    {
-        /* Validations passed .*/
-        shadowStatus = SHADOW_SUCCESS;
-    }
+/**
+ * @brief Compare the shadows of two scratch entries of
+ * Shadow_AssembleWildcardFilters(), for sorting.
+ *
+ * @param[in] pNames Array of the names of the shadows.
+ * @param[in] pEntry The first entry.
+ * @param[in] pOtherEntry The second entry.
+ * @param[in] order What to compare the shadows by.
+ *
+ * @return Zero if the shadows are the same in that order; less than zero if
+ * pEntry comes first; greater than zero if pOtherEntry comes first.
+ */
+static int32_t compareWildcardEntries( const ShadowNames_t * pNames,
+                                       const ShadowWildcardEntry_t * pEntry,
+                                       const ShadowWildcardEntry_t * pOtherEntry,
+                                       WildcardOrder_t order );
 
-    return shadowStatus;
-}
+/**
+ * @brief Move an entry down a heap of scratch entries of
+ * Shadow_AssembleWildcardFilters() until it is not less than its children.
+ *
+ * @param[in] pNames Array of the names of the shadows.
+ * @param[in,out] pEntries The heap.
+ * @param[in] rootIndex Index of the entry to move down.
+ * @param[in] entryCount Number of entries in the heap.
+ * @param[in] order The order of the heap.
+ */
+static void siftDownWildcardEntries( const ShadowNames_t * pNames,
+                                     ShadowWildcardEntry_t * pEntries,
+                                     uint32_t rootIndex,
+                                     uint32_t entryCount,
+                                     WildcardOrder_t order );
 
-/*-----------------------------------------------------------*/
+/**
+ * @brief Sort scratch entries of Shadow_AssembleWildcardFilters() in place
+ * with a heap sort, which needs no other memory and takes a number of steps
+ * proportional to entryCount times its logarithm.
+ *
+ * @param[in] pNames Array of the names of the shadows.
+ * @param[in,out] pEntries The entries to sort.
+ * @param[in] entryCount Number of entries. Must not be zero.
+ * @param[in] order The order to sort the entries in.
+ */
+static void sortWildcardEntries( const ShadowNames_t * pNames,
+                                 ShadowWildcardEntry_t * pEntries,
+                                 uint32_t entryCount,
+                                 WildcardOrder_t order );
 
-static ShadowStatus_t containsSubString( const char * pString,
-                                         uint16_t stringLength,
-                                         const char * pSubString,
-                                         uint16_t subStringLength )
-{
-    ShadowStatus_t returnStatus = SHADOW_FAIL;
+/**
+ * @brief Find the end of a group of sorted scratch entries of
+ * Shadow_AssembleWildcardFilters() that are the same in an order.
+ *
+ * @param[in] pNames Array of the names of the shadows.
+ * @param[in] pEntries The sorted entries.
+ * @param[in] start Index of the first entry of the group.
+ * @param[in] entryCount Number of entries. Must be more than start.
+ * @param[in] order The order that the entries are sorted in.
+ *
+ * @return Index of the first entry after the group, or entryCount.
+ */
+static uint32_t findWildcardGroupEnd( const ShadowNames_t * pNames,
+                                      const ShadowWildcardEntry_t * pEntries,
+                                      uint32_t start,
+                                      uint32_t entryCount,
+                                      WildcardOrder_t order );
 
-    /* The string must be at least as long as the substring to contain it
-     * completely. */
-    if( stringLength >= subStringLength )
-    {
-        /* We are only checking up to subStringLength characters in the original
-        * string. The string may be longer and contain additional characters. */
-        if( strncmp( pString, pSubString, ( size_t ) subStringLength ) == 0 )
-        {
-            returnStatus = SHADOW_SUCCESS;
-        }
-    }
+/**
+ * @brief Group the shadows by the topic filters that cover them.
+ *
+ * Sets the flags of the scratch entry of each shadow: which of its names is
+ * replaced with a wildcard in its topic filters, and whether it is the first
+ * shadow that its topic filters cover. The entries are left in the order of
+ * the shadows, so that the entry of pNames[ i ] is pEntries[ i ].
+ *
+ * @param[in] pNames Array of the names of the shadows.
+ * @param[out] pEntries Array of nameCount scratch entries.
+ * @param[in] nameCount Number of entries in pNames. Must not be zero.
+ */
+static void groupWildcardEntries( const ShadowNames_t * pNames,
+                                  ShadowWildcardEntry_t * pEntries,
+                                  uint32_t nameCount );
 
-    return returnStatus;
-}
+/**
+ * @brief Get the names of the topic filters that cover a shadow, with a
+ * single-level wildcard in place of the Thing name or the Shadow name shared
+ * with other shadows.
+ *
+ * @param[in] pNames The names of the shadow.
+ * @param[in] pEntry The scratch entry of the shadow, grouped with
+ * groupWildcardEntries().
+ * @param[out] pFilterNames The names of the topic filters.
+ */
+static void getWildcardNames( const ShadowNames_t * pNames,
+                              const ShadowWildcardEntry_t * pEntry,
+                              ShadowNames_t * pFilterNames );
+
+/**
+ * @brief Get the length of a topic filter.
+ *
+ * @param[in] pFilterNames The names of the topic filter.
+ * @param[in] pOperation The operation part of the topic filter.
+ *
+ * @return The length of the topic filter.
+ */
+static uint16_t getWildcardFilterLength( const ShadowNames_t * pFilterNames,
+                                         const WildcardFilterOperation_t * pOperation );
+
+/**
+ * @brief Write a topic filter into a buffer whose size has already been checked.
+ *
+ * @param[in] pFilterNames The names of the topic filter.
+ * @param[in] pOperation The operation part of the topic filter.
+ * @param[out] pFilterBuffer The buffer for the topic filter.
+ */
+static void writeWildcardFilter( const ShadowNames_t * pFilterNames,
+                                 const WildcardFilterOperation_t * pOperation,
+                                 char * pFilterBuffer );
+
+/**
+ * @brief Check if a topic matches an MQTT topic filter.
+ *
+ * @param[in] pFilter The topic filter, which may hold '+' and '#' wildcards.
+ * @param[in] filterLength Length of the topic filter.
+ * @param[in] pTopic The topic string.
+ * @param[in] topicLength Length of the topic string. Must not be zero.
+ *
+ * @return true if the topic matches the topic filter; false if not.
+ */
+static bool matchTopicFilter( const char * pFilter,
+                              uint16_t filterLength,
+                              const char * pTopic,
+                              uint16_t topicLength );
+
+/**
+ * @brief Get the hash that a topic or topic filter is indexed under in a
+ * #ShadowFilterIndex_t: the hash of its Thing name level if it starts with
+ * #SHADOW_PREFIX and a Thing name, or else the hash of the '+' wildcard.
+ *
+ * @param[in] pString The topic or topic filter.
+ * @param[in] length Length of pString.
+ *
+ * @return The hash.
+ */
+static uint32_t hashThingLevel( const char * pString,
+                                uint16_t length );
+
+/**
+ * @brief Find the first topic filter indexed under a hash that a topic
+ * matches, by walking the slots from the one that the hash selects up to an
+ * empty slot.
+ *
+ * @param[in] pIndex The index.
+ * @param[in] hash The hash.
+ * @param[in] pTopic The topic string.
+ * @param[in] topicLength Length of the topic string. Must not be zero.
+ * @param[in] firstIndex Index of the first topic filter found so far, or
+ * #SHADOW_FILTER_SLOT_EMPTY if there is none.
+ *
+ * @return The index of the first topic filter that matches, if it is before
+ * firstIndex; firstIndex otherwise.
+ */
+static uint32_t matchIndexedFilters( const ShadowFilterIndex_t * pIndex,
+                                     uint32_t hash,
+                                     const char * pTopic,
+                                     uint16_t topicLength,
+                                     uint32_t firstIndex );
+
+/**
+ * @brief Get the number of bytes needed for the MQTT SUBSCRIBE or UNSUBSCRIBE
+ * payload entries of the topics of one shadow.
+ *
+ * @param[in] pNames The Thing and Shadow names of the shadow.
+ * @param[in] topicTypeMask The topic types being serialized.
+ * @param[in] entryOverhead The number of bytes added to each topic string.
+ *
+ * @return The number of bytes needed for the payload entries.
+ */
+static uint32_t getPayloadLength( const ShadowNames_t * pNames,
+                                  uint16_t topicTypeMask,
+                                  uint32_t entryOverhead );
+
+/**
+ * @brief Write the MQTT SUBSCRIBE or UNSUBSCRIBE payload entries of the topics
+ * of one shadow into a buffer whose size has already been checked.
+ *
+ * @param[in] pNames The Thing and Shadow names of the shadow.
+ * @param[in] topicTypeMask The topic types to serialize.
+ * @param[in] hasOptions true to follow each topic string with the options byte.
+ * @param[in] options The subscription options byte.
+ * @param[out] pBuffer The buffer for the payload.
+ * @param[in] offset The offset in pBuffer to write the first entry at.
+ *
+ * @return The offset in pBuffer after the last entry written.
+ */
+static uint32_t serializeShadowTopics( const ShadowNames_t * pNames,
+                                       uint16_t topicTypeMask,
+                                       bool hasOptions,
+                                       uint8_t options,
+                                       uint8_t * pBuffer,
+                                       uint32_t offset );
+
+/**
+ * @brief Serialize the topic strings of many shadows into an MQTT SUBSCRIBE
+ * or UNSUBSCRIBE payload.
+ *
+ * @param[in] pNames Array of the Thing and Shadow names of the shadows.
+ * @param[in] nameCount Number of entries in pNames.
+ * @param[in] topicTypeMask The topic types to serialize for each shadow.
+ * @param[in] hasOptions true for a SUBSCRIBE payload, false for an UNSUBSCRIBE payload.
+ * @param[in] options The subscription options byte of a SUBSCRIBE payload.
+ * @param[out] pBuffer The buffer for the payload.
+ * @param[in] bufferSize Length of pBuffer.
+ * @param[out] pOutLength Pointer to caller-supplied memory for returning the
+ * number of bytes written, or needed.
+ *
+ * @return #SHADOW_SUCCESS, #SHADOW_BAD_PARAMETER or #SHADOW_BUFFER_TOO_SMALL.
+ */
+static ShadowStatus_t serializeTopicPayload( const ShadowNames_t * pNames,
+                                             uint32_t nameCount,
+                                             uint16_t topicTypeMask,
+                                             bool hasOptions,
+                                             uint8_t options,
+                                             uint8_t * pBuffer,
+                                             uint32_t bufferSize,
+                                             uint32_t * pOutLength );
+
+/**
+ * @brief Match a topic string whose parameters have already been validated.
+ *
+ * @param[in] pTopic Pointer to the topic string. Must not be NULL.
+ * @param[in] topicLength Length of pTopic. Must not be zero.
+ * @param[out] pResult Pointer to caller-supplied memory for returning the match result.
+ * @param[out] pHash NULL, or pointer to caller-supplied memory for returning
+ * the hashes of the names.
+ *
+ * @return Return SHADOW_SUCCESS if the topic is a Shadow topic;
+ *         otherwise the error code of the part of the topic that failed to parse.
+ */
+static ShadowStatus_t matchTopic( const char * pTopic,
+                                  uint16_t topicLength,
+                                  ShadowMatchResult_t * pResult,
+                                  ShadowTopicHash_t * pHash );
+
+/**
+ * @brief Set the name offsets and lengths of the result of matching a Shadow topic.
+ *
+ * @param[out] pResult The match result.
+ * @param[in] thingNameLength Length of the Thing name.
+ * @param[in] shadowNameLength Length of the Shadow name. Zero for a Classic shadow.
+ */
+static void setResultNames( ShadowMatchResult_t * pResult,
+                            uint8_t thingNameLength,
+                            uint8_t shadowNameLength );
 
 /*-----------------------------------------------------------*/
 
-static ShadowStatus_t validateName( const char * pString,
-                                    uint16_t stringLength,
-                                    uint8_t maxAllowedLength,
-                                    uint8_t * pNameLength )
+static ShadowStatus_t validateMatchTopicParameters( const char * pTopic,
+                                                    uint16_t topicLength,
+                                                    const ShadowMessageType_t * pMessageType )
 {
-    uint16_t index = 0U;
-    ShadowStatus_t returnStatus = SHADOW_FAIL;
-    uint8_t parsedName = 0U;
-
-    for( ; index < stringLength; index++ )
-    {
-        /* The name should always be terminated by a forward slash */
-        if( pString[ index ] == ( char ) '/' )
-        {
-            parsedName = 1U;
-            break;
-        }
-    }
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
 
-    if( parsedName == 1U )
-    {
-        if( index == 0U )
-        {
-            LogDebug( ( "Not a Shadow topic. Unable to find a %s name in the topic.",
-                        ( maxAllowedLength == SHADOW_THINGNAME_MAX_LENGTH ) ? "Thing" : "Shadow" ) );
-        }
-        else if( index > maxAllowedLength )
-        {
-            LogDebug( ( "Not a Shadow topic. Extracted %s name length of %u exceeds maximum allowed length %u.",
-                        ( maxAllowedLength == SHADOW_THINGNAME_MAX_LENGTH ) ? "Thing" : "Shadow",
-                        ( unsigned int ) index,
-                        ( unsigned int ) maxAllowedLength ) );
-        }
-        else
-        {
-            /* Only accept names of greater than zero length.
-             * The variable `index` will not exceed the 8 bit integer width here
-             * since it will be lesser than the 8 bit integer `maxAllowedLength`. */
-            *pNameLength = ( uint8_t ) index;
-            returnStatus = SHADOW_SUCCESS;
-        }
-    }
-    else
+    if( ( pTopic == NULL ) ||
+        ( topicLength == 0U ) ||
+        ( pMessageType == NULL ) )
     {
-        LogDebug( ( "Not a Shadow topic. Unable to find a %s name in the topic.",
-                    ( maxAllowedLength == SHADOW_THINGNAME_MAX_LENGTH ) ? "Thing" : "Shadow" ) );
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pTopic: %p, topicLength: %u, pMessageType: %p.",
+                    ( const void * ) pTopic,
+                    ( unsigned int ) topicLength,
+                    ( const void * ) pMessageType ) );
     }
 
-    return returnStatus;
+    return shadowStatus;
 }
 
 /*-----------------------------------------------------------*/
 
-static ShadowStatus_t extractThingName( const char * pTopic,
-                                        uint16_t topicLength,
-                                        uint16_t * pConsumedTopicLength,
-                                        uint8_t * pThingNameLength )
+static ShadowStatus_t validateAssembleTopicParameters( ShadowTopicStringType_t topicType,
+                                                       const char * pThingName,
+                                                       uint8_t thingNameLength,
+                                                       const char * pShadowName,
+                                                       uint8_t shadowNameLength,
+                                                       const char * pTopicBuffer,
+                                                       const uint16_t * pOutLength )
 {
-    /* Extract thing name. */
-    ShadowStatus_t shadowStatus = validateName( &( pTopic[ *pConsumedTopicLength ] ),
-                                                topicLength - *pConsumedTopicLength,
-                                                SHADOW_THINGNAME_MAX_LENGTH,
-                                                pThingNameLength );
+    ShadowStatus_t shadowStatus = SHADOW_BAD_PARAMETER;
 
-    if( shadowStatus != SHADOW_SUCCESS )
+    if( ( pTopicBuffer == NULL ) ||
+        ( topicType >= ShadowTopicStringTypeMaxNum ) ||
+        ( pOutLength == NULL ) )
     {
-        shadowStatus = SHADOW_THINGNAME_PARSE_FAILED;
+        LogError( ( "Invalid input parameters pTopicBuffer: %p, topicType: %d, pOutLength: %p.",
+                    ( const void * ) pTopicBuffer,
+                    ( int ) topicType,
+                    ( const void * ) pOutLength ) );
     }
     else
     {
-        *pConsumedTopicLength += *pThingNameLength;
+        shadowStatus = validateTopicNames( pThingName,
+                                           thingNameLength,
+                                           pShadowName,
+                                           shadowNameLength );
     }
 
     return shadowStatus;
@@ -454,54 +1108,39 @@ static ShadowStatus_t extractThingName( const char * pTopic,
 
 /*-----------------------------------------------------------*/
 
-static ShadowStatus_t extractShadowRootAndName( const char * pTopic,
-                                                uint16_t topicLength,
-                                                uint16_t * pConsumedTopicLength,
-                                                uint8_t * pShadowNameLength )
+static ShadowStatus_t validateTopicNames( const char * pThingName,
+                                          uint8_t thingNameLength,
+                                          const char * pShadowName,
+                                          uint8_t shadowNameLength )
 {
-    /* Look for the named shadow root */
-    ShadowStatus_t shadowStatus = containsSubString( &( pTopic[ *pConsumedTopicLength ] ),
-                                                     topicLength - *pConsumedTopicLength,
-                                                     SHADOW_NAMED_ROOT,
-                                                     SHADOW_NAMED_ROOT_LENGTH );
+    ShadowStatus_t shadowStatus = SHADOW_BAD_PARAMETER;
 
-    if( shadowStatus == SHADOW_SUCCESS )
+    if( ( pThingName == NULL ) ||
+        ( thingNameLength == 0U ) ||
+        ( ( pShadowName == NULL ) && ( shadowNameLength > 0U ) ) )
     {
-        /* Topic is a named shadow */
-        *pConsumedTopicLength += SHADOW_NAMED_ROOT_LENGTH;
-
-        /* Extract shadow name. */
-        shadowStatus = validateName( &( pTopic[ *pConsumedTopicLength ] ),
-                                     topicLength - *pConsumedTopicLength,
-                                     SHADOW_NAME_MAX_LENGTH,
-                                     pShadowNameLength );
-
-        if( shadowStatus != SHADOW_SUCCESS )
-        {
-            shadowStatus = SHADOW_SHADOWNAME_PARSE_FAILED;
-        }
-        else
-        {
-            *pConsumedTopicLength += *pShadowNameLength;
-        }
+        LogError( ( "Invalid input parameters pThingName: %p, thingNameLength: %u, pShadowName: %p, shadowNameLength: %u.",
+                    ( const void * ) pThingName,
+                    ( unsigned int ) thingNameLength,
+                    ( const void * ) pShadowName,
+                    ( unsigned int ) shadowNameLength ) );
+    }
+    else if( thingNameLength > SHADOW_THINGNAME_MAX_LENGTH )
+    {
+        LogError( ( "Invalid thingNamelength. Thing name length of %u exceeds maximum allowed length %u.",
+                    ( unsigned int ) thingNameLength,
+                    ( unsigned int ) SHADOW_THINGNAME_MAX_LENGTH ) );
+    }
+    else if( shadowNameLength > SHADOW_NAME_MAX_LENGTH )
+    {
+        LogError( ( "Invalid shadowNameLength. Shadow name length of %u exceeds maximum allowed length %u.",
+                    ( unsigned int ) shadowNameLength,
+                    ( unsigned int ) SHADOW_NAME_MAX_LENGTH ) );
     }
     else
     {
-        /* Not a named shadow. Try to match the classic shadow root. */
-        shadowStatus = containsSubString( &( pTopic[ *pConsumedTopicLength ] ),
-                                          topicLength - *pConsumedTopicLength,
-                                          SHADOW_CLASSIC_ROOT,
-                                          SHADOW_CLASSIC_ROOT_LENGTH );
-
-        if( shadowStatus == SHADOW_SUCCESS )
-        {
-            *pConsumedTopicLength += SHADOW_CLASSIC_ROOT_LENGTH;
-        }
-        else
-        {
-            shadowStatus = SHADOW_ROOT_PARSE_FAILED;
-            LogDebug( ( "Not a Shadow topic. Failed to parse shadow root in pTopic %.*s", topicLength, pTopic ) );
-        }
+        /* Validations passed .*/
+        shadowStatus = SHADOW_SUCCESS;
     }
 
     return shadowStatus;
@@ -509,256 +1148,2044 @@ static ShadowStatus_t extractShadowRootAndName( const char * pTopic,
 
 /*-----------------------------------------------------------*/
 
-static ShadowStatus_t extractShadowMessageType( const char * pString,
-                                                uint16_t stringLength,
-                                                ShadowMessageType_t * pMessageType )
+static ShadowStatus_t matchPrefixWords( const char * pTopic,
+                                        uint16_t topicLength )
 {
-    uint32_t index = 0U;
     ShadowStatus_t returnStatus = SHADOW_FAIL;
-
-    /* Lookup table for Shadow message string. */
-    static const char * const pMessageStrings[ ShadowMessageTypeMaxNum ] =
-    {
-        SHADOW_OP_GET_ACCEPTED,
-        SHADOW_OP_GET_REJECTED,
-        SHADOW_OP_DELETE_ACCEPTED,
-        SHADOW_OP_DELETE_REJECTED,
-        SHADOW_OP_UPDATE_ACCEPTED,
-        SHADOW_OP_UPDATE_REJECTED,
-        SHADOW_OP_UPDATE_DOCUMENTS,
-        SHADOW_OP_UPDATE_DELTA
-    };
-
-    /* Lookup table for Shadow message string length. */
-    static const uint16_t pMessageStringsLength[ ShadowMessageTypeMaxNum ] =
-    {
-        SHADOW_OP_GET_ACCEPTED_LENGTH,
-        SHADOW_OP_GET_REJECTED_LENGTH,
-        SHADOW_OP_DELETE_ACCEPTED_LENGTH,
-        SHADOW_OP_DELETE_REJECTED_LENGTH,
-        SHADOW_OP_UPDATE_ACCEPTED_LENGTH,
-        SHADOW_OP_UPDATE_REJECTED_LENGTH,
-        SHADOW_OP_UPDATE_DOCUMENTS_LENGTH,
-        SHADOW_OP_UPDATE_DELTA_LENGTH
-    };
-
-    /* Lookup table for Shadow message types. */
-    static const ShadowMessageType_t pMessageTypes[ ShadowMessageTypeMaxNum ] =
-    {
-        ShadowMessageTypeGetAccepted,
-        ShadowMessageTypeGetRejected,
-        ShadowMessageTypeDeleteAccepted,
-        ShadowMessageTypeDeleteRejected,
-        ShadowMessageTypeUpdateAccepted,
-        ShadowMessageTypeUpdateRejected,
-        ShadowMessageTypeUpdateDocuments,
-        ShadowMessageTypeUpdateDelta
-    };
-
-    for( ; index < ( uint32_t ) ( sizeof( pMessageStrings ) / sizeof( pMessageStrings[ 0 ] ) ); index++ )
-    {
-        returnStatus = containsSubString( pString,
-                                          stringLength,
-                                          pMessageStrings[ index ],
-                                          pMessageStringsLength[ index ] );
-
-        /* If the operation string matches, there must not be any other extra
-         * character remaining in the string. */
-        if( returnStatus == SHADOW_SUCCESS )
+    uint64_t topicWord = 0U;
+    uint64_t prefixWord = 0U;
+    uint32_t topicTail = 0U;
+    uint32_t prefixTail = 0U;
+
+    /* SHADOW_PREFIX is 12 characters long: "$aws/thi" fills the 64-bit word
+     * and "ngs/" the 32-bit word. The prefix is copied into words the same way
+     * as the topic so that the comparison does not depend on byte order. The
+     * copies also allow pTopic to be unaligned. */
+    if( topicLength >= SHADOW_PREFIX_LENGTH )
+    {
+        ( void ) memcpy( ( void * ) &topicWord, ( const void * ) pTopic, sizeof( topicWord ) );
+        ( void ) memcpy( ( void * ) &prefixWord, ( const void * ) SHADOW_PREFIX, sizeof( prefixWord ) );
+        ( void ) memcpy( ( void * ) &topicTail,
+                         ( const void * ) &( pTopic[ sizeof( topicWord ) ] ),
+                         sizeof( topicTail ) );
+        ( void ) memcpy( ( void * ) &prefixTail,
+                         ( const void * ) &( SHADOW_PREFIX[ sizeof( prefixWord ) ] ),
+                         sizeof( prefixTail ) );
+
+        if( ( topicWord == prefixWord ) && ( topicTail == prefixTail ) )
         {
-            if( stringLength != pMessageStringsLength[ index ] )
-            {
-                returnStatus = SHADOW_FAIL;
-            }
-            else
-            {
-                *pMessageType = pMessageTypes[ index ];
-                break;
-            }
+            returnStatus = SHADOW_SUCCESS;
         }
     }
 
-    if( returnStatus != SHADOW_SUCCESS )
-    {
-        LogDebug( ( "Not a Shadow topic. Failed to match shadow message type in pString %.*s", stringLength, pString ) );
-    }
-
     return returnStatus;
 }
 
 /*-----------------------------------------------------------*/
 
-static const char * getShadowOperationString( ShadowTopicStringType_t topicType )
+static uint8_t findSuffixOperation( const char * pTopic,
+                                    uint16_t topicLength )
 {
-    const char * shadowOperationString = NULL;
+    uint8_t index = ( uint8_t ) ShadowMessageTypeMaxNum;
 
-    switch( topicType )
+    /* Counting back from the end of the topic, "accepted" and "rejected"
+     * differ in their 8th character, and the verb before them is told apart
+     * by its 12th: the 'g' of "/get", the 'e' of "/delete" or the 'a' of
+     * "/update". The other suffixes end in a character of their own. */
+    switch( pTopic[ topicLength - 1U ] )
     {
-        case ShadowTopicStringTypeGet:
-            shadowOperationString = SHADOW_OP_GET;
-            break;
-
-        case ShadowTopicStringTypeGetAccepted:
-            shadowOperationString = SHADOW_OP_GET_ACCEPTED;
-            break;
-
-        case ShadowTopicStringTypeGetRejected:
-            shadowOperationString = SHADOW_OP_GET_REJECTED;
-            break;
+        case 'd':
+            index = ( pTopic[ topicLength - 8U ] == 'a' ) ?
+                    ( uint8_t ) ShadowMessageTypeGetAccepted :
+                    ( uint8_t ) ShadowMessageTypeGetRejected;
 
-        case ShadowTopicStringTypeDelete:
-            shadowOperationString = SHADOW_OP_DELETE;
-            break;
+            switch( pTopic[ topicLength - 12U ] )
+            {
+                case 'g':
+                    break;
 
-        case ShadowTopicStringTypeDeleteAccepted:
-            shadowOperationString = SHADOW_OP_DELETE_ACCEPTED;
-            break;
+                case 'e':
+                    index = ( uint8_t ) ( index + ( uint8_t ) ShadowMessageTypeDeleteAccepted );
+                    break;
 
-        case ShadowTopicStringTypeDeleteRejected:
-            shadowOperationString = SHADOW_OP_DELETE_REJECTED;
-            break;
+                case 'a':
+                    index = ( uint8_t ) ( index + ( uint8_t ) ShadowMessageTypeUpdateAccepted );
+                    break;
 
-        case ShadowTopicStringTypeUpdate:
-            shadowOperationString = SHADOW_OP_UPDATE;
-            break;
+                default:
+                    index = ( uint8_t ) ShadowMessageTypeMaxNum;
+                    break;
+            }
 
-        case ShadowTopicStringTypeUpdateAccepted:
-            shadowOperationString = SHADOW_OP_UPDATE_ACCEPTED;
             break;
 
-        case ShadowTopicStringTypeUpdateRejected:
-            shadowOperationString = SHADOW_OP_UPDATE_REJECTED;
+        case 's':
+            index = ( uint8_t ) ShadowMessageTypeUpdateDocuments;
             break;
 
-        case ShadowTopicStringTypeUpdateDocuments:
-            shadowOperationString = SHADOW_OP_UPDATE_DOCUMENTS;
+        case 'a':
+            index = ( uint8_t ) ShadowMessageTypeUpdateDelta;
             break;
 
-        case ShadowTopicStringTypeUpdateDelta:
-        /* topicType >= ShadowTopicStringTypeMaxNum check is covered at entry of Shadow_AssembleTopicString. */
         default:
-            shadowOperationString = SHADOW_OP_UPDATE_DELTA;
+            /* Not the end of an operation string. */
             break;
     }
 
-    return shadowOperationString;
+    return index;
 }
 
 /*-----------------------------------------------------------*/
 
-static uint16_t getShadowOperationLength( ShadowTopicStringType_t topicType )
+static bool isShadowRootBefore( const char * pTopic,
+                                uint16_t operationStart )
 {
-    uint16_t shadowOperationLength = 0U;
+    bool isRoot = false;
+    uint16_t nameStart = operationStart;
+    const uint16_t nameStartMin = ( uint16_t ) ( SHADOW_PREFIX_LENGTH + 1U + SHADOW_NAMED_ROOT_LENGTH );
 
-    switch( topicType )
+    if( memcmp( ( const void * ) &( pTopic[ operationStart - SHADOW_CLASSIC_ROOT_LENGTH ] ),
+                ( const void * ) SHADOW_CLASSIC_ROOT,
+                ( size_t ) SHADOW_CLASSIC_ROOT_LENGTH ) == 0 )
     {
-        case ShadowTopicStringTypeGet:
-            shadowOperationLength = SHADOW_OP_GET_LENGTH;
-            break;
+        isRoot = true;
+    }
+    else if( operationStart > nameStartMin )
+    {
+        /* Walk back over the Shadow name, which cannot be longer than
+         * SHADOW_NAME_MAX_LENGTH, to the named shadow root before it. The
+         * Thing name before the root must not be empty. */
+        while( ( nameStart > nameStartMin ) &&
+               ( ( uint16_t ) ( operationStart - nameStart ) < SHADOW_NAME_MAX_LENGTH ) &&
+               ( pTopic[ nameStart - 1U ] != '/' ) )
+        {
+            nameStart--;
+        }
 
-        case ShadowTopicStringTypeGetAccepted:
-            shadowOperationLength = SHADOW_OP_GET_ACCEPTED_LENGTH;
-            break;
+        if( ( nameStart < operationStart ) &&
+            ( memcmp( ( const void * ) &( pTopic[ nameStart - SHADOW_NAMED_ROOT_LENGTH ] ),
+                      ( const void * ) SHADOW_NAMED_ROOT,
+                      ( size_t ) SHADOW_NAMED_ROOT_LENGTH ) == 0 ) )
+        {
+            isRoot = true;
+        }
+    }
+    else
+    {
+        /* Too short for a named shadow root. */
+    }
 
-        case ShadowTopicStringTypeGetRejected:
-            shadowOperationLength = SHADOW_OP_GET_REJECTED_LENGTH;
-            break;
+    return isRoot;
+}
 
-        case ShadowTopicStringTypeDelete:
-            shadowOperationLength = SHADOW_OP_DELETE_LENGTH;
-            break;
+/*-----------------------------------------------------------*/
 
-        case ShadowTopicStringTypeDeleteAccepted:
-            shadowOperationLength = SHADOW_OP_DELETE_ACCEPTED_LENGTH;
-            break;
+static uint16_t findNameEnd( const char * pString,
+                             uint16_t stringLength )
+{
+    uint16_t index = 0U;
 
-        case ShadowTopicStringTypeDeleteRejected:
-            shadowOperationLength = SHADOW_OP_DELETE_REJECTED_LENGTH;
-            break;
+    #if ( SHADOW_NAME_SCAN == SHADOW_NAME_SCAN_MEMCHR )
+        const char * pSlash = ( const char * ) memchr( ( const void * ) pString,
+                                                       ( int ) '/',
+                                                       ( size_t ) stringLength );
+
+        index = ( pSlash == NULL ) ? stringLength : ( uint16_t ) ( pSlash - pString );
+    #else
+        #if ( SHADOW_NAME_SCAN == SHADOW_NAME_SCAN_SWAR )
+            /* 64-bit constants are built from 32-bit halves to stay within C90. */
+            const uint64_t lowBits = ( ( ( uint64_t ) 0x01010101U ) << 32 ) | ( uint64_t ) 0x01010101U;
+            const uint64_t highBits = ( ( ( uint64_t ) 0x80808080U ) << 32 ) | ( uint64_t ) 0x80808080U;
+            const uint64_t slashes = lowBits * ( uint64_t ) '/';
+            uint64_t word = 0U;
+
+            /* Skip whole words without a forward slash. XOR with the slashes
+             * turns each forward slash into a zero byte, and a word has a zero
+             * byte if and only if ( word - lowBits ) & ~word & highBits is not
+             * zero. The word is copied so that pString need not be aligned. */
+            while( ( stringLength - index ) >= ( uint16_t ) sizeof( word ) )
+            {
+                ( void ) memcpy( ( void * ) &word,
+                                 ( const void * ) &( pString[ index ] ),
+                                 sizeof( word ) );
+                word ^= slashes;
 
-        case ShadowTopicStringTypeUpdate:
-            shadowOperationLength = SHADOW_OP_UPDATE_LENGTH;
-            break;
+                if( ( ( word - lowBits ) & ~word & highBits ) != 0U )
+                {
+                    break;
+                }
 
-        case ShadowTopicStringTypeUpdateAccepted:
-            shadowOperationLength = SHADOW_OP_UPDATE_ACCEPTED_LENGTH;
-            break;
+                index = ( uint16_t ) ( index + sizeof( word ) );
+            }
+        #endif /* if ( SHADOW_NAME_SCAN == SHADOW_NAME_SCAN_SWAR ) */
 
-        case ShadowTopicStringTypeUpdateRejected:
-            shadowOperationLength = SHADOW_OP_UPDATE_REJECTED_LENGTH;
-            break;
+        /* Find the forward slash in the remaining bytes. */
+        while( ( index < stringLength ) && ( pString[ index ] != ( char ) '/' ) )
+        {
+            index++;
+        }
+    #endif /* if ( SHADOW_NAME_SCAN == SHADOW_NAME_SCAN_MEMCHR ) */
 
-        case ShadowTopicStringTypeUpdateDocuments:
-            shadowOperationLength = SHADOW_OP_UPDATE_DOCUMENTS_LENGTH;
-            break;
+    return index;
+}
 
-        case ShadowTopicStringTypeUpdateDelta:
-        /* topicType >= ShadowTopicStringTypeMaxNum check is covered at entry of Shadow_AssembleTopicString. */
-        default:
-            shadowOperationLength = SHADOW_OP_UPDATE_DELTA_LENGTH;
-            break;
+/*-----------------------------------------------------------*/
+
+static uint16_t hashNameEnd( const char * pString,
+                             uint16_t stringLength,
+                             uint32_t * pHash )
+{
+    uint16_t index = 0U;
+    uint32_t hash = *pHash;
+
+    while( ( index < stringLength ) && ( pString[ index ] != ( char ) '/' ) )
+    {
+        hash = SHADOW_HASH_BYTE( hash, pString[ index ] );
+        index++;
     }
 
-    return shadowOperationLength;
+    *pHash = hash;
+
+    return index;
 }
 
 /*-----------------------------------------------------------*/
 
-static void createShadowTopicString( ShadowTopicStringType_t topicType,
-                                     const char * pThingName,
-                                     uint8_t thingNameLength,
-                                     const char * pShadowName,
-                                     uint8_t shadowNameLength,
-                                     char * pTopicBuffer )
+static uint32_t hashBytes( uint32_t hash,
+                           const char * pString,
+                           uint8_t length )
 {
-    uint16_t offset = 0U, operationStringLength = 0U;
-    const char * pShadowPrefix = SHADOW_PREFIX;
-    const char * pOperationString = NULL;
-    const char * pClassicShadowRoot = SHADOW_CLASSIC_ROOT;
-    const char * pNamedShadowRoot = SHADOW_NAMED_ROOT;
+    uint32_t result = hash;
+    uint8_t index = 0U;
 
-    /* Copy the Shadow topic prefix into the topic buffer. */
+    for( index = 0U; index < length; index++ )
+    {
+        result = SHADOW_HASH_BYTE( result, pString[ index ] );
+    }
+
+    return result;
+}
+
+/*-----------------------------------------------------------*/
+
+static void hashKey( ShadowTopicHash_t * pHash )
+{
+    uint32_t hash = pHash->thingNameHash;
+    uint32_t shift = 0U;
+
+    /* Continue the Thing name hash with the four bytes of the Shadow name
+     * hash, lowest byte first. This mixes the two names into one hash without
+     * reading the Shadow name again. */
+    for( shift = 0U; shift < 32U; shift += 8U )
+    {
+        hash = SHADOW_HASH_BYTE( hash, pHash->shadowNameHash >> shift );
+    }
+
+    pHash->keyHash = hash;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t matchLiteral( const char * pLiteral,
+                              uint16_t literalLength,
+                              uint16_t * pLiteralIndex,
+                              const char * pBytes,
+                              uint16_t length )
+{
+    uint16_t consumed = 0U;
+    uint16_t literalIndex = *pLiteralIndex;
+
+    while( ( consumed < length ) &&
+           ( literalIndex < literalLength ) &&
+           ( pBytes[ consumed ] == pLiteral[ literalIndex ] ) )
+    {
+        consumed++;
+        literalIndex++;
+    }
+
+    *pLiteralIndex = literalIndex;
+
+    return consumed;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint8_t findOperation( uint8_t operationIndex,
+                              uint16_t literalIndex,
+                              char nextByte )
+{
+    uint8_t index = ( uint8_t ) ( operationIndex + 1U );
+    uint8_t foundIndex = ( uint8_t ) ShadowMessageTypeMaxNum;
+
+    /* The bytes matched so far are the first literalIndex bytes of the
+     * operation at operationIndex, so any other operation sharing that
+     * prefix and continuing with nextByte is the new candidate. The
+     * candidate is always the first operation in the table with the
+     * matched prefix, so only the operations after it need checking. */
+    for( ; index < ( uint8_t ) ShadowMessageTypeMaxNum; index++ )
+    {
+        if( ( SHADOW_MESSAGE_DESCRIPTOR( index ).length > literalIndex ) &&
+            ( SHADOW_MESSAGE_DESCRIPTOR( index ).pString[ literalIndex ] == nextByte ) &&
+            ( strncmp( SHADOW_MESSAGE_DESCRIPTOR( index ).pString,
+                       SHADOW_MESSAGE_DESCRIPTOR( operationIndex ).pString,
+                       ( size_t ) literalIndex ) == 0 ) )
+        {
+            foundIndex = index;
+            break;
+        }
+    }
+
+    return foundIndex;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t matchPrefix( ShadowMatchContext_t * pContext,
+                             const char * pBytes,
+                             uint16_t length )
+{
+    uint16_t consumed = matchLiteral( SHADOW_PREFIX,
+                                      SHADOW_PREFIX_LENGTH,
+                                      &( pContext->literalIndex ),
+                                      pBytes,
+                                      length );
+
+    if( pContext->literalIndex == SHADOW_PREFIX_LENGTH )
+    {
+        pContext->state = ( uint8_t ) MatchStateThingName;
+    }
+    else if( consumed < length )
+    {
+        pContext->state = ( uint8_t ) MatchStateFailed;
+        pContext->failedStatus = SHADOW_FAIL;
+    }
+    else
+    {
+        /* The prefix continues in the next bytes. */
+    }
+
+    return consumed;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t matchName( ShadowMatchContext_t * pContext,
+                           const char * pBytes,
+                           uint16_t length )
+{
+    uint16_t consumed = 0U;
+    uint16_t scanLength = length;
+    uint16_t maxLength = SHADOW_NAME_MAX_LENGTH;
+    ShadowStatus_t failedStatus = SHADOW_SHADOWNAME_PARSE_FAILED;
+
+    if( pContext->state == ( uint8_t ) MatchStateThingName )
+    {
+        maxLength = SHADOW_THINGNAME_MAX_LENGTH;
+        failedStatus = SHADOW_THINGNAME_PARSE_FAILED;
+    }
+
+    /* A name is rejected at its first byte past maxLength, so there is
+     * no need to scan any further than that. */
+    if( scanLength > ( uint16_t ) ( ( maxLength + 1U ) - pContext->nameLength ) )
+    {
+        scanLength = ( uint16_t ) ( ( maxLength + 1U ) - pContext->nameLength );
+    }
+
+    if( pContext->pHash == NULL )
+    {
+        consumed = findNameEnd( pBytes, scanLength );
+    }
+    else if( pContext->state == ( uint8_t ) MatchStateThingName )
+    {
+        consumed = hashNameEnd( pBytes, scanLength, &( pContext->pHash->thingNameHash ) );
+    }
+    else
+    {
+        consumed = hashNameEnd( pBytes, scanLength, &( pContext->pHash->shadowNameHash ) );
+    }
+
+    pContext->nameLength = ( uint16_t ) ( pContext->nameLength + consumed );
+
+    if( consumed < scanLength )
+    {
+        /* The name is terminated by a forward slash. */
+        if( pContext->nameLength == 0U )
+        {
+            pContext->state = ( uint8_t ) MatchStateFailed;
+            pContext->failedStatus = failedStatus;
+        }
+        else
+        {
+            /* The forward slash is also the first character of the
+             * Shadow root or operation that follows the name. */
+            consumed++;
+            pContext->literalIndex = 1U;
+
+            if( pContext->state == ( uint8_t ) MatchStateThingName )
+            {
+                pContext->thingNameLength = ( uint8_t ) pContext->nameLength;
+                pContext->state = ( uint8_t ) MatchStateRoot;
+            }
+            else
+            {
+                pContext->shadowNameLength = ( uint8_t ) pContext->nameLength;
+                pContext->operationIndex = 0U;
+                pContext->state = ( uint8_t ) MatchStateOperation;
+            }
+        }
+    }
+    else if( pContext->nameLength > maxLength )
+    {
+        pContext->state = ( uint8_t ) MatchStateFailed;
+        pContext->failedStatus = failedStatus;
+    }
+    else
+    {
+        /* The name continues in the next bytes. */
+    }
+
+    return consumed;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t matchRoot( ShadowMatchContext_t * pContext,
+                           const char * pBytes,
+                           uint16_t length )
+{
+    /* The classic shadow root is a prefix of the named shadow root, so
+     * both are matched by walking the named shadow root. */
+    uint16_t consumed = matchLiteral( SHADOW_NAMED_ROOT,
+                                      SHADOW_NAMED_ROOT_LENGTH,
+                                      &( pContext->literalIndex ),
+                                      pBytes,
+                                      length );
+
+    if( pContext->literalIndex == SHADOW_NAMED_ROOT_LENGTH )
+    {
+        pContext->state = ( uint8_t ) MatchStateShadowName;
+        pContext->nameLength = 0U;
+    }
+    else if( consumed < length )
+    {
+        if( pContext->literalIndex == ( SHADOW_CLASSIC_ROOT_LENGTH + 1U ) )
+        {
+            /* Classic shadow. The forward slash after the classic shadow
+             * root is the first character of the operation. */
+            pContext->literalIndex = 1U;
+            pContext->operationIndex = 0U;
+            pContext->state = ( uint8_t ) MatchStateOperation;
+        }
+        else if( pContext->literalIndex < SHADOW_CLASSIC_ROOT_LENGTH )
+        {
+            pContext->state = ( uint8_t ) MatchStateFailed;
+            pContext->failedStatus = SHADOW_ROOT_PARSE_FAILED;
+        }
+        else
+        {
+            /* The classic shadow root matched but no operation starts
+             * with the bytes that follow it. */
+            pContext->state = ( uint8_t ) MatchStateFailed;
+            pContext->failedStatus = SHADOW_MESSAGE_TYPE_PARSE_FAILED;
+        }
+    }
+    else
+    {
+        /* The root continues in the next bytes. */
+    }
+
+    return consumed;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t matchOperation( ShadowMatchContext_t * pContext,
+                                const char * pBytes,
+                                uint16_t length )
+{
+    uint16_t consumed = 0U;
+    uint16_t literalIndex = pContext->literalIndex;
+    uint8_t operationIndex = pContext->operationIndex;
+
+    while( ( consumed < length ) && ( operationIndex < ( uint8_t ) ShadowMessageTypeMaxNum ) )
+    {
+        if( ( literalIndex >= SHADOW_MESSAGE_DESCRIPTOR( operationIndex ).length ) ||
+            ( pBytes[ consumed ] != SHADOW_MESSAGE_DESCRIPTOR( operationIndex ).pString[ literalIndex ] ) )
+        {
+            operationIndex = findOperation( operationIndex, literalIndex, pBytes[ consumed ] );
+        }
+
+        if( operationIndex < ( uint8_t ) ShadowMessageTypeMaxNum )
+        {
+            consumed++;
+            literalIndex++;
+        }
+    }
+
+    if( operationIndex < ( uint8_t ) ShadowMessageTypeMaxNum )
+    {
+        pContext->literalIndex = literalIndex;
+        pContext->operationIndex = operationIndex;
+    }
+    else
+    {
+        pContext->state = ( uint8_t ) MatchStateFailed;
+        pContext->failedStatus = SHADOW_MESSAGE_TYPE_PARSE_FAILED;
+    }
+
+    return consumed;
+}
+
+/*-----------------------------------------------------------*/
+
+static void matchTopicBytes( ShadowMatchContext_t * pContext,
+                             const char * pBytes,
+                             uint16_t length )
+{
+    uint16_t consumed = 0U;
+
+    /* Each state either consumes at least one byte or moves the parser to
+     * another state, so every byte of the topic is read once. */
+    while( ( consumed < length ) && ( pContext->state != ( uint8_t ) MatchStateFailed ) )
+    {
+        switch( pContext->state )
+        {
+            case ( uint8_t ) MatchStatePrefix:
+                consumed = ( uint16_t ) ( consumed + matchPrefix( pContext,
+                                                                  &( pBytes[ consumed ] ),
+                                                                  ( uint16_t ) ( length - consumed ) ) );
+                break;
+
+            case ( uint8_t ) MatchStateThingName:
+            case ( uint8_t ) MatchStateShadowName:
+                consumed = ( uint16_t ) ( consumed + matchName( pContext,
+                                                                &( pBytes[ consumed ] ),
+                                                                ( uint16_t ) ( length - consumed ) ) );
+                break;
+
+            case ( uint8_t ) MatchStateRoot:
+                consumed = ( uint16_t ) ( consumed + matchRoot( pContext,
+                                                                &( pBytes[ consumed ] ),
+                                                                ( uint16_t ) ( length - consumed ) ) );
+                break;
+
+            default:
+                /* MatchStateOperation. */
+                consumed = ( uint16_t ) ( consumed + matchOperation( pContext,
+                                                                     &( pBytes[ consumed ] ),
+                                                                     ( uint16_t ) ( length - consumed ) ) );
+                break;
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t finishTopic( const ShadowMatchContext_t * pContext )
+{
+    ShadowStatus_t shadowStatus = SHADOW_FAIL;
+
+    switch( pContext->state )
+    {
+        case ( uint8_t ) MatchStatePrefix:
+            /* A topic with no bytes at all is rejected like a zero topicLength. */
+            shadowStatus = ( pContext->literalIndex == 0U ) ?
+                           SHADOW_BAD_PARAMETER : SHADOW_FAIL;
+            break;
+
+        case ( uint8_t ) MatchStateThingName:
+            shadowStatus = SHADOW_THINGNAME_PARSE_FAILED;
+            break;
+
+        case ( uint8_t ) MatchStateRoot:
+            shadowStatus = ( pContext->literalIndex < SHADOW_CLASSIC_ROOT_LENGTH ) ?
+                           SHADOW_ROOT_PARSE_FAILED : SHADOW_MESSAGE_TYPE_PARSE_FAILED;
+            break;
+
+        case ( uint8_t ) MatchStateShadowName:
+            shadowStatus = SHADOW_SHADOWNAME_PARSE_FAILED;
+            break;
+
+        case ( uint8_t ) MatchStateOperation:
+            shadowStatus = ( pContext->literalIndex == SHADOW_MESSAGE_DESCRIPTOR( pContext->operationIndex ).length ) ?
+                           SHADOW_SUCCESS : SHADOW_MESSAGE_TYPE_PARSE_FAILED;
+            break;
+
+        default:
+            /* MatchStateFailed. */
+            shadowStatus = pContext->failedStatus;
+            break;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+#if ( SHADOW_SINGLE_PASS_MATCH != 1 ) || defined( SHADOW_FIXED_THING_NAME )
+
+    static ShadowStatus_t containsSubString( const char * pString,
+                                             uint16_t stringLength,
+                                             const char * pSubString,
+                                             uint16_t subStringLength )
+    {
+        ShadowStatus_t returnStatus = SHADOW_FAIL;
+
+        /* The string must be at least as long as the substring to contain it
+         * completely. */
+        if( stringLength >= subStringLength )
+        {
+            /* We are only checking up to subStringLength characters in the original
+            * string. The string may be longer and contain additional characters. */
+            if( strncmp( pString, pSubString, ( size_t ) subStringLength ) == 0 )
+            {
+                returnStatus = SHADOW_SUCCESS;
+            }
+        }
+
+        return returnStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static ShadowStatus_t validateName( const char * pString,
+                                        uint16_t stringLength,
+                                        uint8_t maxAllowedLength,
+                                        uint8_t * pNameLength,
+                                        uint32_t * pNameHash )
+    {
+        uint16_t index = 0U;
+        uint16_t scanLength = stringLength;
+        ShadowStatus_t returnStatus = SHADOW_FAIL;
+
+        /* The name should always be terminated by a forward slash. A name
+         * longer than maxAllowedLength is rejected whether or not it is
+         * terminated, so there is no need to look any further for the slash. */
+        if( scanLength > ( uint16_t ) ( maxAllowedLength + 1U ) )
+        {
+            scanLength = ( uint16_t ) ( maxAllowedLength + 1U );
+        }
+
+        if( pNameHash == NULL )
+        {
+            index = findNameEnd( pString, scanLength );
+        }
+        else
+        {
+            index = hashNameEnd( pString, scanLength, pNameHash );
+        }
+
+        if( index > maxAllowedLength )
+        {
+            LogDebug( ( "Not a Shadow topic. Extracted %s name length of at least %u exceeds maximum allowed length %u.",
+                        ( maxAllowedLength == SHADOW_THINGNAME_MAX_LENGTH ) ? "Thing" : "Shadow",
+                        ( unsigned int ) index,
+                        ( unsigned int ) maxAllowedLength ) );
+        }
+        else if( ( index == 0U ) || ( index == stringLength ) )
+        {
+            LogDebug( ( "Not a Shadow topic. Unable to find a %s name in the topic.",
+                        ( maxAllowedLength == SHADOW_THINGNAME_MAX_LENGTH ) ? "Thing" : "Shadow" ) );
+        }
+        else
+        {
+            /* Only accept names of greater than zero length.
+             * The variable `index` will not exceed the 8 bit integer width here
+             * since it will be lesser than the 8 bit integer `maxAllowedLength`. */
+            *pNameLength = ( uint8_t ) index;
+            returnStatus = SHADOW_SUCCESS;
+        }
+
+        return returnStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static ShadowStatus_t extractShadowMessageType( const char * pString,
+                                                    uint16_t stringLength,
+                                                    ShadowMessageType_t * pMessageType )
+    {
+        uint32_t index = ( uint32_t ) ShadowMessageTypeMaxNum;
+        ShadowStatus_t returnStatus = SHADOW_FAIL;
+
+        /* Operation strings with the same verb differ in the first character
+         * of their suffix, except "/update/delta" and "/update/documents" which
+         * differ in length. So the verb, the first character of the suffix and
+         * the length select the only operation string that can match, and the
+         * string is compared once against that candidate. The string must be
+         * long enough to hold the suffix of the longest verb to be checked. */
+        if( stringLength > ( SHADOW_OP_UPDATE_LENGTH + 1U ) )
+        {
+            switch( pString[ 1 ] )
+            {
+                case 'g':
+                    index = ( pString[ SHADOW_OP_GET_LENGTH + 1U ] == 'a' ) ?
+                            ( uint32_t ) ShadowMessageTypeGetAccepted :
+                            ( uint32_t ) ShadowMessageTypeGetRejected;
+                    break;
+
+                case 'd':
+                    index = ( pString[ SHADOW_OP_DELETE_LENGTH + 1U ] == 'a' ) ?
+                            ( uint32_t ) ShadowMessageTypeDeleteAccepted :
+                            ( uint32_t ) ShadowMessageTypeDeleteRejected;
+                    break;
+
+                case 'u':
+
+                    switch( pString[ SHADOW_OP_UPDATE_LENGTH + 1U ] )
+                    {
+                        case 'a':
+                            index = ( uint32_t ) ShadowMessageTypeUpdateAccepted;
+                            break;
+
+                        case 'r':
+                            index = ( uint32_t ) ShadowMessageTypeUpdateRejected;
+                            break;
+
+                        default:
+                            index = ( stringLength == SHADOW_OP_UPDATE_DOCUMENTS_LENGTH ) ?
+                                    ( uint32_t ) ShadowMessageTypeUpdateDocuments :
+                                    ( uint32_t ) ShadowMessageTypeUpdateDelta;
+                            break;
+                    }
+
+                    break;
+
+                default:
+                    /* Not an operation string. */
+                    break;
+            }
+        }
+
+        /* There must not be any other extra character remaining in the string. */
+        if( ( index < ( uint32_t ) ShadowMessageTypeMaxNum ) &&
+            ( stringLength == SHADOW_MESSAGE_DESCRIPTOR( index ).length ) )
+        {
+            returnStatus = containsSubString( pString,
+                                              stringLength,
+                                              SHADOW_MESSAGE_DESCRIPTOR( index ).pString,
+                                              SHADOW_MESSAGE_DESCRIPTOR( index ).length );
+        }
+
+        if( returnStatus == SHADOW_SUCCESS )
+        {
+            *pMessageType = SHADOW_MESSAGE_DESCRIPTOR( index ).messageType;
+        }
+
+        if( returnStatus != SHADOW_SUCCESS )
+        {
+            LogDebug( ( "Not a Shadow topic. Failed to match shadow message type in pString %.*s", stringLength, pString ) );
+        }
+
+        return returnStatus;
+    }
+
+
+#endif /* if ( SHADOW_SINGLE_PASS_MATCH != 1 ) || defined( SHADOW_FIXED_THING_NAME ) */
+/*-----------------------------------------------------------*/
+
+#if ( SHADOW_SINGLE_PASS_MATCH == 1 )
+
+    static ShadowStatus_t parseTopic( const char * pTopic,
+                                      uint16_t topicLength,
+                                      uint8_t * pThingNameLength,
+                                      uint8_t * pShadowNameLength,
+                                      ShadowMessageType_t * pMessageType,
+                                      ShadowTopicHash_t * pHash )
+    {
+        ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+        ShadowMatchContext_t context = { ( uint8_t ) MatchStateThingName, SHADOW_FAIL, 0U, 0U, 0U, 0U, 0U, NULL };
+
+        context.pHash = pHash;
+
+        /* The prefix has already been matched by matchTopic(). */
+        matchTopicBytes( &context,
+                         &( pTopic[ SHADOW_PREFIX_LENGTH ] ),
+                         ( uint16_t ) ( topicLength - SHADOW_PREFIX_LENGTH ) );
+        shadowStatus = finishTopic( &context );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            *pThingNameLength = context.thingNameLength;
+            *pShadowNameLength = context.shadowNameLength;
+            *pMessageType = SHADOW_MESSAGE_DESCRIPTOR( context.operationIndex ).messageType;
+        }
+        else
+        {
+            LogDebug( ( "Not a Shadow topic. Failed to parse pTopic %.*s with status %d.",
+                        topicLength, pTopic, ( int ) shadowStatus ) );
+        }
+
+        return shadowStatus;
+    }
+
+#else /* if ( SHADOW_SINGLE_PASS_MATCH == 1 ) */
+
+    static ShadowStatus_t extractThingName( const char * pTopic,
+                                            uint16_t topicLength,
+                                            uint16_t * pConsumedTopicLength,
+                                            uint8_t * pThingNameLength,
+                                            uint32_t * pThingNameHash )
+    {
+        /* Extract thing name. */
+        ShadowStatus_t shadowStatus = validateName( &( pTopic[ *pConsumedTopicLength ] ),
+                                                    topicLength - *pConsumedTopicLength,
+                                                    SHADOW_THINGNAME_MAX_LENGTH,
+                                                    pThingNameLength,
+                                                    pThingNameHash );
+
+        if( shadowStatus != SHADOW_SUCCESS )
+        {
+            shadowStatus = SHADOW_THINGNAME_PARSE_FAILED;
+        }
+        else
+        {
+            *pConsumedTopicLength += *pThingNameLength;
+        }
+
+        return shadowStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static ShadowStatus_t extractShadowRootAndName( const char * pTopic,
+                                                    uint16_t topicLength,
+                                                    uint16_t * pConsumedTopicLength,
+                                                    uint8_t * pShadowNameLength,
+                                                    uint32_t * pShadowNameHash )
+    {
+        /* Look for the named shadow root */
+        ShadowStatus_t shadowStatus = containsSubString( &( pTopic[ *pConsumedTopicLength ] ),
+                                                         topicLength - *pConsumedTopicLength,
+                                                         SHADOW_NAMED_ROOT,
+                                                         SHADOW_NAMED_ROOT_LENGTH );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            /* Topic is a named shadow */
+            *pConsumedTopicLength += SHADOW_NAMED_ROOT_LENGTH;
+
+            /* Extract shadow name. */
+            shadowStatus = validateName( &( pTopic[ *pConsumedTopicLength ] ),
+                                         topicLength - *pConsumedTopicLength,
+                                         SHADOW_NAME_MAX_LENGTH,
+                                         pShadowNameLength,
+                                         pShadowNameHash );
+
+            if( shadowStatus != SHADOW_SUCCESS )
+            {
+                shadowStatus = SHADOW_SHADOWNAME_PARSE_FAILED;
+            }
+            else
+            {
+                *pConsumedTopicLength += *pShadowNameLength;
+            }
+        }
+        else
+        {
+            /* Not a named shadow. Try to match the classic shadow root. */
+            shadowStatus = containsSubString( &( pTopic[ *pConsumedTopicLength ] ),
+                                              topicLength - *pConsumedTopicLength,
+                                              SHADOW_CLASSIC_ROOT,
+                                              SHADOW_CLASSIC_ROOT_LENGTH );
+
+            if( shadowStatus == SHADOW_SUCCESS )
+            {
+                *pConsumedTopicLength += SHADOW_CLASSIC_ROOT_LENGTH;
+            }
+            else
+            {
+                shadowStatus = SHADOW_ROOT_PARSE_FAILED;
+                LogDebug( ( "Not a Shadow topic. Failed to parse shadow root in pTopic %.*s", topicLength, pTopic ) );
+            }
+        }
+
+        return shadowStatus;
+    }
+
+/*-----------------------------------------------------------*/
+
+    static ShadowStatus_t parseTopic( const char * pTopic,
+                                      uint16_t topicLength,
+                                      uint8_t * pThingNameLength,
+                                      uint8_t * pShadowNameLength,
+                                      ShadowMessageType_t * pMessageType,
+                                      ShadowTopicHash_t * pHash )
+    {
+        uint16_t consumedTopicLength = SHADOW_PREFIX_LENGTH;
+        ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+        uint32_t * pThingNameHash = NULL;
+        uint32_t * pShadowNameHash = NULL;
+
+        /* A shadow topic string takes one of the two forms.
+         * Classic shadow:
+         *   $aws/things/<thingName>/shadow/<operation>
+         *   $aws/things/<thingName>/shadow/<operation>/<suffix>
+         * Named shadow:
+         *   $aws/things/<thingName>/shadow/name/<shadowName>/<operation>
+         *   $aws/things/<thingName>/shadow/name/<shadowName>/<operation>/<suffix>
+         *
+         * We need to match the following things:
+         * 1. Prefix ($aws/things), which matchTopic() has already matched.
+         * 2. Thing Name.
+         * 3. Classic shadow root (/shadow) OR Named shadow root (/shadow/name) and shadow name
+         * 4. Shadow operation and suffix.
+         */
+
+        if( pHash != NULL )
+        {
+            pThingNameHash = &( pHash->thingNameHash );
+            pShadowNameHash = &( pHash->shadowNameHash );
+        }
+
+        /* Extract thing name. */
+        shadowStatus = extractThingName( pTopic,
+                                         topicLength,
+                                         &consumedTopicLength,
+                                         pThingNameLength,
+                                         pThingNameHash );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            shadowStatus = extractShadowRootAndName( pTopic,
+                                                     topicLength,
+                                                     &consumedTopicLength,
+                                                     pShadowNameLength,
+                                                     pShadowNameHash );
+        }
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            /* Extract shadow message type. */
+            shadowStatus = extractShadowMessageType( &( pTopic[ consumedTopicLength ] ),
+                                                     topicLength - consumedTopicLength,
+                                                     pMessageType );
+
+            if( shadowStatus != SHADOW_SUCCESS )
+            {
+                shadowStatus = SHADOW_MESSAGE_TYPE_PARSE_FAILED;
+                LogDebug( ( "Not a Shadow topic. Shadow message type is not in pTopic %.*s, failed to parse shadow message type.", topicLength, pTopic ) );
+            }
+        }
+
+        return shadowStatus;
+    }
+
+#endif /* if ( SHADOW_SINGLE_PASS_MATCH == 1 ) */
+
+/*-----------------------------------------------------------*/
+
+#ifdef SHADOW_FIXED_THING_NAME
+
+    static ShadowStatus_t parseFixedThingTopic( const char * pTopic,
+                                                uint16_t topicLength,
+                                                uint8_t * pThingNameLength,
+                                                uint8_t * pShadowNameLength,
+                                                ShadowMessageType_t * pMessageType,
+                                                ShadowTopicHash_t * pHash )
+    {
+        ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+        uint16_t consumedTopicLength = ( uint16_t ) ( SHADOW_PREFIX_LENGTH + SHADOW_FIXED_THING_ROOT_LENGTH );
+        uint8_t shadowNameLength = 0U;
+        uint32_t * pShadowNameHash = NULL;
+
+        /* The prefix has already been matched by matchTopic(). */
+        if( ( topicLength >= consumedTopicLength ) &&
+            ( memcmp( ( const void * ) &( pTopic[ SHADOW_PREFIX_LENGTH ] ),
+                      ( const void * ) SHADOW_FIXED_THING_ROOT,
+                      ( size_t ) SHADOW_FIXED_THING_ROOT_LENGTH ) == 0 ) )
+        {
+            if( pHash != NULL )
+            {
+                pHash->thingNameHash = hashBytes( pHash->thingNameHash,
+                                                  SHADOW_FIXED_THING_NAME,
+                                                  SHADOW_FIXED_THING_NAME_LENGTH );
+                pShadowNameHash = &( pHash->shadowNameHash );
+            }
+
+            /* The classic shadow root is followed by "/name/" and the Shadow
+             * name for a named shadow. */
+            if( containsSubString( &( pTopic[ consumedTopicLength ] ),
+                                   ( uint16_t ) ( topicLength - consumedTopicLength ),
+                                   &( SHADOW_NAMED_ROOT[ SHADOW_CLASSIC_ROOT_LENGTH ] ),
+                                   ( uint16_t ) ( SHADOW_NAMED_ROOT_LENGTH - SHADOW_CLASSIC_ROOT_LENGTH ) ) == SHADOW_SUCCESS )
+            {
+                consumedTopicLength = ( uint16_t ) ( consumedTopicLength + ( SHADOW_NAMED_ROOT_LENGTH - SHADOW_CLASSIC_ROOT_LENGTH ) );
+                shadowStatus = validateName( &( pTopic[ consumedTopicLength ] ),
+                                             ( uint16_t ) ( topicLength - consumedTopicLength ),
+                                             SHADOW_NAME_MAX_LENGTH,
+                                             &shadowNameLength,
+                                             pShadowNameHash );
+
+                if( shadowStatus == SHADOW_SUCCESS )
+                {
+                    consumedTopicLength = ( uint16_t ) ( consumedTopicLength + shadowNameLength );
+                }
+                else
+                {
+                    shadowStatus = SHADOW_SHADOWNAME_PARSE_FAILED;
+                }
+            }
+
+            if( shadowStatus == SHADOW_SUCCESS )
+            {
+                shadowStatus = extractShadowMessageType( &( pTopic[ consumedTopicLength ] ),
+                                                         ( uint16_t ) ( topicLength - consumedTopicLength ),
+                                                         pMessageType );
+
+                if( shadowStatus != SHADOW_SUCCESS )
+                {
+                    shadowStatus = SHADOW_MESSAGE_TYPE_PARSE_FAILED;
+                }
+            }
+
+            if( shadowStatus == SHADOW_SUCCESS )
+            {
+                *pThingNameLength = SHADOW_FIXED_THING_NAME_LENGTH;
+                *pShadowNameLength = shadowNameLength;
+            }
+        }
+        else
+        {
+            shadowStatus = parseTopic( pTopic,
+                                       topicLength,
+                                       pThingNameLength,
+                                       pShadowNameLength,
+                                       pMessageType,
+                                       pHash );
+        }
+
+        return shadowStatus;
+    }
+
+#endif /* ifdef SHADOW_FIXED_THING_NAME */
+
+/*-----------------------------------------------------------*/
+
+static void createShadowTopicString( ShadowTopicStringType_t topicType,
+                                     const char * pThingName,
+                                     uint8_t thingNameLength,
+                                     const char * pShadowName,
+                                     uint8_t shadowNameLength,
+                                     char * pTopicBuffer )
+{
+    uint16_t offset = 0U, operationStringLength = 0U;
+    const char * pShadowPrefix = SHADOW_PREFIX;
+    const char * pOperationString = NULL;
+    const char * pClassicShadowRoot = SHADOW_CLASSIC_ROOT;
+    const char * pNamedShadowRoot = SHADOW_NAMED_ROOT;
+
+    /* Copy the Shadow topic prefix into the topic buffer. */
     ( void ) memcpy( ( void * ) pTopicBuffer,
                      ( const void * ) pShadowPrefix,
                      ( size_t ) SHADOW_PREFIX_LENGTH );
     offset = ( uint16_t ) ( offset + SHADOW_PREFIX_LENGTH );
 
-    /* Copy the Thing Name into the topic buffer. */
-    ( void ) memcpy( ( void * ) &( pTopicBuffer[ offset ] ),
-                     ( const void * ) pThingName,
-                     ( size_t ) thingNameLength );
-    offset = ( uint16_t ) ( offset + thingNameLength );
+    /* Copy the Thing Name into the topic buffer. */
+    ( void ) memcpy( ( void * ) &( pTopicBuffer[ offset ] ),
+                     ( const void * ) pThingName,
+                     ( size_t ) thingNameLength );
+    offset = ( uint16_t ) ( offset + thingNameLength );
+
+    /* Are we assembling a named shadow? */
+    if( shadowNameLength > 0U )
+    {
+        /* Copy the named Shadow topic root into the topic buffer. */
+        ( void ) memcpy( ( void * ) &( pTopicBuffer[ offset ] ),
+                         ( const void * ) pNamedShadowRoot,
+                         ( size_t ) SHADOW_NAMED_ROOT_LENGTH );
+        offset = ( uint16_t ) ( offset + SHADOW_NAMED_ROOT_LENGTH );
+
+        /* Copy the Shadow Name into the topic buffer. */
+        ( void ) memcpy( ( void * ) &( pTopicBuffer[ offset ] ),
+                         ( const void * ) pShadowName,
+                         ( size_t ) shadowNameLength );
+        offset = ( uint16_t ) ( offset + shadowNameLength );
+    }
+    else
+    {
+        /* Copy the Classic Shadow topic root into the topic buffer. */
+        ( void ) memcpy( ( void * ) &( pTopicBuffer[ offset ] ),
+                         ( const void * ) pClassicShadowRoot,
+                         ( size_t ) SHADOW_CLASSIC_ROOT_LENGTH );
+        offset = ( uint16_t ) ( offset + SHADOW_CLASSIC_ROOT_LENGTH );
+    }
+
+    pOperationString = ShadowTopicDescriptors[ topicType ].pString;
+    operationStringLength = ShadowTopicDescriptors[ topicType ].length;
+    /* Copy the Shadow operation string into the topic buffer. */
+    ( void ) memcpy( ( void * ) &( pTopicBuffer[ offset ] ),
+                     ( const void * ) pOperationString,
+                     ( size_t ) operationStringLength );
+}
+
+/*-----------------------------------------------------------*/
+
+static bool isTopicSharedWithNext( ShadowTopicStringType_t topicType,
+                                   uint16_t topicTypeMask )
+{
+    bool isShared = false;
+
+    if( ( topicType == ShadowTopicStringTypeGet ) ||
+        ( topicType == ShadowTopicStringTypeDelete ) ||
+        ( topicType == ShadowTopicStringTypeUpdate ) )
+    {
+        /* The topic type after a request topic is the "accepted" topic of the
+         * same operation. */
+        isShared = ( ( topicTypeMask & SHADOW_TOPIC_TYPE_BIT( ( uint32_t ) topicType + 1U ) ) != 0U );
+    }
+
+    return isShared;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t countTopicTypes( uint16_t topicTypeMask )
+{
+    uint32_t index = 0U;
+    uint32_t typeCount = 0U;
+
+    for( index = 0U; index < ( uint32_t ) ShadowTopicStringTypeMaxNum; index++ )
+    {
+        if( ( topicTypeMask & SHADOW_TOPIC_TYPE_BIT( index ) ) != 0U )
+        {
+            typeCount++;
+        }
+    }
+
+    return typeCount;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t getShadowTopicsLength( const ShadowNames_t * pNames,
+                                       uint16_t topicTypeMask )
+{
+    uint32_t index = 0U;
+    uint32_t topicsLength = 0U;
+    uint16_t headLength = 0U;
+    ShadowTopicStringType_t topicType = ShadowTopicStringTypeGet;
+
+    /* The prefix, Thing name, root and Shadow name that start every topic. */
+    headLength = ( uint16_t ) ( SHADOW_PREFIX_LENGTH + pNames->thingNameLength +
+                                ( ( pNames->shadowNameLength > 0U ) ?
+                                  ( SHADOW_NAMED_ROOT_LENGTH + pNames->shadowNameLength ) :
+                                  SHADOW_CLASSIC_ROOT_LENGTH ) );
+
+    for( index = 0U; index < ( uint32_t ) ShadowTopicStringTypeMaxNum; index++ )
+    {
+        topicType = ( ShadowTopicStringType_t ) index;
+
+        if( ( ( topicTypeMask & SHADOW_TOPIC_TYPE_BIT( index ) ) != 0U ) &&
+            ( isTopicSharedWithNext( topicType, topicTypeMask ) == false ) )
+        {
+            topicsLength += ( uint32_t ) headLength + ( uint32_t ) ShadowTopicDescriptors[ topicType ].length;
+        }
+    }
+
+    return topicsLength;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t assembleShadowTopics( const ShadowNames_t * pNames,
+                                      uint16_t topicTypeMask,
+                                      char * pTopicBuffer,
+                                      uint32_t offset,
+                                      ShadowTopicSpan_t * pTopicSpans )
+{
+    uint32_t index = 0U;
+    uint32_t spanIndex = 0U;
+    uint32_t headOffset = offset;
+    uint16_t headLength = 0U;
+    uint16_t operationLength = 0U;
+    ShadowTopicStringType_t topicType = ShadowTopicStringTypeGet;
+
+    /* The prefix, Thing name, root and Shadow name that start every topic. */
+    headLength = ( uint16_t ) ( SHADOW_PREFIX_LENGTH + pNames->thingNameLength +
+                                ( ( pNames->shadowNameLength > 0U ) ?
+                                  ( SHADOW_NAMED_ROOT_LENGTH + pNames->shadowNameLength ) :
+                                  SHADOW_CLASSIC_ROOT_LENGTH ) );
+
+    for( index = 0U; index < ( uint32_t ) ShadowTopicStringTypeMaxNum; index++ )
+    {
+        topicType = ( ShadowTopicStringType_t ) index;
+
+        if( ( topicTypeMask & SHADOW_TOPIC_TYPE_BIT( index ) ) != 0U )
+        {
+            operationLength = ShadowTopicDescriptors[ topicType ].length;
+            pTopicSpans[ spanIndex ].offset = offset;
+            pTopicSpans[ spanIndex ].length = ( uint16_t ) ( headLength + operationLength );
+
+            if( isTopicSharedWithNext( topicType, topicTypeMask ) == true )
+            {
+                /* The "accepted" topic of the same operation starts with this
+                 * topic. It is written at the same offset. */
+            }
+            else if( offset == headOffset )
+            {
+                createShadowTopicString( topicType,
+                                         pNames->pThingName,
+                                         pNames->thingNameLength,
+                                         pNames->pShadowName,
+                                         pNames->shadowNameLength,
+                                         &( pTopicBuffer[ offset ] ) );
+                offset += pTopicSpans[ spanIndex ].length;
+            }
+            else
+            {
+                /* Copy the start of the first topic of this shadow, which is
+                 * still in the cache, instead of assembling it again from its
+                 * parts. */
+                ( void ) memcpy( ( void * ) &( pTopicBuffer[ offset ] ),
+                                 ( const void * ) &( pTopicBuffer[ headOffset ] ),
+                                 ( size_t ) headLength );
+                ( void ) memcpy( ( void * ) &( pTopicBuffer[ offset + headLength ] ),
+                                 ( const void * ) ShadowTopicDescriptors[ topicType ].pString,
+                                 ( size_t ) operationLength );
+                offset += pTopicSpans[ spanIndex ].length;
+            }
+
+            spanIndex++;
+        }
+    }
+
+    return offset;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t getFilterOperations( uint16_t topicTypeMask,
+                                     WildcardFilterOperation_t * pOperations )
+{
+    uint16_t operationCount = 0U;
+    uint16_t remainingMask = topicTypeMask;
+    uint16_t responseMask = 0U;
+    uint32_t index = 0U;
+    uint32_t responseIndex = 0U;
+    uint32_t nextRequestIndex = 0U;
+    ShadowTopicStringType_t topicType = ShadowTopicStringTypeGet;
+
+    if( ( remainingMask & SHADOW_RESPONSE_TYPES ) == SHADOW_RESPONSE_TYPES )
+    {
+        pOperations[ operationCount ].pOperation = "";
+        pOperations[ operationCount ].operationLength = 0U;
+        pOperations[ operationCount ].wildcardCount = 2U;
+        operationCount++;
+        remainingMask &= ( uint16_t ) ~SHADOW_RESPONSE_TYPES;
+    }
+
+    if( ( remainingMask & SHADOW_REQUEST_TYPES ) == SHADOW_REQUEST_TYPES )
+    {
+        pOperations[ operationCount ].pOperation = "";
+        pOperations[ operationCount ].operationLength = 0U;
+        pOperations[ operationCount ].wildcardCount = 1U;
+        operationCount++;
+        remainingMask &= ( uint16_t ) ~SHADOW_REQUEST_TYPES;
+    }
+
+    /* Each operation is a request topic type followed by the topic types of
+     * its responses, up to the next request topic type. */
+    for( index = 0U; index < ( uint32_t ) ShadowTopicStringTypeMaxNum; index = nextRequestIndex )
+    {
+        topicType = ( ShadowTopicStringType_t ) index;
+        nextRequestIndex = ( topicType == ShadowTopicStringTypeUpdate ) ?
+                           ( uint32_t ) ShadowTopicStringTypeMaxNum :
+                           ( index + 3U );
+        responseMask = ( uint16_t ) ( SHADOW_TOPIC_TYPE_BIT( nextRequestIndex ) -
+                                      SHADOW_TOPIC_TYPE_BIT( index + 1U ) );
+
+        if( ( remainingMask & SHADOW_TOPIC_TYPE_BIT( index ) ) != 0U )
+        {
+            pOperations[ operationCount ].pOperation = ShadowTopicDescriptors[ topicType ].pString;
+            pOperations[ operationCount ].operationLength = ShadowTopicDescriptors[ topicType ].length;
+            pOperations[ operationCount ].wildcardCount = 0U;
+            operationCount++;
+        }
+
+        if( ( remainingMask & responseMask ) == responseMask )
+        {
+            pOperations[ operationCount ].pOperation = ShadowTopicDescriptors[ topicType ].pString;
+            pOperations[ operationCount ].operationLength = ShadowTopicDescriptors[ topicType ].length;
+            pOperations[ operationCount ].wildcardCount = 1U;
+            operationCount++;
+        }
+        else
+        {
+            for( responseIndex = index + 1U; responseIndex < nextRequestIndex; responseIndex++ )
+            {
+                if( ( remainingMask & SHADOW_TOPIC_TYPE_BIT( responseIndex ) ) != 0U )
+                {
+                    topicType = ( ShadowTopicStringType_t ) responseIndex;
+                    pOperations[ operationCount ].pOperation = ShadowTopicDescriptors[ topicType ].pString;
+                    pOperations[ operationCount ].operationLength = ShadowTopicDescriptors[ topicType ].length;
+                    pOperations[ operationCount ].wildcardCount = 0U;
+                    operationCount++;
+                }
+            }
+        }
+    }
+
+    return operationCount;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t compareNames( const char * pName,
+                             uint8_t nameLength,
+                             const char * pOtherName,
+                             uint8_t otherNameLength )
+{
+    int32_t result = ( int32_t ) nameLength - ( int32_t ) otherNameLength;
+
+    if( ( result == 0 ) && ( nameLength > 0U ) )
+    {
+        result = ( int32_t ) memcmp( ( const void * ) pName, ( const void * ) pOtherName, ( size_t ) nameLength );
+    }
+
+    return result;
+}
+
+/*-----------------------------------------------------------*/
+
+static int32_t compareWildcardEntries( const ShadowNames_t * pNames,
+                                       const ShadowWildcardEntry_t * pEntry,
+                                       const ShadowWildcardEntry_t * pOtherEntry,
+                                       WildcardOrder_t order )
+{
+    const ShadowNames_t * pShadow = &( pNames[ pEntry->nameIndex ] );
+    const ShadowNames_t * pOtherShadow = &( pNames[ pOtherEntry->nameIndex ] );
+    uint8_t wildcardFlags = ( uint8_t ) ( SHADOW_WILDCARD_FLAG_SHADOW_NAME | SHADOW_WILDCARD_FLAG_THING_NAME );
+    bool compareThingNames = true;
+    bool compareShadowNames = true;
+    int32_t result = 0;
+
+    if( order == WildcardOrderThing )
+    {
+        compareShadowNames = false;
+    }
+    else
+    {
+        /* Shadows with a wildcard Shadow name come last when sorting by Shadow
+         * name. The names of a topic filter depend on which name is replaced
+         * with a wildcard, and only the names that are kept are compared. */
+        if( order == WildcardOrderShadow )
+        {
+            wildcardFlags = SHADOW_WILDCARD_FLAG_SHADOW_NAME;
+            compareThingNames = false;
+        }
+        else
+        {
+            compareThingNames = ( ( pEntry->flags & SHADOW_WILDCARD_FLAG_THING_NAME ) == 0U ) ? true : false;
+            compareShadowNames = ( ( pEntry->flags & SHADOW_WILDCARD_FLAG_SHADOW_NAME ) == 0U ) ? true : false;
+        }
+
+        result = ( int32_t ) ( pEntry->flags & wildcardFlags ) - ( int32_t ) ( pOtherEntry->flags & wildcardFlags );
+    }
+
+    if( ( result == 0 ) && ( compareThingNames == true ) )
+    {
+        result = compareNames( pShadow->pThingName, pShadow->thingNameLength,
+                               pOtherShadow->pThingName, pOtherShadow->thingNameLength );
+    }
+
+    if( ( result == 0 ) && ( compareShadowNames == true ) )
+    {
+        result = compareNames( pShadow->pShadowName, pShadow->shadowNameLength,
+                               pOtherShadow->pShadowName, pOtherShadow->shadowNameLength );
+    }
+
+    return result;
+}
+
+/*-----------------------------------------------------------*/
+
+static void siftDownWildcardEntries( const ShadowNames_t * pNames,
+                                     ShadowWildcardEntry_t * pEntries,
+                                     uint32_t rootIndex,
+                                     uint32_t entryCount,
+                                     WildcardOrder_t order )
+{
+    ShadowWildcardEntry_t entry;
+    uint32_t parentIndex = rootIndex;
+    uint32_t childIndex = 0U;
+    bool isDone = false;
+
+    while( isDone == false )
+    {
+        /* The entry count is bounded by SHADOW_BULK_NAME_COUNT_MAX, so the
+         * index of a child does not overflow. */
+        childIndex = ( 2U * parentIndex ) + 1U;
+
+        if( childIndex >= entryCount )
+        {
+            isDone = true;
+        }
+        else
+        {
+            if( ( ( childIndex + 1U ) < entryCount ) &&
+                ( compareWildcardEntries( pNames, &( pEntries[ childIndex ] ),
+                                          &( pEntries[ childIndex + 1U ] ), order ) < 0 ) )
+            {
+                childIndex++;
+            }
+
+            if( compareWildcardEntries( pNames, &( pEntries[ parentIndex ] ),
+                                        &( pEntries[ childIndex ] ), order ) < 0 )
+            {
+                entry = pEntries[ parentIndex ];
+                pEntries[ parentIndex ] = pEntries[ childIndex ];
+                pEntries[ childIndex ] = entry;
+                parentIndex = childIndex;
+            }
+            else
+            {
+                isDone = true;
+            }
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void sortWildcardEntries( const ShadowNames_t * pNames,
+                                 ShadowWildcardEntry_t * pEntries,
+                                 uint32_t entryCount,
+                                 WildcardOrder_t order )
+{
+    ShadowWildcardEntry_t entry;
+    uint32_t index = 0U;
+
+    for( index = entryCount / 2U; index > 0U; index-- )
+    {
+        siftDownWildcardEntries( pNames, pEntries, index - 1U, entryCount, order );
+    }
+
+    for( index = entryCount - 1U; index > 0U; index-- )
+    {
+        entry = pEntries[ 0 ];
+        pEntries[ 0 ] = pEntries[ index ];
+        pEntries[ index ] = entry;
+        siftDownWildcardEntries( pNames, pEntries, 0U, index, order );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t findWildcardGroupEnd( const ShadowNames_t * pNames,
+                                      const ShadowWildcardEntry_t * pEntries,
+                                      uint32_t start,
+                                      uint32_t entryCount,
+                                      WildcardOrder_t order )
+{
+    uint32_t end = start + 1U;
+
+    while( ( end < entryCount ) &&
+           ( compareWildcardEntries( pNames, &( pEntries[ start ] ), &( pEntries[ end ] ), order ) == 0 ) )
+    {
+        end++;
+    }
+
+    return end;
+}
+
+/*-----------------------------------------------------------*/
+
+static void groupWildcardEntries( const ShadowNames_t * pNames,
+                                  ShadowWildcardEntry_t * pEntries,
+                                  uint32_t nameCount )
+{
+    ShadowWildcardEntry_t entry;
+    const ShadowNames_t * pShadow = NULL;
+    const ShadowNames_t * pFirstNamed = NULL;
+    uint32_t index = 0U;
+    uint32_t start = 0U;
+    uint32_t end = 0U;
+    uint32_t firstIndex = 0U;
+    uint32_t targetIndex = 0U;
+    bool hasOtherName = false;
+
+    for( index = 0U; index < nameCount; index++ )
+    {
+        pEntries[ index ].nameIndex = index;
+        pEntries[ index ].flags = 0U;
+    }
+
+    /* The named shadows of a Thing with more than one Shadow name share topic
+     * filters with a wildcard Shadow name. */
+    sortWildcardEntries( pNames, pEntries, nameCount, WildcardOrderThing );
+
+    for( start = 0U; start < nameCount; start = end )
+    {
+        end = findWildcardGroupEnd( pNames, pEntries, start, nameCount, WildcardOrderThing );
+        pFirstNamed = NULL;
+        hasOtherName = false;
+
+        for( index = start; index < end; index++ )
+        {
+            pShadow = &( pNames[ pEntries[ index ].nameIndex ] );
+
+            if( pShadow->shadowNameLength == 0U )
+            {
+                /* A Classic shadow keeps its names. */
+            }
+            else if( pFirstNamed == NULL )
+            {
+                pFirstNamed = pShadow;
+            }
+            else if( compareNames( pShadow->pShadowName, pShadow->shadowNameLength,
+                                   pFirstNamed->pShadowName, pFirstNamed->shadowNameLength ) != 0 )
+            {
+                hasOtherName = true;
+            }
+            else
+            {
+                /* The same shadow is given more than once. */
+            }
+        }
+
+        for( index = start; ( hasOtherName == true ) && ( index < end ); index++ )
+        {
+            if( pNames[ pEntries[ index ].nameIndex ].shadowNameLength > 0U )
+            {
+                pEntries[ index ].flags |= SHADOW_WILDCARD_FLAG_SHADOW_NAME;
+            }
+        }
+    }
+
+    /* Of the shadows that are left, those with the same Shadow name, of more
+     * than one Thing, share topic filters with a wildcard Thing name. A topic
+     * filter never has both names replaced. */
+    sortWildcardEntries( pNames, pEntries, nameCount, WildcardOrderShadow );
+
+    for( start = 0U; start < nameCount; start = end )
+    {
+        end = findWildcardGroupEnd( pNames, pEntries, start, nameCount, WildcardOrderShadow );
+        hasOtherName = false;
+
+        for( index = start + 1U;
+             ( ( pEntries[ start ].flags & SHADOW_WILDCARD_FLAG_SHADOW_NAME ) == 0U ) && ( index < end );
+             index++ )
+        {
+            if( compareWildcardEntries( pNames, &( pEntries[ start ] ), &( pEntries[ index ] ), WildcardOrderThing ) != 0 )
+            {
+                hasOtherName = true;
+            }
+        }
+
+        for( index = start; ( hasOtherName == true ) && ( index < end ); index++ )
+        {
+            pEntries[ index ].flags |= SHADOW_WILDCARD_FLAG_THING_NAME;
+        }
+    }
+
+    /* The topic filters of a group are added for its first shadow in the
+     * names. */
+    sortWildcardEntries( pNames, pEntries, nameCount, WildcardOrderFilter );
+
+    for( start = 0U; start < nameCount; start = end )
+    {
+        end = findWildcardGroupEnd( pNames, pEntries, start, nameCount, WildcardOrderFilter );
+        firstIndex = start;
+
+        for( index = start + 1U; index < end; index++ )
+        {
+            if( pEntries[ index ].nameIndex < pEntries[ firstIndex ].nameIndex )
+            {
+                firstIndex = index;
+            }
+        }
+
+        pEntries[ firstIndex ].flags |= SHADOW_WILDCARD_FLAG_FIRST;
+    }
+
+    /* Each entry holds the index of its shadow, so swapping every entry into
+     * its place puts them back in the order of the names in fewer than
+     * nameCount swaps. */
+    for( index = 0U; index < nameCount; index++ )
+    {
+        while( pEntries[ index ].nameIndex != index )
+        {
+            targetIndex = pEntries[ index ].nameIndex;
+            entry = pEntries[ targetIndex ];
+            pEntries[ targetIndex ] = pEntries[ index ];
+            pEntries[ index ] = entry;
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void getWildcardNames( const ShadowNames_t * pNames,
+                              const ShadowWildcardEntry_t * pEntry,
+                              ShadowNames_t * pFilterNames )
+{
+    *pFilterNames = *pNames;
+
+    if( ( pEntry->flags & SHADOW_WILDCARD_FLAG_SHADOW_NAME ) != 0U )
+    {
+        pFilterNames->pShadowName = SHADOW_WILDCARD;
+        pFilterNames->shadowNameLength = SHADOW_WILDCARD_LENGTH;
+    }
+    else if( ( pEntry->flags & SHADOW_WILDCARD_FLAG_THING_NAME ) != 0U )
+    {
+        pFilterNames->pThingName = SHADOW_WILDCARD;
+        pFilterNames->thingNameLength = SHADOW_WILDCARD_LENGTH;
+    }
+    else
+    {
+        /* Both names are kept. */
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t getWildcardFilterLength( const ShadowNames_t * pFilterNames,
+                                         const WildcardFilterOperation_t * pOperation )
+{
+    return ( uint16_t ) ( SHADOW_PREFIX_LENGTH + pFilterNames->thingNameLength +
+                          ( ( pFilterNames->shadowNameLength > 0U ) ?
+                            ( SHADOW_NAMED_ROOT_LENGTH + pFilterNames->shadowNameLength ) :
+                            SHADOW_CLASSIC_ROOT_LENGTH ) +
+                          pOperation->operationLength +
+                          ( pOperation->wildcardCount * SHADOW_WILDCARD_LEVEL_LENGTH ) );
+}
+
+/*-----------------------------------------------------------*/
+
+static void writeWildcardFilter( const ShadowNames_t * pFilterNames,
+                                 const WildcardFilterOperation_t * pOperation,
+                                 char * pFilterBuffer )
+{
+    uint16_t offset = 0U;
+    uint16_t index = 0U;
+
+    /* The prefix, names and root are those of a topic string. The operation
+     * string of the Get topic type is not used. */
+    createShadowTopicString( ShadowTopicStringTypeGet,
+                             pFilterNames->pThingName,
+                             pFilterNames->thingNameLength,
+                             pFilterNames->pShadowName,
+                             pFilterNames->shadowNameLength,
+                             pFilterBuffer );
+    offset = ( uint16_t ) ( SHADOW_PREFIX_LENGTH + pFilterNames->thingNameLength +
+                            ( ( pFilterNames->shadowNameLength > 0U ) ?
+                              ( SHADOW_NAMED_ROOT_LENGTH + pFilterNames->shadowNameLength ) :
+                              SHADOW_CLASSIC_ROOT_LENGTH ) );
+
+    ( void ) memcpy( ( void * ) &( pFilterBuffer[ offset ] ),
+                     ( const void * ) pOperation->pOperation,
+                     ( size_t ) pOperation->operationLength );
+    offset = ( uint16_t ) ( offset + pOperation->operationLength );
+
+    for( index = 0U; index < pOperation->wildcardCount; index++ )
+    {
+        ( void ) memcpy( ( void * ) &( pFilterBuffer[ offset ] ),
+                         ( const void * ) SHADOW_WILDCARD_LEVEL,
+                         ( size_t ) SHADOW_WILDCARD_LEVEL_LENGTH );
+        offset = ( uint16_t ) ( offset + SHADOW_WILDCARD_LEVEL_LENGTH );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static bool matchTopicFilter( const char * pFilter,
+                              uint16_t filterLength,
+                              const char * pTopic,
+                              uint16_t topicLength )
+{
+    bool isMatch = false;
+    bool isDone = false;
+    uint16_t filterIndex = 0U;
+    uint16_t topicIndex = 0U;
+
+    /* Topics starting with '$' are not matched by a wildcard at the start of
+     * a topic filter. */
+    if( ( pTopic[ 0 ] == '$' ) &&
+        ( filterLength > 0U ) && ( ( pFilter[ 0 ] == '+' ) || ( pFilter[ 0 ] == '#' ) ) )
+    {
+        isDone = true;
+    }
+
+    while( isDone == false )
+    {
+        if( filterIndex == filterLength )
+        {
+            isMatch = ( topicIndex == topicLength );
+            isDone = true;
+        }
+        else if( pFilter[ filterIndex ] == '#' )
+        {
+            isMatch = true;
+            isDone = true;
+        }
+        else if( pFilter[ filterIndex ] == '+' )
+        {
+            while( ( topicIndex < topicLength ) && ( pTopic[ topicIndex ] != '/' ) )
+            {
+                topicIndex++;
+            }
+
+            filterIndex++;
+        }
+        else if( ( topicIndex < topicLength ) && ( pFilter[ filterIndex ] == pTopic[ topicIndex ] ) )
+        {
+            filterIndex++;
+            topicIndex++;
+        }
+        else
+        {
+            /* A "/#" at the end of a topic filter also matches its parent level. */
+            isMatch = ( topicIndex == topicLength ) &&
+                      ( ( filterLength - filterIndex ) == 2U ) &&
+                      ( pFilter[ filterIndex ] == '/' ) &&
+                      ( pFilter[ filterIndex + 1U ] == '#' );
+            isDone = true;
+        }
+    }
+
+    return isMatch;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t hashThingLevel( const char * pString,
+                                uint16_t length )
+{
+    uint32_t hash = SHADOW_FILTER_WILDCARD_HASH;
+    uint16_t levelEnd = SHADOW_PREFIX_LENGTH;
+    uint16_t levelEndMax = ( uint16_t ) ( SHADOW_PREFIX_LENGTH + SHADOW_THINGNAME_MAX_LENGTH );
+
+    if( ( length > SHADOW_PREFIX_LENGTH ) &&
+        ( memcmp( ( const void * ) pString, ( const void * ) SHADOW_PREFIX, ( size_t ) SHADOW_PREFIX_LENGTH ) == 0 ) )
+    {
+        while( ( levelEnd < length ) &&
+               ( levelEnd <= levelEndMax ) &&
+               ( pString[ levelEnd ] != '/' ) &&
+               ( pString[ levelEnd ] != '+' ) &&
+               ( pString[ levelEnd ] != '#' ) )
+        {
+            levelEnd++;
+        }
+
+        /* A level with a wildcard, or too long for a Thing name, is not a
+         * Thing name. A topic filter and a topic that it matches have the same
+         * hash, as they have the same Thing name level. */
+        if( ( levelEnd > SHADOW_PREFIX_LENGTH ) &&
+            ( levelEnd <= levelEndMax ) &&
+            ( ( levelEnd == length ) || ( pString[ levelEnd ] == '/' ) ) )
+        {
+            hash = hashBytes( SHADOW_HASH_OFFSET_BASIS,
+                              &( pString[ SHADOW_PREFIX_LENGTH ] ),
+                              ( uint8_t ) ( levelEnd - SHADOW_PREFIX_LENGTH ) );
+        }
+    }
+
+    return hash;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t matchIndexedFilters( const ShadowFilterIndex_t * pIndex,
+                                     uint32_t hash,
+                                     const char * pTopic,
+                                     uint16_t topicLength,
+                                     uint32_t firstIndex )
+{
+    uint32_t mask = pIndex->slotCount - 1U;
+    uint32_t slotIndex = hash & mask;
+    uint32_t probeCount = 0U;
+    uint32_t matchIndex = firstIndex;
+    const ShadowFilterSlot_t * pSlot = NULL;
+    const ShadowTopicSpan_t * pSpan = NULL;
+    bool isDone = false;
+
+    /* The topic filters of a hash were added in the order of their index, so
+     * they are in that order along the slots, and the first one that matches
+     * is the first in the order of the topic filters. */
+    for( probeCount = 0U; ( isDone == false ) && ( probeCount < pIndex->slotCount ); probeCount++ )
+    {
+        pSlot = &( pIndex->pSlots[ slotIndex ] );
+
+        if( ( pSlot->filterIndex == SHADOW_FILTER_SLOT_EMPTY ) ||
+            ( ( pSlot->hash == hash ) && ( pSlot->filterIndex >= matchIndex ) ) )
+        {
+            isDone = true;
+        }
+        else if( pSlot->hash == hash )
+        {
+            pSpan = &( pIndex->pFilterSpans[ pSlot->filterIndex ] );
+
+            if( matchTopicFilter( &( pIndex->pFilterBuffer[ pSpan->offset ] ),
+                                  pSpan->length,
+                                  pTopic,
+                                  topicLength ) == true )
+            {
+                matchIndex = pSlot->filterIndex;
+                isDone = true;
+            }
+        }
+        else
+        {
+            /* The slot holds a topic filter with another hash. */
+        }
+
+        slotIndex = ( slotIndex + 1U ) & mask;
+    }
+
+    return matchIndex;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t getPayloadLength( const ShadowNames_t * pNames,
+                                  uint16_t topicTypeMask,
+                                  uint32_t entryOverhead )
+{
+    uint32_t index = 0U;
+    uint32_t payloadLength = 0U;
+    uint16_t headLength = 0U;
+
+    /* The prefix, Thing name, root and Shadow name that start every topic. */
+    headLength = ( uint16_t ) ( SHADOW_PREFIX_LENGTH + pNames->thingNameLength +
+                                ( ( pNames->shadowNameLength > 0U ) ?
+                                  ( SHADOW_NAMED_ROOT_LENGTH + pNames->shadowNameLength ) :
+                                  SHADOW_CLASSIC_ROOT_LENGTH ) );
+
+    for( index = 0U; index < ( uint32_t ) ShadowTopicStringTypeMaxNum; index++ )
+    {
+        if( ( topicTypeMask & SHADOW_TOPIC_TYPE_BIT( index ) ) != 0U )
+        {
+            payloadLength += entryOverhead + ( uint32_t ) headLength +
+                             ( uint32_t ) ShadowTopicDescriptors[ index ].length;
+        }
+    }
+
+    return payloadLength;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t serializeShadowTopics( const ShadowNames_t * pNames,
+                                       uint16_t topicTypeMask,
+                                       bool hasOptions,
+                                       uint8_t options,
+                                       uint8_t * pBuffer,
+                                       uint32_t offset )
+{
+    uint32_t index = 0U;
+    uint32_t headOffset = 0U;
+    uint16_t headLength = 0U;
+    uint16_t operationLength = 0U;
+    uint16_t topicLength = 0U;
+    bool isFirstTopic = true;
+    ShadowTopicStringType_t topicType = ShadowTopicStringTypeGet;
+
+    /* The prefix, Thing name, root and Shadow name that start every topic. */
+    headLength = ( uint16_t ) ( SHADOW_PREFIX_LENGTH + pNames->thingNameLength +
+                                ( ( pNames->shadowNameLength > 0U ) ?
+                                  ( SHADOW_NAMED_ROOT_LENGTH + pNames->shadowNameLength ) :
+                                  SHADOW_CLASSIC_ROOT_LENGTH ) );
+
+    for( index = 0U; index < ( uint32_t ) ShadowTopicStringTypeMaxNum; index++ )
+    {
+        topicType = ( ShadowTopicStringType_t ) index;
+
+        if( ( topicTypeMask & SHADOW_TOPIC_TYPE_BIT( index ) ) != 0U )
+        {
+            operationLength = ShadowTopicDescriptors[ topicType ].length;
+            topicLength = ( uint16_t ) ( headLength + operationLength );
 
-    /* Are we assembling a named shadow? */
-    if( shadowNameLength > 0U )
+            /* The length of the topic string, most significant byte first. */
+            pBuffer[ offset ] = ( uint8_t ) ( topicLength >> 8U );
+            pBuffer[ offset + 1U ] = ( uint8_t ) ( topicLength & 0xFFU );
+            offset += 2U;
+
+            if( isFirstTopic == true )
+            {
+                createShadowTopicString( topicType,
+                                         pNames->pThingName,
+                                         pNames->thingNameLength,
+                                         pNames->pShadowName,
+                                         pNames->shadowNameLength,
+                                         ( char * ) &( pBuffer[ offset ] ) );
+                headOffset = offset;
+                isFirstTopic = false;
+            }
+            else
+            {
+                /* Copy the start of the first topic of this shadow instead of
+                 * assembling it again from its parts. */
+                ( void ) memcpy( ( void * ) &( pBuffer[ offset ] ),
+                                 ( const void * ) &( pBuffer[ headOffset ] ),
+                                 ( size_t ) headLength );
+                ( void ) memcpy( ( void * ) &( pBuffer[ offset + headLength ] ),
+                                 ( const void * ) ShadowTopicDescriptors[ topicType ].pString,
+                                 ( size_t ) operationLength );
+            }
+
+            offset += topicLength;
+
+            if( hasOptions == true )
+            {
+                pBuffer[ offset ] = options;
+                offset++;
+            }
+        }
+    }
+
+    return offset;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t serializeTopicPayload( const ShadowNames_t * pNames,
+                                             uint32_t nameCount,
+                                             uint16_t topicTypeMask,
+                                             bool hasOptions,
+                                             uint8_t options,
+                                             uint8_t * pBuffer,
+                                             uint32_t bufferSize,
+                                             uint32_t * pOutLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t index = 0U;
+    uint32_t requiredLength = 0U;
+    uint32_t offset = 0U;
+    uint32_t entryOverhead = ( hasOptions == true ) ? SHADOW_SUBSCRIBE_ENTRY_OVERHEAD :
+                             SHADOW_UNSUBSCRIBE_ENTRY_OVERHEAD;
+
+    if( ( pNames == NULL ) ||
+        ( nameCount == 0U ) ||
+        ( nameCount > SHADOW_PAYLOAD_NAME_COUNT_MAX ) ||
+        ( topicTypeMask == 0U ) ||
+        ( ( topicTypeMask & ( uint16_t ) ~SHADOW_TOPIC_TYPE_ALL ) != 0U ) ||
+        ( pBuffer == NULL ) ||
+        ( pOutLength == NULL ) )
     {
-        /* Copy the named Shadow topic root into the topic buffer. */
-        ( void ) memcpy( ( void * ) &( pTopicBuffer[ offset ] ),
-                         ( const void * ) pNamedShadowRoot,
-                         ( size_t ) SHADOW_NAMED_ROOT_LENGTH );
-        offset = ( uint16_t ) ( offset + SHADOW_NAMED_ROOT_LENGTH );
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pNames: %p, nameCount: %u, topicTypeMask: 0x%x,\
+                    pBuffer: %p, pOutLength: %p.",
+                    ( const void * ) pNames,
+                    ( unsigned int ) nameCount,
+                    ( unsigned int ) topicTypeMask,
+                    ( void * ) pBuffer,
+                    ( void * ) pOutLength ) );
+    }
 
-        /* Copy the Shadow Name into the topic buffer. */
-        ( void ) memcpy( ( void * ) &( pTopicBuffer[ offset ] ),
-                         ( const void * ) pShadowName,
-                         ( size_t ) shadowNameLength );
-        offset = ( uint16_t ) ( offset + shadowNameLength );
+    /* Validate every name and add up the length of the payload before
+     * writing any of it. The bound on nameCount keeps the sum from
+     * overflowing. */
+    for( index = 0U; ( shadowStatus == SHADOW_SUCCESS ) && ( index < nameCount ); index++ )
+    {
+        shadowStatus = validateTopicNames( pNames[ index ].pThingName,
+                                           pNames[ index ].thingNameLength,
+                                           pNames[ index ].pShadowName,
+                                           pNames[ index ].shadowNameLength );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            requiredLength += getPayloadLength( &( pNames[ index ] ), topicTypeMask, entryOverhead );
+        }
     }
-    else
+
+    if( ( shadowStatus == SHADOW_SUCCESS ) && ( bufferSize < requiredLength ) )
     {
-        /* Copy the Classic Shadow topic root into the topic buffer. */
-        ( void ) memcpy( ( void * ) &( pTopicBuffer[ offset ] ),
-                         ( const void * ) pClassicShadowRoot,
-                         ( size_t ) SHADOW_CLASSIC_ROOT_LENGTH );
-        offset = ( uint16_t ) ( offset + SHADOW_CLASSIC_ROOT_LENGTH );
+        shadowStatus = SHADOW_BUFFER_TOO_SMALL;
+        LogError( ( "Input bufferSize too small, bufferSize %u, required %u.",
+                    ( unsigned int ) bufferSize,
+                    ( unsigned int ) requiredLength ) );
+        *pOutLength = requiredLength;
     }
 
-    pOperationString = getShadowOperationString( topicType );
-    operationStringLength = getShadowOperationLength( topicType );
-    /* Copy the Shadow operation string into the topic buffer. */
-    ( void ) memcpy( ( void * ) &( pTopicBuffer[ offset ] ),
-                     ( const void * ) pOperationString,
-                     ( size_t ) operationStringLength );
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        for( index = 0U; index < nameCount; index++ )
+        {
+            offset = serializeShadowTopics( &( pNames[ index ] ),
+                                            topicTypeMask,
+                                            hasOptions,
+                                            options,
+                                            pBuffer,
+                                            offset );
+        }
+
+        *pOutLength = offset;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t matchTopic( const char * pTopic,
+                                  uint16_t topicLength,
+                                  ShadowMatchResult_t * pResult,
+                                  ShadowTopicHash_t * pHash )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint8_t thingNameLength = 0;
+    uint8_t shadowNameLength = 0;
+
+    /* Most topics on a connection are not Shadow topics, and nearly all of them
+     * differ from the Shadow topic prefix. Reject those before parsing. */
+    shadowStatus = matchPrefixWords( pTopic, topicLength );
+
+    if( ( shadowStatus == SHADOW_SUCCESS ) && ( pHash != NULL ) )
+    {
+        pHash->thingNameHash = SHADOW_HASH_OFFSET_BASIS;
+        pHash->shadowNameHash = SHADOW_HASH_OFFSET_BASIS;
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        #ifdef SHADOW_FIXED_THING_NAME
+            shadowStatus = parseFixedThingTopic( pTopic,
+                                                 topicLength,
+                                                 &thingNameLength,
+                                                 &shadowNameLength,
+                                                 &( pResult->messageType ),
+                                                 pHash );
+        #else
+            shadowStatus = parseTopic( pTopic,
+                                       topicLength,
+                                       &thingNameLength,
+                                       &shadowNameLength,
+                                       &( pResult->messageType ),
+                                       pHash );
+        #endif /* ifdef SHADOW_FIXED_THING_NAME */
+    }
+
+    if( ( shadowStatus == SHADOW_SUCCESS ) && ( pHash != NULL ) )
+    {
+        hashKey( pHash );
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        setResultNames( pResult, thingNameLength, shadowNameLength );
+    }
+
+    pResult->status = shadowStatus;
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static void setResultNames( ShadowMatchResult_t * pResult,
+                            uint8_t thingNameLength,
+                            uint8_t shadowNameLength )
+{
+    /* Thing name comes after shadow prefix. */
+    pResult->thingNameOffset = SHADOW_PREFIX_LENGTH;
+    pResult->thingNameLength = thingNameLength;
+
+    /* Shadow name, if any, comes after the named shadow root. */
+    pResult->shadowNameOffset = ( shadowNameLength > 0U ) ?
+                                ( uint16_t ) ( SHADOW_PREFIX_LENGTH + thingNameLength + SHADOW_NAMED_ROOT_LENGTH ) :
+                                0U;
+    pResult->shadowNameLength = shadowNameLength;
 }
 
 /*-----------------------------------------------------------*/
@@ -771,100 +3198,335 @@ ShadowStatus_t Shadow_MatchTopicString( const char * pTopic,
                                         const char ** pShadowName,
                                         uint8_t * pShadowNameLength )
 {
-    uint16_t consumedTopicLength = 0U;
     ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
-    uint8_t thingNameLength = 0;
-    uint8_t shadowNameLength = 0;
+    ShadowMatchResult_t matchResult = { SHADOW_FAIL, ShadowMessageTypeMaxNum, 0U, 0U, 0U, 0U };
 
     shadowStatus = validateMatchTopicParameters( pTopic, topicLength, pMessageType );
 
-    /* A shadow topic string takes one of the two forms.
-     * Classic shadow:
-     *   $aws/things/<thingName>/shadow/<operation>
-     *   $aws/things/<thingName>/shadow/<operation>/<suffix>
-     * Named shadow:
-     *   $aws/things/<thingName>/shadow/name/<shadowName>/<operation>
-     *   $aws/things/<thingName>/shadow/name/<shadowName>/<operation>/<suffix>
-     *
-     * We need to match the following things:
-     * 1. Prefix ($aws/things).
-     * 2. Thing Name.
-     * 3. Classic shadow root (/shadow) OR Named shadow root (/shadow/name) and shadow name
-     * 4. Shadow operation and suffix.
-     */
     if( shadowStatus == SHADOW_SUCCESS )
     {
-        /* First match the prefix. */
-        shadowStatus = containsSubString( &( pTopic[ consumedTopicLength ] ),
-                                          topicLength - consumedTopicLength,
-                                          SHADOW_PREFIX,
-                                          SHADOW_PREFIX_LENGTH );
-
-        if( shadowStatus == SHADOW_SUCCESS )
+        shadowStatus = matchTopic( pTopic, topicLength, &matchResult, NULL );
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        /* Update the out parameters if we successfully matched the topic. */
+        *pMessageType = matchResult.messageType;
+
+        if( pThingName != NULL )
+        {
+            *pThingName = &( pTopic[ matchResult.thingNameOffset ] );
+        }
+
+        if( pThingNameLength != NULL )
+        {
+            *pThingNameLength = matchResult.thingNameLength;
+        }
+
+        if( pShadowName != NULL )
+        {
+            *pShadowName = &( pTopic[ SHADOW_PREFIX_LENGTH + matchResult.thingNameLength +
+                                      SHADOW_NAMED_ROOT_LENGTH ] );
+        }
+
+        if( pShadowNameLength != NULL )
+        {
+            *pShadowNameLength = matchResult.shadowNameLength;
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_MatchTopicBatch( const ShadowTopic_t * pTopics,
+                                       uint32_t topicCount,
+                                       ShadowMatchResult_t * pResults )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t index = 0U;
+
+    if( ( pTopics == NULL ) ||
+        ( topicCount == 0U ) ||
+        ( pResults == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pTopics: %p, topicCount: %u, pResults: %p.",
+                    ( const void * ) pTopics,
+                    ( unsigned int ) topicCount,
+                    ( const void * ) pResults ) );
+    }
+    else
+    {
+        for( ; index < topicCount; index++ )
+        {
+            /* Only the topic itself is checked per entry; the array parameters
+             * have been validated once for the whole batch. */
+            if( ( pTopics[ index ].pTopic == NULL ) || ( pTopics[ index ].topicLength == 0U ) )
+            {
+                pResults[ index ].status = SHADOW_BAD_PARAMETER;
+            }
+            else
+            {
+                ( void ) matchTopic( pTopics[ index ].pTopic,
+                                     pTopics[ index ].topicLength,
+                                     &( pResults[ index ] ),
+                                     NULL );
+            }
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_PrefilterTopic( const char * pTopic,
+                                      uint16_t topicLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_FAIL;
+
+    if( ( pTopic == NULL ) || ( topicLength == 0U ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pTopic: %p, topicLength: %u.",
+                    ( const void * ) pTopic,
+                    ( unsigned int ) topicLength ) );
+    }
+    else if( topicLength >= SHADOW_TOPIC_LEN_MIN )
+    {
+        shadowStatus = matchPrefixWords( pTopic, topicLength );
+    }
+    else
+    {
+        /* Too short to be a Shadow topic. */
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_ClassifyTopic( const char * pTopic,
+                                     uint16_t topicLength,
+                                     ShadowMessageType_t * pMessageType )
+{
+    ShadowStatus_t shadowStatus = SHADOW_FAIL;
+    uint8_t index = ( uint8_t ) ShadowMessageTypeMaxNum;
+    uint16_t operationLength = 0U;
+
+    if( ( pTopic == NULL ) ||
+        ( topicLength == 0U ) ||
+        ( pMessageType == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pTopic: %p, topicLength: %u, pMessageType: %p.",
+                    ( const void * ) pTopic,
+                    ( unsigned int ) topicLength,
+                    ( const void * ) pMessageType ) );
+    }
+    else if( topicLength >= SHADOW_TOPIC_LEN_MIN )
+    {
+        shadowStatus = matchPrefixWords( pTopic, topicLength );
+    }
+    else
+    {
+        /* Too short to be a Shadow topic. */
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        shadowStatus = SHADOW_MESSAGE_TYPE_PARSE_FAILED;
+        index = findSuffixOperation( pTopic, topicLength );
+    }
+
+    if( index < ( uint8_t ) ShadowMessageTypeMaxNum )
+    {
+        operationLength = SHADOW_MESSAGE_DESCRIPTOR( index ).length;
+
+        /* The operation must leave room for a Thing name and the classic
+         * shadow root after the prefix. */
+        if( ( topicLength >= ( SHADOW_PREFIX_LENGTH + 1U + SHADOW_CLASSIC_ROOT_LENGTH + operationLength ) ) &&
+            ( memcmp( ( const void * ) &( pTopic[ topicLength - operationLength ] ),
+                      ( const void * ) SHADOW_MESSAGE_DESCRIPTOR( index ).pString,
+                      ( size_t ) operationLength ) == 0 ) )
+        {
+            /* Topics of other services, such as Jobs, also end with
+             * "/get/accepted" or "/update/accepted". */
+            if( isShadowRootBefore( pTopic, ( uint16_t ) ( topicLength - operationLength ) ) == true )
+            {
+                *pMessageType = SHADOW_MESSAGE_DESCRIPTOR( index ).messageType;
+                shadowStatus = SHADOW_SUCCESS;
+            }
+            else
+            {
+                shadowStatus = SHADOW_ROOT_PARSE_FAILED;
+            }
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_MatchTopicHash( const char * pTopic,
+                                      uint16_t topicLength,
+                                      ShadowMatchResult_t * pResult,
+                                      ShadowTopicHash_t * pHash )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( ( pTopic == NULL ) ||
+        ( topicLength == 0U ) ||
+        ( pResult == NULL ) ||
+        ( pHash == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pTopic: %p, topicLength: %u, pResult: %p, pHash: %p.",
+                    ( const void * ) pTopic,
+                    ( unsigned int ) topicLength,
+                    ( void * ) pResult,
+                    ( void * ) pHash ) );
+    }
+    else
+    {
+        shadowStatus = matchTopic( pTopic, topicLength, pResult, pHash );
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_HashNames( const char * pThingName,
+                                 uint8_t thingNameLength,
+                                 const char * pShadowName,
+                                 uint8_t shadowNameLength,
+                                 ShadowTopicHash_t * pHash )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( ( pThingName == NULL ) ||
+        ( thingNameLength == 0U ) ||
+        ( ( pShadowName == NULL ) && ( shadowNameLength > 0U ) ) ||
+        ( pHash == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pThingName: %p, thingNameLength: %u, pShadowName: %p, shadowNameLength: %u, pHash: %p.",
+                    ( const void * ) pThingName,
+                    ( unsigned int ) thingNameLength,
+                    ( const void * ) pShadowName,
+                    ( unsigned int ) shadowNameLength,
+                    ( void * ) pHash ) );
+    }
+    else
+    {
+        pHash->thingNameHash = hashBytes( SHADOW_HASH_OFFSET_BASIS, pThingName, thingNameLength );
+        pHash->shadowNameHash = hashBytes( SHADOW_HASH_OFFSET_BASIS, pShadowName, shadowNameLength );
+        hashKey( pHash );
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_MatchTopicStart( ShadowMatchContext_t * pContext,
+                                       ShadowTopicHash_t * pHash )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( pContext == NULL )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameter pContext: %p.",
+                    ( void * ) pContext ) );
+    }
+    else
+    {
+        pContext->state = ( uint8_t ) MatchStatePrefix;
+        pContext->failedStatus = SHADOW_FAIL;
+        pContext->literalIndex = 0U;
+        pContext->nameLength = 0U;
+        pContext->thingNameLength = 0U;
+        pContext->shadowNameLength = 0U;
+        pContext->operationIndex = 0U;
+        pContext->pHash = pHash;
+
+        if( pHash != NULL )
         {
-            consumedTopicLength += SHADOW_PREFIX_LENGTH;
-        }
-        else
-        {
-            LogDebug( ( "Not a Shadow topic. Failed to parse shadow topic prefix in pTopic %.*s", topicLength, pTopic ) );
+            pHash->thingNameHash = SHADOW_HASH_OFFSET_BASIS;
+            pHash->shadowNameHash = SHADOW_HASH_OFFSET_BASIS;
         }
     }
 
-    if( shadowStatus == SHADOW_SUCCESS )
-    {
-        /* Extract thing name. */
-        shadowStatus = extractThingName( pTopic,
-                                         topicLength,
-                                         &consumedTopicLength,
-                                         &thingNameLength );
-    }
+    return shadowStatus;
+}
 
-    if( shadowStatus == SHADOW_SUCCESS )
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_MatchTopicChunk( ShadowMatchContext_t * pContext,
+                                       const char * pChunk,
+                                       uint16_t chunkLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( ( pContext == NULL ) ||
+        ( pChunk == NULL ) )
     {
-        shadowStatus = extractShadowRootAndName( pTopic,
-                                                 topicLength,
-                                                 &consumedTopicLength,
-                                                 &shadowNameLength );
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pContext: %p, pChunk: %p.",
+                    ( void * ) pContext,
+                    ( const void * ) pChunk ) );
     }
-
-    if( shadowStatus == SHADOW_SUCCESS )
+    else
     {
-        /* Extract shadow message type. */
-        shadowStatus = extractShadowMessageType( &( pTopic[ consumedTopicLength ] ),
-                                                 topicLength - consumedTopicLength,
-                                                 pMessageType );
+        matchTopicBytes( pContext, pChunk, chunkLength );
 
-        if( shadowStatus != SHADOW_SUCCESS )
+        /* Let the caller stop feeding chunks of a topic that can no longer
+         * be a Shadow topic. */
+        if( pContext->state == ( uint8_t ) MatchStateFailed )
         {
-            shadowStatus = SHADOW_MESSAGE_TYPE_PARSE_FAILED;
-            LogDebug( ( "Not a Shadow topic. Shadow message type is not in pTopic %.*s, failed to parse shadow message type.", topicLength, pTopic ) );
+            shadowStatus = pContext->failedStatus;
         }
     }
 
-    if( shadowStatus == SHADOW_SUCCESS )
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_MatchTopicFinish( const ShadowMatchContext_t * pContext,
+                                        ShadowMatchResult_t * pResult )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( ( pContext == NULL ) ||
+        ( pResult == NULL ) )
     {
-        /* Update the out parameters if we successfully matched the topic. */
-        if( pThingName != NULL )
-        {
-            /* Thing name comes after shadow prefix. */
-            *pThingName = &( pTopic[ SHADOW_PREFIX_LENGTH ] );
-        }
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pContext: %p, pResult: %p.",
+                    ( const void * ) pContext,
+                    ( void * ) pResult ) );
+    }
+    else
+    {
+        shadowStatus = finishTopic( pContext );
 
-        if( pThingNameLength != NULL )
+        if( shadowStatus == SHADOW_SUCCESS )
         {
-            *pThingNameLength = thingNameLength;
-        }
+            pResult->messageType = SHADOW_MESSAGE_DESCRIPTOR( pContext->operationIndex ).messageType;
+            setResultNames( pResult, pContext->thingNameLength, pContext->shadowNameLength );
 
-        if( pShadowName != NULL )
-        {
-            *pShadowName = &( pTopic[ SHADOW_PREFIX_LENGTH + thingNameLength +
-                                      SHADOW_NAMED_ROOT_LENGTH ] );
+            if( pContext->pHash != NULL )
+            {
+                hashKey( pContext->pHash );
+            }
         }
 
-        if( pShadowNameLength != NULL )
-        {
-            *pShadowNameLength = shadowNameLength;
-        }
+        pResult->status = shadowStatus;
     }
 
     return shadowStatus;
@@ -898,7 +3560,7 @@ ShadowStatus_t Shadow_AssembleTopicString( ShadowTopicStringType_t topicType,
                                      ( ( shadowNameLength > 0U ) ? /* Handle named or classic shadow */
                                        ( SHADOW_NAMED_ROOT_LENGTH + shadowNameLength ) :
                                        SHADOW_CLASSIC_ROOT_LENGTH ) +
-                                     getShadowOperationLength( topicType ); /* Shadow operation. */
+                                     ShadowTopicDescriptors[ topicType ].length; /* Shadow operation. */
 
         if( bufferSize < generatedTopicStringLength )
         {
@@ -927,6 +3589,505 @@ ShadowStatus_t Shadow_AssembleTopicString( ShadowTopicStringType_t topicType,
 }
 /*-----------------------------------------------------------*/
 
+ShadowStatus_t Shadow_AssembleAllTopics( const char * pThingName,
+                                         uint8_t thingNameLength,
+                                         const char * pShadowName,
+                                         uint8_t shadowNameLength,
+                                         char * pTopicBuffer,
+                                         uint16_t bufferSize,
+                                         ShadowTopicSpan_t * pTopicSpans,
+                                         uint16_t * pOutLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_BAD_PARAMETER;
+    ShadowNames_t names;
+    uint32_t outLength = 0U;
+
+    if( pOutLength == NULL )
+    {
+        LogError( ( "Invalid input parameter pOutLength: %p.", ( void * ) pOutLength ) );
+    }
+    else
+    {
+        names.pThingName = pThingName;
+        names.thingNameLength = thingNameLength;
+        names.pShadowName = pShadowName;
+        names.shadowNameLength = shadowNameLength;
+
+        shadowStatus = Shadow_AssembleTopicsBulk( &names,
+                                                  1U,
+                                                  SHADOW_TOPIC_TYPE_ALL,
+                                                  pTopicBuffer,
+                                                  ( uint32_t ) bufferSize,
+                                                  pTopicSpans,
+                                                  &outLength );
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        *pOutLength = ( uint16_t ) outLength;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_AssembleTopicsBulk( const ShadowNames_t * pNames,
+                                          uint32_t nameCount,
+                                          uint16_t topicTypeMask,
+                                          char * pTopicBuffer,
+                                          uint32_t bufferSize,
+                                          ShadowTopicSpan_t * pTopicSpans,
+                                          uint32_t * pOutLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t index = 0U;
+    uint32_t typeCount = 0U;
+    uint32_t requiredLength = 0U;
+    uint32_t offset = 0U;
+
+    if( ( pNames == NULL ) ||
+        ( nameCount == 0U ) ||
+        ( nameCount > SHADOW_BULK_NAME_COUNT_MAX ) ||
+        ( topicTypeMask == 0U ) ||
+        ( ( topicTypeMask & ( uint16_t ) ~SHADOW_TOPIC_TYPE_ALL ) != 0U ) ||
+        ( pTopicBuffer == NULL ) ||
+        ( pTopicSpans == NULL ) ||
+        ( pOutLength == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pNames: %p, nameCount: %u, topicTypeMask: 0x%x,\
+                    pTopicBuffer: %p, pTopicSpans: %p, pOutLength: %p.",
+                    ( const void * ) pNames,
+                    ( unsigned int ) nameCount,
+                    ( unsigned int ) topicTypeMask,
+                    ( void * ) pTopicBuffer,
+                    ( void * ) pTopicSpans,
+                    ( void * ) pOutLength ) );
+    }
+
+    /* Validate every name and add up the length of all the topics before
+     * writing any of them. The bound on nameCount keeps the sum from
+     * overflowing. */
+    for( index = 0U; ( shadowStatus == SHADOW_SUCCESS ) && ( index < nameCount ); index++ )
+    {
+        shadowStatus = validateTopicNames( pNames[ index ].pThingName,
+                                           pNames[ index ].thingNameLength,
+                                           pNames[ index ].pShadowName,
+                                           pNames[ index ].shadowNameLength );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            requiredLength += getShadowTopicsLength( &( pNames[ index ] ), topicTypeMask );
+        }
+    }
+
+    if( ( shadowStatus == SHADOW_SUCCESS ) && ( bufferSize < requiredLength ) )
+    {
+        shadowStatus = SHADOW_BUFFER_TOO_SMALL;
+        LogError( ( "Input bufferSize too small, bufferSize %u, required %u.",
+                    ( unsigned int ) bufferSize,
+                    ( unsigned int ) requiredLength ) );
+        *pOutLength = requiredLength;
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        typeCount = countTopicTypes( topicTypeMask );
+
+        for( index = 0U; index < nameCount; index++ )
+        {
+            offset = assembleShadowTopics( &( pNames[ index ] ),
+                                           topicTypeMask,
+                                           pTopicBuffer,
+                                           offset,
+                                           &( pTopicSpans[ index * typeCount ] ) );
+        }
+
+        *pOutLength = offset;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_AssembleWildcardFilters( const ShadowNames_t * pNames,
+                                               uint32_t nameCount,
+                                               uint16_t topicTypeMask,
+                                               ShadowWildcardEntry_t * pScratch,
+                                               char * pFilterBuffer,
+                                               uint32_t bufferSize,
+                                               ShadowTopicSpan_t * pFilterSpans,
+                                               uint32_t spanCount,
+                                               uint32_t * pFilterCount,
+                                               uint32_t * pOutLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    WildcardFilterOperation_t operations[ ShadowTopicStringTypeMaxNum ];
+    ShadowNames_t filterNames;
+    uint16_t operationCount = 0U;
+    uint32_t filterCount = 0U;
+    uint32_t requiredLength = 0U;
+    uint32_t index = 0U;
+    uint16_t operationIndex = 0U;
+
+    if( ( pNames == NULL ) ||
+        ( nameCount == 0U ) ||
+        ( nameCount > SHADOW_BULK_NAME_COUNT_MAX ) ||
+        ( topicTypeMask == 0U ) ||
+        ( ( topicTypeMask & ( uint16_t ) ~SHADOW_TOPIC_TYPE_ALL ) != 0U ) ||
+        ( pScratch == NULL ) ||
+        ( pFilterBuffer == NULL ) ||
+        ( pFilterSpans == NULL ) ||
+        ( pFilterCount == NULL ) ||
+        ( pOutLength == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pNames: %p, nameCount: %u, topicTypeMask: 0x%x, pScratch: %p,\
+                    pFilterBuffer: %p, pFilterSpans: %p, pFilterCount: %p, pOutLength: %p.",
+                    ( const void * ) pNames,
+                    ( unsigned int ) nameCount,
+                    ( unsigned int ) topicTypeMask,
+                    ( void * ) pScratch,
+                    ( void * ) pFilterBuffer,
+                    ( void * ) pFilterSpans,
+                    ( void * ) pFilterCount,
+                    ( void * ) pOutLength ) );
+    }
+
+    for( index = 0U; ( shadowStatus == SHADOW_SUCCESS ) && ( index < nameCount ); index++ )
+    {
+        shadowStatus = validateTopicNames( pNames[ index ].pThingName,
+                                           pNames[ index ].thingNameLength,
+                                           pNames[ index ].pShadowName,
+                                           pNames[ index ].shadowNameLength );
+    }
+
+    /* The shadows are grouped by sorting them in the scratch space, which
+     * also marks the first shadow of each group. The spans are only written
+     * once they are known to fit. */
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        operationCount = getFilterOperations( topicTypeMask, operations );
+        groupWildcardEntries( pNames, pScratch, nameCount );
+
+        for( index = 0U; index < nameCount; index++ )
+        {
+            if( ( pScratch[ index ].flags & SHADOW_WILDCARD_FLAG_FIRST ) != 0U )
+            {
+                getWildcardNames( &( pNames[ index ] ), &( pScratch[ index ] ), &filterNames );
+
+                for( operationIndex = 0U; operationIndex < operationCount; operationIndex++ )
+                {
+                    requiredLength += getWildcardFilterLength( &filterNames, &( operations[ operationIndex ] ) );
+                }
+
+                filterCount += operationCount;
+            }
+        }
+
+        if( spanCount < filterCount )
+        {
+            shadowStatus = SHADOW_BUFFER_TOO_SMALL;
+            LogError( ( "Input spanCount too small, spanCount %u, required %u.",
+                        ( unsigned int ) spanCount,
+                        ( unsigned int ) filterCount ) );
+        }
+        else if( bufferSize < requiredLength )
+        {
+            shadowStatus = SHADOW_BUFFER_TOO_SMALL;
+            LogError( ( "Input bufferSize too small, bufferSize %u, required %u.",
+                        ( unsigned int ) bufferSize,
+                        ( unsigned int ) requiredLength ) );
+        }
+        else
+        {
+            /* Both the spans and the buffer are large enough. */
+        }
+
+        *pFilterCount = filterCount;
+        *pOutLength = requiredLength;
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        filterCount = 0U;
+        requiredLength = 0U;
+
+        for( index = 0U; index < nameCount; index++ )
+        {
+            if( ( pScratch[ index ].flags & SHADOW_WILDCARD_FLAG_FIRST ) != 0U )
+            {
+                getWildcardNames( &( pNames[ index ] ), &( pScratch[ index ] ), &filterNames );
+
+                for( operationIndex = 0U; operationIndex < operationCount; operationIndex++ )
+                {
+                    pFilterSpans[ filterCount ].offset = requiredLength;
+                    pFilterSpans[ filterCount ].length = getWildcardFilterLength( &filterNames,
+                                                                                  &( operations[ operationIndex ] ) );
+                    writeWildcardFilter( &filterNames,
+                                         &( operations[ operationIndex ] ),
+                                         &( pFilterBuffer[ requiredLength ] ) );
+                    requiredLength += pFilterSpans[ filterCount ].length;
+                    filterCount++;
+                }
+            }
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_FilterIndexInit( ShadowFilterIndex_t * pIndex,
+                                       const char * pFilterBuffer,
+                                       const ShadowTopicSpan_t * pFilterSpans,
+                                       uint32_t filterCount,
+                                       ShadowFilterSlot_t * pSlots,
+                                       uint32_t slotCount )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t index = 0U;
+    uint32_t slotIndex = 0U;
+    uint32_t hash = 0U;
+
+    if( ( pIndex == NULL ) ||
+        ( pFilterBuffer == NULL ) ||
+        ( pFilterSpans == NULL ) ||
+        ( pSlots == NULL ) ||
+        ( slotCount == 0U ) ||
+        ( ( slotCount & ( slotCount - 1U ) ) != 0U ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pIndex: %p, pFilterBuffer: %p, pFilterSpans: %p, pSlots: %p, slotCount: %u.",
+                    ( void * ) pIndex,
+                    ( const void * ) pFilterBuffer,
+                    ( const void * ) pFilterSpans,
+                    ( void * ) pSlots,
+                    ( unsigned int ) slotCount ) );
+    }
+    else if( slotCount < filterCount )
+    {
+        shadowStatus = SHADOW_BUFFER_TOO_SMALL;
+        LogError( ( "Input slotCount too small, slotCount %u, required %u.",
+                    ( unsigned int ) slotCount,
+                    ( unsigned int ) filterCount ) );
+    }
+    else
+    {
+        for( index = 0U; index < slotCount; index++ )
+        {
+            pSlots[ index ].filterIndex = SHADOW_FILTER_SLOT_EMPTY;
+        }
+
+        /* Each topic filter takes the first empty slot from the one that its
+         * hash selects. There are at least as many slots as topic filters, so
+         * there is always an empty slot. */
+        for( index = 0U; index < filterCount; index++ )
+        {
+            hash = hashThingLevel( &( pFilterBuffer[ pFilterSpans[ index ].offset ] ),
+                                   pFilterSpans[ index ].length );
+            slotIndex = hash & ( slotCount - 1U );
+
+            while( pSlots[ slotIndex ].filterIndex != SHADOW_FILTER_SLOT_EMPTY )
+            {
+                slotIndex = ( slotIndex + 1U ) & ( slotCount - 1U );
+            }
+
+            pSlots[ slotIndex ].filterIndex = index;
+            pSlots[ slotIndex ].hash = hash;
+        }
+
+        pIndex->pFilterBuffer = pFilterBuffer;
+        pIndex->pFilterSpans = pFilterSpans;
+        pIndex->filterCount = filterCount;
+        pIndex->pSlots = pSlots;
+        pIndex->slotCount = slotCount;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_MatchTopicFilters( const ShadowFilterIndex_t * pIndex,
+                                         const char * pTopic,
+                                         uint16_t topicLength,
+                                         uint32_t * pFilterIndex )
+{
+    ShadowStatus_t shadowStatus = SHADOW_NOT_FOUND;
+    uint32_t hash = 0U;
+    uint32_t matchIndex = SHADOW_FILTER_SLOT_EMPTY;
+
+    if( ( pIndex == NULL ) ||
+        ( pIndex->pSlots == NULL ) ||
+        ( pTopic == NULL ) ||
+        ( topicLength == 0U ) ||
+        ( pFilterIndex == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pIndex: %p, pTopic: %p, topicLength: %u, pFilterIndex: %p.",
+                    ( const void * ) pIndex,
+                    ( const void * ) pTopic,
+                    ( unsigned int ) topicLength,
+                    ( void * ) pFilterIndex ) );
+    }
+    else
+    {
+        /* Only the topic filters with the Thing name of the topic, and those
+         * without a Thing name, can match the topic. */
+        hash = hashThingLevel( pTopic, topicLength );
+        matchIndex = matchIndexedFilters( pIndex, hash, pTopic, topicLength, matchIndex );
+
+        if( hash != SHADOW_FILTER_WILDCARD_HASH )
+        {
+            matchIndex = matchIndexedFilters( pIndex, SHADOW_FILTER_WILDCARD_HASH, pTopic, topicLength, matchIndex );
+        }
+
+        if( matchIndex != SHADOW_FILTER_SLOT_EMPTY )
+        {
+            *pFilterIndex = matchIndex;
+            shadowStatus = SHADOW_SUCCESS;
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_SerializeSubscribePayload( const ShadowNames_t * pNames,
+                                                 uint32_t nameCount,
+                                                 uint16_t topicTypeMask,
+                                                 uint8_t qos,
+                                                 uint8_t * pBuffer,
+                                                 uint32_t bufferSize,
+                                                 uint32_t * pOutLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_BAD_PARAMETER;
+
+    if( qos > SHADOW_SUBSCRIBE_QOS_MAX )
+    {
+        LogError( ( "Invalid input parameter qos: %u.", ( unsigned int ) qos ) );
+    }
+    else
+    {
+        shadowStatus = serializeTopicPayload( pNames,
+                                              nameCount,
+                                              topicTypeMask,
+                                              true,
+                                              qos,
+                                              pBuffer,
+                                              bufferSize,
+                                              pOutLength );
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_SerializeUnsubscribePayload( const ShadowNames_t * pNames,
+                                                   uint32_t nameCount,
+                                                   uint16_t topicTypeMask,
+                                                   uint8_t * pBuffer,
+                                                   uint32_t bufferSize,
+                                                   uint32_t * pOutLength )
+{
+    return serializeTopicPayload( pNames,
+                                  nameCount,
+                                  topicTypeMask,
+                                  false,
+                                  0U,
+                                  pBuffer,
+                                  bufferSize,
+                                  pOutLength );
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_AssembleTopicSegments( ShadowTopicStringType_t topicType,
+                                             const char * pThingName,
+                                             uint8_t thingNameLength,
+                                             const char * pShadowName,
+                                             uint8_t shadowNameLength,
+                                             ShadowTopicSegment_t * pSegments,
+                                             uint8_t * pSegmentCount,
+                                             uint16_t * pOutLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_BAD_PARAMETER;
+    uint8_t segmentCount = 0U;
+    uint16_t topicLength = 0U;
+    uint8_t index = 0U;
+
+    if( ( topicType >= ShadowTopicStringTypeMaxNum ) ||
+        ( pSegments == NULL ) ||
+        ( pSegmentCount == NULL ) ||
+        ( pOutLength == NULL ) )
+    {
+        LogError( ( "Invalid input parameters topicType: %d, pSegments: %p, pSegmentCount: %p, pOutLength: %p.",
+                    ( int ) topicType,
+                    ( void * ) pSegments,
+                    ( void * ) pSegmentCount,
+                    ( void * ) pOutLength ) );
+    }
+    else
+    {
+        shadowStatus = validateTopicNames( pThingName,
+                                           thingNameLength,
+                                           pShadowName,
+                                           shadowNameLength );
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        /* The segments are the parts createShadowTopicString() copies, in the
+         * same order. */
+        pSegments[ segmentCount ].pSegment = SHADOW_PREFIX;
+        pSegments[ segmentCount ].length = SHADOW_PREFIX_LENGTH;
+        segmentCount++;
+
+        pSegments[ segmentCount ].pSegment = pThingName;
+        pSegments[ segmentCount ].length = thingNameLength;
+        segmentCount++;
+
+        if( shadowNameLength > 0U )
+        {
+            pSegments[ segmentCount ].pSegment = SHADOW_NAMED_ROOT;
+            pSegments[ segmentCount ].length = SHADOW_NAMED_ROOT_LENGTH;
+            segmentCount++;
+
+            pSegments[ segmentCount ].pSegment = pShadowName;
+            pSegments[ segmentCount ].length = shadowNameLength;
+            segmentCount++;
+        }
+        else
+        {
+            pSegments[ segmentCount ].pSegment = SHADOW_CLASSIC_ROOT;
+            pSegments[ segmentCount ].length = SHADOW_CLASSIC_ROOT_LENGTH;
+            segmentCount++;
+        }
+
+        pSegments[ segmentCount ].pSegment = ShadowTopicDescriptors[ topicType ].pString;
+        pSegments[ segmentCount ].length = ShadowTopicDescriptors[ topicType ].length;
+        segmentCount++;
+
+        for( index = 0U; index < segmentCount; index++ )
+        {
+            topicLength = ( uint16_t ) ( topicLength + pSegments[ index ].length );
+        }
+
+        *pSegmentCount = segmentCount;
+        *pOutLength = topicLength;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
 ShadowStatus_t Shadow_MatchTopic( const char * pTopic,
                                   uint16_t topicLength,
                                   ShadowMessageType_t * pMessageType,
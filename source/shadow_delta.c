@@ -0,0 +1,497 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file shadow_delta.c
+ * @brief Implements the Shadow delta engine, which finds the keys of a
+ * desired state that differ from a reported state.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <string.h>
+
+/* Shadow includes. */
+#include "shadow_delta.h"
+
+/**
+ * @brief #ShadowDeltaEntry_t.kind of an entry that holds no key.
+ */
+#define ENTRY_EMPTY              ( 0U )
+
+/**
+ * @brief #ShadowDeltaEntry_t.kind of an entry that holds the key of an
+ * object, whose keys are in other entries.
+ */
+#define ENTRY_OBJECT             ( 1U )
+
+/**
+ * @brief #ShadowDeltaEntry_t.kind of an entry that holds a key and its value.
+ */
+#define ENTRY_VALUE              ( 2U )
+
+/**
+ * @brief The JSON literal that a desired state uses to delete a key.
+ */
+#define VALUE_NULL               "null"
+
+/**
+ * @brief Length of #VALUE_NULL.
+ */
+#define VALUE_NULL_LENGTH        ( ( uint32_t ) ( sizeof( VALUE_NULL ) - 1U ) )
+
+/**
+ * @brief Check the parameters of a state.
+ *
+ * @param[in] pDocument The state.
+ *
+ * @return true if the state can be read; false if not.
+ */
+static bool isValidDocument( const ShadowDeltaDocument_t * pDocument );
+
+/**
+ * @brief Hash a key of an object.
+ *
+ * @param[in] pPayload The document holding the key.
+ * @param[in] pKey The key.
+ * @param[in] parent Index of the entry of the object, or the entry count for
+ * a key of the state.
+ *
+ * @return The hash.
+ */
+static uint32_t hashKey( const char * pPayload,
+                         const ShadowPayloadView_t * pKey,
+                         uint32_t parent );
+
+/**
+ * @brief Probe the index for a key of an object.
+ *
+ * Probing starts at the entry selected by the hash and moves to the next
+ * entry until it finds the key or an empty entry, visiting each entry at most
+ * once.
+ *
+ * @param[in] pEngine The engine.
+ * @param[in] pPayload The document holding the key.
+ * @param[in] pKey The key.
+ * @param[in] parent Index of the entry of the object, or the entry count for
+ * a key of the state.
+ * @param[in] hash The hash of the key and parent.
+ * @param[out] pEntryIndex Index of the entry holding the key, or of the empty
+ * entry where the key can be added.
+ *
+ * @return Return SHADOW_SUCCESS if the key is found;
+ *         return SHADOW_NOT_FOUND if an empty entry is found first;
+ *         return SHADOW_BUFFER_TOO_SMALL if neither is found.
+ */
+static ShadowStatus_t findEntry( const ShadowDeltaEngine_t * pEngine,
+                                 const char * pPayload,
+                                 const ShadowPayloadView_t * pKey,
+                                 uint32_t parent,
+                                 uint32_t hash,
+                                 uint32_t * pEntryIndex );
+
+/**
+ * @brief Find the entry of a key path, optionally adding the entries that are
+ * missing.
+ *
+ * The entries of the last key path found are remembered, so the keys that a
+ * key path shares with the previous one, such as the keys of the objects
+ * holding both, are not looked up again.
+ *
+ * @param[in] pEngine The engine.
+ * @param[in] pPayload The document holding the keys.
+ * @param[in] pKeys The key path.
+ * @param[in] keyCount Number of keys in the key path.
+ * @param[in] add Whether to add the keys that are missing.
+ * @param[out] pEntryIndex Index of the entry of the last key.
+ *
+ * @return Return SHADOW_SUCCESS if the key path is found or added;
+ *         return SHADOW_NOT_FOUND if a key is missing and add is false;
+ *         return SHADOW_BUFFER_TOO_SMALL if a key is missing and there is no
+ *         empty entry to add it.
+ */
+static ShadowStatus_t findPath( ShadowDeltaEngine_t * pEngine,
+                                const char * pPayload,
+                                const ShadowPayloadView_t * pKeys,
+                                uint8_t keyCount,
+                                bool add,
+                                uint32_t * pEntryIndex );
+
+/**
+ * @brief Remove the key of the section of a state from the key path of a
+ * token.
+ *
+ * @param[in] pPayload The document.
+ * @param[in] pSection The key of the section, or NULL for the whole "state".
+ * @param[in] sectionLength Length of the key of the section.
+ * @param[in,out] pToken The token. Its key path is shortened if it is in the
+ * section.
+ *
+ * @return true if the token is a key of the state, with a value; false if not.
+ */
+static bool removeSection( const char * pPayload,
+                           const char * pSection,
+                           uint32_t sectionLength,
+                           ShadowDeltaToken_t * pToken );
+
+/**
+ * @brief Check if a value in a document is a string.
+ *
+ * @param[in] pPayload The document.
+ * @param[in] pValue The value, as returned by Shadow_DeltaParserNext().
+ *
+ * @return true if the value is a string; false if not.
+ */
+static bool isString( const char * pPayload,
+                      const ShadowPayloadView_t * pValue );
+
+/**
+ * @brief Check if a key of the desired state has the same value in the
+ * reported state.
+ *
+ * @param[in] pEngine The engine.
+ * @param[in] pToken The key and its desired value.
+ *
+ * @return true if the reported state has the same value; false if not.
+ */
+static bool isReported( ShadowDeltaEngine_t * pEngine,
+                        const ShadowDeltaToken_t * pToken );
+
+/*-----------------------------------------------------------*/
+
+static bool isValidDocument( const ShadowDeltaDocument_t * pDocument )
+{
+    return ( ( pDocument != NULL ) &&
+             ( pDocument->pPayload != NULL ) &&
+             ( pDocument->payloadLength != 0U ) &&
+             ( ( pDocument->pSection != NULL ) || ( pDocument->sectionLength == 0U ) ) ) ? true : false;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t hashKey( const char * pPayload,
+                         const ShadowPayloadView_t * pKey,
+                         uint32_t parent )
+{
+    uint32_t hash = ( SHADOW_HASH_OFFSET_BASIS ^ parent ) * SHADOW_HASH_PRIME;
+    uint32_t index = 0U;
+
+    for( index = 0U; index < pKey->length; index++ )
+    {
+        hash = SHADOW_HASH_BYTE( hash, pPayload[ pKey->offset + index ] );
+    }
+
+    return hash;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t findEntry( const ShadowDeltaEngine_t * pEngine,
+                                 const char * pPayload,
+                                 const ShadowPayloadView_t * pKey,
+                                 uint32_t parent,
+                                 uint32_t hash,
+                                 uint32_t * pEntryIndex )
+{
+    ShadowStatus_t shadowStatus = SHADOW_BUFFER_TOO_SMALL;
+    uint32_t mask = pEngine->entryCount - 1U;
+    uint32_t entryIndex = hash & mask;
+    uint32_t probeCount = 0U;
+    const ShadowDeltaEntry_t * pEntry = NULL;
+
+    for( probeCount = 0U; probeCount < pEngine->entryCount; probeCount++ )
+    {
+        pEntry = &( pEngine->pEntries[ entryIndex ] );
+
+        if( pEntry->kind == ENTRY_EMPTY )
+        {
+            shadowStatus = SHADOW_NOT_FOUND;
+        }
+        /* Compare the hash, parent and length first, so the key is only
+         * compared for an entry that almost certainly holds it. */
+        else if( ( pEntry->hash == hash ) &&
+                 ( pEntry->parent == parent ) &&
+                 ( pEntry->key.length == pKey->length ) &&
+                 ( memcmp( &( pEngine->pReported[ pEntry->key.offset ] ),
+                           &( pPayload[ pKey->offset ] ),
+                           pKey->length ) == 0 ) )
+        {
+            shadowStatus = SHADOW_SUCCESS;
+        }
+        else
+        {
+            entryIndex = ( entryIndex + 1U ) & mask;
+        }
+
+        if( shadowStatus != SHADOW_BUFFER_TOO_SMALL )
+        {
+            break;
+        }
+    }
+
+    *pEntryIndex = entryIndex;
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t findPath( ShadowDeltaEngine_t * pEngine,
+                                const char * pPayload,
+                                const ShadowPayloadView_t * pKeys,
+                                uint8_t keyCount,
+                                bool add,
+                                uint32_t * pEntryIndex )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowDeltaEntry_t * pEntry = NULL;
+    uint32_t parent = pEngine->entryCount;
+    uint32_t entryIndex = 0U;
+    uint32_t hash = 0U;
+    uint8_t level = 0U;
+
+    for( level = 0U; ( level < keyCount ) && ( shadowStatus == SHADOW_SUCCESS ); level++ )
+    {
+        if( ( level < pEngine->pathDepth ) &&
+            ( pEngine->pathOffsets[ level ] == pKeys[ level ].offset ) )
+        {
+            /* Same key as in the last key path. */
+            entryIndex = pEngine->pathEntries[ level ];
+        }
+        else
+        {
+            pEngine->pathDepth = level;
+            hash = hashKey( pPayload, &( pKeys[ level ] ), parent );
+            shadowStatus = findEntry( pEngine, pPayload, &( pKeys[ level ] ), parent, hash, &entryIndex );
+
+            if( ( shadowStatus == SHADOW_NOT_FOUND ) && ( add == true ) )
+            {
+                pEntry = &( pEngine->pEntries[ entryIndex ] );
+                pEntry->key = pKeys[ level ];
+                pEntry->parent = parent;
+                pEntry->hash = hash;
+                pEntry->kind = ENTRY_OBJECT;
+                shadowStatus = SHADOW_SUCCESS;
+            }
+
+            if( shadowStatus == SHADOW_SUCCESS )
+            {
+                pEngine->pathEntries[ level ] = entryIndex;
+                pEngine->pathOffsets[ level ] = pKeys[ level ].offset;
+                pEngine->pathDepth = ( uint8_t ) ( level + 1U );
+            }
+        }
+
+        parent = entryIndex;
+    }
+
+    *pEntryIndex = entryIndex;
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool removeSection( const char * pPayload,
+                           const char * pSection,
+                           uint32_t sectionLength,
+                           ShadowDeltaToken_t * pToken )
+{
+    bool inState = ( pToken->field == ShadowDeltaFieldKey ) ? true : false;
+
+    if( ( inState == true ) && ( pSection != NULL ) )
+    {
+        /* A key of the section has the key of the section, then its own key. */
+        if( ( pToken->keyCount > 1U ) &&
+            ( pToken->pKeys[ 0 ].length == sectionLength ) &&
+            ( memcmp( &( pPayload[ pToken->pKeys[ 0 ].offset ] ), pSection, sectionLength ) == 0 ) )
+        {
+            pToken->pKeys = &( pToken->pKeys[ 1 ] );
+            pToken->keyCount--;
+        }
+        else
+        {
+            inState = false;
+        }
+    }
+
+    return inState;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool isString( const char * pPayload,
+                      const ShadowPayloadView_t * pValue )
+{
+    /* The value of a string is returned without its quotes. Other values
+     * follow a ':' or whitespace. A value is never at offset zero, where the
+     * document starts with '{'. */
+    return ( pPayload[ pValue->offset - 1U ] == '"' ) ? true : false;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool isReported( ShadowDeltaEngine_t * pEngine,
+                        const ShadowDeltaToken_t * pToken )
+{
+    bool reported = false;
+    const char * pDesired = pEngine->parser.pPayload;
+    const ShadowDeltaEntry_t * pEntry = NULL;
+    uint32_t entryIndex = 0U;
+
+    if( findPath( pEngine, pDesired, pToken->pKeys, pToken->keyCount, false, &entryIndex ) == SHADOW_SUCCESS )
+    {
+        pEntry = &( pEngine->pEntries[ entryIndex ] );
+
+        reported = ( ( pEntry->kind == ENTRY_VALUE ) &&
+                     ( pEntry->value.length == pToken->value.length ) &&
+                     ( isString( pEngine->pReported, &( pEntry->value ) ) ==
+                       isString( pDesired, &( pToken->value ) ) ) &&
+                     ( memcmp( &( pEngine->pReported[ pEntry->value.offset ] ),
+                               &( pDesired[ pToken->value.offset ] ),
+                               pToken->value.length ) == 0 ) ) ? true : false;
+    }
+
+    return reported;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_DeltaEngineInit( ShadowDeltaEngine_t * pEngine,
+                                       const ShadowDeltaDocument_t * pDesired,
+                                       const ShadowDeltaDocument_t * pReported,
+                                       ShadowDeltaEntry_t * pEntries,
+                                       uint32_t entryCount )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowDeltaToken_t token = { ShadowDeltaFieldKey, { 0U, 0U }, NULL, 0U };
+    uint32_t index = 0U;
+
+    if( ( pEngine == NULL ) ||
+        ( isValidDocument( pDesired ) == false ) ||
+        ( isValidDocument( pReported ) == false ) ||
+        ( pEntries == NULL ) ||
+        ( entryCount == 0U ) ||
+        ( ( entryCount & ( entryCount - 1U ) ) != 0U ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pEngine: %p, pDesired: %p, pReported: %p, pEntries: %p, entryCount: %u.",
+                    ( void * ) pEngine,
+                    ( const void * ) pDesired,
+                    ( const void * ) pReported,
+                    ( void * ) pEntries,
+                    ( unsigned int ) entryCount ) );
+    }
+    else
+    {
+        for( index = 0U; index < entryCount; index++ )
+        {
+            pEntries[ index ].kind = ENTRY_EMPTY;
+        }
+
+        pEngine->pDesiredSection = pDesired->pSection;
+        pEngine->desiredSectionLength = pDesired->sectionLength;
+        pEngine->pReported = pReported->pPayload;
+        pEngine->pEntries = pEntries;
+        pEngine->entryCount = entryCount;
+        pEngine->pathDepth = 0U;
+
+        /* Index the reported state with the parser that is then used for the
+         * desired state. */
+        ( void ) Shadow_DeltaParserInit( &( pEngine->parser ), pReported->pPayload, pReported->payloadLength );
+    }
+
+    while( shadowStatus == SHADOW_SUCCESS )
+    {
+        shadowStatus = Shadow_DeltaParserNext( &( pEngine->parser ), &token );
+
+        if( ( shadowStatus == SHADOW_SUCCESS ) &&
+            ( removeSection( pReported->pPayload, pReported->pSection, pReported->sectionLength, &token ) == true ) )
+        {
+            shadowStatus = findPath( pEngine, pReported->pPayload, token.pKeys, token.keyCount, true, &index );
+
+            if( shadowStatus == SHADOW_SUCCESS )
+            {
+                pEntries[ index ].value = token.value;
+                pEntries[ index ].kind = ENTRY_VALUE;
+            }
+        }
+    }
+
+    if( shadowStatus == SHADOW_NOT_FOUND )
+    {
+        pEngine->pathDepth = 0U;
+        shadowStatus = Shadow_DeltaParserInit( &( pEngine->parser ), pDesired->pPayload, pDesired->payloadLength );
+    }
+    else if( shadowStatus == SHADOW_BUFFER_TOO_SMALL )
+    {
+        LogError( ( "The reported state has more keys than the %u entries of the index.",
+                    ( unsigned int ) entryCount ) );
+    }
+    else
+    {
+        /* Invalid parameters, or a reported document that cannot be parsed. */
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_DeltaEngineNext( ShadowDeltaEngine_t * pEngine,
+                                       ShadowDeltaToken_t * pToken )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    bool found = false;
+
+    if( ( pEngine == NULL ) || ( pToken == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pEngine: %p, pToken: %p.",
+                    ( void * ) pEngine,
+                    ( void * ) pToken ) );
+    }
+
+    while( ( shadowStatus == SHADOW_SUCCESS ) && ( found == false ) )
+    {
+        shadowStatus = Shadow_DeltaParserNext( &( pEngine->parser ), pToken );
+
+        if( ( shadowStatus == SHADOW_SUCCESS ) &&
+            ( removeSection( pEngine->parser.pPayload, pEngine->pDesiredSection,
+                             pEngine->desiredSectionLength, pToken ) == true ) )
+        {
+            /* A null desired value deletes the key, so it is never part of the delta. */
+            if( ( isString( pEngine->parser.pPayload, &( pToken->value ) ) == true ) ||
+                ( pToken->value.length != VALUE_NULL_LENGTH ) ||
+                ( memcmp( &( pEngine->parser.pPayload[ pToken->value.offset ] ),
+                          VALUE_NULL, VALUE_NULL_LENGTH ) != 0 ) )
+            {
+                found = ( isReported( pEngine, pToken ) == false ) ? true : false;
+            }
+        }
+    }
+
+    return shadowStatus;
+}
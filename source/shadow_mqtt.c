@@ -0,0 +1,704 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file shadow_mqtt.c
+ * @brief Implements matching Shadow topics in received MQTT packets.
+ */
+
+/* Standard includes. */
+#include <stddef.h>
+
+/* Shadow includes. */
+#include "shadow_mqtt.h"
+
+/**
+ * @brief The packet type of a PUBLISH packet, in the high nibble of the first
+ * byte of the fixed header.
+ */
+#define MQTT_PACKET_TYPE_PUBLISH                 ( 0x30U )
+
+/**
+ * @brief Mask of the packet type in the first byte of the fixed header.
+ */
+#define MQTT_PACKET_TYPE_MASK                    ( 0xF0U )
+
+/**
+ * @brief Position of the QoS in the flags of a PUBLISH packet.
+ */
+#define MQTT_PUBLISH_FLAG_QOS_POSITION           ( 1U )
+
+/**
+ * @brief Mask of the QoS in the flags of a PUBLISH packet, once shifted.
+ */
+#define MQTT_PUBLISH_FLAG_QOS_MASK               ( 0x03U )
+
+/**
+ * @brief The QoS value that is not allowed.
+ */
+#define MQTT_PUBLISH_QOS_INVALID                 ( 3U )
+
+/**
+ * @brief Maximum number of bytes of a Variable Byte Integer.
+ */
+#define MQTT_VARIABLE_LENGTH_BYTES_MAX           ( 4U )
+
+/**
+ * @brief Bit of a Variable Byte Integer byte that is set when another byte
+ * follows.
+ */
+#define MQTT_VARIABLE_LENGTH_CONTINUATION_BIT    ( 0x80U )
+
+/**
+ * @brief Mask of the value bits of a Variable Byte Integer byte.
+ */
+#define MQTT_VARIABLE_LENGTH_VALUE_MASK          ( 0x7FU )
+
+/**
+ * @brief Size of the topic name length and packet identifier fields.
+ */
+#define MQTT_UINT16_FIELD_SIZE                   ( 2U )
+
+/**
+ * @brief MQTT 5 PUBLISH property identifiers.
+ */
+#define MQTT_PROPERTY_PAYLOAD_FORMAT             ( 0x01U ) /**< @brief Payload Format Indicator, one byte. */
+#define MQTT_PROPERTY_MESSAGE_EXPIRY             ( 0x02U ) /**< @brief Message Expiry Interval, four bytes. */
+#define MQTT_PROPERTY_CONTENT_TYPE               ( 0x03U ) /**< @brief Content Type, a string. */
+#define MQTT_PROPERTY_RESPONSE_TOPIC             ( 0x08U ) /**< @brief Response Topic, a string. */
+#define MQTT_PROPERTY_CORRELATION_DATA           ( 0x09U ) /**< @brief Correlation Data, binary data. */
+#define MQTT_PROPERTY_SUBSCRIPTION_ID            ( 0x0BU ) /**< @brief Subscription Identifier, a Variable Byte Integer. */
+#define MQTT_PROPERTY_TOPIC_ALIAS                ( 0x23U ) /**< @brief Topic Alias, two bytes. */
+#define MQTT_PROPERTY_USER_PROPERTY              ( 0x26U ) /**< @brief User Property, a pair of strings. */
+
+/**
+ * @brief Size of the Message Expiry Interval property value.
+ */
+#define MQTT_UINT32_FIELD_SIZE                   ( 4U )
+
+/**
+ * @brief Decode an MQTT Variable Byte Integer, such as the remaining length of
+ * a packet.
+ *
+ * @param[in] pBytes The first byte of the integer.
+ * @param[in] availableLength Number of bytes available at pBytes.
+ * @param[out] pValue The decoded value.
+ * @param[out] pSize The number of bytes of the integer.
+ *
+ * @return SHADOW_SUCCESS if the integer is decoded; SHADOW_BAD_PARAMETER if it
+ * is longer than four bytes, or does not fit in availableLength.
+ */
+static ShadowStatus_t decodeVariableLength( const uint8_t * pBytes,
+                                            uint32_t availableLength,
+                                            uint32_t * pValue,
+                                            uint32_t * pSize );
+
+/**
+ * @brief Decode a big-endian two-byte integer.
+ *
+ * @param[in] pBytes The first byte of the integer.
+ *
+ * @return The decoded value.
+ */
+static uint16_t decodeUint16( const uint8_t * pBytes );
+
+/**
+ * @brief Find the topic and payload of a PUBLISH packet whose parameters have
+ * already been validated.
+ *
+ * @param[in] pPacket The packet.
+ * @param[in] packetLength Number of bytes available at pPacket.
+ * @param[in] protocolLevel The MQTT protocol level.
+ * @param[out] pPublishInfo The offsets and lengths of the topic and payload.
+ * @param[out] pPropertiesLength The length of the MQTT 5 properties, which end
+ * where the payload starts. Zero for MQTT 3.1.1.
+ *
+ * @return SHADOW_SUCCESS if the packet is a well-formed PUBLISH packet;
+ * SHADOW_BAD_PARAMETER if not.
+ */
+static ShadowStatus_t decodePublishPacket( const uint8_t * pPacket,
+                                           uint32_t packetLength,
+                                           uint8_t protocolLevel,
+                                           ShadowPublishInfo_t * pPublishInfo,
+                                           uint32_t * pPropertiesLength );
+
+/**
+ * @brief Get the size of an MQTT string or binary data field: its two-byte
+ * length and its content.
+ *
+ * @param[in] pBytes The first byte of the field.
+ * @param[in] availableLength Number of bytes available at pBytes.
+ * @param[out] pSize The size of the field.
+ *
+ * @return SHADOW_SUCCESS if the field fits in availableLength;
+ * SHADOW_BAD_PARAMETER if not.
+ */
+static ShadowStatus_t getStringSize( const uint8_t * pBytes,
+                                     uint32_t availableLength,
+                                     uint32_t * pSize );
+
+/**
+ * @brief Get the size of the value of an MQTT 5 PUBLISH property.
+ *
+ * @param[in] propertyId The property identifier.
+ * @param[in] pValue The first byte of the value.
+ * @param[in] availableLength Number of bytes available at pValue.
+ * @param[out] pSize The size of the value.
+ *
+ * @return SHADOW_SUCCESS if the value fits in availableLength;
+ * SHADOW_BAD_PARAMETER if not, or the property is not a PUBLISH property.
+ */
+static ShadowStatus_t getPropertySize( uint8_t propertyId,
+                                       const uint8_t * pValue,
+                                       uint32_t availableLength,
+                                       uint32_t * pSize );
+
+/**
+ * @brief Find the Topic Alias property in the properties of an MQTT 5
+ * PUBLISH packet.
+ *
+ * @param[in] pProperties The first property.
+ * @param[in] propertiesLength The length of the properties.
+ * @param[out] pTopicAlias The topic alias, if found.
+ *
+ * @return SHADOW_SUCCESS if the topic alias is found; SHADOW_NOT_FOUND if the
+ * packet has no topic alias; SHADOW_BAD_PARAMETER if the properties are
+ * malformed.
+ */
+static ShadowStatus_t findTopicAlias( const uint8_t * pProperties,
+                                      uint32_t propertiesLength,
+                                      uint16_t * pTopicAlias );
+
+/**
+ * @brief Match the topic of a decoded PUBLISH packet in place.
+ *
+ * @param[in] pPacket The packet.
+ * @param[in,out] pPublishInfo The topic of the packet, and the match result.
+ *
+ * @return The status of the match.
+ */
+static ShadowStatus_t matchPublishTopic( const uint8_t * pPacket,
+                                         ShadowPublishInfo_t * pPublishInfo );
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t decodeVariableLength( const uint8_t * pBytes,
+                                            uint32_t availableLength,
+                                            uint32_t * pValue,
+                                            uint32_t * pSize )
+{
+    ShadowStatus_t shadowStatus = SHADOW_BAD_PARAMETER;
+    uint32_t value = 0U;
+    uint32_t index = 0U;
+    uint32_t multiplier = 1U;
+    uint8_t encodedByte = MQTT_VARIABLE_LENGTH_CONTINUATION_BIT;
+
+    while( ( ( encodedByte & MQTT_VARIABLE_LENGTH_CONTINUATION_BIT ) != 0U ) &&
+           ( index < MQTT_VARIABLE_LENGTH_BYTES_MAX ) &&
+           ( index < availableLength ) )
+    {
+        encodedByte = pBytes[ index ];
+        value += ( uint32_t ) ( encodedByte & MQTT_VARIABLE_LENGTH_VALUE_MASK ) * multiplier;
+        multiplier *= 128U;
+        index++;
+    }
+
+    if( ( encodedByte & MQTT_VARIABLE_LENGTH_CONTINUATION_BIT ) == 0U )
+    {
+        shadowStatus = SHADOW_SUCCESS;
+        *pValue = value;
+        *pSize = index;
+    }
+    else
+    {
+        LogError( ( "Invalid or incomplete variable length integer." ) );
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint16_t decodeUint16( const uint8_t * pBytes )
+{
+    return ( uint16_t ) ( ( ( uint16_t ) pBytes[ 0 ] << 8U ) | ( uint16_t ) pBytes[ 1 ] );
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t decodePublishPacket( const uint8_t * pPacket,
+                                           uint32_t packetLength,
+                                           uint8_t protocolLevel,
+                                           ShadowPublishInfo_t * pPublishInfo,
+                                           uint32_t * pPropertiesLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t remainingLength = 0U;
+    uint32_t propertiesLength = 0U;
+    uint32_t fieldSize = 0U;
+    uint32_t offset = 1U;
+    uint32_t packetEnd = 0U;
+    uint8_t qos = 0U;
+
+    qos = ( uint8_t ) ( ( ( uint32_t ) pPacket[ 0 ] >> MQTT_PUBLISH_FLAG_QOS_POSITION ) & MQTT_PUBLISH_FLAG_QOS_MASK );
+
+    if( ( ( ( uint32_t ) pPacket[ 0 ] & MQTT_PACKET_TYPE_MASK ) != MQTT_PACKET_TYPE_PUBLISH ) ||
+        ( qos == MQTT_PUBLISH_QOS_INVALID ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Not a PUBLISH packet: first byte 0x%02x.", ( unsigned int ) pPacket[ 0 ] ) );
+    }
+    else
+    {
+        shadowStatus = decodeVariableLength( &( pPacket[ offset ] ),
+                                             packetLength - offset,
+                                             &remainingLength,
+                                             &fieldSize );
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        offset += fieldSize;
+
+        /* The whole packet must be available, so that the payload can be read
+         * in place. */
+        if( remainingLength > ( packetLength - offset ) )
+        {
+            shadowStatus = SHADOW_BAD_PARAMETER;
+            LogError( ( "Incomplete PUBLISH packet: remaining length %u, available %u.",
+                        ( unsigned int ) remainingLength,
+                        ( unsigned int ) ( packetLength - offset ) ) );
+        }
+        else
+        {
+            packetEnd = offset + remainingLength;
+        }
+    }
+
+    if( ( shadowStatus == SHADOW_SUCCESS ) && ( ( packetEnd - offset ) < MQTT_UINT16_FIELD_SIZE ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "PUBLISH packet too short for the topic name length." ) );
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        pPublishInfo->topicLength = decodeUint16( &( pPacket[ offset ] ) );
+        pPublishInfo->topicOffset = offset + MQTT_UINT16_FIELD_SIZE;
+        offset = pPublishInfo->topicOffset;
+
+        /* The packet identifier follows the topic name at QoS 1 and 2. */
+        fieldSize = ( qos > 0U ) ? MQTT_UINT16_FIELD_SIZE : 0U;
+
+        if( ( ( uint32_t ) pPublishInfo->topicLength + fieldSize ) > ( packetEnd - offset ) )
+        {
+            shadowStatus = SHADOW_BAD_PARAMETER;
+            LogError( ( "PUBLISH packet too short for a topic name of %u bytes.",
+                        ( unsigned int ) pPublishInfo->topicLength ) );
+        }
+        else
+        {
+            offset += ( uint32_t ) pPublishInfo->topicLength + fieldSize;
+        }
+    }
+
+    if( ( shadowStatus == SHADOW_SUCCESS ) && ( protocolLevel == SHADOW_MQTT_PROTOCOL_LEVEL_5 ) )
+    {
+        shadowStatus = decodeVariableLength( &( pPacket[ offset ] ),
+                                             packetEnd - offset,
+                                             &propertiesLength,
+                                             &fieldSize );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            offset += fieldSize;
+
+            if( propertiesLength > ( packetEnd - offset ) )
+            {
+                shadowStatus = SHADOW_BAD_PARAMETER;
+                LogError( ( "PUBLISH packet too short for properties of %u bytes.",
+                            ( unsigned int ) propertiesLength ) );
+            }
+            else
+            {
+                offset += propertiesLength;
+            }
+        }
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        pPublishInfo->payloadOffset = offset;
+        pPublishInfo->payloadLength = packetEnd - offset;
+        *pPropertiesLength = propertiesLength;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t getStringSize( const uint8_t * pBytes,
+                                     uint32_t availableLength,
+                                     uint32_t * pSize )
+{
+    ShadowStatus_t shadowStatus = SHADOW_BAD_PARAMETER;
+    uint32_t size = 0U;
+
+    if( availableLength >= MQTT_UINT16_FIELD_SIZE )
+    {
+        size = MQTT_UINT16_FIELD_SIZE + ( uint32_t ) decodeUint16( pBytes );
+
+        if( size <= availableLength )
+        {
+            shadowStatus = SHADOW_SUCCESS;
+            *pSize = size;
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t getPropertySize( uint8_t propertyId,
+                                       const uint8_t * pValue,
+                                       uint32_t availableLength,
+                                       uint32_t * pSize )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t size = 0U;
+    uint32_t secondSize = 0U;
+    uint32_t value = 0U;
+
+    switch( propertyId )
+    {
+        case MQTT_PROPERTY_PAYLOAD_FORMAT:
+            size = 1U;
+            break;
+
+        case MQTT_PROPERTY_MESSAGE_EXPIRY:
+            size = MQTT_UINT32_FIELD_SIZE;
+            break;
+
+        case MQTT_PROPERTY_TOPIC_ALIAS:
+            size = MQTT_UINT16_FIELD_SIZE;
+            break;
+
+        case MQTT_PROPERTY_CONTENT_TYPE:
+        case MQTT_PROPERTY_RESPONSE_TOPIC:
+        case MQTT_PROPERTY_CORRELATION_DATA:
+            shadowStatus = getStringSize( pValue, availableLength, &size );
+            break;
+
+        case MQTT_PROPERTY_USER_PROPERTY:
+            /* A name string followed by a value string. */
+            shadowStatus = getStringSize( pValue, availableLength, &size );
+
+            if( shadowStatus == SHADOW_SUCCESS )
+            {
+                shadowStatus = getStringSize( &( pValue[ size ] ), availableLength - size, &secondSize );
+                size += secondSize;
+            }
+
+            break;
+
+        case MQTT_PROPERTY_SUBSCRIPTION_ID:
+            shadowStatus = decodeVariableLength( pValue, availableLength, &value, &size );
+            break;
+
+        default:
+            shadowStatus = SHADOW_BAD_PARAMETER;
+            break;
+    }
+
+    if( ( shadowStatus == SHADOW_SUCCESS ) && ( size > availableLength ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        *pSize = size;
+    }
+    else
+    {
+        LogError( ( "Invalid PUBLISH property 0x%02x.", ( unsigned int ) propertyId ) );
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t findTopicAlias( const uint8_t * pProperties,
+                                      uint32_t propertiesLength,
+                                      uint16_t * pTopicAlias )
+{
+    ShadowStatus_t shadowStatus = SHADOW_NOT_FOUND;
+    uint32_t offset = 0U;
+    uint32_t valueSize = 0U;
+    uint8_t propertyId = 0U;
+
+    while( ( shadowStatus == SHADOW_NOT_FOUND ) && ( offset < propertiesLength ) )
+    {
+        propertyId = pProperties[ offset ];
+        offset++;
+
+        shadowStatus = getPropertySize( propertyId,
+                                        &( pProperties[ offset ] ),
+                                        propertiesLength - offset,
+                                        &valueSize );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            if( propertyId == MQTT_PROPERTY_TOPIC_ALIAS )
+            {
+                *pTopicAlias = decodeUint16( &( pProperties[ offset ] ) );
+            }
+            else
+            {
+                shadowStatus = SHADOW_NOT_FOUND;
+            }
+
+            offset += valueSize;
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t matchPublishTopic( const uint8_t * pPacket,
+                                         ShadowPublishInfo_t * pPublishInfo )
+{
+    ShadowTopic_t topic = { NULL, 0U };
+
+    /* Topic names are UTF-8 strings, so the topic can be matched where it
+     * is in the packet. */
+    topic.pTopic = ( const char * ) &( pPacket[ pPublishInfo->topicOffset ] );
+    topic.topicLength = pPublishInfo->topicLength;
+
+    ( void ) Shadow_MatchTopicBatch( &topic, 1U, &( pPublishInfo->match ) );
+
+    return pPublishInfo->match.status;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_MatchPublishPacket( const uint8_t * pPacket,
+                                          uint32_t packetLength,
+                                          uint8_t protocolLevel,
+                                          ShadowPublishInfo_t * pPublishInfo )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t propertiesLength = 0U;
+
+    if( ( pPacket == NULL ) ||
+        ( packetLength == 0U ) ||
+        ( ( protocolLevel != SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1 ) &&
+          ( protocolLevel != SHADOW_MQTT_PROTOCOL_LEVEL_5 ) ) ||
+        ( pPublishInfo == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pPacket: %p, packetLength: %u, protocolLevel: %u, pPublishInfo: %p.",
+                    ( const void * ) pPacket,
+                    ( unsigned int ) packetLength,
+                    ( unsigned int ) protocolLevel,
+                    ( void * ) pPublishInfo ) );
+    }
+    else
+    {
+        shadowStatus = decodePublishPacket( pPacket, packetLength, protocolLevel, pPublishInfo, &propertiesLength );
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        shadowStatus = matchPublishTopic( pPacket, pPublishInfo );
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_TopicAliasInit( ShadowTopicAliasTable_t * pAliasTable,
+                                      ShadowMatchResult_t * pEntries,
+                                      uint16_t entryCount )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( ( pAliasTable == NULL ) ||
+        ( pEntries == NULL ) ||
+        ( entryCount == 0U ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pAliasTable: %p, pEntries: %p, entryCount: %u.",
+                    ( void * ) pAliasTable,
+                    ( void * ) pEntries,
+                    ( unsigned int ) entryCount ) );
+    }
+    else
+    {
+        pAliasTable->pEntries = pEntries;
+        pAliasTable->entryCount = entryCount;
+        shadowStatus = Shadow_TopicAliasReset( pAliasTable );
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_TopicAliasReset( ShadowTopicAliasTable_t * pAliasTable )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    const ShadowMatchResult_t emptyEntry = { SHADOW_NOT_FOUND, ShadowMessageTypeMaxNum, 0U, 0U, 0U, 0U };
+    uint16_t index = 0U;
+
+    if( ( pAliasTable == NULL ) || ( pAliasTable->pEntries == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameter pAliasTable: %p.", ( void * ) pAliasTable ) );
+    }
+    else
+    {
+        for( index = 0U; index < pAliasTable->entryCount; index++ )
+        {
+            pAliasTable->pEntries[ index ] = emptyEntry;
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_TopicAliasMatch( ShadowTopicAliasTable_t * pAliasTable,
+                                       uint16_t topicAlias,
+                                       const char * pTopic,
+                                       uint16_t topicLength,
+                                       ShadowMatchResult_t * pResult )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowMatchResult_t * pEntry = NULL;
+    ShadowTopic_t topic = { NULL, 0U };
+
+    if( ( pAliasTable == NULL ) ||
+        ( pAliasTable->pEntries == NULL ) ||
+        ( topicAlias == 0U ) ||
+        ( topicAlias > pAliasTable->entryCount ) ||
+        ( ( pTopic == NULL ) && ( topicLength > 0U ) ) ||
+        ( pResult == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pAliasTable: %p, topicAlias: %u, pTopic: %p, topicLength: %u, pResult: %p.",
+                    ( void * ) pAliasTable,
+                    ( unsigned int ) topicAlias,
+                    ( const void * ) pTopic,
+                    ( unsigned int ) topicLength,
+                    ( void * ) pResult ) );
+    }
+    else
+    {
+        /* Topic aliases start at 1. */
+        pEntry = &( pAliasTable->pEntries[ topicAlias - 1U ] );
+
+        if( topicLength > 0U )
+        {
+            /* The topic sets or replaces the alias. The result is kept even if
+             * the topic is not a Shadow topic, so that later messages with the
+             * alias are rejected without parsing either. */
+            topic.pTopic = pTopic;
+            topic.topicLength = topicLength;
+            ( void ) Shadow_MatchTopicBatch( &topic, 1U, pEntry );
+        }
+
+        *pResult = *pEntry;
+        shadowStatus = pEntry->status;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_MatchPublishPacketAlias( const uint8_t * pPacket,
+                                               uint32_t packetLength,
+                                               ShadowTopicAliasTable_t * pAliasTable,
+                                               ShadowPublishInfo_t * pPublishInfo )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t propertiesLength = 0U;
+    uint16_t topicAlias = 0U;
+
+    if( ( pPacket == NULL ) ||
+        ( packetLength == 0U ) ||
+        ( pAliasTable == NULL ) ||
+        ( pPublishInfo == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pPacket: %p, packetLength: %u, pAliasTable: %p, pPublishInfo: %p.",
+                    ( const void * ) pPacket,
+                    ( unsigned int ) packetLength,
+                    ( void * ) pAliasTable,
+                    ( void * ) pPublishInfo ) );
+    }
+    else
+    {
+        shadowStatus = decodePublishPacket( pPacket,
+                                            packetLength,
+                                            SHADOW_MQTT_PROTOCOL_LEVEL_5,
+                                            pPublishInfo,
+                                            &propertiesLength );
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        /* The properties end where the payload starts. */
+        shadowStatus = findTopicAlias( &( pPacket[ pPublishInfo->payloadOffset - propertiesLength ] ),
+                                       propertiesLength,
+                                       &topicAlias );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            shadowStatus = Shadow_TopicAliasMatch( pAliasTable,
+                                                   topicAlias,
+                                                   ( const char * ) &( pPacket[ pPublishInfo->topicOffset ] ),
+                                                   pPublishInfo->topicLength,
+                                                   &( pPublishInfo->match ) );
+        }
+        else if( shadowStatus == SHADOW_NOT_FOUND )
+        {
+            shadowStatus = matchPublishTopic( pPacket, pPublishInfo );
+        }
+        else
+        {
+            /* Malformed properties. */
+        }
+    }
+
+    return shadowStatus;
+}
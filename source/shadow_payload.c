@@ -0,0 +1,1609 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file shadow_payload.c
+ * @brief Implements the Shadow payload parser and writer, which read and write
+ * the JSON documents of shadow messages in place.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <string.h>
+
+/* Shadow includes. */
+#include "shadow_payload.h"
+
+/**
+ * @brief Parser phase: the '{' that opens the document is expected.
+ */
+#define PHASE_DOCUMENT_START    ( 0U )
+
+/**
+ * @brief Parser phase: the first key of an object, or the '}' of an empty
+ * object, is expected.
+ */
+#define PHASE_FIRST_KEY         ( 1U )
+
+/**
+ * @brief Parser phase: a key is expected, after a ','.
+ */
+#define PHASE_NEXT_KEY          ( 2U )
+
+/**
+ * @brief Parser phase: a ',' or the '}' that closes an object is expected.
+ */
+#define PHASE_AFTER_VALUE       ( 3U )
+
+/**
+ * @brief Parser phase: the whole document has been read.
+ */
+#define PHASE_DOCUMENT_END      ( 4U )
+
+/**
+ * @brief Parser phase: the document could not be parsed.
+ */
+#define PHASE_FAILED            ( 5U )
+
+/**
+ * @brief Maximum number of levels of arrays and objects in a value that is
+ * skipped or returned as a whole.
+ */
+#define SKIP_DEPTH_MAX          ( 32U )
+
+/**
+ * @brief The key of the reported, desired or delta state in a document.
+ */
+#define KEY_STATE                   "state"
+
+/**
+ * @brief Length of #KEY_STATE.
+ */
+#define KEY_STATE_LENGTH            ( ( uint32_t ) ( sizeof( KEY_STATE ) - 1U ) )
+
+/**
+ * @brief The key of the version number of a document.
+ */
+#define KEY_VERSION                 "version"
+
+/**
+ * @brief Length of #KEY_VERSION.
+ */
+#define KEY_VERSION_LENGTH          ( ( uint32_t ) ( sizeof( KEY_VERSION ) - 1U ) )
+
+/**
+ * @brief The key of the timestamp of a document.
+ */
+#define KEY_TIMESTAMP               "timestamp"
+
+/**
+ * @brief Length of #KEY_TIMESTAMP.
+ */
+#define KEY_TIMESTAMP_LENGTH        ( ( uint32_t ) ( sizeof( KEY_TIMESTAMP ) - 1U ) )
+
+/**
+ * @brief The key of the client token of a document.
+ */
+#define KEY_CLIENT_TOKEN            "clientToken"
+
+/**
+ * @brief Length of #KEY_CLIENT_TOKEN.
+ */
+#define KEY_CLIENT_TOKEN_LENGTH     ( ( uint32_t ) ( sizeof( KEY_CLIENT_TOKEN ) - 1U ) )
+
+/**
+ * @brief The key of the state after an update, in an update/documents document.
+ */
+#define KEY_CURRENT                 "current"
+
+/**
+ * @brief Length of #KEY_CURRENT.
+ */
+#define KEY_CURRENT_LENGTH          ( ( uint32_t ) ( sizeof( KEY_CURRENT ) - 1U ) )
+
+/**
+ * @brief The start of an update document that reports the state of a device.
+ */
+#define DOCUMENT_START              "{\"state\":{\"reported\":{"
+
+/**
+ * @brief Length of #DOCUMENT_START.
+ */
+#define DOCUMENT_START_LENGTH       ( ( uint32_t ) ( sizeof( DOCUMENT_START ) - 1U ) )
+
+/**
+ * @brief The key of the client token of a document, with the ',' before it.
+ */
+#define DOCUMENT_CLIENT_TOKEN       ",\"" KEY_CLIENT_TOKEN "\":"
+
+/**
+ * @brief Length of #DOCUMENT_CLIENT_TOKEN.
+ */
+#define DOCUMENT_CLIENT_TOKEN_LENGTH    ( ( uint32_t ) ( sizeof( DOCUMENT_CLIENT_TOKEN ) - 1U ) )
+
+/**
+ * @brief Maximum number of objects open at once in a document writer.
+ */
+#define DOCUMENT_DEPTH_MAX          ( 255U )
+
+/**
+ * @brief Bound on the magnitude of a number written with
+ * Shadow_DocumentAppendFloat(), so that its integer part fits in 32 bits.
+ *
+ * This is 2^32, which a float represents exactly. The largest float below it,
+ * 4294967040, has no fraction, so rounding it does not carry.
+ */
+#define DOCUMENT_FLOAT_LIMIT        ( 4294967296.0f )
+
+/**
+ * @brief Maximum number of decimal digits of a 32-bit unsigned integer.
+ */
+#define UINT32_DIGITS_MAX           ( 10U )
+
+/**
+ * @brief Powers of ten used to round a number to a number of decimals.
+ */
+static const uint32_t powersOfTen[ SHADOW_DOCUMENT_DECIMALS_MAX + 1U ] =
+{
+    1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U
+};
+
+/**
+ * @brief Skip the JSON whitespace at the position of a parser.
+ *
+ * @param[in] pParser The parser.
+ */
+static void skipWhitespace( ShadowDeltaParser_t * pParser );
+
+/**
+ * @brief Check if a character may be part of a number, true, false or null.
+ *
+ * @param[in] c The character.
+ *
+ * @return true if the character may be part of a literal; false otherwise.
+ */
+static bool isLiteralCharacter( char c );
+
+/**
+ * @brief Read the string at the position of a parser.
+ *
+ * @param[in] pParser The parser, at the opening quote of the string.
+ * @param[out] pView The string, without its quotes.
+ *
+ * @return #SHADOW_SUCCESS if the string is terminated and has no control
+ * characters; #SHADOW_PAYLOAD_PARSE_FAILED otherwise.
+ */
+static ShadowStatus_t readString( ShadowDeltaParser_t * pParser,
+                                  ShadowPayloadView_t * pView );
+
+/**
+ * @brief Read the array or object at the position of a parser as a whole.
+ *
+ * @param[in] pParser The parser, at the opening bracket of the value.
+ * @param[out] pView The value, with its brackets.
+ *
+ * @return #SHADOW_SUCCESS if the brackets of the value are balanced and its
+ * strings are terminated; #SHADOW_PAYLOAD_PARSE_FAILED otherwise.
+ */
+static ShadowStatus_t readContainer( ShadowDeltaParser_t * pParser,
+                                     ShadowPayloadView_t * pView );
+
+/**
+ * @brief Read the value at the position of a parser as a whole.
+ *
+ * @param[in] pParser The parser, at the first character of the value.
+ * @param[out] pView The value. Strings are returned without their quotes.
+ *
+ * @return #SHADOW_SUCCESS if the value is read; #SHADOW_PAYLOAD_PARSE_FAILED
+ * otherwise.
+ */
+static ShadowStatus_t readValue( ShadowDeltaParser_t * pParser,
+                                 ShadowPayloadView_t * pView );
+
+/**
+ * @brief Check if a key is equal to a string.
+ *
+ * @param[in] pParser The parser holding the key.
+ * @param[in] pKey The key.
+ * @param[in] pString The string.
+ * @param[in] stringLength Length of the string.
+ *
+ * @return true if the key is equal to the string; false otherwise.
+ */
+static bool keyEquals( const ShadowDeltaParser_t * pParser,
+                       const ShadowPayloadView_t * pKey,
+                       const char * pString,
+                       uint32_t stringLength );
+
+/**
+ * @brief Read a member of the top level of the document.
+ *
+ * Descends into "state", and returns "version", "timestamp" and
+ * "clientToken". Skips the other members.
+ *
+ * @param[in] pParser The parser, at the value of the member.
+ * @param[in] pKey The key of the member.
+ * @param[out] pToken The member, if it is returned.
+ * @param[out] pTokenReady Set to true if the member is returned.
+ *
+ * @return #SHADOW_SUCCESS if the member is read; #SHADOW_PAYLOAD_PARSE_FAILED
+ * otherwise.
+ */
+static ShadowStatus_t readDocumentMember( ShadowDeltaParser_t * pParser,
+                                          const ShadowPayloadView_t * pKey,
+                                          ShadowDeltaToken_t * pToken,
+                                          bool * pTokenReady );
+
+/**
+ * @brief Read a member of "state" or of an object in it.
+ *
+ * Descends into objects up to #SHADOW_DELTA_DEPTH_MAX levels. Returns the
+ * other members as changed keys.
+ *
+ * @param[in] pParser The parser, at the value of the member.
+ * @param[out] pToken The member, if it is returned.
+ * @param[out] pTokenReady Set to true if the member is returned.
+ *
+ * @return #SHADOW_SUCCESS if the member is read; #SHADOW_PAYLOAD_PARSE_FAILED
+ * otherwise.
+ */
+static ShadowStatus_t readStateMember( ShadowDeltaParser_t * pParser,
+                                       ShadowDeltaToken_t * pToken,
+                                       bool * pTokenReady );
+
+/**
+ * @brief Read a member of the object at the position of a parser.
+ *
+ * @param[in] pParser The parser, at the opening quote of the key.
+ * @param[out] pToken The member, if it is returned.
+ * @param[out] pTokenReady Set to true if the member is returned.
+ *
+ * @return #SHADOW_SUCCESS if the member is read; #SHADOW_PAYLOAD_PARSE_FAILED
+ * otherwise.
+ */
+static ShadowStatus_t readMember( ShadowDeltaParser_t * pParser,
+                                  ShadowDeltaToken_t * pToken,
+                                  bool * pTokenReady );
+
+/**
+ * @brief Read the '}' that closes an object.
+ *
+ * @param[in] pParser The parser, at the closing brace.
+ * @param[out] pToken The "state" object, if it is the one closed.
+ * @param[out] pTokenReady Set to true if "state" is returned.
+ *
+ * @return #SHADOW_SUCCESS if an object of "state" or "state" itself is
+ * closed; #SHADOW_NOT_FOUND if the document is closed;
+ * #SHADOW_PAYLOAD_PARSE_FAILED if anything but whitespace follows the document.
+ */
+static ShadowStatus_t closeObject( ShadowDeltaParser_t * pParser,
+                                   ShadowDeltaToken_t * pToken,
+                                   bool * pTokenReady );
+
+/**
+ * @brief Convert the digits of a version number to an integer.
+ *
+ * @param[in] pParser The parser holding the version number.
+ * @param[in] pValue The version number, as read by readValue().
+ * @param[out] pVersion The version number.
+ *
+ * @return #SHADOW_SUCCESS if the value is an integer from 0 to 4294967295;
+ * #SHADOW_PAYLOAD_PARSE_FAILED otherwise.
+ */
+static ShadowStatus_t convertVersion( const ShadowDeltaParser_t * pParser,
+                                      const ShadowPayloadView_t * pValue,
+                                      uint32_t * pVersion );
+
+/**
+ * @brief Read a document up to the value of its next member, at the top level
+ * of the document or in the object the parser has descended into.
+ *
+ * Leaving the object the parser has descended into returns to the top level
+ * of the document.
+ *
+ * @param[in] pParser The parser, at any point between two members.
+ * @param[out] pKey The key of the member.
+ *
+ * @return #SHADOW_SUCCESS if the parser is at the first character of the
+ * value; #SHADOW_NOT_FOUND if the end of the document is reached first;
+ * #SHADOW_PAYLOAD_PARSE_FAILED otherwise.
+ */
+static ShadowStatus_t nextMember( ShadowDeltaParser_t * pParser,
+                                  ShadowPayloadView_t * pKey );
+
+/**
+ * @brief Read the value of a member of a document while looking for its
+ * version number.
+ *
+ * Descends into "current" at the top level of the document, and skips the
+ * other objects.
+ *
+ * @param[in] pParser The parser, at the first character of the value.
+ * @param[in] pKey The key of the member.
+ * @param[out] pVersion The version number, if the member holds it.
+ * @param[out] pFound Set to true if the member holds the version number.
+ *
+ * @return #SHADOW_SUCCESS if the value is read; #SHADOW_PAYLOAD_PARSE_FAILED
+ * otherwise.
+ */
+static ShadowStatus_t readVersionMember( ShadowDeltaParser_t * pParser,
+                                         const ShadowPayloadView_t * pKey,
+                                         uint32_t * pVersion,
+                                         bool * pFound );
+
+/**
+ * @brief Check if a writer can still write, even if only to compute the
+ * length of the document.
+ *
+ * @param[in] shadowStatus The status of the writer.
+ *
+ * @return true if the writer has not failed, or has only run out of buffer;
+ * false otherwise.
+ */
+static bool isWritable( ShadowStatus_t shadowStatus );
+
+/**
+ * @brief Check the parameters of a writer function.
+ *
+ * @param[in] pWriter The writer.
+ * @param[in] parametersValid Whether the other parameters are valid.
+ *
+ * @return #SHADOW_BAD_PARAMETER if pWriter is NULL; the status of the writer
+ * otherwise, which is set to #SHADOW_BAD_PARAMETER if the parameters are not
+ * valid and the writer has not failed already.
+ */
+static ShadowStatus_t checkWriter( ShadowDocumentWriter_t * pWriter,
+                                   bool parametersValid );
+
+/**
+ * @brief Write characters to the buffer of a writer, or only count them if
+ * they do not fit.
+ *
+ * @param[in] pWriter The writer.
+ * @param[in] pCharacters The characters.
+ * @param[in] length Number of characters.
+ */
+static void writeCharacters( ShadowDocumentWriter_t * pWriter,
+                             const char * pCharacters,
+                             uint32_t length );
+
+/**
+ * @brief Write a string in quotes, escaping quotes, backslashes and control
+ * characters.
+ *
+ * @param[in] pWriter The writer.
+ * @param[in] pString The string.
+ * @param[in] length Length of the string.
+ */
+static void writeString( ShadowDocumentWriter_t * pWriter,
+                         const char * pString,
+                         uint32_t length );
+
+/**
+ * @brief Write an unsigned integer in decimal.
+ *
+ * @param[in] pWriter The writer.
+ * @param[in] value The integer.
+ * @param[in] digitCount The minimum number of digits. Leading zeros are
+ * written up to this number of digits.
+ */
+static void writeUnsigned( ShadowDocumentWriter_t * pWriter,
+                           uint32_t value,
+                           uint8_t digitCount );
+
+/**
+ * @brief Write the key of a member, with the ',' before it if needed.
+ *
+ * @param[in] pWriter The writer.
+ * @param[in] pKey The key.
+ * @param[in] keyLength Length of the key.
+ */
+static void writeKey( ShadowDocumentWriter_t * pWriter,
+                      const char * pKey,
+                      uint16_t keyLength );
+
+/*-----------------------------------------------------------*/
+
+static void skipWhitespace( ShadowDeltaParser_t * pParser )
+{
+    char c = '\0';
+
+    while( pParser->index < pParser->payloadLength )
+    {
+        c = pParser->pPayload[ pParser->index ];
+
+        if( ( c != ' ' ) && ( c != '\t' ) && ( c != '\n' ) && ( c != '\r' ) )
+        {
+            break;
+        }
+
+        pParser->index++;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static bool isLiteralCharacter( char c )
+{
+    return ( ( ( c >= '0' ) && ( c <= '9' ) ) ||
+             ( ( c >= 'a' ) && ( c <= 'z' ) ) ||
+             ( ( c >= 'A' ) && ( c <= 'Z' ) ) ||
+             ( c == '-' ) || ( c == '+' ) || ( c == '.' ) ) ? true : false;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t readString( ShadowDeltaParser_t * pParser,
+                                  ShadowPayloadView_t * pView )
+{
+    ShadowStatus_t shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+    char c = '\0';
+
+    /* Skip the opening quote. */
+    pParser->index++;
+    pView->offset = pParser->index;
+
+    while( pParser->index < pParser->payloadLength )
+    {
+        c = pParser->pPayload[ pParser->index ];
+
+        if( c == '"' )
+        {
+            shadowStatus = SHADOW_SUCCESS;
+            break;
+        }
+        else if( ( uint8_t ) c < 0x20U )
+        {
+            break;
+        }
+        else if( ( c == '\\' ) && ( ( pParser->payloadLength - pParser->index ) > 1U ) )
+        {
+            /* Skip the escaped character, which may be a quote. */
+            pParser->index += 2U;
+        }
+        else if( c == '\\' )
+        {
+            break;
+        }
+        else
+        {
+            pParser->index++;
+        }
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        pView->length = pParser->index - pView->offset;
+
+        /* Skip the closing quote. */
+        pParser->index++;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t readContainer( ShadowDeltaParser_t * pParser,
+                                     ShadowPayloadView_t * pView )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowPayloadView_t string = { 0U, 0U };
+    /* Bit n is set if the bracket n levels down is a '['. */
+    uint32_t arrayLevels = 0U;
+    uint32_t level = 0U;
+    uint32_t isArray = 0U;
+    char c = '\0';
+
+    pView->offset = pParser->index;
+
+    do
+    {
+        if( pParser->index >= pParser->payloadLength )
+        {
+            shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+        }
+        else
+        {
+            c = pParser->pPayload[ pParser->index ];
+
+            if( c == '"' )
+            {
+                /* Skip strings, which may contain brackets. */
+                shadowStatus = readString( pParser, &string );
+            }
+            else if( ( c == '{' ) || ( c == '[' ) )
+            {
+                if( level == SKIP_DEPTH_MAX )
+                {
+                    shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+                }
+                else
+                {
+                    isArray = ( c == '[' ) ? 1U : 0U;
+                    arrayLevels = ( arrayLevels << 1U ) | isArray;
+                    level++;
+                    pParser->index++;
+                }
+            }
+            else if( ( c == '}' ) || ( c == ']' ) )
+            {
+                isArray = ( c == ']' ) ? 1U : 0U;
+
+                if( ( arrayLevels & 1U ) != isArray )
+                {
+                    shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+                }
+                else
+                {
+                    arrayLevels >>= 1U;
+                    level--;
+                    pParser->index++;
+                }
+            }
+            else
+            {
+                pParser->index++;
+            }
+        }
+    } while( ( shadowStatus == SHADOW_SUCCESS ) && ( level > 0U ) );
+
+    pView->length = pParser->index - pView->offset;
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t readValue( ShadowDeltaParser_t * pParser,
+                                 ShadowPayloadView_t * pView )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    char c = pParser->pPayload[ pParser->index ];
+
+    if( c == '"' )
+    {
+        shadowStatus = readString( pParser, pView );
+    }
+    else if( ( c == '{' ) || ( c == '[' ) )
+    {
+        shadowStatus = readContainer( pParser, pView );
+    }
+    else
+    {
+        pView->offset = pParser->index;
+
+        while( ( pParser->index < pParser->payloadLength ) &&
+               ( isLiteralCharacter( pParser->pPayload[ pParser->index ] ) == true ) )
+        {
+            pParser->index++;
+        }
+
+        pView->length = pParser->index - pView->offset;
+
+        if( pView->length == 0U )
+        {
+            shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool keyEquals( const ShadowDeltaParser_t * pParser,
+                       const ShadowPayloadView_t * pKey,
+                       const char * pString,
+                       uint32_t stringLength )
+{
+    return ( ( pKey->length == stringLength ) &&
+             ( memcmp( ( const void * ) &( pParser->pPayload[ pKey->offset ] ),
+                       ( const void * ) pString,
+                       ( size_t ) stringLength ) == 0 ) ) ? true : false;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t readDocumentMember( ShadowDeltaParser_t * pParser,
+                                          const ShadowPayloadView_t * pKey,
+                                          ShadowDeltaToken_t * pToken,
+                                          bool * pTokenReady )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowPayloadView_t value = { 0U, 0U };
+    char first = pParser->pPayload[ pParser->index ];
+    bool isNumber = ( ( first == '-' ) || ( ( first >= '0' ) && ( first <= '9' ) ) ) ? true : false;
+
+    if( ( first == '{' ) && ( keyEquals( pParser, pKey, KEY_STATE, KEY_STATE_LENGTH ) == true ) )
+    {
+        pParser->stateOffset = pParser->index;
+        pParser->depth = 1U;
+        pParser->phase = PHASE_FIRST_KEY;
+        pParser->index++;
+    }
+    else
+    {
+        shadowStatus = readValue( pParser, &value );
+        pParser->phase = PHASE_AFTER_VALUE;
+    }
+
+    if( ( shadowStatus == SHADOW_SUCCESS ) && ( pParser->depth == 0U ) )
+    {
+        if( ( isNumber == true ) && ( keyEquals( pParser, pKey, KEY_VERSION, KEY_VERSION_LENGTH ) == true ) )
+        {
+            pToken->field = ShadowDeltaFieldVersion;
+            *pTokenReady = true;
+        }
+        else if( ( isNumber == true ) && ( keyEquals( pParser, pKey, KEY_TIMESTAMP, KEY_TIMESTAMP_LENGTH ) == true ) )
+        {
+            pToken->field = ShadowDeltaFieldTimestamp;
+            *pTokenReady = true;
+        }
+        else if( ( first == '"' ) && ( keyEquals( pParser, pKey, KEY_CLIENT_TOKEN, KEY_CLIENT_TOKEN_LENGTH ) == true ) )
+        {
+            pToken->field = ShadowDeltaFieldClientToken;
+            *pTokenReady = true;
+        }
+        else
+        {
+            /* Other members, such as "metadata", are skipped. */
+        }
+
+        pToken->value = value;
+        pToken->pKeys = NULL;
+        pToken->keyCount = 0U;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t readStateMember( ShadowDeltaParser_t * pParser,
+                                       ShadowDeltaToken_t * pToken,
+                                       bool * pTokenReady )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( ( pParser->pPayload[ pParser->index ] == '{' ) && ( pParser->depth < SHADOW_DELTA_DEPTH_MAX ) )
+    {
+        pParser->depth++;
+        pParser->phase = PHASE_FIRST_KEY;
+        pParser->index++;
+    }
+    else
+    {
+        shadowStatus = readValue( pParser, &( pToken->value ) );
+        pParser->phase = PHASE_AFTER_VALUE;
+
+        pToken->field = ShadowDeltaFieldKey;
+        pToken->pKeys = pParser->keys;
+        pToken->keyCount = pParser->depth;
+        *pTokenReady = true;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t readMember( ShadowDeltaParser_t * pParser,
+                                  ShadowDeltaToken_t * pToken,
+                                  bool * pTokenReady )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowPayloadView_t key = { 0U, 0U };
+
+    shadowStatus = readString( pParser, &key );
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        skipWhitespace( pParser );
+
+        if( ( pParser->index < pParser->payloadLength ) &&
+            ( pParser->pPayload[ pParser->index ] == ':' ) )
+        {
+            pParser->index++;
+            skipWhitespace( pParser );
+        }
+        else
+        {
+            shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+        }
+    }
+
+    if( ( shadowStatus == SHADOW_SUCCESS ) && ( pParser->index >= pParser->payloadLength ) )
+    {
+        shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        if( pParser->depth == 0U )
+        {
+            shadowStatus = readDocumentMember( pParser, &key, pToken, pTokenReady );
+        }
+        else
+        {
+            pParser->keys[ pParser->depth - 1U ] = key;
+            shadowStatus = readStateMember( pParser, pToken, pTokenReady );
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t closeObject( ShadowDeltaParser_t * pParser,
+                                   ShadowDeltaToken_t * pToken,
+                                   bool * pTokenReady )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    pParser->index++;
+    pParser->phase = PHASE_AFTER_VALUE;
+
+    if( pParser->depth == 0U )
+    {
+        skipWhitespace( pParser );
+
+        if( pParser->index == pParser->payloadLength )
+        {
+            pParser->phase = PHASE_DOCUMENT_END;
+            shadowStatus = SHADOW_NOT_FOUND;
+        }
+        else
+        {
+            shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+        }
+    }
+    else if( pParser->depth == 1U )
+    {
+        pParser->depth = 0U;
+
+        pToken->field = ShadowDeltaFieldState;
+        pToken->value.offset = pParser->stateOffset;
+        pToken->value.length = pParser->index - pParser->stateOffset;
+        pToken->pKeys = NULL;
+        pToken->keyCount = 0U;
+        *pTokenReady = true;
+    }
+    else
+    {
+        pParser->depth--;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t convertVersion( const ShadowDeltaParser_t * pParser,
+                                      const ShadowPayloadView_t * pValue,
+                                      uint32_t * pVersion )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t version = 0U;
+    uint32_t digit = 0U;
+    uint32_t index = 0U;
+    char c = '\0';
+
+    for( index = 0U; ( shadowStatus == SHADOW_SUCCESS ) && ( index < pValue->length ); index++ )
+    {
+        c = pParser->pPayload[ pValue->offset + index ];
+
+        /* Reject fractions, exponents and versions that do not fit. */
+        if( ( c < '0' ) || ( c > '9' ) )
+        {
+            shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+        }
+        else
+        {
+            digit = ( uint32_t ) c - ( uint32_t ) '0';
+
+            if( version > ( ( UINT32_MAX - digit ) / 10U ) )
+            {
+                shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+            }
+            else
+            {
+                version = ( version * 10U ) + digit;
+            }
+        }
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        *pVersion = version;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t nextMember( ShadowDeltaParser_t * pParser,
+                                  ShadowPayloadView_t * pKey )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    bool found = false;
+    char c = '\0';
+
+    while( ( shadowStatus == SHADOW_SUCCESS ) && ( found == false ) )
+    {
+        skipWhitespace( pParser );
+
+        if( pParser->index < pParser->payloadLength )
+        {
+            c = pParser->pPayload[ pParser->index ];
+        }
+        else
+        {
+            c = '\0';
+        }
+
+        if( ( pParser->phase == PHASE_DOCUMENT_START ) && ( c == '{' ) )
+        {
+            pParser->phase = PHASE_FIRST_KEY;
+            pParser->index++;
+        }
+        else if( ( ( pParser->phase == PHASE_FIRST_KEY ) || ( pParser->phase == PHASE_NEXT_KEY ) ) &&
+                 ( c == '"' ) )
+        {
+            shadowStatus = readString( pParser, pKey );
+            found = true;
+        }
+        else if( ( ( pParser->phase == PHASE_FIRST_KEY ) || ( pParser->phase == PHASE_AFTER_VALUE ) ) &&
+                 ( c == '}' ) )
+        {
+            pParser->phase = PHASE_AFTER_VALUE;
+            pParser->index++;
+
+            if( pParser->depth == 0U )
+            {
+                shadowStatus = SHADOW_NOT_FOUND;
+            }
+            else
+            {
+                pParser->depth = 0U;
+            }
+        }
+        else if( ( pParser->phase == PHASE_AFTER_VALUE ) && ( c == ',' ) )
+        {
+            pParser->phase = PHASE_NEXT_KEY;
+            pParser->index++;
+        }
+        else
+        {
+            shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+        }
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        skipWhitespace( pParser );
+
+        if( ( pParser->index < pParser->payloadLength ) &&
+            ( pParser->pPayload[ pParser->index ] == ':' ) )
+        {
+            pParser->index++;
+            skipWhitespace( pParser );
+        }
+        else
+        {
+            shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+        }
+    }
+
+    if( ( shadowStatus == SHADOW_SUCCESS ) && ( pParser->index >= pParser->payloadLength ) )
+    {
+        shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t readVersionMember( ShadowDeltaParser_t * pParser,
+                                         const ShadowPayloadView_t * pKey,
+                                         uint32_t * pVersion,
+                                         bool * pFound )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowPayloadView_t value = { 0U, 0U };
+    char first = pParser->pPayload[ pParser->index ];
+
+    if( ( first == '{' ) && ( pParser->depth == 0U ) &&
+        ( keyEquals( pParser, pKey, KEY_CURRENT, KEY_CURRENT_LENGTH ) == true ) )
+    {
+        pParser->depth = 1U;
+        pParser->phase = PHASE_FIRST_KEY;
+        pParser->index++;
+    }
+    else
+    {
+        shadowStatus = readValue( pParser, &value );
+        pParser->phase = PHASE_AFTER_VALUE;
+    }
+
+    if( ( shadowStatus == SHADOW_SUCCESS ) && ( first >= '0' ) && ( first <= '9' ) &&
+        ( keyEquals( pParser, pKey, KEY_VERSION, KEY_VERSION_LENGTH ) == true ) )
+    {
+        shadowStatus = convertVersion( pParser, &value, pVersion );
+        *pFound = true;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_DeltaParserInit( ShadowDeltaParser_t * pParser,
+                                       const char * pPayload,
+                                       uint32_t payloadLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( ( pParser == NULL ) ||
+        ( pPayload == NULL ) ||
+        ( payloadLength == 0U ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pParser: %p, pPayload: %p, payloadLength: %u.",
+                    ( void * ) pParser,
+                    ( const void * ) pPayload,
+                    ( unsigned int ) payloadLength ) );
+    }
+    else
+    {
+        pParser->pPayload = pPayload;
+        pParser->payloadLength = payloadLength;
+        pParser->index = 0U;
+        pParser->stateOffset = 0U;
+        pParser->depth = 0U;
+        pParser->phase = PHASE_DOCUMENT_START;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_DeltaParserNext( ShadowDeltaParser_t * pParser,
+                                       ShadowDeltaToken_t * pToken )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    bool tokenReady = false;
+    char c = '\0';
+
+    if( ( pParser == NULL ) ||
+        ( pParser->pPayload == NULL ) ||
+        ( pToken == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pParser: %p, pToken: %p.",
+                    ( void * ) pParser,
+                    ( void * ) pToken ) );
+    }
+    else if( pParser->phase == PHASE_DOCUMENT_END )
+    {
+        shadowStatus = SHADOW_NOT_FOUND;
+    }
+    else if( pParser->phase == PHASE_FAILED )
+    {
+        shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+    }
+    else
+    {
+        /* Read until a part of the document is returned, or the end of the
+         * document is reached. */
+        while( ( shadowStatus == SHADOW_SUCCESS ) && ( tokenReady == false ) )
+        {
+            skipWhitespace( pParser );
+
+            if( pParser->index < pParser->payloadLength )
+            {
+                c = pParser->pPayload[ pParser->index ];
+            }
+            else
+            {
+                c = '\0';
+            }
+
+            if( ( pParser->phase == PHASE_DOCUMENT_START ) && ( c == '{' ) )
+            {
+                pParser->phase = PHASE_FIRST_KEY;
+                pParser->index++;
+            }
+            else if( ( ( pParser->phase == PHASE_FIRST_KEY ) || ( pParser->phase == PHASE_NEXT_KEY ) ) &&
+                     ( c == '"' ) )
+            {
+                shadowStatus = readMember( pParser, pToken, &tokenReady );
+            }
+            else if( ( ( pParser->phase == PHASE_FIRST_KEY ) || ( pParser->phase == PHASE_AFTER_VALUE ) ) &&
+                     ( c == '}' ) )
+            {
+                shadowStatus = closeObject( pParser, pToken, &tokenReady );
+            }
+            else if( ( pParser->phase == PHASE_AFTER_VALUE ) && ( c == ',' ) )
+            {
+                pParser->phase = PHASE_NEXT_KEY;
+                pParser->index++;
+            }
+            else
+            {
+                shadowStatus = SHADOW_PAYLOAD_PARSE_FAILED;
+            }
+        }
+
+        if( shadowStatus == SHADOW_PAYLOAD_PARSE_FAILED )
+        {
+            pParser->phase = PHASE_FAILED;
+            LogError( ( "Failed to parse the shadow document at offset %u.",
+                        ( unsigned int ) pParser->index ) );
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_PayloadGetVersion( const char * pPayload,
+                                         uint32_t payloadLength,
+                                         uint32_t * pVersion )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowDeltaParser_t parser;
+    ShadowPayloadView_t key = { 0U, 0U };
+    bool found = false;
+
+    if( pVersion == NULL )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameter pVersion: NULL." ) );
+    }
+    else
+    {
+        shadowStatus = Shadow_DeltaParserInit( &parser, pPayload, payloadLength );
+    }
+
+    /* Read the members of the document until the version number is found,
+     * descending only into "current". */
+    while( ( shadowStatus == SHADOW_SUCCESS ) && ( found == false ) )
+    {
+        shadowStatus = nextMember( &parser, &key );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            shadowStatus = readVersionMember( &parser, &key, pVersion, &found );
+        }
+    }
+
+    if( shadowStatus == SHADOW_PAYLOAD_PARSE_FAILED )
+    {
+        LogError( ( "Failed to read the version of the shadow document at offset %u.",
+                    ( unsigned int ) parser.index ) );
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_PayloadGetClientToken( const char * pPayload,
+                                             uint32_t payloadLength,
+                                             ShadowPayloadView_t * pClientToken )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowDeltaParser_t parser;
+    ShadowPayloadView_t key = { 0U, 0U };
+    ShadowPayloadView_t value = { 0U, 0U };
+    bool found = false;
+    char first = '\0';
+
+    if( pClientToken == NULL )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameter pClientToken: NULL." ) );
+    }
+    else
+    {
+        shadowStatus = Shadow_DeltaParserInit( &parser, pPayload, payloadLength );
+    }
+
+    /* Read the members of the document until the client token is found,
+     * skipping the objects. */
+    while( ( shadowStatus == SHADOW_SUCCESS ) && ( found == false ) )
+    {
+        shadowStatus = nextMember( &parser, &key );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            first = parser.pPayload[ parser.index ];
+            shadowStatus = readValue( &parser, &value );
+            parser.phase = PHASE_AFTER_VALUE;
+        }
+
+        if( ( shadowStatus == SHADOW_SUCCESS ) && ( first == '"' ) &&
+            ( keyEquals( &parser, &key, KEY_CLIENT_TOKEN, KEY_CLIENT_TOKEN_LENGTH ) == true ) )
+        {
+            *pClientToken = value;
+            found = true;
+        }
+    }
+
+    if( shadowStatus == SHADOW_PAYLOAD_PARSE_FAILED )
+    {
+        LogError( ( "Failed to read the client token of the shadow document at offset %u.",
+                    ( unsigned int ) parser.index ) );
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool isWritable( ShadowStatus_t shadowStatus )
+{
+    return ( ( shadowStatus == SHADOW_SUCCESS ) ||
+             ( shadowStatus == SHADOW_BUFFER_TOO_SMALL ) ) ? true : false;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t checkWriter( ShadowDocumentWriter_t * pWriter,
+                                   bool parametersValid )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( pWriter == NULL )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameter pWriter: NULL." ) );
+    }
+    else
+    {
+        if( ( parametersValid == false ) && ( isWritable( pWriter->status ) == true ) )
+        {
+            pWriter->status = SHADOW_BAD_PARAMETER;
+            LogError( ( "Invalid input parameters for the document at offset %u.",
+                        ( unsigned int ) pWriter->length ) );
+        }
+
+        shadowStatus = pWriter->status;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static void writeCharacters( ShadowDocumentWriter_t * pWriter,
+                             const char * pCharacters,
+                             uint32_t length )
+{
+    uint32_t index = 0U;
+
+    if( isWritable( pWriter->status ) == false )
+    {
+        /* Keep the first error. */
+    }
+    else if( pWriter->length > ( UINT32_MAX - length ) )
+    {
+        pWriter->status = SHADOW_FAIL;
+        LogError( ( "The document is too long." ) );
+    }
+    else
+    {
+        if( pWriter->pBuffer == NULL )
+        {
+            /* Only the length of the document is computed. */
+        }
+        else if( ( pWriter->length <= pWriter->bufferSize ) &&
+                 ( ( pWriter->bufferSize - pWriter->length ) >= length ) )
+        {
+            /* Most writes are a few characters long, which a loop copies
+             * faster than a call to memcpy(). */
+            for( index = 0U; index < length; index++ )
+            {
+                pWriter->pBuffer[ pWriter->length + index ] = pCharacters[ index ];
+            }
+        }
+        else
+        {
+            /* Keep counting, so that the length the document needs is known. */
+            pWriter->status = SHADOW_BUFFER_TOO_SMALL;
+        }
+
+        pWriter->length += length;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static void writeString( ShadowDocumentWriter_t * pWriter,
+                         const char * pString,
+                         uint32_t length )
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    char escape[ 6 ] = { '\\', 'u', '0', '0', '0', '0' };
+    uint32_t escapeLength = 2U;
+    uint32_t runStart = 0U;
+    uint32_t index = 0U;
+    char c = '\0';
+
+    writeCharacters( pWriter, "\"", 1U );
+
+    while( index < length )
+    {
+        /* Write the characters up to the next one that must be escaped in
+         * one copy. */
+        runStart = index;
+
+        while( ( index < length ) &&
+               ( ( uint8_t ) pString[ index ] >= 0x20U ) &&
+               ( pString[ index ] != '"' ) &&
+               ( pString[ index ] != '\\' ) )
+        {
+            index++;
+        }
+
+        if( index > runStart )
+        {
+            writeCharacters( pWriter, &( pString[ runStart ] ), index - runStart );
+        }
+
+        if( index < length )
+        {
+            c = pString[ index ];
+            escapeLength = 2U;
+
+            switch( c )
+            {
+                case '\n':
+                    escape[ 1 ] = 'n';
+                    break;
+
+                case '\r':
+                    escape[ 1 ] = 'r';
+                    break;
+
+                case '\t':
+                    escape[ 1 ] = 't';
+                    break;
+
+                case '"':
+                case '\\':
+                    escape[ 1 ] = c;
+                    break;
+
+                default:
+                    escape[ 1 ] = 'u';
+                    escape[ 4 ] = hexDigits[ ( uint8_t ) c >> 4U ];
+                    escape[ 5 ] = hexDigits[ ( uint8_t ) c & 0x0FU ];
+                    escapeLength = 6U;
+                    break;
+            }
+
+            writeCharacters( pWriter, escape, escapeLength );
+            index++;
+        }
+    }
+
+    writeCharacters( pWriter, "\"", 1U );
+}
+
+/*-----------------------------------------------------------*/
+
+static void writeUnsigned( ShadowDocumentWriter_t * pWriter,
+                           uint32_t value,
+                           uint8_t digitCount )
+{
+    char digits[ UINT32_DIGITS_MAX ];
+    uint32_t remaining = value;
+    uint32_t index = UINT32_DIGITS_MAX;
+
+    /* Write the digits from the last one. */
+    do
+    {
+        index--;
+        digits[ index ] = ( char ) ( '0' + ( char ) ( remaining % 10U ) );
+        remaining /= 10U;
+    } while( ( remaining > 0U ) || ( ( UINT32_DIGITS_MAX - index ) < digitCount ) );
+
+    writeCharacters( pWriter, &( digits[ index ] ), UINT32_DIGITS_MAX - index );
+}
+
+/*-----------------------------------------------------------*/
+
+static void writeKey( ShadowDocumentWriter_t * pWriter,
+                      const char * pKey,
+                      uint16_t keyLength )
+{
+    if( pWriter->needComma == true )
+    {
+        writeCharacters( pWriter, ",", 1U );
+    }
+
+    writeString( pWriter, pKey, keyLength );
+    writeCharacters( pWriter, ":", 1U );
+    pWriter->needComma = true;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_DocumentWriterInit( ShadowDocumentWriter_t * pWriter,
+                                          char * pBuffer,
+                                          uint32_t bufferSize )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( ( pWriter == NULL ) ||
+        ( ( pBuffer == NULL ) && ( bufferSize != 0U ) ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pWriter: %p, pBuffer: %p, bufferSize: %u.",
+                    ( void * ) pWriter,
+                    ( void * ) pBuffer,
+                    ( unsigned int ) bufferSize ) );
+    }
+    else
+    {
+        pWriter->pBuffer = pBuffer;
+        pWriter->bufferSize = bufferSize;
+        pWriter->length = 0U;
+        pWriter->status = SHADOW_SUCCESS;
+        pWriter->depth = 0U;
+        pWriter->needComma = false;
+
+        writeCharacters( pWriter, DOCUMENT_START, DOCUMENT_START_LENGTH );
+        shadowStatus = pWriter->status;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_DocumentAppendInt( ShadowDocumentWriter_t * pWriter,
+                                         const char * pKey,
+                                         uint16_t keyLength,
+                                         int32_t value )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t magnitude = ( uint32_t ) value;
+
+    shadowStatus = checkWriter( pWriter, ( ( pKey != NULL ) && ( keyLength > 0U ) ) ? true : false );
+
+    if( isWritable( shadowStatus ) == true )
+    {
+        writeKey( pWriter, pKey, keyLength );
+
+        if( value < 0 )
+        {
+            writeCharacters( pWriter, "-", 1U );
+
+            /* Negate in unsigned arithmetic, which also works for INT32_MIN. */
+            magnitude = 0U - magnitude;
+        }
+
+        writeUnsigned( pWriter, magnitude, 1U );
+        shadowStatus = pWriter->status;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_DocumentAppendBool( ShadowDocumentWriter_t * pWriter,
+                                          const char * pKey,
+                                          uint16_t keyLength,
+                                          bool value )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    shadowStatus = checkWriter( pWriter, ( ( pKey != NULL ) && ( keyLength > 0U ) ) ? true : false );
+
+    if( isWritable( shadowStatus ) == true )
+    {
+        writeKey( pWriter, pKey, keyLength );
+
+        if( value == true )
+        {
+            writeCharacters( pWriter, "true", 4U );
+        }
+        else
+        {
+            writeCharacters( pWriter, "false", 5U );
+        }
+
+        shadowStatus = pWriter->status;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_DocumentAppendFloat( ShadowDocumentWriter_t * pWriter,
+                                           const char * pKey,
+                                           uint16_t keyLength,
+                                           float value,
+                                           uint8_t decimals )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    float magnitude = ( value < 0.0f ) ? -value : value;
+    uint32_t integerPart = 0U;
+    uint32_t fraction = 0U;
+
+    /* The comparison is false for NaN. */
+    shadowStatus = checkWriter( pWriter,
+                                ( ( pKey != NULL ) && ( keyLength > 0U ) &&
+                                  ( decimals <= SHADOW_DOCUMENT_DECIMALS_MAX ) &&
+                                  ( magnitude < DOCUMENT_FLOAT_LIMIT ) ) ? true : false );
+
+    if( isWritable( shadowStatus ) == true )
+    {
+        /* All arithmetic is in float, so that no double-precision routines
+         * are needed. The fraction is exact, and scaling it by at most 10^6
+         * keeps it below 2^24, where a float still resolves the 0.5 used to
+         * round. */
+        integerPart = ( uint32_t ) magnitude;
+        fraction = ( uint32_t ) ( ( ( magnitude - ( float ) integerPart ) * ( float ) powersOfTen[ decimals ] ) + 0.5f );
+
+        /* Carry a fraction that rounds up to one, as in 0.999 with 2 decimals. */
+        if( fraction >= powersOfTen[ decimals ] )
+        {
+            fraction -= powersOfTen[ decimals ];
+            integerPart++;
+        }
+
+        writeKey( pWriter, pKey, keyLength );
+
+        if( ( value < 0.0f ) && ( ( integerPart > 0U ) || ( fraction > 0U ) ) )
+        {
+            writeCharacters( pWriter, "-", 1U );
+        }
+
+        writeUnsigned( pWriter, integerPart, 1U );
+
+        if( decimals > 0U )
+        {
+            writeCharacters( pWriter, ".", 1U );
+            writeUnsigned( pWriter, fraction, decimals );
+        }
+
+        shadowStatus = pWriter->status;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_DocumentAppendString( ShadowDocumentWriter_t * pWriter,
+                                            const char * pKey,
+                                            uint16_t keyLength,
+                                            const char * pValue,
+                                            uint32_t valueLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    shadowStatus = checkWriter( pWriter,
+                                ( ( pKey != NULL ) && ( keyLength > 0U ) &&
+                                  ( ( pValue != NULL ) || ( valueLength == 0U ) ) ) ? true : false );
+
+    if( isWritable( shadowStatus ) == true )
+    {
+        writeKey( pWriter, pKey, keyLength );
+        writeString( pWriter, pValue, valueLength );
+        shadowStatus = pWriter->status;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_DocumentBeginObject( ShadowDocumentWriter_t * pWriter,
+                                           const char * pKey,
+                                           uint16_t keyLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    shadowStatus = checkWriter( pWriter,
+                                ( ( pKey != NULL ) && ( keyLength > 0U ) &&
+                                  ( pWriter != NULL ) && ( pWriter->depth < DOCUMENT_DEPTH_MAX ) ) ? true : false );
+
+    if( isWritable( shadowStatus ) == true )
+    {
+        writeKey( pWriter, pKey, keyLength );
+        writeCharacters( pWriter, "{", 1U );
+        pWriter->depth++;
+        pWriter->needComma = false;
+        shadowStatus = pWriter->status;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_DocumentEndObject( ShadowDocumentWriter_t * pWriter )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    shadowStatus = checkWriter( pWriter, ( ( pWriter != NULL ) && ( pWriter->depth > 0U ) ) ? true : false );
+
+    if( isWritable( shadowStatus ) == true )
+    {
+        writeCharacters( pWriter, "}", 1U );
+        pWriter->depth--;
+        pWriter->needComma = true;
+        shadowStatus = pWriter->status;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_DocumentWriterFinish( ShadowDocumentWriter_t * pWriter,
+                                            const char * pClientToken,
+                                            uint16_t clientTokenLength,
+                                            uint32_t * pDocumentLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    shadowStatus = checkWriter( pWriter,
+                                ( ( pDocumentLength != NULL ) &&
+                                  ( pWriter != NULL ) && ( pWriter->depth == 0U ) ) ? true : false );
+
+    if( isWritable( shadowStatus ) == true )
+    {
+        /* Close the reported state and the state. */
+        writeCharacters( pWriter, "}}", 2U );
+
+        if( pClientToken != NULL )
+        {
+            writeCharacters( pWriter, DOCUMENT_CLIENT_TOKEN, DOCUMENT_CLIENT_TOKEN_LENGTH );
+            writeString( pWriter, pClientToken, clientTokenLength );
+        }
+
+        writeCharacters( pWriter, "}", 1U );
+        shadowStatus = pWriter->status;
+
+        if( isWritable( shadowStatus ) == true )
+        {
+            *pDocumentLength = pWriter->length;
+        }
+    }
+
+    return shadowStatus;
+}
@@ -0,0 +1,309 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file shadow_registry.c
+ * @brief Implements the Shadow registry, which maps incoming topic strings to
+ * registered Thing and Shadow names.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <string.h>
+
+/* Shadow includes. */
+#include "shadow_registry.h"
+
+/**
+ * @brief Check if a used slot holds the given Thing and Shadow names.
+ *
+ * @param[in] pSlot The slot.
+ * @param[in] pThingName Thing name.
+ * @param[in] thingNameLength Length of the Thing name.
+ * @param[in] pShadowName Shadow name.
+ * @param[in] shadowNameLength Length of the Shadow name.
+ * @param[in] hash #ShadowTopicHash_t.keyHash of the names.
+ *
+ * @return true if the slot holds the names; false if not.
+ */
+static bool slotHoldsNames( const ShadowRegistrySlot_t * pSlot,
+                            const char * pThingName,
+                            uint8_t thingNameLength,
+                            const char * pShadowName,
+                            uint8_t shadowNameLength,
+                            uint32_t hash );
+
+/**
+ * @brief Probe the registry for a Thing and Shadow name pair.
+ *
+ * Probing starts at the slot selected by the hash and moves to the next slot
+ * until it finds the pair or an empty slot, visiting each slot at most once.
+ *
+ * @param[in] pRegistry The registry.
+ * @param[in] pThingName Thing name.
+ * @param[in] thingNameLength Length of the Thing name.
+ * @param[in] pShadowName Shadow name.
+ * @param[in] shadowNameLength Length of the Shadow name.
+ * @param[in] hash #ShadowTopicHash_t.keyHash of the names.
+ * @param[out] pSlotIndex Index of the slot holding the pair, or of the empty
+ * slot where the pair can be added.
+ *
+ * @return Return SHADOW_SUCCESS if the pair is found;
+ *         return SHADOW_NOT_FOUND if an empty slot is found first;
+ *         return SHADOW_BUFFER_TOO_SMALL if neither is found.
+ */
+static ShadowStatus_t findSlot( const ShadowRegistry_t * pRegistry,
+                                const char * pThingName,
+                                uint8_t thingNameLength,
+                                const char * pShadowName,
+                                uint8_t shadowNameLength,
+                                uint32_t hash,
+                                uint32_t * pSlotIndex );
+
+/*-----------------------------------------------------------*/
+
+static bool slotHoldsNames( const ShadowRegistrySlot_t * pSlot,
+                            const char * pThingName,
+                            uint8_t thingNameLength,
+                            const char * pShadowName,
+                            uint8_t shadowNameLength,
+                            uint32_t hash )
+{
+    bool holdsNames = false;
+
+    /* Compare the hash and lengths first, so the names are only compared for
+     * a slot that almost certainly holds them. */
+    if( ( pSlot->hash == hash ) &&
+        ( pSlot->thingNameLength == thingNameLength ) &&
+        ( pSlot->shadowNameLength == shadowNameLength ) &&
+        ( memcmp( pSlot->pThingName, pThingName, thingNameLength ) == 0 ) )
+    {
+        holdsNames = ( shadowNameLength == 0U ) ||
+                     ( memcmp( pSlot->pShadowName, pShadowName, shadowNameLength ) == 0 );
+    }
+
+    return holdsNames;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t findSlot( const ShadowRegistry_t * pRegistry,
+                                const char * pThingName,
+                                uint8_t thingNameLength,
+                                const char * pShadowName,
+                                uint8_t shadowNameLength,
+                                uint32_t hash,
+                                uint32_t * pSlotIndex )
+{
+    ShadowStatus_t shadowStatus = SHADOW_BUFFER_TOO_SMALL;
+    uint32_t mask = pRegistry->slotCount - 1U;
+    uint32_t slotIndex = hash & mask;
+    uint32_t probeCount = 0U;
+    const ShadowRegistrySlot_t * pSlot = NULL;
+
+    for( probeCount = 0U; probeCount < pRegistry->slotCount; probeCount++ )
+    {
+        pSlot = &( pRegistry->pSlots[ slotIndex ] );
+
+        if( pSlot->pThingName == NULL )
+        {
+            shadowStatus = SHADOW_NOT_FOUND;
+        }
+        else if( slotHoldsNames( pSlot, pThingName, thingNameLength,
+                                 pShadowName, shadowNameLength, hash ) == true )
+        {
+            shadowStatus = SHADOW_SUCCESS;
+        }
+        else
+        {
+            slotIndex = ( slotIndex + 1U ) & mask;
+        }
+
+        if( shadowStatus != SHADOW_BUFFER_TOO_SMALL )
+        {
+            *pSlotIndex = slotIndex;
+            break;
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_RegistryInit( ShadowRegistry_t * pRegistry,
+                                    ShadowRegistrySlot_t * pSlots,
+                                    uint32_t slotCount )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t index = 0U;
+
+    if( ( pRegistry == NULL ) ||
+        ( pSlots == NULL ) ||
+        ( slotCount == 0U ) ||
+        ( ( slotCount & ( slotCount - 1U ) ) != 0U ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pRegistry: %p, pSlots: %p, slotCount: %u.",
+                    ( void * ) pRegistry,
+                    ( void * ) pSlots,
+                    ( unsigned int ) slotCount ) );
+    }
+    else
+    {
+        for( index = 0U; index < slotCount; index++ )
+        {
+            pSlots[ index ].pThingName = NULL;
+            pSlots[ index ].pShadowName = NULL;
+            pSlots[ index ].hash = 0U;
+            pSlots[ index ].thingNameLength = 0U;
+            pSlots[ index ].shadowNameLength = 0U;
+        }
+
+        pRegistry->pSlots = pSlots;
+        pRegistry->slotCount = slotCount;
+        pRegistry->entryCount = 0U;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_RegistryAdd( ShadowRegistry_t * pRegistry,
+                                   const char * pThingName,
+                                   uint8_t thingNameLength,
+                                   const char * pShadowName,
+                                   uint8_t shadowNameLength,
+                                   uint32_t * pHandle )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowTopicHash_t hash = { 0U, 0U, 0U };
+    uint32_t slotIndex = 0U;
+    ShadowRegistrySlot_t * pSlot = NULL;
+
+    if( ( pRegistry == NULL ) ||
+        ( pThingName == NULL ) ||
+        ( thingNameLength == 0U ) ||
+        ( thingNameLength > SHADOW_THINGNAME_LENGTH_MAX ) ||
+        ( ( pShadowName == NULL ) && ( shadowNameLength > 0U ) ) ||
+        ( shadowNameLength > SHADOW_NAME_LENGTH_MAX ) ||
+        ( pHandle == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pRegistry: %p, pThingName: %p, thingNameLength: %u,\
+                    pShadowName: %p, shadowNameLength: %u, pHandle: %p.",
+                    ( void * ) pRegistry,
+                    ( const void * ) pThingName,
+                    ( unsigned int ) thingNameLength,
+                    ( const void * ) pShadowName,
+                    ( unsigned int ) shadowNameLength,
+                    ( void * ) pHandle ) );
+    }
+    else
+    {
+        /* The parameters have been checked, so hashing cannot fail. */
+        ( void ) Shadow_HashNames( pThingName, thingNameLength,
+                                   pShadowName, shadowNameLength, &hash );
+        shadowStatus = findSlot( pRegistry, pThingName, thingNameLength,
+                                 pShadowName, shadowNameLength, hash.keyHash, &slotIndex );
+
+        if( shadowStatus == SHADOW_NOT_FOUND )
+        {
+            pSlot = &( pRegistry->pSlots[ slotIndex ] );
+            pSlot->pThingName = pThingName;
+            pSlot->pShadowName = pShadowName;
+            pSlot->hash = hash.keyHash;
+            pSlot->thingNameLength = thingNameLength;
+            pSlot->shadowNameLength = shadowNameLength;
+            pRegistry->entryCount++;
+            shadowStatus = SHADOW_SUCCESS;
+        }
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            *pHandle = slotIndex;
+        }
+        else
+        {
+            LogError( ( "Unable to register the Thing and Shadow names: all %u slots are used.",
+                        ( unsigned int ) pRegistry->slotCount ) );
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_RegistryMatchTopic( const ShadowRegistry_t * pRegistry,
+                                          const char * pTopic,
+                                          uint16_t topicLength,
+                                          uint32_t * pHandle,
+                                          ShadowMessageType_t * pMessageType )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowMatchResult_t result = { SHADOW_FAIL, ShadowMessageTypeMaxNum, 0U, 0U, 0U, 0U };
+    ShadowTopicHash_t hash = { 0U, 0U, 0U };
+    uint32_t slotIndex = 0U;
+
+    if( ( pRegistry == NULL ) ||
+        ( pHandle == NULL ) ||
+        ( pMessageType == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pRegistry: %p, pHandle: %p, pMessageType: %p.",
+                    ( const void * ) pRegistry,
+                    ( void * ) pHandle,
+                    ( void * ) pMessageType ) );
+    }
+    else
+    {
+        /* The names are hashed while the topic is matched, so they are only
+         * read again to compare them with the names of a slot. */
+        shadowStatus = Shadow_MatchTopicHash( pTopic, topicLength, &result, &hash );
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        shadowStatus = findSlot( pRegistry,
+                                 &( pTopic[ result.thingNameOffset ] ), result.thingNameLength,
+                                 &( pTopic[ result.shadowNameOffset ] ), result.shadowNameLength,
+                                 hash.keyHash, &slotIndex );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            *pHandle = slotIndex;
+            *pMessageType = result.messageType;
+        }
+        else
+        {
+            /* A full table that does not hold the names has no match either. */
+            shadowStatus = SHADOW_NOT_FOUND;
+            LogDebug( ( "The Thing and Shadow names of the topic are not registered." ) );
+        }
+    }
+
+    return shadowStatus;
+}
@@ -0,0 +1,460 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file shadow_request.c
+ * @brief Implements the Shadow request table, which generates the client
+ * tokens of get, update and delete requests and dispatches their responses.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <string.h>
+
+/* Shadow includes. */
+#include "shadow_request.h"
+#include "shadow_payload.h"
+
+/**
+ * @brief Index of no slot, which ends the list of free slots.
+ */
+#define NO_SLOT                 SHADOW_REQUEST_SLOT_COUNT_MAX
+
+/**
+ * @brief Number of hexadecimal digits of a 16-bit number.
+ */
+#define HEX_DIGITS_16           ( 4U )
+
+/**
+ * @brief The digits of a client token, indexed by their values.
+ */
+static const char hexDigits[ 16 ] =
+{
+    '0', '1', '2', '3', '4', '5', '6', '7',
+    '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+};
+
+/**
+ * @brief Get the operation of the request a message is the response to.
+ *
+ * @param[in] messageType The type of the message.
+ *
+ * @return #ShadowTopicStringTypeGet, #ShadowTopicStringTypeUpdate or
+ * #ShadowTopicStringTypeDelete for accepted and rejected messages;
+ * #ShadowTopicStringTypeMaxNum for the other messages.
+ */
+static ShadowTopicStringType_t responseOperation( ShadowMessageType_t messageType );
+
+/**
+ * @brief Write a 16-bit number as lowercase hexadecimal digits.
+ *
+ * @param[out] pDigits Buffer for #HEX_DIGITS_16 digits.
+ * @param[in] value The number.
+ */
+static void writeHex( char * pDigits,
+                      uint16_t value );
+
+/**
+ * @brief Read a 16-bit number written by writeHex().
+ *
+ * @param[in] pDigits The #HEX_DIGITS_16 digits.
+ * @param[out] pValue The number.
+ *
+ * @return true if the digits are lowercase hexadecimal digits; false if not.
+ */
+static bool readHex( const char * pDigits,
+                     uint16_t * pValue );
+
+/**
+ * @brief Find the slot of the request with a client token.
+ *
+ * @param[in] pTable The table.
+ * @param[in] pClientToken The client token.
+ * @param[in] clientTokenLength Length of the client token.
+ * @param[out] pSlotIndex Index of the slot of the request.
+ *
+ * @return #SHADOW_SUCCESS if a request has the client token;
+ * #SHADOW_NOT_FOUND if not.
+ */
+static ShadowStatus_t findRequest( const ShadowRequestTable_t * pTable,
+                                   const char * pClientToken,
+                                   uint32_t clientTokenLength,
+                                   uint16_t * pSlotIndex );
+
+/**
+ * @brief Free the slot of a request.
+ *
+ * @param[in] pTable The table.
+ * @param[in] slotIndex Index of the slot.
+ */
+static void freeSlot( ShadowRequestTable_t * pTable,
+                      uint16_t slotIndex );
+
+/*-----------------------------------------------------------*/
+
+static ShadowTopicStringType_t responseOperation( ShadowMessageType_t messageType )
+{
+    ShadowTopicStringType_t operation = ShadowTopicStringTypeMaxNum;
+
+    switch( messageType )
+    {
+        case ShadowMessageTypeGetAccepted:
+        case ShadowMessageTypeGetRejected:
+            operation = ShadowTopicStringTypeGet;
+            break;
+
+        case ShadowMessageTypeDeleteAccepted:
+        case ShadowMessageTypeDeleteRejected:
+            operation = ShadowTopicStringTypeDelete;
+            break;
+
+        case ShadowMessageTypeUpdateAccepted:
+        case ShadowMessageTypeUpdateRejected:
+            operation = ShadowTopicStringTypeUpdate;
+            break;
+
+        default:
+            /* Other messages are not responses to a request. */
+            break;
+    }
+
+    return operation;
+}
+
+/*-----------------------------------------------------------*/
+
+static void writeHex( char * pDigits,
+                      uint16_t value )
+{
+    uint32_t index = 0U;
+    uint32_t remaining = value;
+
+    for( index = HEX_DIGITS_16; index > 0U; index-- )
+    {
+        pDigits[ index - 1U ] = hexDigits[ remaining & 0xFU ];
+        remaining >>= 4U;
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+static bool readHex( const char * pDigits,
+                     uint16_t * pValue )
+{
+    bool valid = true;
+    uint32_t index = 0U;
+    uint32_t value = 0U;
+    char c = '\0';
+
+    for( index = 0U; ( index < HEX_DIGITS_16 ) && ( valid == true ); index++ )
+    {
+        c = pDigits[ index ];
+
+        if( ( c >= '0' ) && ( c <= '9' ) )
+        {
+            value = ( value << 4U ) | ( uint32_t ) ( c - '0' );
+        }
+        else if( ( c >= 'a' ) && ( c <= 'f' ) )
+        {
+            value = ( value << 4U ) | ( ( uint32_t ) ( c - 'a' ) + 10U );
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+
+    *pValue = ( uint16_t ) value;
+
+    return valid;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t findRequest( const ShadowRequestTable_t * pTable,
+                                   const char * pClientToken,
+                                   uint32_t clientTokenLength,
+                                   uint16_t * pSlotIndex )
+{
+    ShadowStatus_t shadowStatus = SHADOW_NOT_FOUND;
+    const char * pDigits = NULL;
+    const ShadowRequestSlot_t * pSlot = NULL;
+    uint16_t generation = 0U;
+
+    if( ( clientTokenLength == ( ( uint32_t ) pTable->prefixLength + SHADOW_REQUEST_TOKEN_DIGITS ) ) &&
+        ( memcmp( pClientToken, pTable->pPrefix, pTable->prefixLength ) == 0 ) )
+    {
+        pDigits = &( pClientToken[ pTable->prefixLength ] );
+
+        /* The client token holds the index of its slot, so the slot is
+         * checked instead of being searched for. */
+        if( ( readHex( pDigits, pSlotIndex ) == true ) &&
+            ( readHex( &( pDigits[ HEX_DIGITS_16 ] ), &generation ) == true ) &&
+            ( *pSlotIndex < pTable->slotCount ) )
+        {
+            pSlot = &( pTable->pSlots[ *pSlotIndex ] );
+
+            if( ( pSlot->callback != NULL ) && ( pSlot->generation == generation ) )
+            {
+                shadowStatus = SHADOW_SUCCESS;
+            }
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+static void freeSlot( ShadowRequestTable_t * pTable,
+                      uint16_t slotIndex )
+{
+    ShadowRequestSlot_t * pSlot = &( pTable->pSlots[ slotIndex ] );
+
+    pSlot->callback = NULL;
+    pSlot->pContext = NULL;
+    pSlot->nextFree = pTable->firstFree;
+    pTable->firstFree = slotIndex;
+    pTable->pendingCount--;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_RequestTableInit( ShadowRequestTable_t * pTable,
+                                        ShadowRequestSlot_t * pSlots,
+                                        uint16_t slotCount,
+                                        const char * pPrefix,
+                                        uint8_t prefixLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint16_t index = 0U;
+
+    if( ( pTable == NULL ) ||
+        ( pSlots == NULL ) ||
+        ( slotCount == 0U ) ||
+        ( slotCount >= SHADOW_REQUEST_SLOT_COUNT_MAX ) ||
+        ( ( pPrefix == NULL ) && ( prefixLength != 0U ) ) ||
+        ( prefixLength > SHADOW_REQUEST_PREFIX_LENGTH_MAX ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pTable: %p, pSlots: %p, slotCount: %u, pPrefix: %p, prefixLength: %u.",
+                    ( void * ) pTable,
+                    ( void * ) pSlots,
+                    ( unsigned int ) slotCount,
+                    ( const void * ) pPrefix,
+                    ( unsigned int ) prefixLength ) );
+    }
+    else
+    {
+        /* Chain the slots into the list of free slots, in order. */
+        for( index = 0U; index < slotCount; index++ )
+        {
+            pSlots[ index ].callback = NULL;
+            pSlots[ index ].pContext = NULL;
+            pSlots[ index ].generation = 0U;
+            pSlots[ index ].nextFree = ( uint16_t ) ( index + 1U );
+            pSlots[ index ].operation = ( uint8_t ) ShadowTopicStringTypeMaxNum;
+        }
+
+        pSlots[ slotCount - 1U ].nextFree = NO_SLOT;
+
+        pTable->pSlots = pSlots;
+        /* An empty prefix is compared and copied like any other. */
+        pTable->pPrefix = ( pPrefix == NULL ) ? "" : pPrefix;
+        pTable->slotCount = slotCount;
+        pTable->firstFree = 0U;
+        pTable->pendingCount = 0U;
+        pTable->prefixLength = prefixLength;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_RequestStart( ShadowRequestTable_t * pTable,
+                                    ShadowTopicStringType_t operation,
+                                    ShadowRequestCallback_t callback,
+                                    void * pContext,
+                                    char * pClientToken,
+                                    uint8_t bufferSize,
+                                    uint8_t * pClientTokenLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowRequestSlot_t * pSlot = NULL;
+    uint16_t slotIndex = 0U;
+    uint32_t clientTokenLength = 0U;
+
+    if( ( pTable == NULL ) ||
+        ( pTable->pSlots == NULL ) ||
+        ( ( operation != ShadowTopicStringTypeGet ) &&
+          ( operation != ShadowTopicStringTypeUpdate ) &&
+          ( operation != ShadowTopicStringTypeDelete ) ) ||
+        ( callback == NULL ) ||
+        ( pClientToken == NULL ) ||
+        ( pClientTokenLength == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pTable: %p, operation: %u, pClientToken: %p, pClientTokenLength: %p.",
+                    ( void * ) pTable,
+                    ( unsigned int ) operation,
+                    ( void * ) pClientToken,
+                    ( void * ) pClientTokenLength ) );
+    }
+    else
+    {
+        clientTokenLength = ( uint32_t ) pTable->prefixLength + SHADOW_REQUEST_TOKEN_DIGITS;
+
+        if( pTable->firstFree == NO_SLOT )
+        {
+            shadowStatus = SHADOW_BUFFER_TOO_SMALL;
+            LogWarn( ( "All %u slots of the request table are waiting for a response.",
+                       ( unsigned int ) pTable->slotCount ) );
+        }
+        else if( bufferSize < clientTokenLength )
+        {
+            shadowStatus = SHADOW_BUFFER_TOO_SMALL;
+            LogError( ( "The buffer of %u bytes is too small for a client token of %u bytes.",
+                        ( unsigned int ) bufferSize,
+                        ( unsigned int ) clientTokenLength ) );
+        }
+        else
+        {
+            /* Empty. */
+        }
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        slotIndex = pTable->firstFree;
+        pSlot = &( pTable->pSlots[ slotIndex ] );
+
+        pTable->firstFree = pSlot->nextFree;
+        pTable->pendingCount++;
+
+        /* A new generation keeps responses to an earlier use of the slot from
+         * matching this request. */
+        pSlot->generation++;
+        pSlot->callback = callback;
+        pSlot->pContext = pContext;
+        pSlot->operation = ( uint8_t ) operation;
+
+        ( void ) memcpy( pClientToken, pTable->pPrefix, pTable->prefixLength );
+        writeHex( &( pClientToken[ pTable->prefixLength ] ), slotIndex );
+        writeHex( &( pClientToken[ pTable->prefixLength + HEX_DIGITS_16 ] ), pSlot->generation );
+        *pClientTokenLength = ( uint8_t ) clientTokenLength;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_RequestDispatch( ShadowRequestTable_t * pTable,
+                                       ShadowMessageType_t messageType,
+                                       const char * pPayload,
+                                       uint32_t payloadLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowTopicStringType_t operation = responseOperation( messageType );
+    ShadowPayloadView_t clientToken = { 0U, 0U };
+    ShadowRequestCallback_t callback = NULL;
+    void * pContext = NULL;
+    uint16_t slotIndex = 0U;
+
+    if( ( pTable == NULL ) ||
+        ( pTable->pSlots == NULL ) ||
+        ( pPayload == NULL ) ||
+        ( payloadLength == 0U ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pTable: %p, pPayload: %p, payloadLength: %u.",
+                    ( void * ) pTable,
+                    ( const void * ) pPayload,
+                    ( unsigned int ) payloadLength ) );
+    }
+    else if( operation == ShadowTopicStringTypeMaxNum )
+    {
+        shadowStatus = SHADOW_NOT_FOUND;
+    }
+    else
+    {
+        shadowStatus = Shadow_PayloadGetClientToken( pPayload, payloadLength, &clientToken );
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        shadowStatus = findRequest( pTable, &( pPayload[ clientToken.offset ] ), clientToken.length, &slotIndex );
+    }
+
+    if( ( shadowStatus == SHADOW_SUCCESS ) &&
+        ( pTable->pSlots[ slotIndex ].operation != ( uint8_t ) operation ) )
+    {
+        /* The response of another operation, with the client token of the request. */
+        shadowStatus = SHADOW_NOT_FOUND;
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        callback = pTable->pSlots[ slotIndex ].callback;
+        pContext = pTable->pSlots[ slotIndex ].pContext;
+        freeSlot( pTable, slotIndex );
+
+        callback( pContext, messageType, pPayload, payloadLength );
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_RequestCancel( ShadowRequestTable_t * pTable,
+                                     const char * pClientToken,
+                                     uint8_t clientTokenLength )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint16_t slotIndex = 0U;
+
+    if( ( pTable == NULL ) ||
+        ( pTable->pSlots == NULL ) ||
+        ( pClientToken == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pTable: %p, pClientToken: %p.",
+                    ( void * ) pTable,
+                    ( const void * ) pClientToken ) );
+    }
+    else
+    {
+        shadowStatus = findRequest( pTable, pClientToken, clientTokenLength, &slotIndex );
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        freeSlot( pTable, slotIndex );
+    }
+
+    return shadowStatus;
+}
@@ -0,0 +1,433 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/**
+ * @file shadow_reserved_topic.c
+ * @brief Implements the reserved topic engine, which matches
+ * "$aws/things/<thingName>/..." topics with tables of operations.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <string.h>
+
+/* Shadow includes. */
+#include "shadow_reserved_topic.h"
+
+/**
+ * @brief Flags of an operation of the Shadow service, which is used by both
+ * Classic and named shadows.
+ */
+#define SHADOW_OPERATION_FLAGS    ( SHADOW_RESERVED_OP_UNNAMED | SHADOW_RESERVED_OP_NAMED )
+
+/**
+ * @brief Initializer of a #ShadowReservedOperation_t of the Shadow service
+ * from an operation and suffix of shadow.h, without the leading '/'.
+ */
+#define SHADOW_OPERATION( operation, suffix ) \
+    { &( ( operation suffix )[ 1 ] ), ( uint16_t ) ( sizeof( operation suffix ) - 2U ), SHADOW_OPERATION_FLAGS }
+
+/**
+ * @brief The operations of the Shadow service, in the order of
+ * #ShadowMessageType_t.
+ */
+static const ShadowReservedOperation_t shadowOperations[ ShadowMessageTypeMaxNum ] =
+{
+    SHADOW_OPERATION( SHADOW_OP_GET, SHADOW_SUFFIX_ACCEPTED ),
+    SHADOW_OPERATION( SHADOW_OP_GET, SHADOW_SUFFIX_REJECTED ),
+    SHADOW_OPERATION( SHADOW_OP_DELETE, SHADOW_SUFFIX_ACCEPTED ),
+    SHADOW_OPERATION( SHADOW_OP_DELETE, SHADOW_SUFFIX_REJECTED ),
+    SHADOW_OPERATION( SHADOW_OP_UPDATE, SHADOW_SUFFIX_ACCEPTED ),
+    SHADOW_OPERATION( SHADOW_OP_UPDATE, SHADOW_SUFFIX_REJECTED ),
+    SHADOW_OPERATION( SHADOW_OP_UPDATE, SHADOW_SUFFIX_DOCUMENTS ),
+    SHADOW_OPERATION( SHADOW_OP_UPDATE, SHADOW_SUFFIX_DELTA )
+};
+
+/**
+ * @brief The built-in table of the Shadow service. Its root is
+ * #SHADOW_CLASSIC_ROOT and its keyword is the level of #SHADOW_NAMED_ROOT
+ * after it, both without their '/'.
+ */
+static const ShadowReservedTable_t shadowTable =
+{
+    &( SHADOW_CLASSIC_ROOT[ 1 ] ),
+    ( uint16_t ) ( SHADOW_CLASSIC_ROOT_LENGTH - 1U ),
+    &( SHADOW_NAMED_ROOT[ SHADOW_CLASSIC_ROOT_LENGTH + 1U ] ),
+    ( uint16_t ) ( SHADOW_NAMED_ROOT_LENGTH - SHADOW_CLASSIC_ROOT_LENGTH - 2U ),
+    ( uint8_t ) SHADOW_NAME_LENGTH_MAX,
+    shadowOperations,
+    ( uint16_t ) ShadowMessageTypeMaxNum
+};
+
+/**
+ * @brief Find the end of a topic level, which is the next '/' or the end of
+ * the topic.
+ *
+ * @param[in] pTopic The topic string.
+ * @param[in] start Offset of the first character of the level.
+ * @param[in] topicLength Length of the topic string.
+ *
+ * @return Offset of the '/' after the level, or topicLength if there is none.
+ */
+static uint16_t findLevelEnd( const char * pTopic,
+                              uint16_t start,
+                              uint16_t topicLength );
+
+/**
+ * @brief Find the table whose root starts the rest of a topic.
+ *
+ * @param[in] pEngine The engine.
+ * @param[in] pRest The rest of the topic after the Thing name and its '/'.
+ * @param[in] restLength Length of the rest of the topic.
+ * @param[out] pTableIndex Index of the table.
+ *
+ * @return true if a table is found; false if not.
+ */
+static bool findTable( const ShadowReservedTopicEngine_t * pEngine,
+                       const char * pRest,
+                       uint16_t restLength,
+                       uint16_t * pTableIndex );
+
+/**
+ * @brief Find the operation of a table that is the rest of a topic.
+ *
+ * @param[in] pTable The table.
+ * @param[in] pRest The rest of the topic after the root or the name, and its '/'.
+ * @param[in] restLength Length of the rest of the topic.
+ * @param[in] flag #SHADOW_RESERVED_OP_UNNAMED or #SHADOW_RESERVED_OP_NAMED.
+ * @param[out] pOperationIndex Index of the operation.
+ *
+ * @return true if an operation with the flag is found; false if not.
+ */
+static bool findOperation( const ShadowReservedTable_t * pTable,
+                           const char * pRest,
+                           uint16_t restLength,
+                           uint8_t flag,
+                           uint16_t * pOperationIndex );
+
+/**
+ * @brief Match the name and the operation of a topic that is not an unnamed
+ * operation of its table.
+ *
+ * @param[in] pTable The table of the topic.
+ * @param[in] pTopic The topic string.
+ * @param[in] topicLength Length of the topic string.
+ * @param[in] offset Offset of the rest of the topic after the root and its '/'.
+ * @param[out] pMatch The name and the operation of the topic.
+ *
+ * @return Return SHADOW_SUCCESS if the topic is a named operation of the table;
+ *         return SHADOW_SHADOWNAME_PARSE_FAILED if the name is empty or too long;
+ *         return SHADOW_MESSAGE_TYPE_PARSE_FAILED if not.
+ */
+static ShadowStatus_t matchNamedOperation( const ShadowReservedTable_t * pTable,
+                                           const char * pTopic,
+                                           uint16_t topicLength,
+                                           uint16_t offset,
+                                           ShadowReservedMatch_t * pMatch );
+
+/*-----------------------------------------------------------*/
+
+static uint16_t findLevelEnd( const char * pTopic,
+                              uint16_t start,
+                              uint16_t topicLength )
+{
+    uint16_t index = start;
+
+    while( ( index < topicLength ) && ( pTopic[ index ] != '/' ) )
+    {
+        index++;
+    }
+
+    return index;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool findTable( const ShadowReservedTopicEngine_t * pEngine,
+                       const char * pRest,
+                       uint16_t restLength,
+                       uint16_t * pTableIndex )
+{
+    bool found = false;
+    uint16_t index = 0U;
+    const ShadowReservedTable_t * pTable = NULL;
+
+    for( index = 0U; index < pEngine->tableCount; index++ )
+    {
+        pTable = pEngine->ppTables[ index ];
+
+        if( ( restLength > pTable->rootLength ) &&
+            ( pRest[ pTable->rootLength ] == '/' ) &&
+            ( memcmp( pRest, pTable->pRoot, pTable->rootLength ) == 0 ) )
+        {
+            *pTableIndex = index;
+            found = true;
+            break;
+        }
+    }
+
+    return found;
+}
+
+/*-----------------------------------------------------------*/
+
+static bool findOperation( const ShadowReservedTable_t * pTable,
+                           const char * pRest,
+                           uint16_t restLength,
+                           uint8_t flag,
+                           uint16_t * pOperationIndex )
+{
+    bool found = false;
+    uint16_t index = 0U;
+    const ShadowReservedOperation_t * pOperation = NULL;
+
+    for( index = 0U; index < pTable->operationCount; index++ )
+    {
+        pOperation = &( pTable->pOperations[ index ] );
+
+        if( ( ( pOperation->flags & flag ) != 0U ) &&
+            ( pOperation->operationLength == restLength ) &&
+            ( memcmp( pRest, pOperation->pOperation, restLength ) == 0 ) )
+        {
+            *pOperationIndex = index;
+            found = true;
+            break;
+        }
+    }
+
+    return found;
+}
+
+/*-----------------------------------------------------------*/
+
+static ShadowStatus_t matchNamedOperation( const ShadowReservedTable_t * pTable,
+                                           const char * pTopic,
+                                           uint16_t topicLength,
+                                           uint16_t offset,
+                                           ShadowReservedMatch_t * pMatch )
+{
+    ShadowStatus_t shadowStatus = SHADOW_MESSAGE_TYPE_PARSE_FAILED;
+    uint16_t nameOffset = offset;
+    uint16_t nameEnd = 0U;
+
+    /* The keyword, if any, is a level of its own before the name. */
+    if( pTable->nameKeywordLength > 0U )
+    {
+        if( ( ( topicLength - offset ) > pTable->nameKeywordLength ) &&
+            ( pTopic[ offset + pTable->nameKeywordLength ] == '/' ) &&
+            ( memcmp( &( pTopic[ offset ] ), pTable->pNameKeyword, pTable->nameKeywordLength ) == 0 ) )
+        {
+            nameOffset = ( uint16_t ) ( offset + pTable->nameKeywordLength + 1U );
+            shadowStatus = SHADOW_SUCCESS;
+        }
+    }
+    else
+    {
+        shadowStatus = SHADOW_SUCCESS;
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        nameEnd = findLevelEnd( pTopic, nameOffset, topicLength );
+
+        if( ( nameEnd == nameOffset ) ||
+            ( nameEnd == topicLength ) ||
+            ( ( nameEnd - nameOffset ) > pTable->nameLengthMax ) )
+        {
+            shadowStatus = SHADOW_SHADOWNAME_PARSE_FAILED;
+        }
+        else if( findOperation( pTable,
+                                &( pTopic[ nameEnd + 1U ] ),
+                                ( uint16_t ) ( topicLength - nameEnd - 1U ),
+                                SHADOW_RESERVED_OP_NAMED,
+                                &( pMatch->operationIndex ) ) == true )
+        {
+            pMatch->nameOffset = nameOffset;
+            pMatch->nameLength = ( uint8_t ) ( nameEnd - nameOffset );
+        }
+        else
+        {
+            shadowStatus = SHADOW_MESSAGE_TYPE_PARSE_FAILED;
+        }
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_ReservedTopicInit( ShadowReservedTopicEngine_t * pEngine,
+                                         const ShadowReservedTable_t ** ppTables,
+                                         uint16_t tableCountMax )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( ( pEngine == NULL ) ||
+        ( ppTables == NULL ) ||
+        ( tableCountMax == 0U ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pEngine: %p, ppTables: %p, tableCountMax: %u.",
+                    ( void * ) pEngine,
+                    ( void * ) ppTables,
+                    ( unsigned int ) tableCountMax ) );
+    }
+    else
+    {
+        ppTables[ SHADOW_RESERVED_TABLE_SHADOW ] = &shadowTable;
+        pEngine->ppTables = ppTables;
+        pEngine->tableCount = 1U;
+        pEngine->tableCountMax = tableCountMax;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_ReservedTopicRegister( ShadowReservedTopicEngine_t * pEngine,
+                                             const ShadowReservedTable_t * pTable,
+                                             uint16_t * pTableIndex )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( ( pEngine == NULL ) ||
+        ( pTable == NULL ) ||
+        ( pTable->pRoot == NULL ) ||
+        ( pTable->rootLength == 0U ) ||
+        ( ( pTable->pNameKeyword == NULL ) && ( pTable->nameKeywordLength > 0U ) ) ||
+        ( pTable->pOperations == NULL ) ||
+        ( pTable->operationCount == 0U ) ||
+        ( pTableIndex == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pEngine: %p, pTable: %p, pTableIndex: %p.",
+                    ( void * ) pEngine,
+                    ( const void * ) pTable,
+                    ( void * ) pTableIndex ) );
+    }
+    else if( pEngine->tableCount == pEngine->tableCountMax )
+    {
+        shadowStatus = SHADOW_BUFFER_TOO_SMALL;
+        LogError( ( "Unable to register the table: all %u tables are used.",
+                    ( unsigned int ) pEngine->tableCountMax ) );
+    }
+    else
+    {
+        pEngine->ppTables[ pEngine->tableCount ] = pTable;
+        *pTableIndex = pEngine->tableCount;
+        pEngine->tableCount++;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_ReservedTopicMatch( const ShadowReservedTopicEngine_t * pEngine,
+                                          const char * pTopic,
+                                          uint16_t topicLength,
+                                          ShadowReservedMatch_t * pMatch )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    const ShadowReservedTable_t * pTable = NULL;
+    uint16_t thingNameEnd = 0U;
+    uint16_t offset = 0U;
+
+    if( ( pEngine == NULL ) ||
+        ( pTopic == NULL ) ||
+        ( topicLength == 0U ) ||
+        ( pMatch == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pEngine: %p, pTopic: %p, topicLength: %u, pMatch: %p.",
+                    ( const void * ) pEngine,
+                    ( const void * ) pTopic,
+                    ( unsigned int ) topicLength,
+                    ( void * ) pMatch ) );
+    }
+    else if( ( topicLength <= SHADOW_PREFIX_LENGTH ) ||
+             ( memcmp( pTopic, SHADOW_PREFIX, SHADOW_PREFIX_LENGTH ) != 0 ) )
+    {
+        shadowStatus = SHADOW_FAIL;
+        LogDebug( ( "Not a reserved topic: the topic does not start with " SHADOW_PREFIX "." ) );
+    }
+    else
+    {
+        /* The prefix and the Thing name are parsed once for all tables. */
+        thingNameEnd = findLevelEnd( pTopic, SHADOW_PREFIX_LENGTH, topicLength );
+
+        if( ( thingNameEnd == SHADOW_PREFIX_LENGTH ) ||
+            ( thingNameEnd == topicLength ) ||
+            ( ( uint16_t ) ( thingNameEnd - SHADOW_PREFIX_LENGTH ) > SHADOW_THINGNAME_LENGTH_MAX ) )
+        {
+            shadowStatus = SHADOW_THINGNAME_PARSE_FAILED;
+            LogDebug( ( "Not a reserved topic: failed to parse the Thing name." ) );
+        }
+        else
+        {
+            pMatch->thingNameLength = ( uint8_t ) ( thingNameEnd - SHADOW_PREFIX_LENGTH );
+            offset = thingNameEnd + 1U;
+        }
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        if( findTable( pEngine, &( pTopic[ offset ] ), topicLength - offset,
+                       &( pMatch->tableIndex ) ) == true )
+        {
+            pTable = pEngine->ppTables[ pMatch->tableIndex ];
+            offset = ( uint16_t ) ( offset + pTable->rootLength + 1U );
+        }
+        else
+        {
+            shadowStatus = SHADOW_ROOT_PARSE_FAILED;
+            LogDebug( ( "Not a reserved topic: no registered table has the root of the topic." ) );
+        }
+    }
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        if( findOperation( pTable, &( pTopic[ offset ] ), topicLength - offset,
+                           SHADOW_RESERVED_OP_UNNAMED, &( pMatch->operationIndex ) ) == true )
+        {
+            pMatch->nameOffset = 0U;
+            pMatch->nameLength = 0U;
+        }
+        else if( pTable->nameLengthMax == 0U )
+        {
+            shadowStatus = SHADOW_MESSAGE_TYPE_PARSE_FAILED;
+        }
+        else
+        {
+            shadowStatus = matchNamedOperation( pTable, pTopic, topicLength, offset, pMatch );
+        }
+
+        if( shadowStatus != SHADOW_SUCCESS )
+        {
+            LogDebug( ( "Not a reserved topic: failed to parse the name or the operation." ) );
+        }
+    }
+
+    return shadowStatus;
+}
@@ -0,0 +1,213 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file shadow_topic_cache.c
+ * @brief Implements the Shadow topic cache, which keeps the results of
+ * matching recently received topic strings.
+ */
+
+/* Standard includes. */
+#include <string.h>
+
+/* Shadow includes. */
+#include "shadow_topic_cache.h"
+
+/**
+ * @brief Number of characters of a topic read into each half of its key.
+ */
+#define CACHE_KEY_SPAN_LENGTH    ( 8U )
+
+/**
+ * @brief Read four characters as a 32-bit word, in the same order on every
+ * platform. Compilers turn this into a single load.
+ *
+ * @param[in] pCharacters The first of the four characters.
+ *
+ * @return The word.
+ */
+static uint32_t loadWord( const char * pCharacters );
+
+/**
+ * @brief Compute the key of a topic string, which selects its entry.
+ *
+ * The key is computed from the length of the topic, the eight characters
+ * after #SHADOW_PREFIX, where the Thing name starts, and the last eight
+ * characters, where the operation and suffix are. A topic that is too short
+ * for these is read from its start. The key does not depend on the other
+ * characters, so the cached topic is compared with the whole topic as well.
+ *
+ * @param[in] pTopic The topic string.
+ * @param[in] topicLength Length of the topic string.
+ *
+ * @return The key of the topic.
+ */
+static uint32_t keyTopic( const char * pTopic,
+                          uint16_t topicLength );
+
+/*-----------------------------------------------------------*/
+
+static uint32_t loadWord( const char * pCharacters )
+{
+    return ( ( uint32_t ) ( uint8_t ) pCharacters[ 0 ] ) |
+           ( ( ( uint32_t ) ( uint8_t ) pCharacters[ 1 ] ) << 8U ) |
+           ( ( ( uint32_t ) ( uint8_t ) pCharacters[ 2 ] ) << 16U ) |
+           ( ( ( uint32_t ) ( uint8_t ) pCharacters[ 3 ] ) << 24U );
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t keyTopic( const char * pTopic,
+                          uint16_t topicLength )
+{
+    char shortTopic[ CACHE_KEY_SPAN_LENGTH ] = { 0 };
+    const char * pHead = pTopic;
+    const char * pTail = pTopic;
+    uint32_t key = topicLength;
+
+    if( topicLength >= ( SHADOW_PREFIX_LENGTH + CACHE_KEY_SPAN_LENGTH ) )
+    {
+        pHead = &( pTopic[ SHADOW_PREFIX_LENGTH ] );
+        pTail = &( pTopic[ topicLength - CACHE_KEY_SPAN_LENGTH ] );
+    }
+    else if( topicLength >= CACHE_KEY_SPAN_LENGTH )
+    {
+        pTail = &( pTopic[ topicLength - CACHE_KEY_SPAN_LENGTH ] );
+    }
+    else
+    {
+        ( void ) memcpy( ( void * ) shortTopic, ( const void * ) pTopic, ( size_t ) topicLength );
+        pHead = shortTopic;
+        pTail = shortTopic;
+    }
+
+    key = ( key ^ loadWord( pHead ) ) * SHADOW_HASH_PRIME;
+    key = ( key ^ loadWord( &( pHead[ 4 ] ) ) ) * SHADOW_HASH_PRIME;
+    key = ( key ^ loadWord( pTail ) ) * SHADOW_HASH_PRIME;
+    key = ( key ^ loadWord( &( pTail[ 4 ] ) ) ) * SHADOW_HASH_PRIME;
+
+    /* The low bits of a product depend only on the low bits of its factors,
+     * so fold the high bits in before the low bits select the entry. */
+    return key ^ ( key >> 16U );
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_TopicCacheInit( ShadowTopicCache_t * pCache,
+                                      ShadowTopicCacheEntry_t * pEntries,
+                                      uint32_t entryCount )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t index = 0U;
+
+    if( ( pCache == NULL ) ||
+        ( pEntries == NULL ) ||
+        ( entryCount == 0U ) ||
+        ( ( entryCount & ( entryCount - 1U ) ) != 0U ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pCache: %p, pEntries: %p, entryCount: %u.",
+                    ( void * ) pCache,
+                    ( void * ) pEntries,
+                    ( unsigned int ) entryCount ) );
+    }
+    else
+    {
+        for( index = 0U; index < entryCount; index++ )
+        {
+            pEntries[ index ].topicLength = 0U;
+        }
+
+        pCache->pEntries = pEntries;
+        pCache->entryCount = entryCount;
+        pCache->hitCount = 0U;
+        pCache->missCount = 0U;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_TopicCacheMatch( ShadowTopicCache_t * pCache,
+                                       const char * pTopic,
+                                       uint16_t topicLength,
+                                       ShadowMatchResult_t * pResult )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowTopicCacheEntry_t * pEntry = NULL;
+    ShadowTopic_t topic = { NULL, 0U };
+    uint32_t key = 0U;
+
+    if( ( pCache == NULL ) ||
+        ( pCache->pEntries == NULL ) ||
+        ( pTopic == NULL ) ||
+        ( topicLength == 0U ) ||
+        ( pResult == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pCache: %p, pTopic: %p, topicLength: %u, pResult: %p.",
+                    ( void * ) pCache,
+                    ( const void * ) pTopic,
+                    ( unsigned int ) topicLength,
+                    ( void * ) pResult ) );
+    }
+    else
+    {
+        /* Each topic has a single entry, chosen by its key, so a topic is
+         * compared with one cached copy at most. */
+        key = keyTopic( pTopic, topicLength );
+        pEntry = &( pCache->pEntries[ key & ( pCache->entryCount - 1U ) ] );
+
+        if( ( pEntry->topicLength == topicLength ) &&
+            ( pEntry->key == key ) &&
+            ( memcmp( ( const void * ) pEntry->topic,
+                      ( const void * ) pTopic,
+                      ( size_t ) topicLength ) == 0 ) )
+        {
+            pCache->hitCount++;
+            *pResult = pEntry->result;
+        }
+        else
+        {
+            pCache->missCount++;
+            topic.pTopic = pTopic;
+            topic.topicLength = topicLength;
+            ( void ) Shadow_MatchTopicBatch( &topic, 1U, pResult );
+
+            /* The topic replaces the one in its entry. */
+            if( topicLength <= SHADOW_CACHED_TOPIC_LENGTH_MAX )
+            {
+                ( void ) memcpy( ( void * ) pEntry->topic, ( const void * ) pTopic, ( size_t ) topicLength );
+                pEntry->topicLength = topicLength;
+                pEntry->key = key;
+                pEntry->result = *pResult;
+            }
+        }
+
+        shadowStatus = pResult->status;
+    }
+
+    return shadowStatus;
+}
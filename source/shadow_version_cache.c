@@ -0,0 +1,204 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file shadow_version_cache.c
+ * @brief Implements the Shadow version cache, which keeps the version of the
+ * last message applied to each registered shadow and drops older messages.
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Shadow includes. */
+#include "shadow_version_cache.h"
+#include "shadow_payload.h"
+
+/**
+ * @brief Check if messages of a type carry the version of the shadow.
+ *
+ * @param[in] messageType The type of the message.
+ *
+ * @return true for accepted, update/delta and update/documents messages;
+ * false for rejected messages.
+ */
+static bool hasVersion( ShadowMessageType_t messageType );
+
+/*-----------------------------------------------------------*/
+
+static bool hasVersion( ShadowMessageType_t messageType )
+{
+    return ( ( messageType == ShadowMessageTypeGetAccepted ) ||
+             ( messageType == ShadowMessageTypeDeleteAccepted ) ||
+             ( messageType == ShadowMessageTypeUpdateAccepted ) ||
+             ( messageType == ShadowMessageTypeUpdateDocuments ) ||
+             ( messageType == ShadowMessageTypeUpdateDelta ) ) ? true : false;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_VersionCacheInit( ShadowVersionCache_t * pCache,
+                                        uint32_t * pVersions,
+                                        uint32_t versionCount )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t index = 0U;
+
+    if( ( pCache == NULL ) ||
+        ( pVersions == NULL ) ||
+        ( versionCount == 0U ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pCache: %p, pVersions: %p, versionCount: %u.",
+                    ( void * ) pCache,
+                    ( void * ) pVersions,
+                    ( unsigned int ) versionCount ) );
+    }
+    else
+    {
+        for( index = 0U; index < versionCount; index++ )
+        {
+            pVersions[ index ] = 0U;
+        }
+
+        pCache->pVersions = pVersions;
+        pCache->versionCount = versionCount;
+        pCache->staleCount = 0U;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_VersionCacheAccept( ShadowVersionCache_t * pCache,
+                                          uint32_t handle,
+                                          uint32_t version )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( ( pCache == NULL ) ||
+        ( pCache->pVersions == NULL ) ||
+        ( handle >= pCache->versionCount ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pCache: %p, handle: %u.",
+                    ( void * ) pCache,
+                    ( unsigned int ) handle ) );
+    }
+    else if( version < pCache->pVersions[ handle ] )
+    {
+        shadowStatus = SHADOW_VERSION_STALE;
+        pCache->staleCount++;
+        LogDebug( ( "Dropping a message of version %u, after version %u.",
+                    ( unsigned int ) version,
+                    ( unsigned int ) pCache->pVersions[ handle ] ) );
+    }
+    else
+    {
+        pCache->pVersions[ handle ] = version;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_VersionCacheReset( ShadowVersionCache_t * pCache,
+                                         uint32_t handle )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    if( ( pCache == NULL ) ||
+        ( pCache->pVersions == NULL ) ||
+        ( handle >= pCache->versionCount ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pCache: %p, handle: %u.",
+                    ( void * ) pCache,
+                    ( unsigned int ) handle ) );
+    }
+    else
+    {
+        pCache->pVersions[ handle ] = 0U;
+    }
+
+    return shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+ShadowStatus_t Shadow_VersionCacheMatch( ShadowVersionCache_t * pCache,
+                                         const ShadowRegistry_t * pRegistry,
+                                         const char * pTopic,
+                                         uint16_t topicLength,
+                                         const char * pPayload,
+                                         uint32_t payloadLength,
+                                         uint32_t * pHandle,
+                                         ShadowMessageType_t * pMessageType )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    uint32_t version = 0U;
+
+    if( ( pCache == NULL ) ||
+        ( pCache->pVersions == NULL ) ||
+        ( pRegistry == NULL ) ||
+        ( pCache->versionCount < pRegistry->slotCount ) ||
+        ( pHandle == NULL ) ||
+        ( pMessageType == NULL ) )
+    {
+        shadowStatus = SHADOW_BAD_PARAMETER;
+        LogError( ( "Invalid input parameters pCache: %p, pRegistry: %p, pHandle: %p, pMessageType: %p.",
+                    ( void * ) pCache,
+                    ( const void * ) pRegistry,
+                    ( void * ) pHandle,
+                    ( void * ) pMessageType ) );
+    }
+    else
+    {
+        shadowStatus = Shadow_RegistryMatchTopic( pRegistry, pTopic, topicLength, pHandle, pMessageType );
+    }
+
+    if( ( shadowStatus == SHADOW_SUCCESS ) && ( hasVersion( *pMessageType ) == true ) )
+    {
+        shadowStatus = Shadow_PayloadGetVersion( pPayload, payloadLength, &version );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            shadowStatus = Shadow_VersionCacheAccept( pCache, *pHandle, version );
+        }
+        else if( shadowStatus == SHADOW_NOT_FOUND )
+        {
+            /* A message without a version cannot be stale. */
+            shadowStatus = SHADOW_SUCCESS;
+        }
+        else
+        {
+            /* The payload cannot be parsed. */
+        }
+    }
+
+    return shadowStatus;
+}
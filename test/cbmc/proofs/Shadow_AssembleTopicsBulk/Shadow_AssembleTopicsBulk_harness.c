@@ -0,0 +1,70 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file Shadow_AssembleTopicsBulk_harness.c
+ * @brief Implements the proof harness for Shadow_AssembleTopicsBulk function.
+ */
+
+#include "shadow.h"
+
+#include <stdlib.h>
+
+void harness()
+{
+    ShadowNames_t * pNames;
+    uint32_t nameCount;
+    uint16_t topicTypeMask;
+    char * topicBuffer;
+    uint32_t bufferSize;
+    ShadowTopicSpan_t * pTopicSpans;
+    uint32_t * pOutLength;
+    uint32_t index;
+
+    __CPROVER_assume( nameCount < NAME_COUNT_MAX );
+    /* Limit the buffer to what the topics of NAME_COUNT_MAX shadows can use. */
+    __CPROVER_assume( bufferSize < ( NAME_COUNT_MAX * SHADOW_TOPIC_LEN_ALL( 128U, 64U ) ) );
+
+    pNames = malloc( sizeof( *pNames ) * nameCount );
+    topicBuffer = malloc( bufferSize );
+    pTopicSpans = malloc( sizeof( *pTopicSpans ) * nameCount * ShadowTopicStringTypeMaxNum );
+    pOutLength = malloc( sizeof( *pOutLength ) );
+
+    if( pNames != NULL )
+    {
+        for( index = 0U; index < nameCount; index++ )
+        {
+            pNames[ index ].pThingName = malloc( pNames[ index ].thingNameLength );
+            pNames[ index ].pShadowName = malloc( pNames[ index ].shadowNameLength );
+        }
+    }
+
+    Shadow_AssembleTopicsBulk( pNames,
+                               nameCount,
+                               topicTypeMask,
+                               topicBuffer,
+                               bufferSize,
+                               pTopicSpans,
+                               pOutLength );
+}
@@ -0,0 +1,70 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file Shadow_DeltaEngineInit_harness.c
+ * @brief Implements the proof harness for Shadow_DeltaEngineInit function.
+ */
+
+#include "shadow_delta.h"
+
+#include <stdlib.h>
+
+/* Give a state a payload and section of arbitrary content and length. */
+static void initDocument( ShadowDeltaDocument_t * pDocument )
+{
+    if( pDocument != NULL )
+    {
+        __CPROVER_assume( pDocument->payloadLength < PAYLOAD_LENGTH_MAX );
+        __CPROVER_assume( pDocument->sectionLength < PAYLOAD_LENGTH_MAX );
+
+        pDocument->pPayload = malloc( pDocument->payloadLength );
+        pDocument->pSection = malloc( pDocument->sectionLength );
+    }
+}
+
+void harness()
+{
+    ShadowDeltaEngine_t * pEngine;
+    ShadowDeltaDocument_t * pDesired;
+    ShadowDeltaDocument_t * pReported;
+    ShadowDeltaEntry_t * pEntries;
+    uint32_t entryCount;
+
+    __CPROVER_assume( entryCount < ENTRY_COUNT_MAX );
+
+    pEngine = malloc( sizeof( *pEngine ) );
+    pDesired = malloc( sizeof( *pDesired ) );
+    pReported = malloc( sizeof( *pReported ) );
+    pEntries = malloc( sizeof( *pEntries ) * entryCount );
+
+    initDocument( pDesired );
+    initDocument( pReported );
+
+    Shadow_DeltaEngineInit( pEngine,
+                            pDesired,
+                            pReported,
+                            pEntries,
+                            entryCount );
+}
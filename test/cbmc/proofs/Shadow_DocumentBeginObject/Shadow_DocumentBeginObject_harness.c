@@ -0,0 +1,61 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file Shadow_DocumentBeginObject_harness.c
+ * @brief Implements the proof harness for Shadow_DocumentBeginObject function.
+ */
+
+#include "shadow_payload.h"
+
+#include <stdlib.h>
+
+void harness()
+{
+    ShadowDocumentWriter_t * pWriter;
+    char * pBuffer;
+    uint32_t bufferSize;
+    const char * pKey;
+    uint16_t keyLength;
+
+    __CPROVER_assume( bufferSize < BUFFER_SIZE_MAX );
+
+    pWriter = malloc( sizeof( *pWriter ) );
+    pBuffer = malloc( bufferSize );
+
+    __CPROVER_assume( keyLength < STRING_LENGTH_MAX );
+    pKey = malloc( keyLength );
+
+    if( pWriter != NULL )
+    {
+        /* Start from any point in a document, with any status. */
+        pWriter->pBuffer = pBuffer;
+        pWriter->bufferSize = bufferSize;
+        __CPROVER_assume( pWriter->length < BUFFER_SIZE_MAX );
+    }
+
+    Shadow_DocumentBeginObject( pWriter,
+                                pKey,
+                                keyLength );
+}
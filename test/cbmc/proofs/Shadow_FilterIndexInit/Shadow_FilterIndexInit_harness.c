@@ -0,0 +1,70 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file Shadow_FilterIndexInit_harness.c
+ * @brief Implements the proof harness for Shadow_FilterIndexInit function.
+ */
+
+#include "shadow.h"
+
+#include <stdlib.h>
+
+void harness()
+{
+    ShadowFilterIndex_t * pIndex;
+    char * pFilterBuffer;
+    uint32_t bufferSize;
+    ShadowTopicSpan_t * pFilterSpans;
+    uint32_t filterCount;
+    ShadowFilterSlot_t * pSlots;
+    uint32_t slotCount;
+    uint32_t index;
+
+    __CPROVER_assume( bufferSize < TOPIC_STRING_LENGTH_MAX );
+    __CPROVER_assume( filterCount < FILTER_COUNT_MAX );
+    __CPROVER_assume( slotCount <= SLOT_COUNT_MAX );
+
+    pIndex = malloc( sizeof( *pIndex ) );
+    pFilterBuffer = malloc( bufferSize );
+    pFilterSpans = malloc( sizeof( *pFilterSpans ) * filterCount );
+    pSlots = malloc( sizeof( *pSlots ) * slotCount );
+
+    /* Every topic filter is in the buffer. */
+    if( pFilterSpans != NULL )
+    {
+        for( index = 0U; index < filterCount; index++ )
+        {
+            __CPROVER_assume( pFilterSpans[ index ].offset <= bufferSize );
+            __CPROVER_assume( pFilterSpans[ index ].length <= ( bufferSize - pFilterSpans[ index ].offset ) );
+        }
+    }
+
+    Shadow_FilterIndexInit( pIndex,
+                            pFilterBuffer,
+                            pFilterSpans,
+                            filterCount,
+                            pSlots,
+                            slotCount );
+}
@@ -0,0 +1,53 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file Shadow_MatchTopicFinish_harness.c
+ * @brief Implements the proof harness for Shadow_MatchTopicFinish function.
+ */
+
+#include "shadow.h"
+
+#include <stdlib.h>
+
+void harness()
+{
+    ShadowMatchContext_t context;
+    ShadowTopicHash_t * pHash;
+    ShadowMatchResult_t * pResult;
+    const char * pTopicName;
+    uint16_t topicNameLength;
+
+    __CPROVER_assume( topicNameLength < TOPIC_STRING_LENGTH_MAX );
+
+    pHash = malloc( sizeof( *pHash ) );
+    pResult = malloc( sizeof( *pResult ) );
+    pTopicName = malloc( topicNameLength );
+
+    /* The context can only be used once it is started. */
+    ( void ) Shadow_MatchTopicStart( &context, pHash );
+    ( void ) Shadow_MatchTopicChunk( &context, pTopicName, topicNameLength );
+
+    Shadow_MatchTopicFinish( &context, pResult );
+}
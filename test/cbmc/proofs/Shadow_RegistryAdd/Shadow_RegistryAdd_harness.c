@@ -0,0 +1,83 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file Shadow_RegistryAdd_harness.c
+ * @brief Implements the proof harness for Shadow_RegistryAdd function.
+ */
+
+#include "shadow_registry.h"
+
+#include <stdlib.h>
+
+/* Give each slot either no names, or names of arbitrary content and length. */
+static void initSlots( ShadowRegistrySlot_t * pSlots,
+                       uint32_t slotCount )
+{
+    uint32_t index;
+
+    for( index = 0U; index < slotCount; index++ )
+    {
+        __CPROVER_assume( pSlots[ index ].thingNameLength < NAME_LENGTH_MAX );
+        __CPROVER_assume( pSlots[ index ].shadowNameLength < NAME_LENGTH_MAX );
+        pSlots[ index ].pThingName = malloc( pSlots[ index ].thingNameLength );
+        pSlots[ index ].pShadowName = malloc( pSlots[ index ].shadowNameLength );
+    }
+}
+
+void harness()
+{
+    ShadowRegistry_t * pRegistry;
+    ShadowRegistrySlot_t * pSlots;
+    uint32_t slotCount;
+    const char * pThingName;
+    uint8_t thingNameLength;
+    const char * pShadowName;
+    uint8_t shadowNameLength;
+    uint32_t * pHandle;
+
+    __CPROVER_assume( slotCount < SLOT_COUNT_MAX );
+    __CPROVER_assume( thingNameLength < NAME_LENGTH_MAX );
+    __CPROVER_assume( shadowNameLength < NAME_LENGTH_MAX );
+
+    pRegistry = malloc( sizeof( *pRegistry ) );
+    pSlots = malloc( sizeof( *pSlots ) * slotCount );
+
+    if( pRegistry != NULL )
+    {
+        __CPROVER_assume( Shadow_RegistryInit( pRegistry, pSlots, slotCount ) == SHADOW_SUCCESS );
+        initSlots( pSlots, slotCount );
+    }
+
+    pThingName = malloc( thingNameLength );
+    pShadowName = malloc( shadowNameLength );
+    pHandle = malloc( sizeof( *pHandle ) );
+
+    Shadow_RegistryAdd( pRegistry,
+                        pThingName,
+                        thingNameLength,
+                        pShadowName,
+                        shadowNameLength,
+                        pHandle );
+}
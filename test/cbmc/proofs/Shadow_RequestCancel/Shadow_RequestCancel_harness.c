@@ -0,0 +1,79 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file Shadow_RequestCancel_harness.c
+ * @brief Implements the proof harness for Shadow_RequestCancel function.
+ */
+
+#include "shadow_request.h"
+
+#include <stdlib.h>
+
+/* The callback of the requests. */
+static void onResponse( void * pContext,
+                        ShadowMessageType_t messageType,
+                        const char * pPayload,
+                        uint32_t payloadLength )
+{
+    ( void ) pContext;
+    ( void ) messageType;
+    ( void ) pPayload;
+    ( void ) payloadLength;
+}
+
+void harness()
+{
+    ShadowRequestTable_t * pTable;
+    ShadowRequestSlot_t * pSlots;
+    uint16_t slotCount;
+    const char * pPrefix;
+    uint8_t prefixLength;
+    ShadowTopicStringType_t operation;
+    char startedToken[ 64 ];
+    uint8_t startedTokenLength;
+    const char * pClientToken;
+    uint8_t clientTokenLength;
+
+    __CPROVER_assume( slotCount < SLOT_COUNT_MAX );
+    __CPROVER_assume( prefixLength <= SHADOW_REQUEST_PREFIX_LENGTH_MAX );
+
+    pTable = malloc( sizeof( *pTable ) );
+    pSlots = malloc( sizeof( *pSlots ) * slotCount );
+    pPrefix = malloc( prefixLength );
+
+    if( pTable != NULL )
+    {
+        __CPROVER_assume( Shadow_RequestTableInit( pTable, pSlots, slotCount, pPrefix, prefixLength ) == SHADOW_SUCCESS );
+
+        /* Wait for the response to a request. */
+        ( void ) Shadow_RequestStart( pTable, operation, onResponse, NULL, startedToken, sizeof( startedToken ), &startedTokenLength );
+    }
+
+    pClientToken = malloc( clientTokenLength );
+
+    Shadow_RequestCancel( pTable,
+                          pClientToken,
+                          clientTokenLength );
+}
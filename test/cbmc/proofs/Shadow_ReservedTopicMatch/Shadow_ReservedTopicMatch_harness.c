@@ -0,0 +1,75 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file Shadow_ReservedTopicMatch_harness.c
+ * @brief Implements the proof harness for Shadow_ReservedTopicMatch function.
+ */
+
+#include "shadow_reserved_topic.h"
+
+#include <stdlib.h>
+
+void harness()
+{
+    const ShadowReservedTable_t * tables[ 2 ];
+    ShadowReservedTopicEngine_t engine;
+    ShadowReservedTable_t table;
+    ShadowReservedOperation_t * pOperations;
+    uint16_t tableIndex;
+    uint16_t index;
+    const char * pTopic;
+    uint16_t topicLength;
+    ShadowReservedMatch_t * pMatch;
+
+    ( void ) Shadow_ReservedTopicInit( &engine, tables, 2U );
+
+    /* Register a table of arbitrary content. */
+    __CPROVER_assume( ( table.rootLength > 0U ) && ( table.rootLength <= ROOT_LENGTH_MAX ) );
+    __CPROVER_assume( table.nameKeywordLength <= ROOT_LENGTH_MAX );
+    __CPROVER_assume( ( table.operationCount > 0U ) && ( table.operationCount <= OPERATION_COUNT_MAX ) );
+    table.pRoot = malloc( table.rootLength );
+    table.pNameKeyword = malloc( table.nameKeywordLength );
+    pOperations = malloc( sizeof( *pOperations ) * table.operationCount );
+    __CPROVER_assume( ( table.pRoot != NULL ) && ( table.pNameKeyword != NULL ) && ( pOperations != NULL ) );
+
+    for( index = 0U; index < table.operationCount; index++ )
+    {
+        __CPROVER_assume( pOperations[ index ].operationLength <= OPERATION_LENGTH_MAX );
+        pOperations[ index ].pOperation = malloc( pOperations[ index ].operationLength );
+        __CPROVER_assume( pOperations[ index ].pOperation != NULL );
+    }
+
+    table.pOperations = pOperations;
+    ( void ) Shadow_ReservedTopicRegister( &engine, &table, &tableIndex );
+
+    __CPROVER_assume( topicLength < TOPIC_STRING_LENGTH_MAX );
+    pTopic = malloc( topicLength );
+    pMatch = malloc( sizeof( *pMatch ) );
+
+    Shadow_ReservedTopicMatch( &engine,
+                               pTopic,
+                               topicLength,
+                               pMatch );
+}
@@ -0,0 +1,67 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file Shadow_SerializeUnsubscribePayload_harness.c
+ * @brief Implements the proof harness for Shadow_SerializeUnsubscribePayload function.
+ */
+
+#include "shadow.h"
+
+#include <stdlib.h>
+
+void harness()
+{
+    ShadowNames_t * pNames;
+    uint32_t nameCount;
+    uint16_t topicTypeMask;
+    uint8_t * pBuffer;
+    uint32_t bufferSize;
+    uint32_t * pOutLength;
+    uint32_t index;
+
+    __CPROVER_assume( nameCount < NAME_COUNT_MAX );
+    /* Limit the buffer to what the payload of NAME_COUNT_MAX shadows can use. */
+    __CPROVER_assume( bufferSize < ( NAME_COUNT_MAX * SHADOW_SUBSCRIBE_PAYLOAD_LEN_ALL( 128U, 64U ) ) );
+
+    pNames = malloc( sizeof( *pNames ) * nameCount );
+    pBuffer = malloc( bufferSize );
+    pOutLength = malloc( sizeof( *pOutLength ) );
+
+    if( pNames != NULL )
+    {
+        for( index = 0U; index < nameCount; index++ )
+        {
+            pNames[ index ].pThingName = malloc( pNames[ index ].thingNameLength );
+            pNames[ index ].pShadowName = malloc( pNames[ index ].shadowNameLength );
+        }
+    }
+
+    Shadow_SerializeUnsubscribePayload( pNames,
+                                        nameCount,
+                                        topicTypeMask,
+                                        pBuffer,
+                                        bufferSize,
+                                        pOutLength );
+}
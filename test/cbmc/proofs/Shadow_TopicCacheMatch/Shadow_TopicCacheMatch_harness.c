@@ -0,0 +1,68 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file Shadow_TopicCacheMatch_harness.c
+ * @brief Implements the proof harness for Shadow_TopicCacheMatch function.
+ */
+
+#include "shadow_topic_cache.h"
+
+#include <stdlib.h>
+
+void harness()
+{
+    ShadowTopicCache_t * pCache;
+    ShadowTopicCacheEntry_t * pEntries;
+    uint32_t entryCount;
+    const char * pTopic;
+    uint16_t topicLength;
+    ShadowMatchResult_t * pResult;
+    uint32_t index;
+
+    __CPROVER_assume( entryCount < ENTRY_COUNT_MAX );
+    __CPROVER_assume( topicLength < TOPIC_STRING_LENGTH_MAX );
+
+    pCache = malloc( sizeof( *pCache ) );
+    pEntries = malloc( sizeof( *pEntries ) * entryCount );
+
+    if( pCache != NULL )
+    {
+        __CPROVER_assume( Shadow_TopicCacheInit( pCache, pEntries, entryCount ) == SHADOW_SUCCESS );
+
+        /* Give each entry a cached topic of arbitrary content and length. */
+        for( index = 0U; index < entryCount; index++ )
+        {
+            __CPROVER_assume( pEntries[ index ].topicLength <= SHADOW_CACHED_TOPIC_LENGTH_MAX );
+        }
+    }
+
+    pTopic = malloc( topicLength );
+    pResult = malloc( sizeof( *pResult ) );
+
+    Shadow_TopicCacheMatch( pCache,
+                            pTopic,
+                            topicLength,
+                            pResult );
+}
@@ -0,0 +1,55 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file Shadow_VersionCacheAccept_harness.c
+ * @brief Implements the proof harness for Shadow_VersionCacheAccept function.
+ */
+
+#include "shadow_version_cache.h"
+
+#include <stdlib.h>
+
+void harness()
+{
+    ShadowVersionCache_t * pCache;
+    uint32_t * pVersions;
+    uint32_t versionCount;
+    uint32_t handle;
+    uint32_t version;
+
+    __CPROVER_assume( versionCount < VERSION_COUNT_MAX );
+
+    pCache = malloc( sizeof( *pCache ) );
+    pVersions = malloc( sizeof( *pVersions ) * versionCount );
+
+    if( pCache != NULL )
+    {
+        __CPROVER_assume( Shadow_VersionCacheInit( pCache, pVersions, versionCount ) == SHADOW_SUCCESS );
+    }
+
+    Shadow_VersionCacheAccept( pCache,
+                               handle,
+                               version );
+}
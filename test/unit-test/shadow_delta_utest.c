@@ -0,0 +1,335 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file shadow_delta_utest.c
+ * @brief Tests for the Shadow delta engine functions (declared in shadow_delta.h).
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Test framework includes. */
+#include "unity.h"
+
+/* Shadow include. */
+#include "shadow_delta.h"
+
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The number of entries of the index used by the tests.
+ */
+#define TEST_ENTRY_COUNT     ( 32U )
+
+/**
+ * @brief Size of the buffer for the keys and values of a delta.
+ */
+#define TEST_DELTA_SIZE      ( 256U )
+
+/**
+ * @brief Entries of the index used by the tests.
+ */
+static ShadowDeltaEntry_t entries[ TEST_ENTRY_COUNT ];
+
+/**
+ * @brief The engine used by the tests.
+ */
+static ShadowDeltaEngine_t engine;
+
+/**
+ * @brief The keys and values of the last delta computed by computeDelta().
+ */
+static char delta[ TEST_DELTA_SIZE ];
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Append part of a payload to #delta.
+ */
+static void appendDelta( const char * pPayload,
+                         uint32_t offset,
+                         uint32_t length )
+{
+    size_t deltaLength = strlen( delta );
+
+    TEST_ASSERT_LESS_THAN( TEST_DELTA_SIZE, deltaLength + length + 1U );
+    ( void ) memcpy( &( delta[ deltaLength ] ), &( pPayload[ offset ] ), length );
+    delta[ deltaLength + length ] = '\0';
+}
+
+/**
+ * @brief Compute the delta between two null-terminated documents with an
+ * index of entryCount entries, and write it to #delta as
+ * "key.key=value;key=value;".
+ */
+static ShadowStatus_t computeDelta( const char * pDesired,
+                                    const char * pDesiredSection,
+                                    const char * pReported,
+                                    const char * pReportedSection,
+                                    uint32_t entryCount )
+{
+    ShadowDeltaDocument_t desired = { NULL, 0U, NULL, 0U };
+    ShadowDeltaDocument_t reported = { NULL, 0U, NULL, 0U };
+    ShadowDeltaToken_t token;
+    ShadowStatus_t shadowStatus;
+    uint8_t level;
+
+    desired.pPayload = pDesired;
+    desired.payloadLength = ( uint32_t ) strlen( pDesired );
+    desired.pSection = pDesiredSection;
+    desired.sectionLength = ( pDesiredSection == NULL ) ? 0U : ( uint32_t ) strlen( pDesiredSection );
+    reported.pPayload = pReported;
+    reported.payloadLength = ( uint32_t ) strlen( pReported );
+    reported.pSection = pReportedSection;
+    reported.sectionLength = ( pReportedSection == NULL ) ? 0U : ( uint32_t ) strlen( pReportedSection );
+
+    delta[ 0 ] = '\0';
+    shadowStatus = Shadow_DeltaEngineInit( &engine, &desired, &reported, entries, entryCount );
+
+    while( shadowStatus == SHADOW_SUCCESS )
+    {
+        shadowStatus = Shadow_DeltaEngineNext( &engine, &token );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            TEST_ASSERT_EQUAL( ShadowDeltaFieldKey, token.field );
+
+            for( level = 0U; level < token.keyCount; level++ )
+            {
+                appendDelta( pDesired, token.pKeys[ level ].offset, token.pKeys[ level ].length );
+                appendDelta( ( level + 1U < token.keyCount ) ? "." : "=", 0U, 1U );
+            }
+
+            appendDelta( pDesired, token.value.offset, token.value.length );
+            appendDelta( ";", 0U, 1U );
+        }
+    }
+
+    /* The end of the desired document is the only expected way to stop. */
+    return ( shadowStatus == SHADOW_NOT_FOUND ) ? SHADOW_SUCCESS : shadowStatus;
+}
+
+/*-----------------------------------------------------------*/
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests the delta engine functions with invalid parameters.
+ */
+void test_Shadow_DeltaEngine_Invalid_Parameters( void )
+{
+    ShadowDeltaDocument_t document = { "{}", 2U, NULL, 0U };
+    ShadowDeltaDocument_t noPayload = { NULL, 2U, NULL, 0U };
+    ShadowDeltaDocument_t emptyPayload = { "{}", 0U, NULL, 0U };
+    ShadowDeltaDocument_t noSection = { "{}", 2U, NULL, 7U };
+    ShadowDeltaToken_t token;
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaEngineInit( NULL, &document, &document, entries, TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaEngineInit( &engine, NULL, &document, entries, TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaEngineInit( &engine, &document, NULL, entries, TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaEngineInit( &engine, &noPayload, &document, entries, TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaEngineInit( &engine, &emptyPayload, &document, entries, TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaEngineInit( &engine, &document, &noSection, entries, TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaEngineInit( &engine, &document, &document, NULL, TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaEngineInit( &engine, &document, &document, entries, 0U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaEngineInit( &engine, &document, &document, entries, TEST_ENTRY_COUNT - 1U ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaEngineInit( &engine, &document, &document, entries, TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaEngineNext( NULL, &token ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaEngineNext( &engine, NULL ) );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, Shadow_DeltaEngineNext( &engine, &token ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests the delta of a desired state held locally and the reported
+ * state last sent to the update topic.
+ */
+void test_Shadow_DeltaEngine_Keys( void )
+{
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"color\":\"red\",\"on\":true,\"level\":3}}", NULL,
+                                     "{\"state\":{\"reported\":{\"color\":\"red\",\"on\":false,\"mode\":1}},\"clientToken\":\"t1\"}", "reported",
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "on=true;level=3;", delta );
+
+    /* Keys of nested objects are compared one by one. Keys only in the
+     * reported state are not part of the delta. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"light\":{\"color\":\"red\",\"level\":3},\"fan\":{\"speed\":2},\"door\":{\"lock\":{\"on\":true}}}}", NULL,
+                                     "{\"state\":{\"light\":{\"color\":\"red\",\"level\":4,\"extra\":1},\"fan\":2,\"door\":{\"lock\":{\"on\":true}}}}", NULL,
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "light.level=3;fan.speed=2;", delta );
+
+    /* A value that is an object in the reported state. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"fan\":2,\"light\":{}}}", NULL,
+                                     "{\"state\":{\"fan\":{\"speed\":2}}}", NULL,
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "fan=2;", delta );
+
+    /* An object that is not in the reported state. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"light\":{\"color\":{\"r\":1}}}}", NULL,
+                                     "{\"state\":{\"fan\":1}}", NULL,
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "light.color.r=1;", delta );
+
+    /* Both states of a get/accepted document, whose metadata is skipped. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"desired\":{\"on\":true,\"level\":3},\"reported\":{\"on\":true,\"level\":2}},"
+                                     "\"metadata\":{\"desired\":{\"on\":{\"timestamp\":1}}},\"version\":4}", "desired",
+                                     "{\"state\":{\"desired\":{\"on\":true,\"level\":3},\"reported\":{\"on\":true,\"level\":2}},"
+                                     "\"metadata\":{\"desired\":{\"on\":{\"timestamp\":1}}},\"version\":4}", "reported",
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "level=3;", delta );
+
+    /* A desired state that is not an object, and another section. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"desired\":null,\"reported\":{\"on\":true}}}", "desired",
+                                     "{\"state\":{}}", NULL,
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "", delta );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"desired\":{\"on\":true}}}", "reported",
+                                     "{\"state\":{}}", NULL,
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "", delta );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"desirex\":{\"on\":true}}}", "desired",
+                                     "{\"state\":{}}", NULL,
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "", delta );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that values are compared as they are written in the documents.
+ */
+void test_Shadow_DeltaEngine_Values( void )
+{
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"a\":\"1\",\"b\":true,\"c\":1.0,\"d\":[1,2],\"e\":[1,2],\"f\":\"\",\"g\":null,\"h\":\"null\",\"i\":\"x\"}}", NULL,
+                                     "{\"state\":{\"a\":1,\"b\":\"true\",\"c\":1,\"d\":[1,2],\"e\":[1,3],\"f\":\"\",\"g\":1,\"h\":null,\"i\":\"x\"}}", NULL,
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "a=1;b=true;c=1.0;e=[1,2];h=null;", delta );
+
+    /* The last of duplicate reported keys is kept. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"a\":2,\"b\":{\"c\":1}}}", NULL,
+                                     "{\"state\":{\"a\":1,\"a\":2,\"b\":{\"c\":2},\"b\":{\"c\":1}}}", NULL,
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "", delta );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests an index that is too small, and documents that cannot be
+ * parsed.
+ */
+void test_Shadow_DeltaEngine_Errors( void )
+{
+    /* Three keys do not fit in two entries. */
+    TEST_ASSERT_EQUAL( SHADOW_BUFFER_TOO_SMALL,
+                       computeDelta( "{\"state\":{}}", NULL,
+                                     "{\"state\":{\"a\":1,\"b\":{\"c\":1}}}", NULL,
+                                     2U ) );
+
+    /* Two keys fill two entries. A key that is not in a full index is
+     * still found to differ. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"a\":1,\"b\":1,\"c\":1}}", NULL,
+                                     "{\"state\":{\"a\":1,\"b\":1}}", NULL,
+                                     2U ) );
+    TEST_ASSERT_EQUAL_STRING( "c=1;", delta );
+
+    TEST_ASSERT_EQUAL( SHADOW_PAYLOAD_PARSE_FAILED,
+                       computeDelta( "{\"state\":{}}", NULL,
+                                     "{\"state\":{\"a\":1,}}", NULL,
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_PAYLOAD_PARSE_FAILED,
+                       computeDelta( "{\"state\":{\"a\":2,}}", NULL,
+                                     "{\"state\":{\"a\":1}}", NULL,
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "a=2;", delta );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests keys whose hashes are the same as the hash of a reported key,
+ * in an index of #TEST_ENTRY_COUNT entries.
+ */
+void test_Shadow_DeltaEngine_Hash_Collisions( void )
+{
+    /* Keys of different lengths. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"dsbaaa\":1}}", NULL,
+                                     "{\"state\":{\"zwxgv\":1}}", NULL,
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "dsbaaa=1;", delta );
+
+    /* Keys of the same length. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"o\":{\"sacxa\":1}}}", NULL,
+                                     "{\"state\":{\"o\":{\"mlbvs\":1}}}", NULL,
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "o.sacxa=1;", delta );
+
+    /* Keys of different objects. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       computeDelta( "{\"state\":{\"aziad\":1}}", NULL,
+                                     "{\"state\":{\"o\":{\"kbbaa\":1}}}", NULL,
+                                     TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL_STRING( "aziad=1;", delta );
+}
@@ -0,0 +1,612 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/**
+ * @file shadow_mqtt_utest.c
+ * @brief Tests for the Shadow MQTT functions (declared in shadow_mqtt.h).
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Test framework includes. */
+#include "unity.h"
+
+/* Shadow include. */
+#include "shadow_mqtt.h"
+
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief A named shadow topic used by the tests.
+ */
+#define TEST_TOPIC             "$aws/things/testThing/shadow/name/testShadow/update/delta"
+
+/**
+ * @brief Length of #TEST_TOPIC.
+ */
+#define TEST_TOPIC_LENGTH      ( ( uint16_t ) ( sizeof( TEST_TOPIC ) - 1U ) )
+
+/**
+ * @brief A payload used by the tests.
+ */
+#define TEST_PAYLOAD           "{\"state\":{\"on\":true}}"
+
+/**
+ * @brief Length of #TEST_PAYLOAD.
+ */
+#define TEST_PAYLOAD_LENGTH    ( ( uint32_t ) ( sizeof( TEST_PAYLOAD ) - 1U ) )
+
+/**
+ * @brief Size of the packet buffer used by the tests.
+ */
+#define TEST_BUFFER_SIZE       ( 512U )
+
+/**
+ * @brief Number of entries of the topic alias table used by the tests.
+ */
+#define TEST_ALIAS_COUNT       ( 4U )
+
+/**
+ * @brief A Message Expiry Interval property of 3600 seconds.
+ */
+static const uint8_t messageExpiryProperty[] = { 0x02U, 0x00U, 0x00U, 0x0EU, 0x10U };
+
+/**
+ * @brief The packet buffer used by the tests.
+ */
+static uint8_t packet[ TEST_BUFFER_SIZE ];
+
+/**
+ * @brief The properties of the MQTT 5 packets serialized by the tests.
+ */
+static const uint8_t * pProperties;
+
+/**
+ * @brief Length of #pProperties.
+ */
+static uint32_t propertiesLength;
+
+/**
+ * @brief Entries of the topic alias table used by the tests.
+ */
+static ShadowMatchResult_t aliasEntries[ TEST_ALIAS_COUNT ];
+
+/**
+ * @brief The topic alias table used by the tests.
+ */
+static ShadowTopicAliasTable_t aliasTable;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Serialize a PUBLISH packet into #packet and return its length.
+ *
+ * @param[in] firstByte The first byte of the fixed header.
+ * @param[in] protocolLevel The MQTT protocol level. Adds #pProperties for MQTT 5.
+ * @param[in] pTopic The topic name.
+ * @param[in] topicLength Length of the topic name.
+ * @param[in] pPayload The payload.
+ * @param[in] payloadLength Length of the payload.
+ */
+static uint32_t serializePublish( uint8_t firstByte,
+                                  uint8_t protocolLevel,
+                                  const char * pTopic,
+                                  uint16_t topicLength,
+                                  const char * pPayload,
+                                  uint32_t payloadLength )
+{
+    uint8_t variableHeader[ TEST_BUFFER_SIZE ];
+    uint32_t variableLength = 0U;
+    uint32_t remainingLength = 0U;
+    uint32_t offset = 0U;
+
+    variableHeader[ variableLength++ ] = ( uint8_t ) ( topicLength >> 8U );
+    variableHeader[ variableLength++ ] = ( uint8_t ) topicLength;
+    ( void ) memcpy( &( variableHeader[ variableLength ] ), pTopic, topicLength );
+    variableLength += topicLength;
+
+    if( ( ( firstByte >> 1U ) & 0x03U ) != 0U )
+    {
+        /* Packet identifier 0x1234. */
+        variableHeader[ variableLength++ ] = 0x12U;
+        variableHeader[ variableLength++ ] = 0x34U;
+    }
+
+    if( protocolLevel == SHADOW_MQTT_PROTOCOL_LEVEL_5 )
+    {
+        variableHeader[ variableLength++ ] = ( uint8_t ) propertiesLength;
+        ( void ) memcpy( &( variableHeader[ variableLength ] ), pProperties, propertiesLength );
+        variableLength += propertiesLength;
+    }
+
+    remainingLength = variableLength + payloadLength;
+
+    packet[ offset++ ] = firstByte;
+
+    do
+    {
+        packet[ offset ] = ( uint8_t ) ( remainingLength & 0x7FU );
+        remainingLength >>= 7U;
+
+        if( remainingLength > 0U )
+        {
+            packet[ offset ] |= 0x80U;
+        }
+
+        offset++;
+    } while( remainingLength > 0U );
+
+    ( void ) memcpy( &( packet[ offset ] ), variableHeader, variableLength );
+    offset += variableLength;
+    ( void ) memcpy( &( packet[ offset ] ), pPayload, payloadLength );
+    offset += payloadLength;
+
+    return offset;
+}
+
+/**
+ * @brief Check that a packet in #packet has the given topic and payload.
+ */
+static void checkPublishInfo( const ShadowPublishInfo_t * pPublishInfo,
+                              const char * pTopic,
+                              uint16_t topicLength,
+                              const char * pPayload,
+                              uint32_t payloadLength )
+{
+    TEST_ASSERT_EQUAL_UINT16( topicLength, pPublishInfo->topicLength );
+    TEST_ASSERT_EQUAL_MEMORY( pTopic, &( packet[ pPublishInfo->topicOffset ] ), topicLength );
+    TEST_ASSERT_EQUAL_UINT32( payloadLength, pPublishInfo->payloadLength );
+    TEST_ASSERT_EQUAL_MEMORY( pPayload, &( packet[ pPublishInfo->payloadOffset ] ), payloadLength );
+}
+
+/*-----------------------------------------------------------*/
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    ( void ) memset( packet, 0, sizeof( packet ) );
+    pProperties = messageExpiryProperty;
+    propertiesLength = ( uint32_t ) sizeof( messageExpiryProperty );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_TopicAliasInit( &aliasTable, aliasEntries, TEST_ALIAS_COUNT ) );
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests Shadow_MatchPublishPacket with invalid parameters.
+ */
+void test_Shadow_MatchPublishPacket_Invalid_Parameters( void )
+{
+    ShadowPublishInfo_t publishInfo;
+    uint32_t packetLength = serializePublish( 0x30U, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1,
+                                              TEST_TOPIC, TEST_TOPIC_LENGTH,
+                                              TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacket( NULL, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1, &publishInfo ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacket( packet, 0U, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1, &publishInfo ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacket( packet, packetLength, 3U, &publishInfo ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1, NULL ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests matching MQTT 3.1.1 PUBLISH packets at each QoS.
+ */
+void test_Shadow_MatchPublishPacket_Mqtt_3_1_1( void )
+{
+    ShadowPublishInfo_t publishInfo;
+    uint32_t packetLength = 0U;
+    uint8_t qos = 0U;
+
+    for( qos = 0U; qos < 3U; qos++ )
+    {
+        packetLength = serializePublish( ( uint8_t ) ( 0x30U | ( qos << 1U ) ), SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1,
+                                         TEST_TOPIC, TEST_TOPIC_LENGTH,
+                                         TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+
+        TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                           Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1, &publishInfo ) );
+        checkPublishInfo( &publishInfo, TEST_TOPIC, TEST_TOPIC_LENGTH, TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+        TEST_ASSERT_EQUAL( SHADOW_SUCCESS, publishInfo.match.status );
+        TEST_ASSERT_EQUAL( ShadowMessageTypeUpdateDelta, publishInfo.match.messageType );
+        TEST_ASSERT_EQUAL_MEMORY( "testThing",
+                                  &( packet[ publishInfo.topicOffset + publishInfo.match.thingNameOffset ] ),
+                                  publishInfo.match.thingNameLength );
+        TEST_ASSERT_EQUAL_MEMORY( "testShadow",
+                                  &( packet[ publishInfo.topicOffset + publishInfo.match.shadowNameOffset ] ),
+                                  publishInfo.match.shadowNameLength );
+    }
+
+    /* The bytes after the packet, such as the next packet in a receive buffer,
+     * are not part of the payload. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_MatchPublishPacket( packet, TEST_BUFFER_SIZE, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1, &publishInfo ) );
+    checkPublishInfo( &publishInfo, TEST_TOPIC, TEST_TOPIC_LENGTH, TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+
+    /* An empty payload. */
+    packetLength = serializePublish( 0x31U, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1,
+                                     TEST_TOPIC, TEST_TOPIC_LENGTH, "", 0U );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1, &publishInfo ) );
+    checkPublishInfo( &publishInfo, TEST_TOPIC, TEST_TOPIC_LENGTH, "", 0U );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests matching MQTT 5 PUBLISH packets, whose properties are skipped.
+ */
+void test_Shadow_MatchPublishPacket_Mqtt_5( void )
+{
+    ShadowPublishInfo_t publishInfo;
+    char payload[ 300 ];
+    uint32_t packetLength = 0U;
+
+    packetLength = serializePublish( 0x32U, SHADOW_MQTT_PROTOCOL_LEVEL_5,
+                                     TEST_TOPIC, TEST_TOPIC_LENGTH,
+                                     TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_5, &publishInfo ) );
+    checkPublishInfo( &publishInfo, TEST_TOPIC, TEST_TOPIC_LENGTH, TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+    TEST_ASSERT_EQUAL( ShadowMessageTypeUpdateDelta, publishInfo.match.messageType );
+
+    /* A remaining length of more than one byte. */
+    ( void ) memset( payload, ( int ) 'x', sizeof( payload ) );
+    packetLength = serializePublish( 0x30U, SHADOW_MQTT_PROTOCOL_LEVEL_5,
+                                     TEST_TOPIC, TEST_TOPIC_LENGTH,
+                                     payload, ( uint32_t ) sizeof( payload ) );
+    TEST_ASSERT_EQUAL_HEX8( 0x80U, packet[ 1 ] & 0x80U );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_5, &publishInfo ) );
+    checkPublishInfo( &publishInfo, TEST_TOPIC, TEST_TOPIC_LENGTH, payload, ( uint32_t ) sizeof( payload ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that the topic and payload of a packet whose topic is not a
+ * Shadow topic are returned with the error code of the match.
+ */
+void test_Shadow_MatchPublishPacket_Not_Shadow_Topic( void )
+{
+    ShadowPublishInfo_t publishInfo;
+    uint32_t packetLength = 0U;
+
+    packetLength = serializePublish( 0x30U, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1,
+                                     "sensors/temperature", 19U,
+                                     TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+    TEST_ASSERT_EQUAL( SHADOW_FAIL,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1, &publishInfo ) );
+    checkPublishInfo( &publishInfo, "sensors/temperature", 19U, TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+
+    packetLength = serializePublish( 0x30U, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1,
+                                     "$aws/things/testThing/shadow/unknown", 36U,
+                                     TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+    TEST_ASSERT_EQUAL( SHADOW_MESSAGE_TYPE_PARSE_FAILED,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1, &publishInfo ) );
+
+    /* An MQTT 5 packet that uses a topic alias has an empty topic name. */
+    packetLength = serializePublish( 0x30U, SHADOW_MQTT_PROTOCOL_LEVEL_5,
+                                     "", 0U,
+                                     TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_5, &publishInfo ) );
+    checkPublishInfo( &publishInfo, "", 0U, TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that malformed and incomplete packets are rejected.
+ */
+void test_Shadow_MatchPublishPacket_Malformed( void )
+{
+    ShadowPublishInfo_t publishInfo;
+    uint32_t packetLength = 0U;
+    uint32_t length = 0U;
+    static const uint8_t longRemainingLength[] = { 0x30U, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0x7FU };
+
+    packetLength = serializePublish( 0x30U, SHADOW_MQTT_PROTOCOL_LEVEL_5,
+                                     TEST_TOPIC, TEST_TOPIC_LENGTH,
+                                     TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+
+    /* Every prefix of a packet is incomplete. */
+    for( length = 1U; length < packetLength; length++ )
+    {
+        TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                           Shadow_MatchPublishPacket( packet, length, SHADOW_MQTT_PROTOCOL_LEVEL_5, &publishInfo ) );
+    }
+
+    /* Not a PUBLISH packet. */
+    packet[ 0 ] = 0x20U;
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_5, &publishInfo ) );
+
+    /* QoS 3 is not allowed. */
+    packet[ 0 ] = 0x36U;
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_5, &publishInfo ) );
+
+    /* A remaining length of more than four bytes. */
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacket( longRemainingLength, ( uint32_t ) sizeof( longRemainingLength ),
+                                                  SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1, &publishInfo ) );
+
+    /* A remaining length too short for the topic name length. */
+    packet[ 0 ] = 0x30U;
+    packet[ 1 ] = 0x01U;
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1, &publishInfo ) );
+
+    /* A topic name longer than the packet. */
+    packetLength = serializePublish( 0x30U, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1,
+                                     TEST_TOPIC, TEST_TOPIC_LENGTH,
+                                     TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+    packet[ 2 ] = 0x01U;
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1, &publishInfo ) );
+
+    /* A QoS 1 packet without room for the packet identifier. */
+    packetLength = serializePublish( 0x30U, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1,
+                                     TEST_TOPIC, TEST_TOPIC_LENGTH, "x", 1U );
+    packet[ 0 ] = 0x32U;
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1, &publishInfo ) );
+
+    /* An MQTT 5 packet without the properties length. */
+    packetLength = serializePublish( 0x30U, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1,
+                                     TEST_TOPIC, TEST_TOPIC_LENGTH, "", 0U );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_5, &publishInfo ) );
+
+    /* An MQTT 5 packet with properties longer than the packet. */
+    packetLength = serializePublish( 0x30U, SHADOW_MQTT_PROTOCOL_LEVEL_3_1_1,
+                                     TEST_TOPIC, TEST_TOPIC_LENGTH, "\x05", 1U );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacket( packet, packetLength, SHADOW_MQTT_PROTOCOL_LEVEL_5, &publishInfo ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests Shadow_TopicAliasInit and Shadow_TopicAliasReset.
+ */
+void test_Shadow_TopicAliasInit_Reset( void )
+{
+    ShadowTopicAliasTable_t emptyTable = { NULL, 0U };
+    ShadowMatchResult_t result;
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicAliasInit( NULL, aliasEntries, TEST_ALIAS_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicAliasInit( &aliasTable, NULL, TEST_ALIAS_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicAliasInit( &aliasTable, aliasEntries, 0U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicAliasReset( NULL ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicAliasReset( &emptyTable ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_TopicAliasMatch( &aliasTable, 1U, TEST_TOPIC, TEST_TOPIC_LENGTH, &result ) );
+
+    /* A reset forgets the topic alias. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_TopicAliasReset( &aliasTable ) );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND,
+                       Shadow_TopicAliasMatch( &aliasTable, 1U, NULL, 0U, &result ) );
+    TEST_ASSERT_EQUAL( ShadowMessageTypeMaxNum, result.messageType );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests setting and using topic aliases with Shadow_TopicAliasMatch.
+ */
+void test_Shadow_TopicAliasMatch( void )
+{
+    ShadowTopicAliasTable_t emptyTable = { NULL, 0U };
+    ShadowMatchResult_t result;
+    ShadowMatchResult_t aliasResult;
+
+    /* Setting a topic alias matches the topic. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_TopicAliasMatch( &aliasTable, TEST_ALIAS_COUNT, TEST_TOPIC, TEST_TOPIC_LENGTH, &result ) );
+    TEST_ASSERT_EQUAL( ShadowMessageTypeUpdateDelta, result.messageType );
+
+    /* Using the topic alias returns the same result. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_TopicAliasMatch( &aliasTable, TEST_ALIAS_COUNT, NULL, 0U, &aliasResult ) );
+    TEST_ASSERT_EQUAL( result.messageType, aliasResult.messageType );
+    TEST_ASSERT_EQUAL_UINT16( result.thingNameOffset, aliasResult.thingNameOffset );
+    TEST_ASSERT_EQUAL_UINT8( result.thingNameLength, aliasResult.thingNameLength );
+    TEST_ASSERT_EQUAL_UINT16( result.shadowNameOffset, aliasResult.shadowNameOffset );
+    TEST_ASSERT_EQUAL_UINT8( result.shadowNameLength, aliasResult.shadowNameLength );
+
+    /* A topic alias that has not been set. */
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND,
+                       Shadow_TopicAliasMatch( &aliasTable, 1U, NULL, 0U, &result ) );
+
+    /* A topic alias of a topic that is not a Shadow topic keeps the error code. */
+    TEST_ASSERT_EQUAL( SHADOW_FAIL,
+                       Shadow_TopicAliasMatch( &aliasTable, 1U, "sensors/temperature", 19U, &result ) );
+    TEST_ASSERT_EQUAL( SHADOW_FAIL,
+                       Shadow_TopicAliasMatch( &aliasTable, 1U, NULL, 0U, &result ) );
+
+    /* A new topic replaces the topic of the topic alias. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_TopicAliasMatch( &aliasTable, 1U, TEST_TOPIC, TEST_TOPIC_LENGTH, &result ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_TopicAliasMatch( &aliasTable, 1U, NULL, 0U, &result ) );
+
+    /* Invalid parameters. */
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_TopicAliasMatch( NULL, 1U, TEST_TOPIC, TEST_TOPIC_LENGTH, &result ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_TopicAliasMatch( &emptyTable, 1U, TEST_TOPIC, TEST_TOPIC_LENGTH, &result ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_TopicAliasMatch( &aliasTable, 0U, TEST_TOPIC, TEST_TOPIC_LENGTH, &result ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_TopicAliasMatch( &aliasTable, TEST_ALIAS_COUNT + 1U, TEST_TOPIC, TEST_TOPIC_LENGTH, &result ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_TopicAliasMatch( &aliasTable, 1U, NULL, TEST_TOPIC_LENGTH, &result ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_TopicAliasMatch( &aliasTable, 1U, TEST_TOPIC, TEST_TOPIC_LENGTH, NULL ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests matching MQTT 5 PUBLISH packets with topic aliases.
+ */
+void test_Shadow_MatchPublishPacketAlias( void )
+{
+    /* Every PUBLISH property, with topic alias 2 last. */
+    static const uint8_t allProperties[] =
+    {
+        0x01U, 0x01U,                                     /* Payload Format Indicator. */
+        0x02U, 0x00U, 0x00U, 0x0EU, 0x10U,                /* Message Expiry Interval. */
+        0x03U, 0x00U, 0x04U, 'j',   's',   'o',   'n',    /* Content Type. */
+        0x08U, 0x00U, 0x01U, 'r',                         /* Response Topic. */
+        0x09U, 0x00U, 0x02U, 0xAAU, 0xBBU,                /* Correlation Data. */
+        0x26U, 0x00U, 0x01U, 'k',   0x00U, 0x01U, 'v',    /* User Property. */
+        0x0BU, 0x81U, 0x01U,                              /* Subscription Identifier. */
+        0x23U, 0x00U, 0x02U                               /* Topic Alias. */
+    };
+    static const uint8_t aliasProperty[] = { 0x23U, 0x00U, 0x02U };
+    ShadowPublishInfo_t publishInfo;
+    uint32_t packetLength = 0U;
+
+    /* The first packet with the topic alias sets it. */
+    pProperties = allProperties;
+    propertiesLength = ( uint32_t ) sizeof( allProperties );
+    packetLength = serializePublish( 0x30U, SHADOW_MQTT_PROTOCOL_LEVEL_5,
+                                     TEST_TOPIC, TEST_TOPIC_LENGTH,
+                                     TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_MatchPublishPacketAlias( packet, packetLength, &aliasTable, &publishInfo ) );
+    checkPublishInfo( &publishInfo, TEST_TOPIC, TEST_TOPIC_LENGTH, TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+    TEST_ASSERT_EQUAL( ShadowMessageTypeUpdateDelta, aliasEntries[ 1 ].messageType );
+
+    /* Later packets only carry the topic alias. */
+    pProperties = aliasProperty;
+    propertiesLength = ( uint32_t ) sizeof( aliasProperty );
+    packetLength = serializePublish( 0x32U, SHADOW_MQTT_PROTOCOL_LEVEL_5,
+                                     "", 0U,
+                                     TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_MatchPublishPacketAlias( packet, packetLength, &aliasTable, &publishInfo ) );
+    checkPublishInfo( &publishInfo, "", 0U, TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+    TEST_ASSERT_EQUAL( ShadowMessageTypeUpdateDelta, publishInfo.match.messageType );
+    TEST_ASSERT_EQUAL_UINT8( 9U, publishInfo.match.thingNameLength );
+
+    /* A topic alias that has not been set. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_TopicAliasReset( &aliasTable ) );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND,
+                       Shadow_MatchPublishPacketAlias( packet, packetLength, &aliasTable, &publishInfo ) );
+
+    /* A packet without a topic alias is matched as by Shadow_MatchPublishPacket(). */
+    pProperties = messageExpiryProperty;
+    propertiesLength = ( uint32_t ) sizeof( messageExpiryProperty );
+    packetLength = serializePublish( 0x30U, SHADOW_MQTT_PROTOCOL_LEVEL_5,
+                                     TEST_TOPIC, TEST_TOPIC_LENGTH,
+                                     TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_MatchPublishPacketAlias( packet, packetLength, &aliasTable, &publishInfo ) );
+    TEST_ASSERT_EQUAL( ShadowMessageTypeUpdateDelta, publishInfo.match.messageType );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, aliasEntries[ 1 ].status );
+
+    /* Invalid parameters. */
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacketAlias( NULL, packetLength, &aliasTable, &publishInfo ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacketAlias( packet, 0U, &aliasTable, &publishInfo ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacketAlias( packet, packetLength, NULL, &publishInfo ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacketAlias( packet, packetLength, &aliasTable, NULL ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_MatchPublishPacketAlias( packet, packetLength - 1U, &aliasTable, &publishInfo ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that packets with malformed properties are rejected.
+ */
+void test_Shadow_MatchPublishPacketAlias_Malformed_Properties( void )
+{
+    static const uint8_t unknownProperty[] = { 0x7FU, 0x00U };
+    static const uint8_t shortAlias[] = { 0x23U, 0x00U };
+    static const uint8_t shortStringLength[] = { 0x03U, 0x00U };
+    static const uint8_t shortString[] = { 0x03U, 0x00U, 0x04U, 'j' };
+    static const uint8_t shortUserName[] = { 0x26U, 0x00U, 0x02U, 'k' };
+    static const uint8_t shortUserValue[] = { 0x26U, 0x00U, 0x01U, 'k', 0x00U, 0x02U, 'v' };
+    static const uint8_t shortSubscriptionId[] = { 0x0BU, 0x81U };
+    const uint8_t * const pMalformed[] =
+    {
+        unknownProperty, shortAlias, shortStringLength, shortString, shortUserName, shortUserValue, shortSubscriptionId
+    };
+    const uint32_t malformedLengths[] =
+    {
+        sizeof( unknownProperty ), sizeof( shortAlias ), sizeof( shortStringLength ),
+        sizeof( shortString ), sizeof( shortUserName ), sizeof( shortUserValue ), sizeof( shortSubscriptionId )
+    };
+    ShadowPublishInfo_t publishInfo;
+    uint32_t packetLength = 0U;
+    uint32_t index = 0U;
+
+    for( index = 0U; index < ( sizeof( malformedLengths ) / sizeof( malformedLengths[ 0 ] ) ); index++ )
+    {
+        pProperties = pMalformed[ index ];
+        propertiesLength = malformedLengths[ index ];
+        packetLength = serializePublish( 0x30U, SHADOW_MQTT_PROTOCOL_LEVEL_5,
+                                         TEST_TOPIC, TEST_TOPIC_LENGTH,
+                                         TEST_PAYLOAD, TEST_PAYLOAD_LENGTH );
+        TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                           Shadow_MatchPublishPacketAlias( packet, packetLength, &aliasTable, &publishInfo ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
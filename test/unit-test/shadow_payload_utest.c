@@ -0,0 +1,691 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/**
+ * @file shadow_payload_utest.c
+ * @brief Tests for the Shadow payload functions (declared in shadow_payload.h).
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Test framework includes. */
+#include "unity.h"
+
+/* Shadow include. */
+#include "shadow_payload.h"
+
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Size of the buffer that a token is written to by describeToken().
+ */
+#define TOKEN_DESCRIPTION_SIZE    ( 256U )
+
+/**
+ * @brief The parser used by the tests.
+ */
+static ShadowDeltaParser_t parser;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Append a part of the payload to a token description.
+ */
+static void appendView( char * pDescription,
+                        const char * pPayload,
+                        const ShadowPayloadView_t * pView )
+{
+    size_t length = strlen( pDescription );
+
+    TEST_ASSERT_TRUE( ( length + pView->length ) < TOKEN_DESCRIPTION_SIZE );
+    ( void ) memcpy( &( pDescription[ length ] ), &( pPayload[ pView->offset ] ), pView->length );
+    pDescription[ length + pView->length ] = '\0';
+}
+
+/**
+ * @brief Write a token as "<field> <key path>=<value>", for example
+ * "key power/level=5" or "version=12".
+ */
+static void describeToken( char * pDescription,
+                           const char * pPayload,
+                           const ShadowDeltaToken_t * pToken )
+{
+    static const char * const pFieldNames[] = { "key ", "state", "version", "timestamp", "clientToken" };
+    uint8_t index = 0U;
+
+    ( void ) strcpy( pDescription, pFieldNames[ pToken->field ] );
+
+    for( index = 0U; index < pToken->keyCount; index++ )
+    {
+        if( index > 0U )
+        {
+            ( void ) strcat( pDescription, "/" );
+        }
+
+        appendView( pDescription, pPayload, &( pToken->pKeys[ index ] ) );
+    }
+
+    ( void ) strcat( pDescription, "=" );
+    appendView( pDescription, pPayload, &( pToken->value ) );
+}
+
+/**
+ * @brief Parse a null-terminated document, and check the tokens returned and
+ * the status that ends the parse.
+ */
+static void expectTokens( const char * pPayload,
+                          const char * const * ppExpected,
+                          size_t expectedCount,
+                          ShadowStatus_t endStatus )
+{
+    char description[ TOKEN_DESCRIPTION_SIZE ];
+    ShadowDeltaToken_t token;
+    size_t index = 0U;
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserInit( &parser, pPayload, ( uint32_t ) strlen( pPayload ) ) );
+
+    for( index = 0U; index < expectedCount; index++ )
+    {
+        TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserNext( &parser, &token ) );
+        describeToken( description, pPayload, &token );
+        TEST_ASSERT_EQUAL_STRING( ppExpected[ index ], description );
+    }
+
+    /* The status that ends the parse is returned again by later calls. */
+    TEST_ASSERT_EQUAL( endStatus, Shadow_DeltaParserNext( &parser, &token ) );
+    TEST_ASSERT_EQUAL( endStatus, Shadow_DeltaParserNext( &parser, &token ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests Shadow_DeltaParserInit and Shadow_DeltaParserNext with invalid parameters.
+ */
+void test_Shadow_DeltaParser_Invalid_Parameters( void )
+{
+    ShadowDeltaParser_t emptyParser = { 0 };
+    ShadowDeltaToken_t token;
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaParserInit( NULL, "{}", 2U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaParserInit( &parser, NULL, 2U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaParserInit( &parser, "{}", 0U ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserInit( &parser, "{}", 2U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaParserNext( NULL, &token ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaParserNext( &emptyParser, &token ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DeltaParserNext( &parser, NULL ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests parsing an update/delta document.
+ */
+void test_Shadow_DeltaParserNext_Delta( void )
+{
+    const char * pDelta =
+        "{\"version\":12,\"timestamp\":1600000000,"
+        "\"state\":{\"color\":\"red\",\"power\":{\"level\":5,\"on\":true}},"
+        "\"metadata\":{\"color\":{\"timestamp\":1600000000}},"
+        "\"clientToken\":\"token-1\"}";
+    const char * const pExpected[] =
+    {
+        "version=12",
+        "timestamp=1600000000",
+        "key color=red",
+        "key power/level=5",
+        "key power/on=true",
+        "state={\"color\":\"red\",\"power\":{\"level\":5,\"on\":true}}",
+        "clientToken=token-1"
+    };
+
+    expectTokens( pDelta, pExpected, sizeof( pExpected ) / sizeof( pExpected[ 0 ] ), SHADOW_NOT_FOUND );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests the values of changed keys, and whitespace between the parts
+ * of a document.
+ */
+void test_Shadow_DeltaParserNext_Values( void )
+{
+    const char * pDelta =
+        " \r\n{ \"state\" :\t{ \"list\" : [ 1, { \"a\" : \"}]\" } ] ,"
+        " \"text\" : \"say \\\"hi\\\"\\\\\", \"empty\" : \"\", \"none\" : null ,"
+        " \"off\" : false, \"offset\" : -1.5E+3, \"object\" : { } } } \n";
+    const char * const pExpected[] =
+    {
+        "key list=[ 1, { \"a\" : \"}]\" } ]",
+        "key text=say \\\"hi\\\"\\\\",
+        "key empty=",
+        "key none=null",
+        "key off=false",
+        "key offset=-1.5E+3",
+        "state={ \"list\" : [ 1, { \"a\" : \"}]\" } ] , \"text\" : \"say \\\"hi\\\"\\\\\", \"empty\" : \"\","
+        " \"none\" : null , \"off\" : false, \"offset\" : -1.5E+3, \"object\" : { } }"
+    };
+
+    expectTokens( pDelta, pExpected, sizeof( pExpected ) / sizeof( pExpected[ 0 ] ), SHADOW_NOT_FOUND );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests documents whose members are skipped because of their type.
+ */
+void test_Shadow_DeltaParserNext_Skipped_Members( void )
+{
+    const char * const pExpected[] = { "version=-1" };
+
+    expectTokens( "{}", NULL, 0U, SHADOW_NOT_FOUND );
+    expectTokens( "{\"state\":5,\"version\":\"12\",\"timestamp\":[1],\"clientToken\":7}", NULL, 0U, SHADOW_NOT_FOUND );
+    expectTokens( "{\"state\":[{\"a\":1}],\"stats\":{\"a\":1},\"versions\":1,\"version\":-1}", pExpected, 1U, SHADOW_NOT_FOUND );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that objects nested deeper than SHADOW_DELTA_DEPTH_MAX are
+ * returned as a single value.
+ */
+void test_Shadow_DeltaParserNext_Depth_Max( void )
+{
+    char delta[ 16U + ( 6U * SHADOW_DELTA_DEPTH_MAX ) ];
+    char expected[ 16U + ( 2U * SHADOW_DELTA_DEPTH_MAX ) ];
+    char description[ TOKEN_DESCRIPTION_SIZE ];
+    ShadowDeltaToken_t token;
+    uint32_t level = 0U;
+
+    /* {"state":{"a":{"a":...{"a":{"b":1}}...}}} with SHADOW_DELTA_DEPTH_MAX keys "a". */
+    ( void ) strcpy( delta, "{\"state\":" );
+    ( void ) strcpy( expected, "key " );
+
+    for( level = 0U; level < SHADOW_DELTA_DEPTH_MAX; level++ )
+    {
+        ( void ) strcat( delta, "{\"a\":" );
+        ( void ) strcat( expected, ( level == 0U ) ? "a" : "/a" );
+    }
+
+    ( void ) strcat( delta, "{\"b\":1}" );
+    ( void ) strcat( expected, "={\"b\":1}" );
+
+    for( level = 0U; level <= SHADOW_DELTA_DEPTH_MAX; level++ )
+    {
+        ( void ) strcat( delta, "}" );
+    }
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserInit( &parser, delta, ( uint32_t ) strlen( delta ) ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserNext( &parser, &token ) );
+    TEST_ASSERT_EQUAL_UINT8( SHADOW_DELTA_DEPTH_MAX, token.keyCount );
+    describeToken( description, delta, &token );
+    TEST_ASSERT_EQUAL_STRING( expected, description );
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserNext( &parser, &token ) );
+    TEST_ASSERT_EQUAL( ShadowDeltaFieldState, token.field );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, Shadow_DeltaParserNext( &parser, &token ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that the parser does not read past the end of a payload that
+ * is not null-terminated.
+ */
+void test_Shadow_DeltaParserNext_Payload_Length( void )
+{
+    const char * pPayload = "{\"state\":{\"on\":true}}{\"state\":{\"on\":false}}";
+    ShadowDeltaToken_t token;
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserInit( &parser, pPayload, 21U ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserNext( &parser, &token ) );
+    TEST_ASSERT_EQUAL_UINT32( 15U, token.value.offset );
+    TEST_ASSERT_EQUAL_UINT32( 4U, token.value.length );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserNext( &parser, &token ) );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, Shadow_DeltaParserNext( &parser, &token ) );
+
+    /* The literal true ends at the end of the payload. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserInit( &parser, pPayload, 19U ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserNext( &parser, &token ) );
+    TEST_ASSERT_EQUAL( SHADOW_PAYLOAD_PARSE_FAILED, Shadow_DeltaParserNext( &parser, &token ) );
+
+    /* The whole payload holds two documents. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserInit( &parser, pPayload, ( uint32_t ) strlen( pPayload ) ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserNext( &parser, &token ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DeltaParserNext( &parser, &token ) );
+    TEST_ASSERT_EQUAL( SHADOW_PAYLOAD_PARSE_FAILED, Shadow_DeltaParserNext( &parser, &token ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests documents that cannot be parsed.
+ */
+void test_Shadow_DeltaParserNext_Malformed( void )
+{
+    static const char * const pMalformed[] =
+    {
+        " ",
+        "[]",
+        "{",
+        "{,}",
+        "{1:2}",
+        "{\"a",
+        "{\"a\"",
+        "{\"a\" 1}",
+        "{\"a\":",
+        "{\"a\":}",
+        "{\"a\":1",
+        "{\"a\":1,}",
+        "{\"a\":1 2}",
+        "{\"a\":\"text",
+        "{\"a\":\"text\\",
+        "{\"a\":\"line\nbreak\"}",
+        "{\"a\":[1}",
+        "{\"a\":{]}",
+        "{\"a\":[1",
+        "{\"a\":[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]}",
+        "{\"state\":{\"a\":}}",
+        "{} x"
+    };
+    const char * const pExpected[] = { "key a=1" };
+    size_t index = 0U;
+
+    for( index = 0U; index < ( sizeof( pMalformed ) / sizeof( pMalformed[ 0 ] ) ); index++ )
+    {
+        expectTokens( pMalformed[ index ], NULL, 0U, SHADOW_PAYLOAD_PARSE_FAILED );
+    }
+
+    /* The keys before the error are returned. */
+    expectTokens( "{\"state\":{\"a\":1,,}}", pExpected, 1U, SHADOW_PAYLOAD_PARSE_FAILED );
+
+    /* The nesting limit of a skipped value is the limit of the parser, not of JSON. */
+    expectTokens( "{\"a\":[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]}", NULL, 0U, SHADOW_NOT_FOUND );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Write the document used by the writer tests.
+ */
+static ShadowStatus_t writeDocument( char * pBuffer,
+                                     uint32_t bufferSize,
+                                     uint32_t * pDocumentLength )
+{
+    ShadowDocumentWriter_t writer;
+
+    ( void ) Shadow_DocumentWriterInit( &writer, pBuffer, bufferSize );
+    ( void ) Shadow_DocumentAppendBool( &writer, "on", 2U, true );
+    ( void ) Shadow_DocumentAppendInt( &writer, "level", 5U, -12 );
+    ( void ) Shadow_DocumentBeginObject( &writer, "sensor", 6U );
+    ( void ) Shadow_DocumentAppendFloat( &writer, "temperature", 11U, 21.5f, 2U );
+    ( void ) Shadow_DocumentBeginObject( &writer, "limits", 6U );
+    ( void ) Shadow_DocumentEndObject( &writer );
+    ( void ) Shadow_DocumentAppendString( &writer, "name", 4U, "hall", 4U );
+    ( void ) Shadow_DocumentEndObject( &writer );
+    ( void ) Shadow_DocumentAppendBool( &writer, "fan", 3U, false );
+
+    return Shadow_DocumentWriterFinish( &writer, "token-1", 7U, pDocumentLength );
+}
+
+/**
+ * @brief The document written by writeDocument().
+ */
+#define TEST_DOCUMENT                                                                        \
+    "{\"state\":{\"reported\":{\"on\":true,\"level\":-12,"                                   \
+    "\"sensor\":{\"temperature\":21.50,\"limits\":{},\"name\":\"hall\"},\"fan\":false}},"    \
+    "\"clientToken\":\"token-1\"}"
+
+/**
+ * @brief Write a document with one member added by @p appendMember, and check
+ * the value written.
+ */
+#define EXPECT_MEMBER( appendMember, expectedValue )                                       \
+    do {                                                                                   \
+        ShadowDocumentWriter_t writer;                                                     \
+        char buffer[ 128 ];                                                                \
+        uint32_t documentLength = 0U;                                                      \
+        const char * pExpected = "{\"state\":{\"reported\":{\"k\":" expectedValue "}}}"; \
+        TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) ) ); \
+        TEST_ASSERT_EQUAL( SHADOW_SUCCESS, appendMember );                                 \
+        TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DocumentWriterFinish( &writer, NULL, 0U, &documentLength ) ); \
+        TEST_ASSERT_EQUAL_UINT32( strlen( pExpected ), documentLength );                   \
+        TEST_ASSERT_EQUAL_STRING_LEN( pExpected, buffer, documentLength );                 \
+    } while( 0 )
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests the document writer functions with invalid parameters.
+ */
+void test_Shadow_DocumentWriter_Invalid_Parameters( void )
+{
+    ShadowDocumentWriter_t writer;
+    char buffer[ 64 ];
+    uint32_t documentLength = 0U;
+    volatile float zero = 0.0f;
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentWriterInit( NULL, buffer, sizeof( buffer ) ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentWriterInit( &writer, NULL, sizeof( buffer ) ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendInt( NULL, "k", 1U, 1 ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendBool( NULL, "k", 1U, true ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendFloat( NULL, "k", 1U, 1.0f, 1U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendString( NULL, "k", 1U, "v", 1U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentBeginObject( NULL, "k", 1U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentEndObject( NULL ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentWriterFinish( NULL, NULL, 0U, &documentLength ) );
+
+    /* Each invalid parameter fails the document, and the first error is kept. */
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendInt( &writer, NULL, 1U, 1 ) );
+    writer.length = UINT32_MAX;
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendBool( &writer, "k", 1U, true ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentWriterFinish( &writer, NULL, 0U, &documentLength ) );
+
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendInt( &writer, "k", 0U, 1 ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendBool( &writer, NULL, 1U, true ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendBool( &writer, "k", 0U, true ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendFloat( &writer, NULL, 1U, 1.0f, 1U ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendFloat( &writer, "k", 0U, 1.0f, 1U ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendString( &writer, NULL, 1U, "v", 1U ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendString( &writer, "k", 0U, "v", 1U ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentBeginObject( &writer, "k", 0U ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendFloat( &writer, "k", 1U, 1.0f, SHADOW_DOCUMENT_DECIMALS_MAX + 1U ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendFloat( &writer, "k", 1U, 5e9f, 0U ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendFloat( &writer, "k", 1U, -5e9f, 0U ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendFloat( &writer, "k", 1U, 4294967296.0f, 0U ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendFloat( &writer, "k", 1U, zero / zero, 0U ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentAppendString( &writer, "k", 1U, NULL, 1U ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentBeginObject( &writer, NULL, 0U ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentEndObject( &writer ) );
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentWriterFinish( &writer, NULL, 0U, NULL ) );
+
+    /* An object is still open. */
+    ( void ) Shadow_DocumentWriterInit( &writer, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DocumentBeginObject( &writer, "k", 1U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentWriterFinish( &writer, NULL, 0U, &documentLength ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests writing a document, and computing its length first.
+ */
+void test_Shadow_DocumentWriter_Document( void )
+{
+    char buffer[ 256 ];
+    uint32_t documentLength = 0U;
+    uint32_t requiredLength = 0U;
+    const char * const pExpected[] =
+    {
+        "key reported/on=true",
+        "key reported/level=-12",
+        "key reported/sensor/temperature=21.50",
+        "key reported/sensor/name=hall",
+        "key reported/fan=false",
+        "state={\"reported\":{\"on\":true,\"level\":-12,\"sensor\":{\"temperature\":21.50,"
+        "\"limits\":{},\"name\":\"hall\"},\"fan\":false}}",
+        "clientToken=token-1"
+    };
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, writeDocument( NULL, 0U, &requiredLength ) );
+    TEST_ASSERT_EQUAL_UINT32( strlen( TEST_DOCUMENT ), requiredLength );
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, writeDocument( buffer, requiredLength, &documentLength ) );
+    TEST_ASSERT_EQUAL_UINT32( requiredLength, documentLength );
+    buffer[ documentLength ] = '\0';
+    TEST_ASSERT_EQUAL_STRING( TEST_DOCUMENT, buffer );
+
+    /* The document is read back by the parser. */
+    expectTokens( buffer, pExpected, sizeof( pExpected ) / sizeof( pExpected[ 0 ] ), SHADOW_NOT_FOUND );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that a document that does not fit is not written past the end
+ * of the buffer, and that the length it needs is returned.
+ */
+void test_Shadow_DocumentWriter_Buffer_Too_Small( void )
+{
+    char buffer[ sizeof( TEST_DOCUMENT ) ];
+    uint32_t bufferSize = 0U;
+    uint32_t documentLength = 0U;
+    ShadowDocumentWriter_t writer;
+
+    for( bufferSize = 0U; bufferSize < ( sizeof( TEST_DOCUMENT ) - 1U ); bufferSize++ )
+    {
+        ( void ) memset( buffer, ( int ) '#', sizeof( buffer ) );
+        documentLength = 0U;
+        TEST_ASSERT_EQUAL( SHADOW_BUFFER_TOO_SMALL, writeDocument( buffer, bufferSize, &documentLength ) );
+        TEST_ASSERT_EQUAL_UINT32( sizeof( TEST_DOCUMENT ) - 1U, documentLength );
+        TEST_ASSERT_EQUAL( '#', buffer[ bufferSize ] );
+    }
+
+    TEST_ASSERT_EQUAL( SHADOW_BUFFER_TOO_SMALL, Shadow_DocumentWriterInit( &writer, buffer, 1U ) );
+
+    /* A document longer than 4294967295 characters. */
+    ( void ) Shadow_DocumentWriterInit( &writer, NULL, 0U );
+    writer.length = UINT32_MAX - 1U;
+    TEST_ASSERT_EQUAL( SHADOW_FAIL, Shadow_DocumentAppendInt( &writer, "k", 1U, 1 ) );
+    TEST_ASSERT_EQUAL( SHADOW_FAIL, Shadow_DocumentAppendInt( &writer, NULL, 0U, 1 ) );
+    TEST_ASSERT_EQUAL( SHADOW_FAIL, Shadow_DocumentWriterFinish( &writer, NULL, 0U, &documentLength ) );
+
+    ( void ) Shadow_DocumentWriterInit( &writer, NULL, 0U );
+    writer.length = UINT32_MAX - 2U;
+    TEST_ASSERT_EQUAL( SHADOW_FAIL, Shadow_DocumentWriterFinish( &writer, NULL, 0U, &documentLength ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests the values written by the document writer.
+ */
+void test_Shadow_DocumentWriter_Values( void )
+{
+    ShadowDocumentWriter_t keyWriter;
+    ShadowDocumentWriter_t depthWriter;
+    char buffer[ 64 ];
+    uint32_t documentLength = 0U;
+    uint32_t depth = 0U;
+
+    EXPECT_MEMBER( Shadow_DocumentAppendInt( &writer, "k", 1U, 0 ), "0" );
+    EXPECT_MEMBER( Shadow_DocumentAppendInt( &writer, "k", 1U, INT32_MAX ), "2147483647" );
+    EXPECT_MEMBER( Shadow_DocumentAppendInt( &writer, "k", 1U, INT32_MIN ), "-2147483648" );
+
+    EXPECT_MEMBER( Shadow_DocumentAppendFloat( &writer, "k", 1U, 21.5f, 1U ), "21.5" );
+    EXPECT_MEMBER( Shadow_DocumentAppendFloat( &writer, "k", 1U, -3.25f, 0U ), "-3" );
+    EXPECT_MEMBER( Shadow_DocumentAppendFloat( &writer, "k", 1U, 0.05f, 3U ), "0.050" );
+    EXPECT_MEMBER( Shadow_DocumentAppendFloat( &writer, "k", 1U, 0.999f, 2U ), "1.00" );
+    EXPECT_MEMBER( Shadow_DocumentAppendFloat( &writer, "k", 1U, -0.001f, 2U ), "0.00" );
+    EXPECT_MEMBER( Shadow_DocumentAppendFloat( &writer, "k", 1U, -0.125f, 6U ), "-0.125000" );
+    EXPECT_MEMBER( Shadow_DocumentAppendFloat( &writer, "k", 1U, 4e9f, 0U ), "4000000000" );
+    EXPECT_MEMBER( Shadow_DocumentAppendFloat( &writer, "k", 1U, -4294967040.0f, 6U ), "-4294967040.000000" );
+
+    EXPECT_MEMBER( Shadow_DocumentAppendString( &writer, "k", 1U, NULL, 0U ), "\"\"" );
+    EXPECT_MEMBER( Shadow_DocumentAppendString( &writer, "k", 1U, "a\"b\\c\nd\re\tf\001\037", 13U ),
+                   "\"a\\\"b\\\\c\\nd\\re\\tf\\u0001\\u001f\"" );
+
+    /* Keys are escaped too. */
+    ( void ) Shadow_DocumentWriterInit( &keyWriter, buffer, sizeof( buffer ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DocumentAppendBool( &keyWriter, "a\"b", 3U, true ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DocumentWriterFinish( &keyWriter, NULL, 0U, &documentLength ) );
+    TEST_ASSERT_EQUAL_STRING_LEN( "{\"state\":{\"reported\":{\"a\\\"b\":true}}}", buffer, documentLength );
+
+    /* Objects can be nested up to 255 levels. */
+    ( void ) Shadow_DocumentWriterInit( &depthWriter, NULL, 0U );
+
+    for( depth = 0U; depth < 255U; depth++ )
+    {
+        TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_DocumentBeginObject( &depthWriter, "k", 1U ) );
+    }
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_DocumentBeginObject( &depthWriter, "k", 1U ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests reading the version number of documents.
+ */
+void test_Shadow_PayloadGetVersion( void )
+{
+    static const char * const pMalformed[] =
+    {
+        "[]",
+        "{",
+        "{\"vers",
+        "{\"version\"",
+        "{\"version\":",
+        "{\"version\" 12}",
+        "{\"state\":{\"on\":true} \"version\":12}",
+        "{\"version\":1.5}",
+        "{\"version\":1e3}",
+        "{\"version\":4294967296}",
+        "{\"version\":99999999999}",
+        "{\"version\":}",
+        "{,}"
+    };
+    uint32_t version = 0U;
+    size_t index = 0U;
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_PayloadGetVersion( NULL, 2U, &version ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_PayloadGetVersion( "{}", 0U, &version ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_PayloadGetVersion( "{}", 2U, NULL ) );
+
+    /* A "version" key in the state is not the version of the document. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_PayloadGetVersion( "{\"state\":{\"version\":3},\"metadata\":{},\"version\":12}",
+                                                                 50U, &version ) );
+    TEST_ASSERT_EQUAL_UINT32( 12U, version );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_PayloadGetVersion( "{\"timestamp\":1,\"version\":0}", 27U, &version ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, version );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_PayloadGetVersion( " { \"version\" : 4294967295 } ", 28U, &version ) );
+    TEST_ASSERT_EQUAL_UINT32( 4294967295U, version );
+
+    /* The version of update/documents is the version of "current". */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_PayloadGetVersion( "{\"previous\":{\"version\":12},\"current\":{\"state\":{},\"version\":13}}",
+                                                                 63U, &version ) );
+    TEST_ASSERT_EQUAL_UINT32( 13U, version );
+
+    /* Documents without a version. */
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, Shadow_PayloadGetVersion( "{}", 2U, &version ) );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, Shadow_PayloadGetVersion( "{\"current\":{},\"version\":\"1\",\"state\":{\"current\":{\"version\":2}}}",
+                                                                   62U, &version ) );
+
+    for( index = 0U; index < ( sizeof( pMalformed ) / sizeof( pMalformed[ 0 ] ) ); index++ )
+    {
+        TEST_ASSERT_EQUAL( SHADOW_PAYLOAD_PARSE_FAILED,
+                           Shadow_PayloadGetVersion( pMalformed[ index ], ( uint32_t ) strlen( pMalformed[ index ] ), &version ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests reading the client token of documents.
+ */
+void test_Shadow_PayloadGetClientToken( void )
+{
+    static const char * const pMalformed[] =
+    {
+        "[]",
+        "{\"code\":400,",
+        "{\"clientToken\" \"a\"}",
+        "{\"clientToken\":\"a}"
+    };
+    const char * pAccepted = "{\"state\":{\"clientToken\":\"x\"},\"clientToken\":1,\"version\":2,\"clientToken\":\"req-1\"}";
+    ShadowPayloadView_t clientToken = { 0U, 0U };
+    size_t index = 0U;
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_PayloadGetClientToken( NULL, 2U, &clientToken ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_PayloadGetClientToken( "{}", 0U, &clientToken ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_PayloadGetClientToken( "{}", 2U, NULL ) );
+
+    /* A "clientToken" key in the state, or that is not a string, is not the
+     * client token of the document. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_PayloadGetClientToken( pAccepted, ( uint32_t ) strlen( pAccepted ), &clientToken ) );
+    TEST_ASSERT_EQUAL_UINT32( 5U, clientToken.length );
+    TEST_ASSERT_EQUAL_INT( 0, strncmp( &( pAccepted[ clientToken.offset ] ), "req-1", 5U ) );
+
+    /* The document is not read past the client token. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_PayloadGetClientToken( "{\"clientToken\":\"\",", 18U, &clientToken ) );
+    TEST_ASSERT_EQUAL_UINT32( 16U, clientToken.offset );
+    TEST_ASSERT_EQUAL_UINT32( 0U, clientToken.length );
+
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, Shadow_PayloadGetClientToken( "{\"code\":400,\"message\":\"Bad\"}", 29U, &clientToken ) );
+
+    for( index = 0U; index < ( sizeof( pMalformed ) / sizeof( pMalformed[ 0 ] ) ); index++ )
+    {
+        TEST_ASSERT_EQUAL( SHADOW_PAYLOAD_PARSE_FAILED,
+                           Shadow_PayloadGetClientToken( pMalformed[ index ], ( uint32_t ) strlen( pMalformed[ index ] ), &clientToken ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
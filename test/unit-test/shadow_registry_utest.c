@@ -0,0 +1,346 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+
+/**
+ * @file shadow_registry_utest.c
+ * @brief Tests for the Shadow registry functions (declared in shadow_registry.h).
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Test framework includes. */
+#include "unity.h"
+
+/* Shadow include. */
+#include "shadow_registry.h"
+
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The number of slots of the registry used by the tests.
+ */
+#define TEST_SLOT_COUNT    ( 8U )
+
+/**
+ * @brief Slots of the registry used by the tests.
+ */
+static ShadowRegistrySlot_t slots[ TEST_SLOT_COUNT ];
+
+/**
+ * @brief The registry used by the tests.
+ */
+static ShadowRegistry_t registry;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Register a pair of null-terminated names and return its handle.
+ */
+static uint32_t addNames( const char * pThingName,
+                          const char * pShadowName )
+{
+    uint32_t handle = TEST_SLOT_COUNT;
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_RegistryAdd( &registry,
+                                           pThingName, ( uint8_t ) strlen( pThingName ),
+                                           pShadowName, ( uint8_t ) strlen( pShadowName ),
+                                           &handle ) );
+    TEST_ASSERT_TRUE( handle < TEST_SLOT_COUNT );
+
+    return handle;
+}
+
+/**
+ * @brief Match a null-terminated topic and check the handle and message type.
+ */
+static void matchTopic( const char * pTopic,
+                        uint32_t expectedHandle,
+                        ShadowMessageType_t expectedMessageType )
+{
+    uint32_t handle = TEST_SLOT_COUNT;
+    ShadowMessageType_t messageType = ShadowMessageTypeMaxNum;
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_RegistryMatchTopic( &registry,
+                                                  pTopic, ( uint16_t ) strlen( pTopic ),
+                                                  &handle, &messageType ) );
+    TEST_ASSERT_EQUAL_UINT32( expectedHandle, handle );
+    TEST_ASSERT_EQUAL( expectedMessageType, messageType );
+}
+
+/*-----------------------------------------------------------*/
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_RegistryInit( &registry, slots, TEST_SLOT_COUNT ) );
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests Shadow_RegistryInit with invalid and valid parameters.
+ */
+void test_Shadow_RegistryInit( void )
+{
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RegistryInit( NULL, slots, TEST_SLOT_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RegistryInit( &registry, NULL, TEST_SLOT_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RegistryInit( &registry, slots, 0U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RegistryInit( &registry, slots, 6U ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_RegistryInit( &registry, slots, 1U ) );
+    TEST_ASSERT_EQUAL_UINT32( 1U, registry.slotCount );
+    TEST_ASSERT_EQUAL_UINT32( 0U, registry.entryCount );
+    TEST_ASSERT_NULL( slots[ 0 ].pThingName );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests Shadow_RegistryAdd with invalid parameters.
+ */
+void test_Shadow_RegistryAdd_Invalid_Parameters( void )
+{
+    uint32_t handle = 0U;
+    char longName[ SHADOW_THINGNAME_LENGTH_MAX + 1U ];
+
+    ( void ) memset( longName, ( int ) 'a', sizeof( longName ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_RegistryAdd( NULL, "thing", 5U, "shadow", 6U, &handle ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_RegistryAdd( &registry, NULL, 5U, "shadow", 6U, &handle ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_RegistryAdd( &registry, "thing", 0U, "shadow", 6U, &handle ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_RegistryAdd( &registry, longName, ( uint8_t ) sizeof( longName ),
+                                           "shadow", 6U, &handle ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_RegistryAdd( &registry, "thing", 5U, NULL, 6U, &handle ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_RegistryAdd( &registry, "thing", 5U,
+                                           longName, SHADOW_NAME_LENGTH_MAX + 1U, &handle ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_RegistryAdd( &registry, "thing", 5U, "shadow", 6U, NULL ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, registry.entryCount );
+
+    /* A Classic shadow may be registered without a Shadow name pointer. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_RegistryAdd( &registry, longName, SHADOW_THINGNAME_LENGTH_MAX,
+                                           NULL, 0U, &handle ) );
+    TEST_ASSERT_EQUAL_UINT32( 1U, registry.entryCount );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that registering fills every slot, returns the existing handle
+ * for a registered pair, and fails once every slot is used.
+ */
+void test_Shadow_RegistryAdd_Full_Table( void )
+{
+    static const char * const pShadowNames[ TEST_SLOT_COUNT ] =
+    {
+        "", "one", "two", "three", "four", "five", "six", "seven"
+    };
+    uint32_t handles[ TEST_SLOT_COUNT ];
+    uint32_t handle = 0U;
+    uint32_t index = 0U;
+    uint32_t other = 0U;
+
+    for( index = 0U; index < TEST_SLOT_COUNT; index++ )
+    {
+        handles[ index ] = addNames( "thing", pShadowNames[ index ] );
+
+        for( other = 0U; other < index; other++ )
+        {
+            TEST_ASSERT_NOT_EQUAL( handles[ other ], handles[ index ] );
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32( TEST_SLOT_COUNT, registry.entryCount );
+
+    for( index = 0U; index < TEST_SLOT_COUNT; index++ )
+    {
+        TEST_ASSERT_EQUAL_UINT32( handles[ index ], addNames( "thing", pShadowNames[ index ] ) );
+    }
+
+    TEST_ASSERT_EQUAL_UINT32( TEST_SLOT_COUNT, registry.entryCount );
+
+    TEST_ASSERT_EQUAL( SHADOW_BUFFER_TOO_SMALL,
+                       Shadow_RegistryAdd( &registry, "thing", 5U, "eight", 5U, &handle ) );
+    TEST_ASSERT_EQUAL_UINT32( TEST_SLOT_COUNT, registry.entryCount );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests Shadow_RegistryMatchTopic with invalid parameters and topics.
+ */
+void test_Shadow_RegistryMatchTopic_Invalid_Parameters( void )
+{
+    const char * pTopic = SHADOW_TOPIC_STR_GET_ACC( "thing", SHADOW_NAME_CLASSIC );
+    uint16_t topicLength = SHADOW_TOPIC_LEN_GET_ACC( 5U, SHADOW_NAME_CLASSIC_LENGTH );
+    uint32_t handle = 0U;
+    ShadowMessageType_t messageType = ShadowMessageTypeMaxNum;
+
+    ( void ) addNames( "thing", "" );
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_RegistryMatchTopic( NULL, pTopic, topicLength, &handle, &messageType ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_RegistryMatchTopic( &registry, NULL, topicLength, &handle, &messageType ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_RegistryMatchTopic( &registry, pTopic, 0U, &handle, &messageType ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_RegistryMatchTopic( &registry, pTopic, topicLength, NULL, &messageType ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_RegistryMatchTopic( &registry, pTopic, topicLength, &handle, NULL ) );
+
+    /* Topics that are not Shadow topics fail as in Shadow_MatchTopicString(). */
+    TEST_ASSERT_EQUAL( SHADOW_FAIL,
+                       Shadow_RegistryMatchTopic( &registry, "a/topic", 7U, &handle, &messageType ) );
+    TEST_ASSERT_EQUAL( SHADOW_MESSAGE_TYPE_PARSE_FAILED,
+                       Shadow_RegistryMatchTopic( &registry, pTopic, topicLength - 1U, &handle, &messageType ) );
+    TEST_ASSERT_EQUAL( ShadowMessageTypeMaxNum, messageType );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests Shadow_RegistryMatchTopic with registered and unregistered pairs.
+ */
+void test_Shadow_RegistryMatchTopic_Happy_Path( void )
+{
+    const char * pTopic = NULL;
+    uint32_t handle = TEST_SLOT_COUNT;
+    uint32_t classicHandle = 0U;
+    uint32_t namedHandle = 0U;
+    uint32_t otherHandle = 0U;
+    ShadowMessageType_t messageType = ShadowMessageTypeMaxNum;
+
+    classicHandle = addNames( "thing", "" );
+    namedHandle = addNames( "thing", "shadow" );
+    otherHandle = addNames( "other", "shadow" );
+
+    matchTopic( SHADOW_TOPIC_STR_UPDATE_DELTA( "thing", SHADOW_NAME_CLASSIC ),
+                classicHandle, ShadowMessageTypeUpdateDelta );
+    matchTopic( SHADOW_TOPIC_STR_GET_ACC( "thing", "shadow" ),
+                namedHandle, ShadowMessageTypeGetAccepted );
+    matchTopic( SHADOW_TOPIC_STR_DELETE_REJ( "other", "shadow" ),
+                otherHandle, ShadowMessageTypeDeleteRejected );
+
+    /* Shadow topics of pairs that are not registered. */
+    pTopic = SHADOW_TOPIC_STR_GET_ACC( "other", SHADOW_NAME_CLASSIC );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND,
+                       Shadow_RegistryMatchTopic( &registry, pTopic, ( uint16_t ) strlen( pTopic ),
+                                                  &handle, &messageType ) );
+    pTopic = SHADOW_TOPIC_STR_GET_ACC( "thing", "shadows" );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND,
+                       Shadow_RegistryMatchTopic( &registry, pTopic, ( uint16_t ) strlen( pTopic ),
+                                                  &handle, &messageType ) );
+    TEST_ASSERT_EQUAL_UINT32( TEST_SLOT_COUNT, handle );
+    TEST_ASSERT_EQUAL( ShadowMessageTypeMaxNum, messageType );
+
+    /* A pair that is not registered is not found in a full table either. */
+    ( void ) addNames( "thing", "one" );
+    ( void ) addNames( "thing", "two" );
+    ( void ) addNames( "thing", "three" );
+    ( void ) addNames( "thing", "four" );
+    ( void ) addNames( "thing", "five" );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND,
+                       Shadow_RegistryMatchTopic( &registry, pTopic, ( uint16_t ) strlen( pTopic ),
+                                                  &handle, &messageType ) );
+    matchTopic( SHADOW_TOPIC_STR_UPDATE_DOCS( "thing", "five" ),
+                addNames( "thing", "five" ), ShadowMessageTypeUpdateDocuments );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that different pairs with the same hash get their own handles.
+ */
+void test_Shadow_RegistryMatchTopic_Hash_Collisions( void )
+{
+    /* Each row holds two pairs with the same #ShadowTopicHash_t.keyHash. */
+    static const char * const pCollisions[][ 4 ] =
+    {
+        { "wy0ys5w", "",        "tt6gv9", ""       }, /* Different Thing name lengths. */
+        { "wg6nv6",  "",        "lv5ng4", ""       }, /* Different Thing names. */
+        { "thing",   "sl1aj3a", "thing",  "fo3hj7" }, /* Different Shadow name lengths. */
+        { "thing",   "bq3nv7",  "thing",  "sv6cv9" }  /* Different Shadow names. */
+    };
+    char topic[ SHADOW_TOPIC_LEN_MAX( SHADOW_THINGNAME_LENGTH_MAX, SHADOW_NAME_LENGTH_MAX ) ];
+    uint16_t topicLength = 0U;
+    uint32_t firstHandle = 0U;
+    uint32_t secondHandle = 0U;
+    size_t index = 0U;
+
+    for( index = 0U; index < ( sizeof( pCollisions ) / sizeof( pCollisions[ 0 ] ) ); index++ )
+    {
+        TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_RegistryInit( &registry, slots, TEST_SLOT_COUNT ) );
+
+        firstHandle = addNames( pCollisions[ index ][ 0 ], pCollisions[ index ][ 1 ] );
+        secondHandle = addNames( pCollisions[ index ][ 2 ], pCollisions[ index ][ 3 ] );
+        TEST_ASSERT_EQUAL_UINT32( registry.pSlots[ firstHandle ].hash,
+                                  registry.pSlots[ secondHandle ].hash );
+        TEST_ASSERT_EQUAL_UINT32( ( firstHandle + 1U ) % TEST_SLOT_COUNT, secondHandle );
+
+        TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                           Shadow_AssembleTopicString( ShadowTopicStringTypeUpdateDelta,
+                                                       pCollisions[ index ][ 2 ],
+                                                       ( uint8_t ) strlen( pCollisions[ index ][ 2 ] ),
+                                                       pCollisions[ index ][ 3 ],
+                                                       ( uint8_t ) strlen( pCollisions[ index ][ 3 ] ),
+                                                       topic, ( uint16_t ) sizeof( topic ),
+                                                       &topicLength ) );
+        topic[ topicLength ] = '\0';
+        matchTopic( topic, secondHandle, ShadowMessageTypeUpdateDelta );
+    }
+}
+
+/*-----------------------------------------------------------*/
@@ -0,0 +1,362 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2021 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+
+/**
+ * @file shadow_request_utest.c
+ * @brief Tests for the Shadow request table functions (declared in shadow_request.h).
+ */
+
+/* Standard includes. */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Test framework includes. */
+#include "unity.h"
+
+/* Shadow include. */
+#include "shadow_request.h"
+
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The number of slots of the table used by the tests.
+ */
+#define TEST_SLOT_COUNT      ( 2U )
+
+/**
+ * @brief The prefix of the client tokens of the table used by the tests.
+ */
+#define TEST_PREFIX          "dev1-"
+
+/**
+ * @brief Length of #TEST_PREFIX.
+ */
+#define TEST_PREFIX_LENGTH   ( ( uint8_t ) ( sizeof( TEST_PREFIX ) - 1U ) )
+
+/**
+ * @brief Length of the client tokens of the table used by the tests.
+ */
+#define TEST_TOKEN_LENGTH    ( TEST_PREFIX_LENGTH + SHADOW_REQUEST_TOKEN_DIGITS )
+
+/**
+ * @brief Slots of the table used by the tests.
+ */
+static ShadowRequestSlot_t slots[ TEST_SLOT_COUNT ];
+
+/**
+ * @brief The table used by the tests.
+ */
+static ShadowRequestTable_t requests;
+
+/**
+ * @brief Number of calls to onResponse().
+ */
+static uint32_t callCount;
+
+/**
+ * @brief The context of the last call to onResponse().
+ */
+static void * pLastContext;
+
+/**
+ * @brief The message type of the last call to onResponse().
+ */
+static ShadowMessageType_t lastMessageType;
+
+/**
+ * @brief Whether onResponse() starts another request.
+ */
+static bool restartRequest;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The callback of the requests of the tests.
+ */
+static void onResponse( void * pContext,
+                        ShadowMessageType_t messageType,
+                        const char * pPayload,
+                        uint32_t payloadLength )
+{
+    char clientToken[ TEST_TOKEN_LENGTH ];
+    uint8_t clientTokenLength = 0U;
+
+    TEST_ASSERT_NOT_NULL( pPayload );
+    TEST_ASSERT_GREATER_THAN( 0U, payloadLength );
+
+    callCount++;
+    pLastContext = pContext;
+    lastMessageType = messageType;
+
+    if( restartRequest == true )
+    {
+        restartRequest = false;
+        TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_RequestStart( &requests, ShadowTopicStringTypeGet, onResponse, NULL,
+                                                                clientToken, TEST_TOKEN_LENGTH, &clientTokenLength ) );
+    }
+}
+
+/**
+ * @brief Start a request, and return its client token null-terminated.
+ */
+static ShadowStatus_t startRequest( ShadowTopicStringType_t operation,
+                                    void * pContext,
+                                    char * pClientToken )
+{
+    ShadowStatus_t shadowStatus;
+    uint8_t clientTokenLength = 0U;
+
+    shadowStatus = Shadow_RequestStart( &requests, operation, onResponse, pContext,
+                                        pClientToken, TEST_TOKEN_LENGTH, &clientTokenLength );
+
+    if( shadowStatus == SHADOW_SUCCESS )
+    {
+        TEST_ASSERT_EQUAL_UINT8( TEST_TOKEN_LENGTH, clientTokenLength );
+    }
+
+    pClientToken[ TEST_TOKEN_LENGTH ] = '\0';
+
+    return shadowStatus;
+}
+
+/**
+ * @brief Dispatch a response with a client token.
+ */
+static ShadowStatus_t dispatchResponse( ShadowMessageType_t messageType,
+                                        const char * pClientToken )
+{
+    char payload[ 128 ];
+
+    ( void ) strcpy( payload, "{\"state\":{\"on\":true},\"version\":3,\"clientToken\":\"" );
+    ( void ) strcat( payload, pClientToken );
+    ( void ) strcat( payload, "\"}" );
+
+    return Shadow_RequestDispatch( &requests, messageType, payload, ( uint32_t ) strlen( payload ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_RequestTableInit( &requests, slots, TEST_SLOT_COUNT, TEST_PREFIX, TEST_PREFIX_LENGTH ) );
+    callCount = 0U;
+    pLastContext = NULL;
+    lastMessageType = ShadowMessageTypeMaxNum;
+    restartRequest = false;
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests the request table functions with invalid parameters.
+ */
+void test_Shadow_Request_Invalid_Parameters( void )
+{
+    ShadowRequestTable_t emptyTable = { NULL, NULL, 0U, 0U, 0U, 0U };
+    char clientToken[ TEST_TOKEN_LENGTH ];
+    uint8_t clientTokenLength = 0U;
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestTableInit( NULL, slots, TEST_SLOT_COUNT, NULL, 0U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestTableInit( &requests, NULL, TEST_SLOT_COUNT, NULL, 0U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestTableInit( &requests, slots, 0U, NULL, 0U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestTableInit( &requests, slots, SHADOW_REQUEST_SLOT_COUNT_MAX, NULL, 0U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestTableInit( &requests, slots, TEST_SLOT_COUNT, NULL, 1U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestTableInit( &requests, slots, TEST_SLOT_COUNT, TEST_PREFIX,
+                                                                      SHADOW_REQUEST_PREFIX_LENGTH_MAX + 1U ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestStart( NULL, ShadowTopicStringTypeGet, onResponse, NULL,
+                                                                  clientToken, TEST_TOKEN_LENGTH, &clientTokenLength ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestStart( &emptyTable, ShadowTopicStringTypeGet, onResponse, NULL,
+                                                                  clientToken, TEST_TOKEN_LENGTH, &clientTokenLength ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestStart( &requests, ShadowTopicStringTypeGetAccepted, onResponse, NULL,
+                                                                  clientToken, TEST_TOKEN_LENGTH, &clientTokenLength ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestStart( &requests, ShadowTopicStringTypeGet, NULL, NULL,
+                                                                  clientToken, TEST_TOKEN_LENGTH, &clientTokenLength ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestStart( &requests, ShadowTopicStringTypeGet, onResponse, NULL,
+                                                                  NULL, TEST_TOKEN_LENGTH, &clientTokenLength ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestStart( &requests, ShadowTopicStringTypeGet, onResponse, NULL,
+                                                                  clientToken, TEST_TOKEN_LENGTH, NULL ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestDispatch( NULL, ShadowMessageTypeGetAccepted, "{}", 2U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestDispatch( &emptyTable, ShadowMessageTypeGetAccepted, "{}", 2U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestDispatch( &requests, ShadowMessageTypeGetAccepted, NULL, 2U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestDispatch( &requests, ShadowMessageTypeGetAccepted, "{}", 0U ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestCancel( NULL, clientToken, TEST_TOKEN_LENGTH ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestCancel( &emptyTable, clientToken, TEST_TOKEN_LENGTH ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_RequestCancel( &requests, NULL, TEST_TOKEN_LENGTH ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests dispatching responses to the callbacks of their requests.
+ */
+void test_Shadow_RequestDispatch( void )
+{
+    char updateToken[ TEST_TOKEN_LENGTH + 1U ];
+    char getToken[ TEST_TOKEN_LENGTH + 1U ];
+    uint32_t updateContext = 1U;
+    uint32_t getContext = 2U;
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, startRequest( ShadowTopicStringTypeUpdate, &updateContext, updateToken ) );
+    TEST_ASSERT_EQUAL_STRING( "dev1-00000001", updateToken );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, startRequest( ShadowTopicStringTypeGet, &getContext, getToken ) );
+    TEST_ASSERT_EQUAL_STRING( "dev1-00010001", getToken );
+    TEST_ASSERT_EQUAL_UINT16( 2U, requests.pendingCount );
+
+    /* Responses of other operations, and messages that are not responses. */
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, dispatchResponse( ShadowMessageTypeGetAccepted, updateToken ) );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, dispatchResponse( ShadowMessageTypeUpdateDelta, updateToken ) );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, dispatchResponse( ShadowMessageTypeUpdateDocuments, updateToken ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, callCount );
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, dispatchResponse( ShadowMessageTypeUpdateAccepted, updateToken ) );
+    TEST_ASSERT_EQUAL_UINT32( 1U, callCount );
+    TEST_ASSERT_EQUAL_PTR( &updateContext, pLastContext );
+    TEST_ASSERT_EQUAL( ShadowMessageTypeUpdateAccepted, lastMessageType );
+
+    /* A response is dispatched once. */
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, dispatchResponse( ShadowMessageTypeUpdateAccepted, updateToken ) );
+
+    /* The callback can start another request, which takes the freed slot. */
+    restartRequest = true;
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_RequestDispatch( &requests, ShadowMessageTypeGetRejected,
+                                                               "{\"code\":404,\"clientToken\":\"dev1-00010001\"}", 42U ) );
+    TEST_ASSERT_EQUAL_PTR( &getContext, pLastContext );
+    TEST_ASSERT_EQUAL( ShadowMessageTypeGetRejected, lastMessageType );
+    TEST_ASSERT_EQUAL_UINT16( 1U, requests.pendingCount );
+    TEST_ASSERT_EQUAL_UINT16( 2U, slots[ 1 ].generation );
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, startRequest( ShadowTopicStringTypeDelete, NULL, updateToken ) );
+    TEST_ASSERT_EQUAL_STRING( "dev1-00000002", updateToken );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, dispatchResponse( ShadowMessageTypeDeleteRejected, updateToken ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, dispatchResponse( ShadowMessageTypeGetAccepted, "dev1-00010002" ) );
+    TEST_ASSERT_EQUAL_UINT32( 4U, callCount );
+    TEST_ASSERT_EQUAL_UINT16( 0U, requests.pendingCount );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests client tokens that do not match a request.
+ */
+void test_Shadow_RequestDispatch_Unknown_Tokens( void )
+{
+    static const char * const pUnknown[] =
+    {
+        "dev1-0000000",
+        "dev1-000000011",
+        "dev2-00000001",
+        "dev1-0000000G",
+        "dev1-0000000A",
+        "dev1-000G0001",
+        "dev1-G0000001",
+        "dev1-0000000-",
+        "dev1-0000000g",
+        "dev1-000a0001",
+        "dev1-00020001",
+        "dev1-00010001",
+        "dev1-00000002"
+    };
+    char clientToken[ TEST_TOKEN_LENGTH + 1U ];
+    size_t index = 0U;
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, startRequest( ShadowTopicStringTypeUpdate, NULL, clientToken ) );
+
+    for( index = 0U; index < ( sizeof( pUnknown ) / sizeof( pUnknown[ 0 ] ) ); index++ )
+    {
+        TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, dispatchResponse( ShadowMessageTypeUpdateAccepted, pUnknown[ index ] ) );
+        TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, Shadow_RequestCancel( &requests, pUnknown[ index ], ( uint8_t ) strlen( pUnknown[ index ] ) ) );
+    }
+
+    /* Documents without a client token, or that cannot be parsed. */
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, Shadow_RequestDispatch( &requests, ShadowMessageTypeUpdateRejected, "{\"code\":400}", 12U ) );
+    TEST_ASSERT_EQUAL( SHADOW_PAYLOAD_PARSE_FAILED, Shadow_RequestDispatch( &requests, ShadowMessageTypeUpdateRejected, "[]", 2U ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, callCount );
+    TEST_ASSERT_EQUAL_UINT16( 1U, requests.pendingCount );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests a full table, cancelled requests, and a table without a
+ * prefix.
+ */
+void test_Shadow_RequestStart_Cancel( void )
+{
+    char firstToken[ TEST_TOKEN_LENGTH + 1U ];
+    char secondToken[ TEST_TOKEN_LENGTH + 1U ];
+    char clientToken[ TEST_TOKEN_LENGTH + 1U ];
+    uint8_t clientTokenLength = 0U;
+
+    TEST_ASSERT_EQUAL( SHADOW_BUFFER_TOO_SMALL, Shadow_RequestStart( &requests, ShadowTopicStringTypeGet, onResponse, NULL,
+                                                                     clientToken, TEST_TOKEN_LENGTH - 1U, &clientTokenLength ) );
+    TEST_ASSERT_EQUAL_UINT16( 0U, requests.pendingCount );
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, startRequest( ShadowTopicStringTypeGet, NULL, firstToken ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, startRequest( ShadowTopicStringTypeGet, NULL, secondToken ) );
+    TEST_ASSERT_EQUAL( SHADOW_BUFFER_TOO_SMALL, startRequest( ShadowTopicStringTypeGet, NULL, clientToken ) );
+
+    /* A cancelled request is not dispatched, and its slot is reused with
+     * another client token. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_RequestCancel( &requests, secondToken, TEST_TOKEN_LENGTH ) );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, Shadow_RequestCancel( &requests, secondToken, TEST_TOKEN_LENGTH ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, startRequest( ShadowTopicStringTypeGet, NULL, clientToken ) );
+    TEST_ASSERT_EQUAL_STRING( "dev1-00010002", clientToken );
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, dispatchResponse( ShadowMessageTypeGetAccepted, secondToken ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, dispatchResponse( ShadowMessageTypeGetAccepted, clientToken ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, dispatchResponse( ShadowMessageTypeGetAccepted, firstToken ) );
+    TEST_ASSERT_EQUAL_UINT32( 2U, callCount );
+
+    /* Client tokens without a prefix. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_RequestTableInit( &requests, slots, TEST_SLOT_COUNT, NULL, 0U ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_RequestStart( &requests, ShadowTopicStringTypeUpdate, onResponse, NULL,
+                                                            clientToken, SHADOW_REQUEST_TOKEN_DIGITS, &clientTokenLength ) );
+    TEST_ASSERT_EQUAL_UINT8( SHADOW_REQUEST_TOKEN_DIGITS, clientTokenLength );
+    TEST_ASSERT_EQUAL_INT( 0, strncmp( "00000001", clientToken, SHADOW_REQUEST_TOKEN_DIGITS ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, dispatchResponse( ShadowMessageTypeUpdateAccepted, "00000001" ) );
+    TEST_ASSERT_EQUAL_UINT32( 3U, callCount );
+}
@@ -0,0 +1,361 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/**
+ * @file shadow_reserved_topic_utest.c
+ * @brief Tests for the reserved topic engine functions (declared in shadow_reserved_topic.h).
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Test framework includes. */
+#include "unity.h"
+
+/* Shadow include. */
+#include "shadow_reserved_topic.h"
+
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The number of tables of the engine used by the tests.
+ */
+#define TEST_TABLE_COUNT    ( 3U )
+
+/**
+ * @brief A Thing name of the maximum length.
+ */
+#define TEST_THING_NAME_LENGTH_MAX                                         \
+    "0123456789012345678901234567890123456789012345678901234567890123" \
+    "0123456789012345678901234567890123456789012345678901234567890123"
+
+/**
+ * @brief A Shadow name of the maximum length.
+ */
+#define TEST_SHADOW_NAME_LENGTH_MAX \
+    "0123456789012345678901234567890123456789012345678901234567890123"
+
+/**
+ * @brief Array of tables of the engine used by the tests.
+ */
+static const ShadowReservedTable_t * tables[ TEST_TABLE_COUNT ];
+
+/**
+ * @brief The engine used by the tests.
+ */
+static ShadowReservedTopicEngine_t engine;
+
+/**
+ * @brief Some of the operations of the Jobs service.
+ */
+static const ShadowReservedOperation_t jobsOperations[] =
+{
+    { "notify",          6U,  SHADOW_RESERVED_OP_UNNAMED                            },
+    { "get/accepted",    12U, SHADOW_RESERVED_OP_UNNAMED | SHADOW_RESERVED_OP_NAMED },
+    { "update/accepted", 15U, SHADOW_RESERVED_OP_NAMED                              }
+};
+
+/**
+ * @brief A table of the Jobs service, whose job IDs directly follow the root.
+ */
+static const ShadowReservedTable_t jobsTable =
+{
+    "jobs", 4U, NULL, 0U, 64U, jobsOperations, 3U
+};
+
+/**
+ * @brief A table without named operations.
+ */
+static const ShadowReservedTable_t tunnelsTable =
+{
+    "tunnels", 7U, NULL, 0U, 0U, jobsOperations, 1U
+};
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Match a null-terminated topic with the engine, and return the status.
+ */
+static ShadowStatus_t matchTopic( const char * pTopic,
+                                  ShadowReservedMatch_t * pMatch )
+{
+    return Shadow_ReservedTopicMatch( &engine, pTopic, ( uint16_t ) strlen( pTopic ), pMatch );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check that a null-terminated topic matches the expected operation
+ * and names.
+ */
+static void checkMatch( const char * pTopic,
+                        uint16_t tableIndex,
+                        uint16_t operationIndex,
+                        uint8_t thingNameLength,
+                        const char * pName )
+{
+    ShadowReservedMatch_t match;
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, matchTopic( pTopic, &match ) );
+    TEST_ASSERT_EQUAL( tableIndex, match.tableIndex );
+    TEST_ASSERT_EQUAL( operationIndex, match.operationIndex );
+    TEST_ASSERT_EQUAL( thingNameLength, match.thingNameLength );
+
+    if( pName == NULL )
+    {
+        TEST_ASSERT_EQUAL( 0U, match.nameOffset );
+        TEST_ASSERT_EQUAL( 0U, match.nameLength );
+    }
+    else
+    {
+        TEST_ASSERT_EQUAL( strlen( pName ), match.nameLength );
+        TEST_ASSERT_EQUAL_MEMORY( pName, &( pTopic[ match.nameOffset ] ), match.nameLength );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check that the engine matches the same Shadow topics as
+ * Shadow_MatchTopicString().
+ */
+static void checkShadowMatch( const char * pTopic )
+{
+    ShadowReservedMatch_t match;
+    ShadowMessageType_t messageType;
+    const char * pThingName;
+    uint8_t thingNameLength;
+    const char * pShadowName;
+    uint8_t shadowNameLength;
+    uint16_t topicLength = ( uint16_t ) strlen( pTopic );
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS,
+                       Shadow_MatchTopicString( pTopic, topicLength, &messageType,
+                                                &pThingName, &thingNameLength,
+                                                &pShadowName, &shadowNameLength ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, matchTopic( pTopic, &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_RESERVED_TABLE_SHADOW, match.tableIndex );
+    TEST_ASSERT_EQUAL( messageType, match.operationIndex );
+    TEST_ASSERT_EQUAL( thingNameLength, match.thingNameLength );
+    TEST_ASSERT_EQUAL_PTR( pThingName, &( pTopic[ SHADOW_PREFIX_LENGTH ] ) );
+    TEST_ASSERT_EQUAL( shadowNameLength, match.nameLength );
+
+    if( shadowNameLength > 0U )
+    {
+        TEST_ASSERT_EQUAL_PTR( pShadowName, &( pTopic[ match.nameOffset ] ) );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Initialize the engine and register the test tables before each test.
+ */
+void setUp( void )
+{
+    uint16_t tableIndex = 0U;
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_ReservedTopicInit( &engine, tables, TEST_TABLE_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_ReservedTopicRegister( &engine, &jobsTable, &tableIndex ) );
+    TEST_ASSERT_EQUAL( 1U, tableIndex );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_ReservedTopicRegister( &engine, &tunnelsTable, &tableIndex ) );
+    TEST_ASSERT_EQUAL( 2U, tableIndex );
+}
+
+/* Called after each test method. */
+void tearDown( void )
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests the parameter checks of Shadow_ReservedTopicInit().
+ */
+void test_Shadow_ReservedTopicInit( void )
+{
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_ReservedTopicInit( NULL, tables, TEST_TABLE_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_ReservedTopicInit( &engine, NULL, TEST_TABLE_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_ReservedTopicInit( &engine, tables, 0U ) );
+
+    /* The table of the Shadow service is registered on initialization. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_ReservedTopicInit( &engine, tables, 1U ) );
+    TEST_ASSERT_EQUAL( 1U, engine.tableCount );
+    checkMatch( "$aws/things/T/shadow/update/delta", SHADOW_RESERVED_TABLE_SHADOW,
+                ( uint16_t ) ShadowMessageTypeUpdateDelta, 1U, NULL );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests the parameter checks of Shadow_ReservedTopicRegister(), and
+ * registering more tables than the engine holds.
+ */
+void test_Shadow_ReservedTopicRegister( void )
+{
+    ShadowReservedTable_t table = jobsTable;
+    uint16_t tableIndex = 0U;
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_ReservedTopicRegister( NULL, &jobsTable, &tableIndex ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_ReservedTopicRegister( &engine, NULL, &tableIndex ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_ReservedTopicRegister( &engine, &jobsTable, NULL ) );
+
+    table.pRoot = NULL;
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_ReservedTopicRegister( &engine, &table, &tableIndex ) );
+    table = jobsTable;
+    table.rootLength = 0U;
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_ReservedTopicRegister( &engine, &table, &tableIndex ) );
+    table = jobsTable;
+    table.nameKeywordLength = 1U;
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_ReservedTopicRegister( &engine, &table, &tableIndex ) );
+    table = jobsTable;
+    table.pOperations = NULL;
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_ReservedTopicRegister( &engine, &table, &tableIndex ) );
+    table = jobsTable;
+    table.operationCount = 0U;
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_ReservedTopicRegister( &engine, &table, &tableIndex ) );
+
+    /* A keyword is allowed when its pointer is set. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_ReservedTopicInit( &engine, tables, TEST_TABLE_COUNT ) );
+    table = jobsTable;
+    table.pNameKeyword = "job";
+    table.nameKeywordLength = 3U;
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_ReservedTopicRegister( &engine, &table, &tableIndex ) );
+    TEST_ASSERT_EQUAL( 1U, tableIndex );
+    checkMatch( "$aws/things/T/jobs/job/42/update/accepted", 1U, 2U, 1U, "42" );
+
+    /* The engine is full. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_ReservedTopicRegister( &engine, &tunnelsTable, &tableIndex ) );
+    TEST_ASSERT_EQUAL( SHADOW_BUFFER_TOO_SMALL, Shadow_ReservedTopicRegister( &engine, &jobsTable, &tableIndex ) );
+    TEST_ASSERT_EQUAL( 2U, tableIndex );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that the table of the Shadow service matches the same topics
+ * as Shadow_MatchTopicString().
+ */
+void test_Shadow_ReservedTopicMatch_Shadow( void )
+{
+    ShadowReservedMatch_t match;
+
+    checkShadowMatch( "$aws/things/TestThingName/shadow/get/accepted" );
+    checkShadowMatch( "$aws/things/TestThingName/shadow/get/rejected" );
+    checkShadowMatch( "$aws/things/TestThingName/shadow/delete/accepted" );
+    checkShadowMatch( "$aws/things/TestThingName/shadow/delete/rejected" );
+    checkShadowMatch( "$aws/things/TestThingName/shadow/update/accepted" );
+    checkShadowMatch( "$aws/things/TestThingName/shadow/update/rejected" );
+    checkShadowMatch( "$aws/things/TestThingName/shadow/update/documents" );
+    checkShadowMatch( "$aws/things/TestThingName/shadow/update/delta" );
+    checkShadowMatch( "$aws/things/TestThingName/shadow/name/TestShadowName/get/accepted" );
+    checkShadowMatch( "$aws/things/TestThingName/shadow/name/TestShadowName/update/delta" );
+    checkShadowMatch( "$aws/things/" TEST_THING_NAME_LENGTH_MAX "/shadow/name/"
+                      TEST_SHADOW_NAME_LENGTH_MAX "/update/documents" );
+
+    /* Not "$aws/things/". */
+    TEST_ASSERT_EQUAL( SHADOW_FAIL, matchTopic( "$aws/things/", &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_FAIL, matchTopic( "$aws/thingz/T/shadow/update/delta", &match ) );
+
+    /* Empty, too long or unterminated Thing names. */
+    TEST_ASSERT_EQUAL( SHADOW_THINGNAME_PARSE_FAILED, matchTopic( "$aws/things//shadow/update/delta", &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_THINGNAME_PARSE_FAILED,
+                       matchTopic( "$aws/things/" TEST_THING_NAME_LENGTH_MAX "x/shadow/update/delta", &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_THINGNAME_PARSE_FAILED, matchTopic( "$aws/things/TestThingName", &match ) );
+
+    /* No registered root. */
+    TEST_ASSERT_EQUAL( SHADOW_ROOT_PARSE_FAILED, matchTopic( "$aws/things/T/shadow", &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_ROOT_PARSE_FAILED, matchTopic( "$aws/things/T/shadowx/update/delta", &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_ROOT_PARSE_FAILED, matchTopic( "$aws/things/T/shadov/update/delta", &match ) );
+
+    /* Empty, too long or unterminated Shadow names. */
+    TEST_ASSERT_EQUAL( SHADOW_SHADOWNAME_PARSE_FAILED, matchTopic( "$aws/things/T/shadow/name//update/delta", &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_SHADOWNAME_PARSE_FAILED,
+                       matchTopic( "$aws/things/T/shadow/name/" TEST_SHADOW_NAME_LENGTH_MAX "x/update/delta", &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_SHADOWNAME_PARSE_FAILED, matchTopic( "$aws/things/T/shadow/name/S", &match ) );
+
+    /* Unknown operations and keywords. */
+    TEST_ASSERT_EQUAL( SHADOW_MESSAGE_TYPE_PARSE_FAILED, matchTopic( "$aws/things/T/shadow/update", &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_MESSAGE_TYPE_PARSE_FAILED, matchTopic( "$aws/things/T/shadow/name", &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_MESSAGE_TYPE_PARSE_FAILED, matchTopic( "$aws/things/T/shadow/namex/S/update/delta", &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_MESSAGE_TYPE_PARSE_FAILED, matchTopic( "$aws/things/T/shadow/nane/S/update/delta", &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_MESSAGE_TYPE_PARSE_FAILED, matchTopic( "$aws/things/T/shadow/name/S/update/deltas", &match ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests matching the topics of registered tables.
+ */
+void test_Shadow_ReservedTopicMatch_Registered( void )
+{
+    ShadowReservedMatch_t match;
+
+    checkMatch( "$aws/things/TestThingName/jobs/notify", 1U, 0U, 13U, NULL );
+    checkMatch( "$aws/things/TestThingName/jobs/get/accepted", 1U, 1U, 13U, NULL );
+    checkMatch( "$aws/things/TestThingName/jobs/42/get/accepted", 1U, 1U, 13U, "42" );
+    checkMatch( "$aws/things/TestThingName/jobs/42/update/accepted", 1U, 2U, 13U, "42" );
+    checkMatch( "$aws/things/T/tunnels/notify", 2U, 0U, 1U, NULL );
+
+    /* Operations that are only unnamed or only named. */
+    TEST_ASSERT_EQUAL( SHADOW_MESSAGE_TYPE_PARSE_FAILED, matchTopic( "$aws/things/T/jobs/42/notify", &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_MESSAGE_TYPE_PARSE_FAILED, matchTopic( "$aws/things/T/jobs/update/accepted/x", &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_SHADOWNAME_PARSE_FAILED, matchTopic( "$aws/things/T/jobs/update", &match ) );
+
+    /* A table without named operations. */
+    TEST_ASSERT_EQUAL( SHADOW_MESSAGE_TYPE_PARSE_FAILED, matchTopic( "$aws/things/T/tunnels/42/notify", &match ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests the parameter checks of Shadow_ReservedTopicMatch().
+ */
+void test_Shadow_ReservedTopicMatch_InvalidParameters( void )
+{
+    ShadowReservedMatch_t match;
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_ReservedTopicMatch( NULL, "$aws/things/T/jobs/notify", 25U, &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_ReservedTopicMatch( &engine, NULL, 25U, &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_ReservedTopicMatch( &engine, "$aws/things/T/jobs/notify", 0U, &match ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER,
+                       Shadow_ReservedTopicMatch( &engine, "$aws/things/T/jobs/notify", 25U, NULL ) );
+}
@@ -0,0 +1,228 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/**
+ * @file shadow_topic_cache_utest.c
+ * @brief Tests for the Shadow topic cache functions (declared in shadow_topic_cache.h).
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Test framework includes. */
+#include "unity.h"
+
+/* Shadow include. */
+#include "shadow_topic_cache.h"
+
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The number of entries of the cache used by the tests.
+ */
+#define TEST_ENTRY_COUNT    ( 2U )
+
+/**
+ * @brief Entries of the cache used by the tests.
+ */
+static ShadowTopicCacheEntry_t entries[ TEST_ENTRY_COUNT ];
+
+/**
+ * @brief The cache used by the tests.
+ */
+static ShadowTopicCache_t topicCache;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Match a null-terminated topic with the cache, and check that the
+ * result is the same as without the cache.
+ */
+static void matchTopic( const char * pTopic )
+{
+    ShadowTopic_t topic = { NULL, 0U };
+    ShadowMatchResult_t expectedResult;
+    ShadowMatchResult_t result;
+
+    topic.pTopic = pTopic;
+    topic.topicLength = ( uint16_t ) strlen( pTopic );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_MatchTopicBatch( &topic, 1U, &expectedResult ) );
+
+    TEST_ASSERT_EQUAL( expectedResult.status,
+                       Shadow_TopicCacheMatch( &topicCache, topic.pTopic, topic.topicLength, &result ) );
+    TEST_ASSERT_EQUAL( expectedResult.status, result.status );
+
+    if( expectedResult.status == SHADOW_SUCCESS )
+    {
+        TEST_ASSERT_EQUAL( expectedResult.messageType, result.messageType );
+        TEST_ASSERT_EQUAL_UINT16( expectedResult.thingNameOffset, result.thingNameOffset );
+        TEST_ASSERT_EQUAL_UINT8( expectedResult.thingNameLength, result.thingNameLength );
+        TEST_ASSERT_EQUAL_UINT16( expectedResult.shadowNameOffset, result.shadowNameOffset );
+        TEST_ASSERT_EQUAL_UINT8( expectedResult.shadowNameLength, result.shadowNameLength );
+    }
+}
+
+/**
+ * @brief Match a null-terminated topic, and check whether it was in the cache.
+ */
+static void matchTopicExpectHit( const char * pTopic,
+                                 uint32_t expectHit )
+{
+    uint32_t hitCount = topicCache.hitCount;
+    uint32_t missCount = topicCache.missCount;
+
+    matchTopic( pTopic );
+    TEST_ASSERT_EQUAL_UINT32( hitCount + expectHit, topicCache.hitCount );
+    TEST_ASSERT_EQUAL_UINT32( missCount + 1U - expectHit, topicCache.missCount );
+}
+
+/*-----------------------------------------------------------*/
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_TopicCacheInit( &topicCache, entries, TEST_ENTRY_COUNT ) );
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests Shadow_TopicCacheInit and Shadow_TopicCacheMatch with invalid parameters.
+ */
+void test_Shadow_TopicCache_Invalid_Parameters( void )
+{
+    ShadowTopicCache_t emptyCache = { NULL, 0U, 0U, 0U };
+    ShadowMatchResult_t result;
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicCacheInit( NULL, entries, TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicCacheInit( &topicCache, NULL, TEST_ENTRY_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicCacheInit( &topicCache, entries, 0U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicCacheInit( &topicCache, entries, 3U ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicCacheMatch( NULL, "topic", 5U, &result ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicCacheMatch( &emptyCache, "topic", 5U, &result ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicCacheMatch( &topicCache, NULL, 5U, &result ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicCacheMatch( &topicCache, "topic", 0U, &result ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_TopicCacheMatch( &topicCache, "topic", 5U, NULL ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, topicCache.hitCount + topicCache.missCount );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that a topic matched again is found in the cache, including a
+ * topic that is not a Shadow topic.
+ */
+void test_Shadow_TopicCacheMatch_Hit( void )
+{
+    char topic[] = "$aws/things/thing/shadow/name/config/update/delta";
+
+    matchTopicExpectHit( topic, 0U );
+    matchTopicExpectHit( topic, 1U );
+    matchTopicExpectHit( "sensors/temperature", 0U );
+    matchTopicExpectHit( "sensors/temperature", 1U );
+    matchTopicExpectHit( topic, 1U );
+
+    /* A topic shorter than the characters read for its key. */
+    matchTopicExpectHit( "a/b", 0U );
+    matchTopicExpectHit( "a/b", 1U );
+
+    /* A topic of the same length that differs in one character. */
+    topic[ 12 ] = 'T';
+    matchTopicExpectHit( topic, 0U );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that a topic replaces the topic kept in the entry that its hash
+ * selects, and leaves the other entries.
+ */
+void test_Shadow_TopicCacheMatch_Replace( void )
+{
+    /* The keys of update/delta and update/accepted are even, and the key of
+     * get/accepted is odd. */
+    matchTopicExpectHit( "$aws/things/thing/shadow/update/delta", 0U );
+    matchTopicExpectHit( "$aws/things/thing/shadow/get/accepted", 0U );
+    matchTopicExpectHit( "$aws/things/thing/shadow/update/delta", 1U );
+    matchTopicExpectHit( "$aws/things/thing/shadow/get/accepted", 1U );
+
+    /* Replaces update/delta, which has the same entry. */
+    matchTopicExpectHit( "$aws/things/thing/shadow/update/accepted", 0U );
+    matchTopicExpectHit( "$aws/things/thing/shadow/get/accepted", 1U );
+    matchTopicExpectHit( "$aws/things/thing/shadow/update/accepted", 1U );
+    matchTopicExpectHit( "$aws/things/thing/shadow/update/delta", 0U );
+
+    /* Replaces update/delta, which has the same entry and length, but not the
+     * same key. */
+    matchTopicExpectHit( "$aws/things/thing/shadow/get/rejected", 0U );
+    matchTopicExpectHit( "$aws/things/thing/shadow/update/delta", 0U );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests topics that are not cached, or that have the same length and
+ * key as a cached topic.
+ */
+void test_Shadow_TopicCacheMatch_Not_Cached( void )
+{
+    char longTopic[ SHADOW_CACHED_TOPIC_LENGTH_MAX + 2U ];
+
+    /* A topic longer than SHADOW_CACHED_TOPIC_LENGTH_MAX is matched every time. */
+    ( void ) memset( longTopic, ( int ) 'a', sizeof( longTopic ) - 1U );
+    longTopic[ sizeof( longTopic ) - 1U ] = '\0';
+    matchTopicExpectHit( longTopic, 0U );
+    matchTopicExpectHit( longTopic, 0U );
+
+    /* These topics have the same length, the same eight characters after the
+     * prefix and the same last eight characters, so they have the same key,
+     * and the second one replaces the first. */
+    matchTopicExpectHit( "$aws/things/thing/shadow/update/accepted", 0U );
+    matchTopicExpectHit( "$aws/things/thing/shadow/delete/accepted", 0U );
+    matchTopicExpectHit( "$aws/things/thing/shadow/delete/accepted", 1U );
+    matchTopicExpectHit( "$aws/things/thing/shadow/update/accepted", 0U );
+}
+
+/*-----------------------------------------------------------*/
@@ -29,6 +29,7 @@
  */
 
 /* Standard includes. */
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -598,6 +599,68 @@ void test_Shadow_Named_MacrosLength( void )
     TEST_ASSERT_EQUAL( TEST_NAMED_TOPIC_LENGTH_DELETE_REJECTED, SHADOW_TOPIC_LEN_DELETE_REJ( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) );
 }
 
+/**
+ * @brief Tests that #ShadowTopicDescriptors describes every topic type.
+ */
+void test_Shadow_TopicDescriptors( void )
+{
+    const ShadowTopicDescriptor_t * pDescriptor = NULL;
+    char topicBuffer[ SHADOW_TOPIC_LEN_MAX( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) ];
+    uint16_t topicLength = 0U;
+    uint32_t index = 0U;
+    uint32_t messageCount = 0U;
+    ShadowMessageType_t messageType = ShadowMessageTypeMaxNum;
+    const char * pThingName = NULL;
+    uint8_t thingNameLength = 0U;
+
+    for( index = 0U; index < ( uint32_t ) ShadowTopicStringTypeMaxNum; index++ )
+    {
+        pDescriptor = &( ShadowTopicDescriptors[ index ] );
+
+        TEST_ASSERT_EQUAL_SIZE_T( pDescriptor->length, strlen( pDescriptor->pString ) );
+        TEST_ASSERT_TRUE( pDescriptor->operationLength <= pDescriptor->length );
+        TEST_ASSERT_EQUAL( SHADOW_TOPIC_LEN( pDescriptor->length, 0U, TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ),
+                           SHADOW_TOPIC_LEN( pDescriptor->operationLength,
+                                             pDescriptor->length - pDescriptor->operationLength,
+                                             TEST_THING_NAME_LENGTH,
+                                             TEST_SHADOW_NAME_LENGTH ) );
+
+        /* The topic ends with the string of the descriptor. */
+        TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, Shadow_AssembleTopicString( ( ShadowTopicStringType_t ) index,
+                                                                           TEST_THING_NAME,
+                                                                           TEST_THING_NAME_LENGTH,
+                                                                           TEST_SHADOW_NAME,
+                                                                           TEST_SHADOW_NAME_LENGTH,
+                                                                           topicBuffer,
+                                                                           ( uint16_t ) sizeof( topicBuffer ),
+                                                                           &topicLength ) );
+        TEST_ASSERT_EQUAL( SHADOW_TOPIC_LEN( pDescriptor->length, 0U, TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ),
+                           topicLength );
+        TEST_ASSERT_EQUAL_MEMORY( pDescriptor->pString, &( topicBuffer[ topicLength - pDescriptor->length ] ), pDescriptor->length );
+
+        /* Only response topics have a message type, which the topic matches. */
+        if( pDescriptor->messageType != ShadowMessageTypeMaxNum )
+        {
+            TEST_ASSERT_TRUE( pDescriptor->operationLength < pDescriptor->length );
+            TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, Shadow_MatchTopicString( topicBuffer,
+                                                                            topicLength,
+                                                                            &messageType,
+                                                                            &pThingName,
+                                                                            &thingNameLength,
+                                                                            NULL,
+                                                                            NULL ) );
+            TEST_ASSERT_EQUAL_INT( pDescriptor->messageType, messageType );
+            messageCount++;
+        }
+        else
+        {
+            TEST_ASSERT_EQUAL( pDescriptor->operationLength, pDescriptor->length );
+        }
+    }
+
+    TEST_ASSERT_EQUAL_UINT32( ( uint32_t ) ShadowMessageTypeMaxNum, messageCount );
+}
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -1341,3 +1404,1861 @@ void test_Shadow_MatchTopicString_Invalid_Parameters( void )
 }
 
 /*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests the behavior of Shadow_MatchTopicBatch() with a mix of Classic,
+ *        named and non-Shadow topics.
+ */
+void test_Shadow_MatchTopicBatch_Happy_Path( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowTopic_t topics[ 5 ];
+    ShadowMatchResult_t results[ 5 ];
+
+    topics[ 0 ].pTopic = TEST_CLASSIC_TOPIC_STRING_UPDATE_DELTA;
+    topics[ 0 ].topicLength = TEST_CLASSIC_TOPIC_LENGTH_UPDATE_DELTA;
+    topics[ 1 ].pTopic = TEST_NAMED_TOPIC_STRING_GET_REJECTED;
+    topics[ 1 ].topicLength = TEST_NAMED_TOPIC_LENGTH_GET_REJECTED;
+    topics[ 2 ].pTopic = TEST_TOPIC_STRING_INVALID_PREFIX;
+    topics[ 2 ].topicLength = TEST_TOPIC_LENGTH_INVALID_PREFIX;
+    topics[ 3 ].pTopic = NULL;
+    topics[ 3 ].topicLength = TEST_CLASSIC_TOPIC_LENGTH_UPDATE_DELTA;
+    topics[ 4 ].pTopic = TEST_NAMED_TOPIC_STRING_EXCEEDS_MAX_SHADOW_NAME;
+    topics[ 4 ].topicLength = 0U;
+
+    shadowStatus = Shadow_MatchTopicBatch( topics, 5U, results );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, results[ 0 ].status );
+    TEST_ASSERT_EQUAL_INT( ShadowMessageTypeUpdateDelta, results[ 0 ].messageType );
+    TEST_ASSERT_EQUAL_INT( TEST_THING_NAME_LENGTH, results[ 0 ].thingNameLength );
+    TEST_ASSERT_EQUAL_STRING_LEN( TEST_THING_NAME,
+                                  &( topics[ 0 ].pTopic[ results[ 0 ].thingNameOffset ] ),
+                                  TEST_THING_NAME_LENGTH );
+    TEST_ASSERT_EQUAL_INT( 0, results[ 0 ].shadowNameOffset );
+    TEST_ASSERT_EQUAL_INT( 0, results[ 0 ].shadowNameLength );
+
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, results[ 1 ].status );
+    TEST_ASSERT_EQUAL_INT( ShadowMessageTypeGetRejected, results[ 1 ].messageType );
+    TEST_ASSERT_EQUAL_INT( TEST_THING_NAME_LENGTH, results[ 1 ].thingNameLength );
+    TEST_ASSERT_EQUAL_STRING_LEN( TEST_THING_NAME,
+                                  &( topics[ 1 ].pTopic[ results[ 1 ].thingNameOffset ] ),
+                                  TEST_THING_NAME_LENGTH );
+    TEST_ASSERT_EQUAL_INT( TEST_SHADOW_NAME_LENGTH, results[ 1 ].shadowNameLength );
+    TEST_ASSERT_EQUAL_STRING_LEN( TEST_SHADOW_NAME,
+                                  &( topics[ 1 ].pTopic[ results[ 1 ].shadowNameOffset ] ),
+                                  TEST_SHADOW_NAME_LENGTH );
+
+    TEST_ASSERT_EQUAL_INT( SHADOW_FAIL, results[ 2 ].status );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, results[ 3 ].status );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, results[ 4 ].status );
+
+    /* A batch of one with the topic that exceeds the maximum shadow name length
+     * reports the same error as Shadow_MatchTopicString(). */
+    topics[ 4 ].topicLength = TEST_NAMED_TOPIC_LENGTH_EXCEEDS_MAX_SHADOW_NAME;
+    shadowStatus = Shadow_MatchTopicBatch( &( topics[ 4 ] ), 1U, &( results[ 4 ] ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SHADOWNAME_PARSE_FAILED, results[ 4 ].status );
+}
+
+/**
+ * @brief Tests the behavior of Shadow_MatchTopicBatch() with invalid parameters.
+ */
+void test_Shadow_MatchTopicBatch_Invalid_Parameters( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowTopic_t topic = { TEST_CLASSIC_TOPIC_STRING_UPDATE_DELTA, TEST_CLASSIC_TOPIC_LENGTH_UPDATE_DELTA };
+    ShadowMatchResult_t result;
+
+    shadowStatus = Shadow_MatchTopicBatch( NULL, 1U, &result );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_MatchTopicBatch( &topic, 0U, &result );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_MatchTopicBatch( &topic, 1U, NULL );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that topics diverging from a Shadow topic at each part of the
+ *        topic are rejected with the status of that part.
+ */
+void test_Shadow_MatchTopicString_Partial_Topics( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowTopic_t topics[ 16 ];
+    ShadowMatchResult_t results[ 16 ];
+    uint32_t index = 0U;
+    char thingNameTopic[ 200 ];
+    uint16_t thingNameTopicLength = 0U;
+
+    static const char * const pTopicStrings[ 16 ] =
+    {
+        "$aws",
+        "$aws/thingz/TestThingName/shadow/get",
+        "$aws/things/TestThingName/shado",
+        "$aws/things/TestThingName/shadowx/get",
+        "$aws/things/TestThingName/shadow/",
+        "$aws/things/TestThingName/shadow/nam",
+        "$aws/things/TestThingName/shadow/namex/get/accepted",
+        "$aws/things/TestThingName/shadow/name",
+        "$aws/things/TestThingName/shadow/name/",
+        "$aws/things/TestThingName/shadow/name/TestShadowName",
+        "$aws/things/TestThingName/shadow/get/",
+        "$aws/things/TestThingName/shadow/update/delt",
+        "$aws/things/TestThingName/shadow/update/deltas",
+        "$aws/things/TestThingName/shadow/get/documents",
+        "$aws/things/TestThingName/shadow/delete/rejected",
+        "$aws/things/TestThingName/shadow/name/TestShadowName/update/documents"
+    };
+
+    static const ShadowStatus_t expectedStatus[ 16 ] =
+    {
+        SHADOW_FAIL,
+        SHADOW_FAIL,
+        SHADOW_ROOT_PARSE_FAILED,
+        SHADOW_MESSAGE_TYPE_PARSE_FAILED,
+        SHADOW_MESSAGE_TYPE_PARSE_FAILED,
+        SHADOW_MESSAGE_TYPE_PARSE_FAILED,
+        SHADOW_MESSAGE_TYPE_PARSE_FAILED,
+        SHADOW_MESSAGE_TYPE_PARSE_FAILED,
+        SHADOW_SHADOWNAME_PARSE_FAILED,
+        SHADOW_SHADOWNAME_PARSE_FAILED,
+        SHADOW_MESSAGE_TYPE_PARSE_FAILED,
+        SHADOW_MESSAGE_TYPE_PARSE_FAILED,
+        SHADOW_MESSAGE_TYPE_PARSE_FAILED,
+        SHADOW_MESSAGE_TYPE_PARSE_FAILED,
+        SHADOW_SUCCESS,
+        SHADOW_SUCCESS
+    };
+
+    for( index = 0U; index < 16U; index++ )
+    {
+        topics[ index ].pTopic = pTopicStrings[ index ];
+        topics[ index ].topicLength = ( uint16_t ) strlen( pTopicStrings[ index ] );
+    }
+
+    shadowStatus = Shadow_MatchTopicBatch( topics, 16U, results );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+
+    for( index = 0U; index < 16U; index++ )
+    {
+        TEST_ASSERT_EQUAL_INT( expectedStatus[ index ], results[ index ].status );
+    }
+
+    TEST_ASSERT_EQUAL_INT( ShadowMessageTypeDeleteRejected, results[ 14 ].messageType );
+    TEST_ASSERT_EQUAL_INT( ShadowMessageTypeUpdateDocuments, results[ 15 ].messageType );
+    TEST_ASSERT_EQUAL_INT( TEST_SHADOW_NAME_LENGTH, results[ 15 ].shadowNameLength );
+
+    /* A Thing name of the maximum length is accepted, one byte more is not. */
+    ( void ) memcpy( thingNameTopic, SHADOW_PREFIX, SHADOW_PREFIX_LENGTH );
+    ( void ) memset( &( thingNameTopic[ SHADOW_PREFIX_LENGTH ] ), 'T', 129U );
+    ( void ) memcpy( &( thingNameTopic[ SHADOW_PREFIX_LENGTH + 129U ] ), "/shadow/get/accepted", 20U );
+    thingNameTopicLength = ( uint16_t ) ( SHADOW_PREFIX_LENGTH + 129U + 20U );
+
+    topics[ 0 ].pTopic = thingNameTopic;
+    topics[ 0 ].topicLength = thingNameTopicLength;
+    shadowStatus = Shadow_MatchTopicBatch( topics, 1U, results );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_INT( SHADOW_THINGNAME_PARSE_FAILED, results[ 0 ].status );
+
+    /* Move the prefix one byte right to shorten the Thing name by one. */
+    ( void ) memcpy( &( thingNameTopic[ 1 ] ), SHADOW_PREFIX, SHADOW_PREFIX_LENGTH );
+    topics[ 0 ].pTopic = &( thingNameTopic[ 1 ] );
+    topics[ 0 ].topicLength = ( uint16_t ) ( thingNameTopicLength - 1U );
+    shadowStatus = Shadow_MatchTopicBatch( topics, 1U, results );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, results[ 0 ].status );
+    TEST_ASSERT_EQUAL_INT( 128, results[ 0 ].thingNameLength );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that Shadow_MatchTopicString() returns the message type of each
+ *        Shadow response topic, and rejects operations that differ from one
+ *        only after the characters used to pick it.
+ */
+void test_Shadow_MatchTopicString_All_Message_Types( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowMessageType_t messageType = ShadowMessageTypeMaxNum;
+    uint32_t index = 0U;
+
+    static const char * const pTopicStrings[ ShadowMessageTypeMaxNum ] =
+    {
+        TEST_CLASSIC_TOPIC_STRING_GET_ACCEPTED,
+        TEST_CLASSIC_TOPIC_STRING_GET_REJECTED,
+        TEST_CLASSIC_TOPIC_STRING_DELETE_ACCEPTED,
+        TEST_CLASSIC_TOPIC_STRING_DELETE_REJECTED,
+        TEST_CLASSIC_TOPIC_STRING_UPDATE_ACCEPTED,
+        TEST_CLASSIC_TOPIC_STRING_UPDATE_REJECTED,
+        TEST_CLASSIC_TOPIC_STRING_UPDATE_DOCUMENTS,
+        TEST_CLASSIC_TOPIC_STRING_UPDATE_DELTA
+    };
+
+    static const char * const pInvalidTopicStrings[ 5 ] =
+    {
+        "$aws/things/TestThingName/shadow/gel/accepted",
+        "$aws/things/TestThingName/shadow/get/approved",
+        "$aws/things/TestThingName/shadow/delete/released",
+        "$aws/things/TestThingName/shadow/update/dance",
+        "$aws/things/TestThingName/shadow/update/databases"
+    };
+
+    for( index = 0U; index < ( uint32_t ) ShadowMessageTypeMaxNum; index++ )
+    {
+        shadowStatus = Shadow_MatchTopicString( pTopicStrings[ index ],
+                                                ( uint16_t ) strlen( pTopicStrings[ index ] ),
+                                                &messageType,
+                                                NULL,
+                                                NULL,
+                                                NULL,
+                                                NULL );
+        TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+        TEST_ASSERT_EQUAL_INT( index, messageType );
+    }
+
+    for( index = 0U; index < 5U; index++ )
+    {
+        shadowStatus = Shadow_MatchTopicString( pInvalidTopicStrings[ index ],
+                                                ( uint16_t ) strlen( pInvalidTopicStrings[ index ] ),
+                                                &messageType,
+                                                NULL,
+                                                NULL,
+                                                NULL,
+                                                NULL );
+        TEST_ASSERT_EQUAL_INT( SHADOW_MESSAGE_TYPE_PARSE_FAILED, shadowStatus );
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that Thing and Shadow names of every length up to the maximum
+ *        are found, wherever the terminating forward slash falls.
+ */
+void test_Shadow_MatchTopicString_Name_Lengths( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowMessageType_t messageType = ShadowMessageTypeMaxNum;
+    const char * pThingName = NULL;
+    uint8_t thingNameLength = 0U;
+    const char * pShadowName = NULL;
+    uint8_t shadowNameLength = 0U;
+    char topicBuffer[ 256 ];
+    uint16_t topicLength = 0U;
+    uint16_t nameLength = 0U;
+
+    for( nameLength = 1U; nameLength <= 128U; nameLength++ )
+    {
+        /* Classic topic with a Thing name of nameLength bytes. */
+        ( void ) memcpy( topicBuffer, SHADOW_PREFIX, SHADOW_PREFIX_LENGTH );
+        ( void ) memset( &( topicBuffer[ SHADOW_PREFIX_LENGTH ] ), 'T', nameLength );
+        topicLength = ( uint16_t ) ( SHADOW_PREFIX_LENGTH + nameLength );
+        ( void ) memcpy( &( topicBuffer[ topicLength ] ), "/shadow/update/delta", 20U );
+        topicLength = ( uint16_t ) ( topicLength + 20U );
+
+        shadowStatus = Shadow_MatchTopicString( topicBuffer,
+                                                topicLength,
+                                                &messageType,
+                                                &pThingName,
+                                                &thingNameLength,
+                                                NULL,
+                                                NULL );
+        TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+        TEST_ASSERT_EQUAL_INT( ShadowMessageTypeUpdateDelta, messageType );
+        TEST_ASSERT_EQUAL_INT( nameLength, thingNameLength );
+        TEST_ASSERT_EQUAL_PTR( &( topicBuffer[ SHADOW_PREFIX_LENGTH ] ), pThingName );
+
+        /* The same topic cut off inside the Thing name. */
+        shadowStatus = Shadow_MatchTopicString( topicBuffer,
+                                                ( uint16_t ) ( SHADOW_PREFIX_LENGTH + nameLength ),
+                                                &messageType,
+                                                NULL,
+                                                NULL,
+                                                NULL,
+                                                NULL );
+        TEST_ASSERT_EQUAL_INT( SHADOW_THINGNAME_PARSE_FAILED, shadowStatus );
+
+        if( nameLength <= 64U )
+        {
+            /* Named topic with a Shadow name of nameLength bytes. */
+            topicLength = ( uint16_t ) ( SHADOW_PREFIX_LENGTH + 1U );
+            ( void ) memcpy( &( topicBuffer[ topicLength ] ), SHADOW_NAMED_ROOT, SHADOW_NAMED_ROOT_LENGTH );
+            topicLength = ( uint16_t ) ( topicLength + SHADOW_NAMED_ROOT_LENGTH );
+            ( void ) memset( &( topicBuffer[ topicLength ] ), 'S', nameLength );
+            topicLength = ( uint16_t ) ( topicLength + nameLength );
+            ( void ) memcpy( &( topicBuffer[ topicLength ] ), "/get/accepted", 13U );
+            topicLength = ( uint16_t ) ( topicLength + 13U );
+
+            shadowStatus = Shadow_MatchTopicString( topicBuffer,
+                                                    topicLength,
+                                                    &messageType,
+                                                    &pThingName,
+                                                    &thingNameLength,
+                                                    &pShadowName,
+                                                    &shadowNameLength );
+            TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+            TEST_ASSERT_EQUAL_INT( ShadowMessageTypeGetAccepted, messageType );
+            TEST_ASSERT_EQUAL_INT( 1, thingNameLength );
+            TEST_ASSERT_EQUAL_INT( nameLength, shadowNameLength );
+            TEST_ASSERT_EQUAL_PTR( &( topicBuffer[ SHADOW_PREFIX_LENGTH + 1U + SHADOW_NAMED_ROOT_LENGTH ] ),
+                                   pShadowName );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests topics of #TEST_THING_NAME, and of Thing names that differ from
+ *        it, which the fixed_thing_name build matches with the
+ *        SHADOW_FIXED_THING_NAME fast path and its fallback to the full parser.
+ *        The results are the same in every build.
+ */
+void test_Shadow_MatchTopicString_Fixed_Thing_Name( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowMatchResult_t result;
+    ShadowTopicHash_t hash;
+    ShadowTopicHash_t expectedHash;
+    uint16_t topicLength = 0U;
+    uint32_t index = 0U;
+
+    static const struct
+    {
+        const char * pTopic;
+        ShadowStatus_t status;
+        ShadowMessageType_t messageType;
+        uint8_t thingNameLength;
+        uint8_t shadowNameLength;
+    } testTopics[] =
+    {
+        /* The fixed Thing name, with a Classic and a named shadow. */
+        { TEST_CLASSIC_TOPIC_STRING_UPDATE_DELTA,                              SHADOW_SUCCESS,                   ShadowMessageTypeUpdateDelta,     13U, 0U  },
+        { TEST_NAMED_TOPIC_STRING_GET_ACCEPTED,                                SHADOW_SUCCESS,                   ShadowMessageTypeGetAccepted,     13U, 14U },
+        /* A Thing name of the same length that differs in its last character. */
+        { "$aws/things/TestThingNamf/shadow/update/delta",                     SHADOW_SUCCESS,                   ShadowMessageTypeUpdateDelta,     13U, 0U  },
+        { "$aws/things/TestThingNamf/shadow/name/TestShadowName/get/accepted", SHADOW_SUCCESS,                   ShadowMessageTypeGetAccepted,     13U, 14U },
+        /* Thing names that are longer or shorter, including one that starts with it. */
+        { "$aws/things/TestThingName2/shadow/update/documents",                SHADOW_SUCCESS,                   ShadowMessageTypeUpdateDocuments, 14U, 0U  },
+        { "$aws/things/TestThing/shadow/delete/rejected",                      SHADOW_SUCCESS,                   ShadowMessageTypeDeleteRejected,  9U,  0U  },
+        /* Topics that fail after the Thing name. */
+        { "$aws/things/TestThingName/shadow/name//update/delta",               SHADOW_SHADOWNAME_PARSE_FAILED,   ShadowMessageTypeMaxNum,          0U,  0U  },
+        { "$aws/things/TestThingName/shadow/name/TestShadowName/update/deltx", SHADOW_MESSAGE_TYPE_PARSE_FAILED, ShadowMessageTypeMaxNum,          0U,  0U  },
+        { "$aws/things/TestThingName/shadow/updatx/delta",                     SHADOW_MESSAGE_TYPE_PARSE_FAILED, ShadowMessageTypeMaxNum,          0U,  0U  },
+        { "$aws/things/TestThingNamf/shadow/update/deltx",                     SHADOW_MESSAGE_TYPE_PARSE_FAILED, ShadowMessageTypeMaxNum,          0U,  0U  },
+        /* A topic cut off inside the root of the fixed Thing name. */
+        { "$aws/things/TestThingName/shad",                                    SHADOW_ROOT_PARSE_FAILED,         ShadowMessageTypeMaxNum,          0U,  0U  }
+    };
+
+    for( index = 0U; index < ( sizeof( testTopics ) / sizeof( testTopics[ 0 ] ) ); index++ )
+    {
+        topicLength = ( uint16_t ) strlen( testTopics[ index ].pTopic );
+        shadowStatus = Shadow_MatchTopicHash( testTopics[ index ].pTopic, topicLength, &result, &hash );
+        TEST_ASSERT_EQUAL_INT( testTopics[ index ].status, shadowStatus );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            TEST_ASSERT_EQUAL_INT( testTopics[ index ].messageType, result.messageType );
+            TEST_ASSERT_EQUAL_UINT16( SHADOW_PREFIX_LENGTH, result.thingNameOffset );
+            TEST_ASSERT_EQUAL_UINT8( testTopics[ index ].thingNameLength, result.thingNameLength );
+            TEST_ASSERT_EQUAL_UINT8( testTopics[ index ].shadowNameLength, result.shadowNameLength );
+
+            shadowStatus = Shadow_HashNames( &( testTopics[ index ].pTopic[ result.thingNameOffset ] ),
+                                             result.thingNameLength,
+                                             &( testTopics[ index ].pTopic[ result.shadowNameOffset ] ),
+                                             result.shadowNameLength,
+                                             &expectedHash );
+            TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+            TEST_ASSERT_EQUAL_UINT32( expectedHash.keyHash, hash.keyHash );
+
+            /* The names are found without a hash too. */
+            shadowStatus = Shadow_MatchTopicString( testTopics[ index ].pTopic, topicLength,
+                                                    &( result.messageType ), NULL, NULL, NULL, NULL );
+            TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+            TEST_ASSERT_EQUAL_INT( testTopics[ index ].messageType, result.messageType );
+        }
+    }
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests the behavior of Shadow_PrefilterTopic() with Shadow, non-Shadow
+ *        and invalid topics.
+ */
+void test_Shadow_PrefilterTopic( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+
+    /* The shortest Shadow topics pass. */
+    TEST_ASSERT_EQUAL_INT( 33, SHADOW_TOPIC_LEN_MIN );
+    shadowStatus = Shadow_PrefilterTopic( "$aws/things/T/shadow/get/accepted", SHADOW_TOPIC_LEN_MIN );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+
+    shadowStatus = Shadow_PrefilterTopic( TEST_NAMED_TOPIC_STRING_UPDATE_DOCUMENTS,
+                                          TEST_NAMED_TOPIC_LENGTH_UPDATE_DOCUMENTS );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+
+    /* Topics shorter than the shortest Shadow topic fail. */
+    shadowStatus = Shadow_PrefilterTopic( "$aws/things/T/shadow/get/accepted", SHADOW_TOPIC_LEN_MIN - 1U );
+    TEST_ASSERT_EQUAL_INT( SHADOW_FAIL, shadowStatus );
+
+    /* Topics differing from the prefix in either word fail. */
+    shadowStatus = Shadow_PrefilterTopic( "$aws/jobs/TestThingName/jobs/notify-next",
+                                          ( uint16_t ) strlen( "$aws/jobs/TestThingName/jobs/notify-next" ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_FAIL, shadowStatus );
+
+    shadowStatus = Shadow_PrefilterTopic( "$aws/thinks/TestThingName/shadow/get/accepted",
+                                          ( uint16_t ) strlen( "$aws/thinks/TestThingName/shadow/get/accepted" ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_FAIL, shadowStatus );
+
+    shadowStatus = Shadow_PrefilterTopic( "devices/TestThingName/telemetry/temperature",
+                                          ( uint16_t ) strlen( "devices/TestThingName/telemetry/temperature" ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_FAIL, shadowStatus );
+
+    /* Invalid parameters. */
+    shadowStatus = Shadow_PrefilterTopic( NULL, TEST_CLASSIC_TOPIC_LENGTH_GET_ACCEPTED );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_PrefilterTopic( TEST_CLASSIC_TOPIC_STRING_GET_ACCEPTED, 0U );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that Shadow_ClassifyTopic gives the message type that
+ *        Shadow_MatchTopicString gives, from the end of the topic.
+ */
+void test_Shadow_ClassifyTopic( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowMessageType_t messageType = ShadowMessageTypeMaxNum;
+    ShadowMessageType_t expectedMessageType = ShadowMessageTypeMaxNum;
+    uint32_t index = 0U;
+
+    static const char * const pTopicStrings[ 2U * ( uint32_t ) ShadowMessageTypeMaxNum ] =
+    {
+        TEST_CLASSIC_TOPIC_STRING_GET_ACCEPTED,
+        TEST_CLASSIC_TOPIC_STRING_GET_REJECTED,
+        TEST_CLASSIC_TOPIC_STRING_DELETE_ACCEPTED,
+        TEST_CLASSIC_TOPIC_STRING_DELETE_REJECTED,
+        TEST_CLASSIC_TOPIC_STRING_UPDATE_ACCEPTED,
+        TEST_CLASSIC_TOPIC_STRING_UPDATE_REJECTED,
+        TEST_CLASSIC_TOPIC_STRING_UPDATE_DOCUMENTS,
+        TEST_CLASSIC_TOPIC_STRING_UPDATE_DELTA,
+        TEST_NAMED_TOPIC_STRING_GET_ACCEPTED,
+        TEST_NAMED_TOPIC_STRING_GET_REJECTED,
+        TEST_NAMED_TOPIC_STRING_DELETE_ACCEPTED,
+        TEST_NAMED_TOPIC_STRING_DELETE_REJECTED,
+        TEST_NAMED_TOPIC_STRING_UPDATE_ACCEPTED,
+        TEST_NAMED_TOPIC_STRING_UPDATE_REJECTED,
+        TEST_NAMED_TOPIC_STRING_UPDATE_DOCUMENTS,
+        TEST_NAMED_TOPIC_STRING_UPDATE_DELTA
+    };
+
+    static const char * const pInvalidTopicStrings[ 7 ] =
+    {
+        TEST_CLASSIC_TOPIC_STRING_GET,
+        "$aws/things/TestThingName/shadow/get/acceptex",
+        "$aws/things/TestThingName/shadow/fetch/accepted",
+        "$aws/things/TestThingName/shadow/get/acceptedd",
+        "$aws/things/TestThingName/shadow/update/documentss",
+        "$aws/things/TestThingName/shadow/update/deltaa",
+        "$aws/things/xyzab/update/documents"
+    };
+
+    static const char * const pNoRootTopicStrings[ 9 ] =
+    {
+        "$aws/things/Thing/jobs/get/accepted",
+        "$aws/things/TestThingName/jobs/get/accepted",
+        "$aws/things/TestThingName/jobs/job-1/update/accepted",
+        "$aws/things/TestThingName/jobs/job-1/get/rejected",
+        "$aws/things/TestThingName/other/update/delta",
+        "$aws/things/TestThingName/shadow/name//update/delta",
+        "$aws/things//shadow/name/TestShadowName/update/delta",
+        "$aws/things/TestThingName/shadow/name/"
+        "01234567890123456789012345678901234567890123456789012345678901234/get/accepted",
+        "$aws/things/shadow/name/TestShadowName/update/documents"
+    };
+
+    for( index = 0U; index < ( 2U * ( uint32_t ) ShadowMessageTypeMaxNum ); index++ )
+    {
+        shadowStatus = Shadow_MatchTopicString( pTopicStrings[ index ],
+                                                ( uint16_t ) strlen( pTopicStrings[ index ] ),
+                                                &expectedMessageType,
+                                                NULL,
+                                                NULL,
+                                                NULL,
+                                                NULL );
+        TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+
+        shadowStatus = Shadow_ClassifyTopic( pTopicStrings[ index ],
+                                             ( uint16_t ) strlen( pTopicStrings[ index ] ),
+                                             &messageType );
+        TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+        TEST_ASSERT_EQUAL_INT( expectedMessageType, messageType );
+    }
+
+    for( index = 0U; index < 7U; index++ )
+    {
+        shadowStatus = Shadow_ClassifyTopic( pInvalidTopicStrings[ index ],
+                                             ( uint16_t ) strlen( pInvalidTopicStrings[ index ] ),
+                                             &messageType );
+        TEST_ASSERT_EQUAL_INT( SHADOW_MESSAGE_TYPE_PARSE_FAILED, shadowStatus );
+    }
+
+    /* The Thing name is not checked. */
+    shadowStatus = Shadow_ClassifyTopic( "$aws/things/Test/Thing/shadow/update/delta",
+                                         ( uint16_t ) strlen( "$aws/things/Test/Thing/shadow/update/delta" ),
+                                         &messageType );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_INT( ShadowMessageTypeUpdateDelta, messageType );
+
+    /* Topics of other services, and topics without a Shadow root, an empty
+     * or too long Shadow name, or an empty Thing name fail. */
+    for( index = 0U; index < 9U; index++ )
+    {
+        shadowStatus = Shadow_ClassifyTopic( pNoRootTopicStrings[ index ],
+                                             ( uint16_t ) strlen( pNoRootTopicStrings[ index ] ),
+                                             &messageType );
+        TEST_ASSERT_EQUAL_INT( SHADOW_ROOT_PARSE_FAILED, shadowStatus );
+    }
+
+    /* A Shadow name of the maximum length. */
+    shadowStatus = Shadow_ClassifyTopic( "$aws/things/T/shadow/name/"
+                                         "0123456789012345678901234567890123456789012345678901234567890123/get/accepted",
+                                         ( uint16_t ) strlen( "$aws/things/T/shadow/name/"
+                                                              "0123456789012345678901234567890123456789012345678901234567890123/get/accepted" ),
+                                         &messageType );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_INT( ShadowMessageTypeGetAccepted, messageType );
+
+    /* Topics that are too short or have another prefix fail. */
+    shadowStatus = Shadow_ClassifyTopic( "$aws/things/T/shadow/get/accepted", SHADOW_TOPIC_LEN_MIN, &messageType );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    shadowStatus = Shadow_ClassifyTopic( "$aws/things/T/shadow/get/accepted", SHADOW_TOPIC_LEN_MIN - 1U, &messageType );
+    TEST_ASSERT_EQUAL_INT( SHADOW_FAIL, shadowStatus );
+    shadowStatus = Shadow_ClassifyTopic( "$aws/thinks/TestThingName/shadow/get/accepted",
+                                         ( uint16_t ) strlen( "$aws/thinks/TestThingName/shadow/get/accepted" ),
+                                         &messageType );
+    TEST_ASSERT_EQUAL_INT( SHADOW_FAIL, shadowStatus );
+
+    /* Invalid parameters. */
+    shadowStatus = Shadow_ClassifyTopic( NULL, TEST_CLASSIC_TOPIC_LENGTH_GET_ACCEPTED, &messageType );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+    shadowStatus = Shadow_ClassifyTopic( TEST_CLASSIC_TOPIC_STRING_GET_ACCEPTED, 0U, &messageType );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+    shadowStatus = Shadow_ClassifyTopic( TEST_CLASSIC_TOPIC_STRING_GET_ACCEPTED,
+                                         TEST_CLASSIC_TOPIC_LENGTH_GET_ACCEPTED,
+                                         NULL );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that Shadow_MatchTopicHash matches topics like Shadow_MatchTopicBatch,
+ * and hashes the names like Shadow_HashNames.
+ */
+void test_Shadow_MatchTopicHash( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowTopic_t topics[ 8 ];
+    ShadowMatchResult_t results[ 8 ];
+    ShadowMatchResult_t result;
+    ShadowTopicHash_t hash;
+    ShadowTopicHash_t expectedHash;
+    uint32_t index = 0U;
+    char longNameTopic[ 200 ];
+
+    static const char * const pTopicStrings[ 8 ] =
+    {
+        TEST_CLASSIC_TOPIC_STRING_UPDATE_DELTA,
+        TEST_NAMED_TOPIC_STRING_GET_ACCEPTED,
+        TEST_NAMED_TOPIC_STRING_UPDATE_DOCUMENTS,
+        "$aws/things/foobar/shadow/delete/rejected",
+        "$aws/thingz/TestThingName/shadow/get",
+        "$aws/things/TestThingName",
+        "$aws/things/TestThingName/shadow/name/TestShadowName",
+        "$aws/things/TestThingName/shadow/name/TestShadowName/get/released"
+    };
+
+    for( index = 0U; index < 8U; index++ )
+    {
+        topics[ index ].pTopic = pTopicStrings[ index ];
+        topics[ index ].topicLength = ( uint16_t ) strlen( pTopicStrings[ index ] );
+    }
+
+    shadowStatus = Shadow_MatchTopicBatch( topics, 8U, results );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+
+    for( index = 0U; index < 8U; index++ )
+    {
+        shadowStatus = Shadow_MatchTopicHash( topics[ index ].pTopic,
+                                              topics[ index ].topicLength,
+                                              &result,
+                                              &hash );
+        TEST_ASSERT_EQUAL_INT( results[ index ].status, shadowStatus );
+        TEST_ASSERT_EQUAL_INT( results[ index ].status, result.status );
+
+        if( shadowStatus == SHADOW_SUCCESS )
+        {
+            TEST_ASSERT_EQUAL_INT( results[ index ].messageType, result.messageType );
+            TEST_ASSERT_EQUAL_UINT16( results[ index ].thingNameOffset, result.thingNameOffset );
+            TEST_ASSERT_EQUAL_UINT8( results[ index ].thingNameLength, result.thingNameLength );
+            TEST_ASSERT_EQUAL_UINT16( results[ index ].shadowNameOffset, result.shadowNameOffset );
+            TEST_ASSERT_EQUAL_UINT8( results[ index ].shadowNameLength, result.shadowNameLength );
+
+            shadowStatus = Shadow_HashNames( &( topics[ index ].pTopic[ result.thingNameOffset ] ),
+                                             result.thingNameLength,
+                                             &( topics[ index ].pTopic[ result.shadowNameOffset ] ),
+                                             result.shadowNameLength,
+                                             &expectedHash );
+            TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+            TEST_ASSERT_EQUAL_UINT32( expectedHash.thingNameHash, hash.thingNameHash );
+            TEST_ASSERT_EQUAL_UINT32( expectedHash.shadowNameHash, hash.shadowNameHash );
+            TEST_ASSERT_EQUAL_UINT32( expectedHash.keyHash, hash.keyHash );
+        }
+    }
+
+    /* The name hashes are 32-bit FNV-1a, and the hash of the empty Shadow name
+     * of a Classic shadow is the offset basis. */
+    shadowStatus = Shadow_MatchTopicHash( topics[ 3 ].pTopic, topics[ 3 ].topicLength, &result, &hash );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_HEX32( 0xbf9cf968U, hash.thingNameHash );
+    TEST_ASSERT_EQUAL_HEX32( 0x811c9dc5U, hash.shadowNameHash );
+
+    /* Different Shadow names of the same Thing give different key hashes. */
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, Shadow_HashNames( "foobar", 6U, NULL, 0U, &expectedHash ) );
+    TEST_ASSERT_EQUAL_UINT32( hash.keyHash, expectedHash.keyHash );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, Shadow_HashNames( "foobar", 6U, "foobar", 6U, &expectedHash ) );
+    TEST_ASSERT_NOT_EQUAL( hash.keyHash, expectedHash.keyHash );
+
+    /* Names longer than the maximum are rejected while they are hashed. */
+    ( void ) memcpy( longNameTopic, SHADOW_PREFIX, SHADOW_PREFIX_LENGTH );
+    ( void ) memset( &( longNameTopic[ SHADOW_PREFIX_LENGTH ] ), 'T', 129U );
+    ( void ) memcpy( &( longNameTopic[ SHADOW_PREFIX_LENGTH + 129U ] ), "/shadow/get", 11U );
+    shadowStatus = Shadow_MatchTopicHash( longNameTopic, SHADOW_PREFIX_LENGTH + 129U + 11U, &result, &hash );
+    TEST_ASSERT_EQUAL_INT( SHADOW_THINGNAME_PARSE_FAILED, shadowStatus );
+
+    ( void ) memcpy( &( longNameTopic[ SHADOW_PREFIX_LENGTH ] ), "T/shadow/name/", 14U );
+    ( void ) memset( &( longNameTopic[ SHADOW_PREFIX_LENGTH + 14U ] ), 'S', 65U );
+    ( void ) memcpy( &( longNameTopic[ SHADOW_PREFIX_LENGTH + 14U + 65U ] ), "/get", 4U );
+    shadowStatus = Shadow_MatchTopicHash( longNameTopic, SHADOW_PREFIX_LENGTH + 14U + 65U + 4U, &result, &hash );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SHADOWNAME_PARSE_FAILED, shadowStatus );
+
+    /* Invalid parameters. */
+    shadowStatus = Shadow_MatchTopicHash( NULL, TEST_CLASSIC_TOPIC_LENGTH_GET_ACCEPTED, &result, &hash );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+    shadowStatus = Shadow_MatchTopicHash( TEST_CLASSIC_TOPIC_STRING_GET_ACCEPTED, 0U, &result, &hash );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+    shadowStatus = Shadow_MatchTopicHash( TEST_CLASSIC_TOPIC_STRING_GET_ACCEPTED,
+                                          TEST_CLASSIC_TOPIC_LENGTH_GET_ACCEPTED, NULL, &hash );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+    shadowStatus = Shadow_MatchTopicHash( TEST_CLASSIC_TOPIC_STRING_GET_ACCEPTED,
+                                          TEST_CLASSIC_TOPIC_LENGTH_GET_ACCEPTED, &result, NULL );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_HashNames( NULL, 6U, "foobar", 6U, &hash );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+    shadowStatus = Shadow_HashNames( "foobar", 0U, "foobar", 6U, &hash );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+    shadowStatus = Shadow_HashNames( "foobar", 6U, NULL, 6U, &hash );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+    shadowStatus = Shadow_HashNames( "foobar", 6U, "foobar", 6U, NULL );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that a topic fed to Shadow_MatchTopicChunk in pieces gives the
+ * same result as Shadow_MatchTopicBatch, wherever the topic is split.
+ */
+void test_Shadow_MatchTopicChunk( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowMatchContext_t context;
+    ShadowTopic_t topics[ 23 ];
+    ShadowMatchResult_t results[ 23 ];
+    ShadowMatchResult_t result;
+    ShadowTopicHash_t hash;
+    ShadowTopicHash_t expectedHash;
+    uint32_t index = 0U;
+    uint16_t split = 0U;
+    uint16_t offset = 0U;
+    char longNameTopic[ 200 ];
+
+    static const char * const pTopicStrings[ 22 ] =
+    {
+        "$aws",
+        "$aws/thingz/TestThingName/shadow/get",
+        "$aws/things//shadow/get",
+        "$aws/things/TestThingName",
+        "$aws/things/TestThingName/shado",
+        "$aws/things/TestThingName/shadow",
+        "$aws/things/TestThingName/shadowx/get",
+        "$aws/things/TestThingName/shadow/nam",
+        "$aws/things/TestThingName/shadow/name/",
+        "$aws/things/TestThingName/shadow/name/TestShadowName",
+        "$aws/things/TestThingName/shadow/get/",
+        "$aws/things/TestThingName/shadow/get/approved",
+        "$aws/things/TestThingName/shadow/get/acceptedx",
+        "$aws/things/TestThingName/shadow/delete/released",
+        "$aws/things/TestThingName/shadow/update/delt",
+        "$aws/things/TestThingName/shadow/update/deltas",
+        "$aws/things/TestThingName/shadow/update/databases",
+        TEST_CLASSIC_TOPIC_STRING_UPDATE_DELTA,
+        TEST_CLASSIC_TOPIC_STRING_DELETE_REJECTED,
+        TEST_NAMED_TOPIC_STRING_GET_ACCEPTED,
+        TEST_NAMED_TOPIC_STRING_UPDATE_DOCUMENTS,
+        "$aws/things/foobar/shadow/delete/rejected"
+    };
+
+    for( index = 0U; index < 22U; index++ )
+    {
+        topics[ index ].pTopic = pTopicStrings[ index ];
+        topics[ index ].topicLength = ( uint16_t ) strlen( pTopicStrings[ index ] );
+    }
+
+    /* A Thing name one byte longer than the maximum. */
+    ( void ) memcpy( longNameTopic, SHADOW_PREFIX, SHADOW_PREFIX_LENGTH );
+    ( void ) memset( &( longNameTopic[ SHADOW_PREFIX_LENGTH ] ), 'T', 129U );
+    ( void ) memcpy( &( longNameTopic[ SHADOW_PREFIX_LENGTH + 129U ] ), "/shadow/get", 11U );
+    topics[ 22 ].pTopic = longNameTopic;
+    topics[ 22 ].topicLength = SHADOW_PREFIX_LENGTH + 129U + 11U;
+
+    shadowStatus = Shadow_MatchTopicBatch( topics, 23U, results );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+
+    for( index = 0U; index < 23U; index++ )
+    {
+        /* Split the topic in two at every position, including before the
+         * first byte and after the last. */
+        for( split = 0U; split <= topics[ index ].topicLength; split++ )
+        {
+            TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, Shadow_MatchTopicStart( &context, &hash ) );
+            shadowStatus = Shadow_MatchTopicChunk( &context, topics[ index ].pTopic, split );
+
+            if( shadowStatus == SHADOW_SUCCESS )
+            {
+                shadowStatus = Shadow_MatchTopicChunk( &context,
+                                                       &( topics[ index ].pTopic[ split ] ),
+                                                       ( uint16_t ) ( topics[ index ].topicLength - split ) );
+            }
+
+            TEST_ASSERT_TRUE( ( shadowStatus == SHADOW_SUCCESS ) || ( shadowStatus == results[ index ].status ) );
+
+            shadowStatus = Shadow_MatchTopicFinish( &context, &result );
+            TEST_ASSERT_EQUAL_INT( results[ index ].status, shadowStatus );
+            TEST_ASSERT_EQUAL_INT( results[ index ].status, result.status );
+
+            if( shadowStatus == SHADOW_SUCCESS )
+            {
+                TEST_ASSERT_EQUAL_INT( results[ index ].messageType, result.messageType );
+                TEST_ASSERT_EQUAL_UINT16( results[ index ].thingNameOffset, result.thingNameOffset );
+                TEST_ASSERT_EQUAL_UINT8( results[ index ].thingNameLength, result.thingNameLength );
+                TEST_ASSERT_EQUAL_UINT16( results[ index ].shadowNameOffset, result.shadowNameOffset );
+                TEST_ASSERT_EQUAL_UINT8( results[ index ].shadowNameLength, result.shadowNameLength );
+
+                shadowStatus = Shadow_HashNames( &( topics[ index ].pTopic[ result.thingNameOffset ] ),
+                                                 result.thingNameLength,
+                                                 &( topics[ index ].pTopic[ result.shadowNameOffset ] ),
+                                                 result.shadowNameLength,
+                                                 &expectedHash );
+                TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+                TEST_ASSERT_EQUAL_UINT32( expectedHash.keyHash, hash.keyHash );
+            }
+        }
+
+        /* Feed the topic one byte at a time, without hashing. */
+        TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, Shadow_MatchTopicStart( &context, NULL ) );
+
+        for( offset = 0U; offset < topics[ index ].topicLength; offset++ )
+        {
+            ( void ) Shadow_MatchTopicChunk( &context, &( topics[ index ].pTopic[ offset ] ), 1U );
+        }
+
+        shadowStatus = Shadow_MatchTopicFinish( &context, &result );
+        TEST_ASSERT_EQUAL_INT( results[ index ].status, shadowStatus );
+    }
+
+    /* A topic with no bytes is rejected like a zero topicLength. */
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, Shadow_MatchTopicStart( &context, NULL ) );
+    shadowStatus = Shadow_MatchTopicFinish( &context, &result );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    /* A chunk reports the failure as soon as the topic cannot be a Shadow topic. */
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, Shadow_MatchTopicStart( &context, NULL ) );
+    shadowStatus = Shadow_MatchTopicChunk( &context, "$aws/things/TestThingName/", 26U );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    shadowStatus = Shadow_MatchTopicChunk( &context, "shadox", 6U );
+    TEST_ASSERT_EQUAL_INT( SHADOW_ROOT_PARSE_FAILED, shadowStatus );
+
+    /* Invalid parameters. */
+    shadowStatus = Shadow_MatchTopicStart( NULL, &hash );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+    shadowStatus = Shadow_MatchTopicChunk( NULL, TEST_CLASSIC_TOPIC_STRING_GET_ACCEPTED, 1U );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+    shadowStatus = Shadow_MatchTopicChunk( &context, NULL, 1U );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+    shadowStatus = Shadow_MatchTopicFinish( NULL, &result );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+    shadowStatus = Shadow_MatchTopicFinish( &context, NULL );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that Shadow_AssembleAllTopics assembles the same topic strings as
+ * Shadow_AssembleTopicString, for Classic and named shadows.
+ */
+void test_Shadow_AssembleAllTopics( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    char topicBuffer[ SHADOW_TOPIC_LEN_ALL( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) + 1U ];
+    char expectedTopic[ SHADOW_TOPIC_LEN_MAX( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) ];
+    ShadowTopicSpan_t topicSpans[ ShadowTopicStringTypeMaxNum ];
+    uint16_t outLength = 0U;
+    uint16_t expectedLength = 0U;
+    uint8_t shadowNameLength = 0U;
+    uint32_t pass = 0U;
+    uint32_t index = 0U;
+
+    for( pass = 0U; pass < 2U; pass++ )
+    {
+        /* The first pass assembles Classic shadow topics, the second named shadow topics. */
+        shadowNameLength = ( pass == 0U ) ? SHADOW_NAME_CLASSIC_LENGTH : TEST_SHADOW_NAME_LENGTH;
+
+        shadowStatus = Shadow_AssembleAllTopics( TEST_THING_NAME,
+                                                 TEST_THING_NAME_LENGTH,
+                                                 TEST_SHADOW_NAME,
+                                                 shadowNameLength,
+                                                 topicBuffer,
+                                                 SHADOW_TOPIC_LEN_ALL( TEST_THING_NAME_LENGTH, shadowNameLength ),
+                                                 topicSpans,
+                                                 &outLength );
+        TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+        TEST_ASSERT_EQUAL_UINT16( SHADOW_TOPIC_LEN_ALL( TEST_THING_NAME_LENGTH, shadowNameLength ), outLength );
+
+        for( index = 0U; index < ( uint32_t ) ShadowTopicStringTypeMaxNum; index++ )
+        {
+            shadowStatus = Shadow_AssembleTopicString( ( ShadowTopicStringType_t ) index,
+                                                       TEST_THING_NAME,
+                                                       TEST_THING_NAME_LENGTH,
+                                                       TEST_SHADOW_NAME,
+                                                       shadowNameLength,
+                                                       expectedTopic,
+                                                       ( uint16_t ) sizeof( expectedTopic ),
+                                                       &expectedLength );
+            TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+            TEST_ASSERT_EQUAL_UINT16( expectedLength, topicSpans[ index ].length );
+            TEST_ASSERT_TRUE( ( topicSpans[ index ].offset + topicSpans[ index ].length ) <= outLength );
+            TEST_ASSERT_EQUAL_MEMORY( expectedTopic, &( topicBuffer[ topicSpans[ index ].offset ] ), expectedLength );
+        }
+    }
+
+    /* The "get" topic is the beginning of the "get/accepted" topic. */
+    TEST_ASSERT_EQUAL_UINT16( topicSpans[ ShadowTopicStringTypeGetAccepted ].offset,
+                              topicSpans[ ShadowTopicStringTypeGet ].offset );
+
+    /* The buffer must hold all the topics. */
+    shadowStatus = Shadow_AssembleAllTopics( TEST_THING_NAME, TEST_THING_NAME_LENGTH,
+                                             TEST_SHADOW_NAME, TEST_SHADOW_NAME_LENGTH,
+                                             topicBuffer,
+                                             SHADOW_TOPIC_LEN_ALL( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) - 1U,
+                                             topicSpans, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BUFFER_TOO_SMALL, shadowStatus );
+
+    /* Invalid parameters. */
+    shadowStatus = Shadow_AssembleAllTopics( NULL, TEST_THING_NAME_LENGTH,
+                                             TEST_SHADOW_NAME, TEST_SHADOW_NAME_LENGTH,
+                                             topicBuffer, ( uint16_t ) sizeof( topicBuffer ),
+                                             topicSpans, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleAllTopics( TEST_THING_NAME, TEST_THING_NAME_LENGTH,
+                                             TEST_SHADOW_NAME, SHADOW_NAME_LENGTH_MAX + 1U,
+                                             topicBuffer, ( uint16_t ) sizeof( topicBuffer ),
+                                             topicSpans, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleAllTopics( TEST_THING_NAME, TEST_THING_NAME_LENGTH,
+                                             TEST_SHADOW_NAME, TEST_SHADOW_NAME_LENGTH,
+                                             topicBuffer, ( uint16_t ) sizeof( topicBuffer ),
+                                             NULL, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleAllTopics( TEST_THING_NAME, TEST_THING_NAME_LENGTH,
+                                             TEST_SHADOW_NAME, TEST_SHADOW_NAME_LENGTH,
+                                             topicBuffer, ( uint16_t ) sizeof( topicBuffer ),
+                                             topicSpans, NULL );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests assembling the topics of several shadows with
+ * Shadow_AssembleTopicsBulk().
+ */
+void test_Shadow_AssembleTopicsBulk( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowNames_t names[ 3 ] =
+    {
+        { TEST_THING_NAME, SHADOW_NAME_CLASSIC, TEST_THING_NAME_LENGTH, SHADOW_NAME_CLASSIC_LENGTH },
+        { TEST_THING_NAME, TEST_SHADOW_NAME,    TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH    },
+        { "otherThing",    SHADOW_NAME_CLASSIC, 10U,                    SHADOW_NAME_CLASSIC_LENGTH }
+    };
+    const uint16_t topicTypeMasks[] =
+    {
+        SHADOW_TOPIC_TYPE_ALL,
+        SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeGet ),
+        SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeGet ) | SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeGetRejected ),
+        SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdate ) | SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateAccepted ) |
+        SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta ),
+        SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta )
+    };
+    char topicBuffer[ 3U * SHADOW_TOPIC_LEN_ALL( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) ];
+    char expectedTopic[ SHADOW_TOPIC_LEN_MAX( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) ];
+    ShadowTopicSpan_t topicSpans[ 3U * ( uint32_t ) ShadowTopicStringTypeMaxNum ];
+    ShadowTopicSpan_t * pSpan = NULL;
+    uint32_t outLength = 0U;
+    uint32_t requiredLength = 0U;
+    uint16_t expectedLength = 0U;
+    uint32_t maskIndex = 0U;
+    uint32_t nameIndex = 0U;
+    uint32_t index = 0U;
+    uint32_t spanIndex = 0U;
+
+    for( maskIndex = 0U; maskIndex < ( sizeof( topicTypeMasks ) / sizeof( topicTypeMasks[ 0 ] ) ); maskIndex++ )
+    {
+        shadowStatus = Shadow_AssembleTopicsBulk( names, 3U, topicTypeMasks[ maskIndex ],
+                                                  topicBuffer, ( uint32_t ) sizeof( topicBuffer ),
+                                                  topicSpans, &outLength );
+        TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+
+        spanIndex = 0U;
+        requiredLength = 0U;
+
+        for( nameIndex = 0U; nameIndex < 3U; nameIndex++ )
+        {
+            for( index = 0U; index < ( uint32_t ) ShadowTopicStringTypeMaxNum; index++ )
+            {
+                if( ( topicTypeMasks[ maskIndex ] & SHADOW_TOPIC_TYPE_BIT( index ) ) != 0U )
+                {
+                    shadowStatus = Shadow_AssembleTopicString( ( ShadowTopicStringType_t ) index,
+                                                               names[ nameIndex ].pThingName,
+                                                               names[ nameIndex ].thingNameLength,
+                                                               names[ nameIndex ].pShadowName,
+                                                               names[ nameIndex ].shadowNameLength,
+                                                               expectedTopic,
+                                                               ( uint16_t ) sizeof( expectedTopic ),
+                                                               &expectedLength );
+                    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+
+                    pSpan = &( topicSpans[ spanIndex ] );
+                    TEST_ASSERT_EQUAL_UINT16( expectedLength, pSpan->length );
+                    TEST_ASSERT_TRUE( ( pSpan->offset + pSpan->length ) <= outLength );
+                    TEST_ASSERT_EQUAL_MEMORY( expectedTopic, &( topicBuffer[ pSpan->offset ] ), expectedLength );
+
+                    /* The topics of each shadow follow those of the previous one. */
+                    TEST_ASSERT_TRUE( pSpan->offset >= requiredLength );
+
+                    if( ( index == ( uint32_t ) ShadowTopicStringTypeUpdate ) &&
+                        ( ( topicTypeMasks[ maskIndex ] & SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateAccepted ) ) != 0U ) )
+                    {
+                        /* Shares its bytes with the "update/accepted" topic. */
+                        TEST_ASSERT_EQUAL_UINT32( topicSpans[ spanIndex + 1U ].offset, pSpan->offset );
+                    }
+
+                    spanIndex++;
+                }
+            }
+
+            requiredLength = topicSpans[ spanIndex - 1U ].offset + topicSpans[ spanIndex - 1U ].length;
+        }
+
+        /* The topics are packed without gaps. */
+        TEST_ASSERT_EQUAL_UINT32( requiredLength, outLength );
+    }
+
+    /* All topics of one shadow take the same space as with Shadow_AssembleAllTopics(). */
+    shadowStatus = Shadow_AssembleTopicsBulk( &( names[ 1 ] ), 1U, SHADOW_TOPIC_TYPE_ALL,
+                                              topicBuffer, ( uint32_t ) sizeof( topicBuffer ),
+                                              topicSpans, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( SHADOW_TOPIC_LEN_ALL( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ), outLength );
+
+    /* The length needed is returned if the buffer is too small. */
+    shadowStatus = Shadow_AssembleTopicsBulk( names, 3U, SHADOW_TOPIC_TYPE_ALL,
+                                              topicBuffer, 0U,
+                                              topicSpans, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BUFFER_TOO_SMALL, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( SHADOW_TOPIC_LEN_ALL( TEST_THING_NAME_LENGTH, SHADOW_NAME_CLASSIC_LENGTH ) +
+                              SHADOW_TOPIC_LEN_ALL( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) +
+                              SHADOW_TOPIC_LEN_ALL( 10U, SHADOW_NAME_CLASSIC_LENGTH ),
+                              outLength );
+
+    shadowStatus = Shadow_AssembleTopicsBulk( names, 3U, SHADOW_TOPIC_TYPE_ALL,
+                                              topicBuffer, outLength - 1U,
+                                              topicSpans, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BUFFER_TOO_SMALL, shadowStatus );
+
+    /* Invalid parameters. */
+    shadowStatus = Shadow_AssembleTopicsBulk( NULL, 3U, SHADOW_TOPIC_TYPE_ALL,
+                                              topicBuffer, ( uint32_t ) sizeof( topicBuffer ),
+                                              topicSpans, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleTopicsBulk( names, 0U, SHADOW_TOPIC_TYPE_ALL,
+                                              topicBuffer, ( uint32_t ) sizeof( topicBuffer ),
+                                              topicSpans, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleTopicsBulk( names, UINT32_MAX, SHADOW_TOPIC_TYPE_ALL,
+                                              topicBuffer, ( uint32_t ) sizeof( topicBuffer ),
+                                              topicSpans, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleTopicsBulk( names, 3U, 0U,
+                                              topicBuffer, ( uint32_t ) sizeof( topicBuffer ),
+                                              topicSpans, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleTopicsBulk( names, 3U, SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeMaxNum ),
+                                              topicBuffer, ( uint32_t ) sizeof( topicBuffer ),
+                                              topicSpans, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleTopicsBulk( names, 3U, SHADOW_TOPIC_TYPE_ALL,
+                                              NULL, ( uint32_t ) sizeof( topicBuffer ),
+                                              topicSpans, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleTopicsBulk( names, 3U, SHADOW_TOPIC_TYPE_ALL,
+                                              topicBuffer, ( uint32_t ) sizeof( topicBuffer ),
+                                              NULL, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleTopicsBulk( names, 3U, SHADOW_TOPIC_TYPE_ALL,
+                                              topicBuffer, ( uint32_t ) sizeof( topicBuffer ),
+                                              topicSpans, NULL );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    /* An invalid name anywhere in the array fails the whole call. */
+    names[ 2 ].thingNameLength = 0U;
+    shadowStatus = Shadow_AssembleTopicsBulk( names, 3U, SHADOW_TOPIC_TYPE_ALL,
+                                              topicBuffer, ( uint32_t ) sizeof( topicBuffer ),
+                                              topicSpans, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests describing topic strings as segments with
+ * Shadow_AssembleTopicSegments().
+ */
+void test_Shadow_AssembleTopicSegments( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowTopicSegment_t segments[ SHADOW_TOPIC_SEGMENT_COUNT_MAX ];
+    char expectedTopic[ SHADOW_TOPIC_LEN_MAX( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) ];
+    char joinedTopic[ SHADOW_TOPIC_LEN_MAX( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) ];
+    uint16_t expectedLength = 0U;
+    uint16_t outLength = 0U;
+    uint16_t joinedLength = 0U;
+    uint8_t segmentCount = 0U;
+    uint8_t shadowNameLength = 0U;
+    uint32_t pass = 0U;
+    uint32_t index = 0U;
+    uint8_t segment = 0U;
+
+    for( pass = 0U; pass < 2U; pass++ )
+    {
+        /* The first pass describes Classic shadow topics, the second named shadow topics. */
+        shadowNameLength = ( pass == 0U ) ? SHADOW_NAME_CLASSIC_LENGTH : TEST_SHADOW_NAME_LENGTH;
+
+        for( index = 0U; index < ( uint32_t ) ShadowTopicStringTypeMaxNum; index++ )
+        {
+            shadowStatus = Shadow_AssembleTopicSegments( ( ShadowTopicStringType_t ) index,
+                                                         TEST_THING_NAME,
+                                                         TEST_THING_NAME_LENGTH,
+                                                         TEST_SHADOW_NAME,
+                                                         shadowNameLength,
+                                                         segments,
+                                                         &segmentCount,
+                                                         &outLength );
+            TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+            TEST_ASSERT_EQUAL_UINT8( ( pass == 0U ) ? 4U : SHADOW_TOPIC_SEGMENT_COUNT_MAX, segmentCount );
+
+            /* The names are not copied. */
+            TEST_ASSERT_EQUAL_PTR( TEST_THING_NAME, segments[ 1 ].pSegment );
+
+            if( pass == 1U )
+            {
+                TEST_ASSERT_EQUAL_PTR( TEST_SHADOW_NAME, segments[ 3 ].pSegment );
+            }
+
+            joinedLength = 0U;
+
+            for( segment = 0U; segment < segmentCount; segment++ )
+            {
+                ( void ) memcpy( &( joinedTopic[ joinedLength ] ), segments[ segment ].pSegment, segments[ segment ].length );
+                joinedLength = ( uint16_t ) ( joinedLength + segments[ segment ].length );
+            }
+
+            shadowStatus = Shadow_AssembleTopicString( ( ShadowTopicStringType_t ) index,
+                                                       TEST_THING_NAME,
+                                                       TEST_THING_NAME_LENGTH,
+                                                       TEST_SHADOW_NAME,
+                                                       shadowNameLength,
+                                                       expectedTopic,
+                                                       ( uint16_t ) sizeof( expectedTopic ),
+                                                       &expectedLength );
+            TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+            TEST_ASSERT_EQUAL_UINT16( expectedLength, outLength );
+            TEST_ASSERT_EQUAL_UINT16( expectedLength, joinedLength );
+            TEST_ASSERT_EQUAL_MEMORY( expectedTopic, joinedTopic, expectedLength );
+        }
+    }
+
+    /* Invalid parameters. */
+    shadowStatus = Shadow_AssembleTopicSegments( ShadowTopicStringTypeMaxNum,
+                                                 TEST_THING_NAME, TEST_THING_NAME_LENGTH,
+                                                 TEST_SHADOW_NAME, TEST_SHADOW_NAME_LENGTH,
+                                                 segments, &segmentCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleTopicSegments( ShadowTopicStringTypeUpdate,
+                                                 TEST_THING_NAME, TEST_THING_NAME_LENGTH,
+                                                 TEST_SHADOW_NAME, TEST_SHADOW_NAME_LENGTH,
+                                                 NULL, &segmentCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleTopicSegments( ShadowTopicStringTypeUpdate,
+                                                 TEST_THING_NAME, TEST_THING_NAME_LENGTH,
+                                                 TEST_SHADOW_NAME, TEST_SHADOW_NAME_LENGTH,
+                                                 segments, NULL, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleTopicSegments( ShadowTopicStringTypeUpdate,
+                                                 TEST_THING_NAME, TEST_THING_NAME_LENGTH,
+                                                 TEST_SHADOW_NAME, TEST_SHADOW_NAME_LENGTH,
+                                                 segments, &segmentCount, NULL );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleTopicSegments( ShadowTopicStringTypeUpdate,
+                                                 NULL, TEST_THING_NAME_LENGTH,
+                                                 TEST_SHADOW_NAME, TEST_SHADOW_NAME_LENGTH,
+                                                 segments, &segmentCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The number of slots of the topic filter indexes of the tests.
+ */
+#define TEST_FILTER_SLOT_COUNT    ( 64U )
+
+/**
+ * @brief Index topic filters with Shadow_FilterIndexInit(), and find the first
+ * one that a topic matches with Shadow_MatchTopicFilters().
+ */
+static ShadowStatus_t matchTopicFilters( const char * pFilterBuffer,
+                                         const ShadowTopicSpan_t * pFilterSpans,
+                                         uint32_t filterCount,
+                                         const char * pTopic,
+                                         uint16_t topicLength,
+                                         uint32_t * pFilterIndex )
+{
+    ShadowFilterSlot_t filterSlots[ TEST_FILTER_SLOT_COUNT ];
+    ShadowFilterIndex_t filterIndexTable;
+
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, Shadow_FilterIndexInit( &filterIndexTable, pFilterBuffer, pFilterSpans,
+                                                                   filterCount, filterSlots, TEST_FILTER_SLOT_COUNT ) );
+
+    return Shadow_MatchTopicFilters( &filterIndexTable, pTopic, topicLength, pFilterIndex );
+}
+
+/**
+ * @brief The topic filters of every topic type of the shadows of
+ * test_Shadow_AssembleWildcardFilters().
+ */
+#define TEST_ALL_WILDCARD_FILTERS                       \
+    "$aws/things/+/shadow/+/+"                          \
+    "$aws/things/+/shadow/+"                            \
+    "$aws/things/" TEST_THING_NAME "/shadow/name/+/+/+" \
+    "$aws/things/" TEST_THING_NAME "/shadow/name/+/+"
+
+/**
+ * @brief The number of spans for the topic filters of the shadows of
+ * test_Shadow_AssembleWildcardFilters().
+ */
+#define TEST_WILDCARD_SPAN_COUNT    SHADOW_WILDCARD_FILTER_COUNT_MAX( 4U )
+
+/**
+ * @brief Tests assembling topic filters with Shadow_AssembleWildcardFilters(),
+ * and that they cover the topics they are assembled for.
+ */
+void test_Shadow_AssembleWildcardFilters( void )
+{
+
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowNames_t names[ 4 ] =
+    {
+        { TEST_THING_NAME, SHADOW_NAME_CLASSIC, TEST_THING_NAME_LENGTH, SHADOW_NAME_CLASSIC_LENGTH },
+        { TEST_THING_NAME, TEST_SHADOW_NAME,    TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH    },
+        { "otherThing",    SHADOW_NAME_CLASSIC, 10U,                    SHADOW_NAME_CLASSIC_LENGTH },
+        { TEST_THING_NAME, "otherShadow",       TEST_THING_NAME_LENGTH, 11U                        }
+    };
+    const uint16_t topicTypeMasks[] =
+    {
+        SHADOW_TOPIC_TYPE_ALL,
+        SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta ),
+        SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeGet ) | SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeGetAccepted ) |
+        SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeGetRejected ) | SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeDelete ) |
+        SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateAccepted ) | SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta ),
+        SHADOW_TOPIC_TYPE_ALL & ( uint16_t ) ~SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdate ),
+        SHADOW_TOPIC_TYPE_ALL & ( uint16_t ) ~SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeDeleteRejected )
+    };
+    char filterBuffer[ TEST_WILDCARD_SPAN_COUNT * SHADOW_TOPIC_LEN_MAX( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) ];
+    char topic[ SHADOW_TOPIC_LEN_MAX( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) ];
+    ShadowTopicSpan_t filterSpans[ TEST_WILDCARD_SPAN_COUNT ];
+    ShadowWildcardEntry_t scratch[ 4 ];
+    uint32_t filterCount = 0U;
+    uint32_t filterIndex = 0U;
+    uint16_t topicLength = 0U;
+    uint32_t outLength = 0U;
+    uint32_t maskIndex = 0U;
+    uint32_t nameCount = 0U;
+    uint32_t nameIndex = 0U;
+    uint32_t index = 0U;
+
+    /* The topic filters of one shadow are its topics. */
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 1U, SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta ),
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( 1U, filterCount );
+    TEST_ASSERT_EQUAL_UINT32( TEST_CLASSIC_TOPIC_LENGTH_UPDATE_DELTA, outLength );
+    TEST_ASSERT_EQUAL_MEMORY( TEST_CLASSIC_TOPIC_STRING_UPDATE_DELTA, filterBuffer, outLength );
+
+    /* Names that differ are replaced with wildcards, and topic types that
+     * make up a topic level are covered by one topic filter. */
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 4U, SHADOW_TOPIC_TYPE_ALL,
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( 4U, filterCount );
+    TEST_ASSERT_EQUAL_UINT32( sizeof( TEST_ALL_WILDCARD_FILTERS ) - 1U, outLength );
+    TEST_ASSERT_EQUAL_MEMORY( TEST_ALL_WILDCARD_FILTERS, filterBuffer, outLength );
+
+    shadowStatus = Shadow_AssembleWildcardFilters( &( names[ 1 ] ), 1U, topicTypeMasks[ 2 ],
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( 5U, filterCount );
+    TEST_ASSERT_EQUAL_MEMORY( "$aws/things/" TEST_THING_NAME "/shadow/name/" TEST_SHADOW_NAME "/get"
+                              "$aws/things/" TEST_THING_NAME "/shadow/name/" TEST_SHADOW_NAME "/get/+"
+                              "$aws/things/" TEST_THING_NAME "/shadow/name/" TEST_SHADOW_NAME "/delete"
+                              "$aws/things/" TEST_THING_NAME "/shadow/name/" TEST_SHADOW_NAME "/update/accepted"
+                              "$aws/things/" TEST_THING_NAME "/shadow/name/" TEST_SHADOW_NAME "/update/delta",
+                              filterBuffer, outLength );
+
+    /* Names of the same length are compared too. */
+    names[ 2 ].pThingName = "TestThingNamf";
+    names[ 2 ].thingNameLength = TEST_THING_NAME_LENGTH;
+    names[ 3 ].pShadowName = "TestShadowNamf";
+    names[ 3 ].shadowNameLength = TEST_SHADOW_NAME_LENGTH;
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 4U, SHADOW_TOPIC_TYPE_ALL,
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( sizeof( TEST_ALL_WILDCARD_FILTERS ) - 1U, outLength );
+    TEST_ASSERT_EQUAL_MEMORY( TEST_ALL_WILDCARD_FILTERS, filterBuffer, outLength );
+
+    /* Every topic of every shadow is covered by a topic filter. */
+    for( maskIndex = 0U; maskIndex < ( sizeof( topicTypeMasks ) / sizeof( topicTypeMasks[ 0 ] ) ); maskIndex++ )
+    {
+        for( nameCount = 1U; nameCount <= 4U; nameCount++ )
+        {
+            shadowStatus = Shadow_AssembleWildcardFilters( names, nameCount, topicTypeMasks[ maskIndex ],
+                                                           scratch,
+                                                           filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                           filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+            TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+            TEST_ASSERT_TRUE( filterCount <= SHADOW_WILDCARD_FILTER_COUNT_MAX( nameCount ) );
+            TEST_ASSERT_EQUAL_UINT32( filterSpans[ filterCount - 1U ].offset + filterSpans[ filterCount - 1U ].length,
+                                      outLength );
+
+            for( nameIndex = 0U; nameIndex < nameCount; nameIndex++ )
+            {
+                for( index = 0U; index < ( uint32_t ) ShadowTopicStringTypeMaxNum; index++ )
+                {
+                    shadowStatus = Shadow_AssembleTopicString( ( ShadowTopicStringType_t ) index,
+                                                               names[ nameIndex ].pThingName,
+                                                               names[ nameIndex ].thingNameLength,
+                                                               names[ nameIndex ].pShadowName,
+                                                               names[ nameIndex ].shadowNameLength,
+                                                               topic,
+                                                               ( uint16_t ) sizeof( topic ),
+                                                               &topicLength );
+                    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+
+                    shadowStatus = matchTopicFilters( filterBuffer, filterSpans, filterCount,
+                                                      topic, topicLength, &filterIndex );
+                    TEST_ASSERT_EQUAL_INT( ( ( topicTypeMasks[ maskIndex ] & SHADOW_TOPIC_TYPE_BIT( index ) ) != 0U ) ?
+                                           SHADOW_SUCCESS : SHADOW_NOT_FOUND,
+                                           shadowStatus );
+                }
+            }
+        }
+    }
+
+    /* The length needed is returned if the buffer is too small. */
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 4U, SHADOW_TOPIC_TYPE_ALL,
+                                                   scratch,
+                                                   filterBuffer, 0U,
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BUFFER_TOO_SMALL, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( sizeof( TEST_ALL_WILDCARD_FILTERS ) - 1U, outLength );
+
+    /* The number of spans needed is returned if there are too few, and no
+     * span is written. */
+    filterSpans[ 0 ].length = 0U;
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 4U, SHADOW_TOPIC_TYPE_ALL,
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, 3U, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BUFFER_TOO_SMALL, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( 4U, filterCount );
+    TEST_ASSERT_EQUAL_UINT16( 0U, filterSpans[ 0 ].length );
+
+    /* Invalid parameters. */
+    shadowStatus = Shadow_AssembleWildcardFilters( NULL, 4U, SHADOW_TOPIC_TYPE_ALL,
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 0U, SHADOW_TOPIC_TYPE_ALL,
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleWildcardFilters( names, UINT32_MAX, SHADOW_TOPIC_TYPE_ALL,
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 4U, 0U,
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 4U, SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeMaxNum ),
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 4U, SHADOW_TOPIC_TYPE_ALL,
+                                                   scratch,
+                                                   NULL, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 4U, SHADOW_TOPIC_TYPE_ALL,
+                                                   NULL,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 4U, SHADOW_TOPIC_TYPE_ALL,
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   NULL, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 4U, SHADOW_TOPIC_TYPE_ALL,
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, NULL, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 4U, SHADOW_TOPIC_TYPE_ALL,
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, NULL );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+
+    /* An invalid name anywhere in the array fails the whole call. */
+    names[ 2 ].thingNameLength = 0U;
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 4U, SHADOW_TOPIC_TYPE_ALL,
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, TEST_WILDCARD_SPAN_COUNT, &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that Shadow_AssembleWildcardFilters() groups the shadows by
+ * Thing, and never replaces both the Thing name and the Shadow name.
+ */
+void test_Shadow_AssembleWildcardFilters_Grouping( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    const ShadowNames_t names[ 7 ] =
+    {
+        { "thingA", "x",                 6U, 1U                         },
+        { "thingA", "y",                 6U, 1U                         },
+        { "thingB", "x",                 6U, 1U                         },
+        { "thingB", "y",                 6U, 1U                         },
+        { "thingC", "z",                 6U, 1U                         },
+        { "thingD", "z",                 6U, 1U                         },
+        { "thingD", SHADOW_NAME_CLASSIC, 6U, SHADOW_NAME_CLASSIC_LENGTH }
+    };
+    const ShadowNames_t otherNames[ 4 ] =
+    {
+        { "thingA", "x", 6U, 1U },
+        { "thingA", "y", 6U, 1U },
+        { "thingB", "x", 6U, 1U },
+        { "thingB", "x", 6U, 1U }
+    };
+    char filterBuffer[ 256 ];
+    ShadowTopicSpan_t filterSpans[ SHADOW_WILDCARD_FILTER_COUNT_MAX( 7U ) ];
+    ShadowWildcardEntry_t scratch[ 7 ];
+    uint32_t filterCount = 0U;
+    uint32_t filterIndex = 0U;
+    uint32_t outLength = 0U;
+
+    /* Two Things with two named shadows each get a topic filter each. */
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 4U, SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta ),
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, SHADOW_WILDCARD_FILTER_COUNT_MAX( 7U ),
+                                                   &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( 2U, filterCount );
+    TEST_ASSERT_EQUAL_UINT32( sizeof( "$aws/things/thingA/shadow/name/+/update/delta"
+                                      "$aws/things/thingB/shadow/name/+/update/delta" ) - 1U, outLength );
+    TEST_ASSERT_EQUAL_MEMORY( "$aws/things/thingA/shadow/name/+/update/delta"
+                              "$aws/things/thingB/shadow/name/+/update/delta",
+                              filterBuffer, outLength );
+
+    /* The only named shadows of two Things share a topic filter, and so do
+     * shadows repeated in the array. A Thing with more than one named shadow
+     * keeps its own topic filter. */
+    shadowStatus = Shadow_AssembleWildcardFilters( &( names[ 2 ] ), 5U, SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta ),
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, SHADOW_WILDCARD_FILTER_COUNT_MAX( 7U ),
+                                                   &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( 3U, filterCount );
+    TEST_ASSERT_EQUAL_MEMORY( "$aws/things/thingB/shadow/name/+/update/delta"
+                              "$aws/things/+/shadow/name/z/update/delta"
+                              "$aws/things/thingD/shadow/update/delta",
+                              filterBuffer, outLength );
+
+    shadowStatus = Shadow_AssembleWildcardFilters( &( names[ 4 ] ), 2U, SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta ),
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, SHADOW_WILDCARD_FILTER_COUNT_MAX( 7U ),
+                                                   &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( 1U, filterCount );
+    TEST_ASSERT_EQUAL_MEMORY( "$aws/things/+/shadow/name/z/update/delta", filterBuffer, outLength );
+
+    /* A named shadow of a Thing with another named shadow is not given a
+     * wildcard Thing name with the same shadow of other Things. */
+    shadowStatus = Shadow_AssembleWildcardFilters( otherNames, 4U, SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta ),
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, SHADOW_WILDCARD_FILTER_COUNT_MAX( 7U ),
+                                                   &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( 2U, filterCount );
+    TEST_ASSERT_EQUAL_MEMORY( "$aws/things/thingA/shadow/name/+/update/delta"
+                              "$aws/things/thingB/shadow/name/x/update/delta",
+                              filterBuffer, outLength );
+
+    /* A shadow of one Thing is not covered for another. */
+    shadowStatus = Shadow_AssembleWildcardFilters( names, 7U, SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta ),
+                                                   scratch,
+                                                   filterBuffer, ( uint32_t ) sizeof( filterBuffer ),
+                                                   filterSpans, SHADOW_WILDCARD_FILTER_COUNT_MAX( 7U ),
+                                                   &filterCount, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( 4U, filterCount );
+    shadowStatus = matchTopicFilters( filterBuffer, filterSpans, filterCount,
+                                      "$aws/things/thingC/shadow/name/x/update/delta",
+                                      ( uint16_t ) strlen( "$aws/things/thingC/shadow/name/x/update/delta" ),
+                                      &filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, shadowStatus );
+    shadowStatus = matchTopicFilters( filterBuffer, filterSpans, filterCount,
+                                      "$aws/things/thingA/shadow/update/delta",
+                                      ( uint16_t ) strlen( "$aws/things/thingA/shadow/update/delta" ),
+                                      &filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, shadowStatus );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests matching topics with MQTT topic filters with
+ * Shadow_MatchTopicFilters().
+ */
+void test_Shadow_MatchTopicFilters( void )
+{
+    static const char filterBuffer[] = "a/+/c" "a/#" "#" "+/b" "$aws/things/+/shadow/+/+" "x/y/#";
+    static const ShadowTopicSpan_t filterSpans[ 6 ] =
+    {
+        { 0U,  5U  },
+        { 5U,  3U  },
+        { 8U,  1U  },
+        { 9U,  3U  },
+        { 12U, 24U },
+        { 36U, 5U  }
+    };
+    static const ShadowTopicSpan_t emptyFilterSpan = { 0U, 0U };
+    static const ShadowTopicSpan_t partialFilterSpan = { 4U, 3U }; /* "ca/" */
+    ShadowFilterSlot_t filterSlots[ TEST_FILTER_SLOT_COUNT ];
+    ShadowFilterIndex_t filterIndexTable;
+    ShadowFilterIndex_t emptyIndex = { NULL, NULL, 0U, NULL, 0U };
+    uint32_t filterIndex = 0U;
+
+    /* The first topic filter that matches is returned. */
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 6U, "a/b/c", 5U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 6U, "a//c", 4U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 6U, "a/b/c/d", 7U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 1U, filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 6U, "a", 1U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 1U, filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 6U, "b/b", 3U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 2U, filterIndex );
+
+    /* Topics starting with '$' are not matched by a topic filter starting
+     * with a wildcard. */
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 6U,
+                                                              TEST_CLASSIC_TOPIC_STRING_UPDATE_DELTA,
+                                                              TEST_CLASSIC_TOPIC_LENGTH_UPDATE_DELTA,
+                                                              &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 4U, filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, matchTopicFilters( filterBuffer, filterSpans, 6U, "$b", 2U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, matchTopicFilters( filterBuffer, &( filterSpans[ 3 ] ), 1U, "$/b", 3U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, matchTopicFilters( filterBuffer, &( filterSpans[ 4 ] ), 1U,
+                                                                TEST_CLASSIC_TOPIC_STRING_UPDATE,
+                                                                TEST_CLASSIC_TOPIC_LENGTH_UPDATE,
+                                                                &filterIndex ) );
+
+    /* Topics that match no topic filter. */
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, matchTopicFilters( filterBuffer, &( filterSpans[ 5 ] ), 1U, "x/z", 3U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, matchTopicFilters( filterBuffer, &( filterSpans[ 5 ] ), 1U, "x/", 2U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, &( filterSpans[ 5 ] ), 1U, "x/y", 3U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, matchTopicFilters( filterBuffer, filterSpans, 1U, "a/b/cd", 6U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, matchTopicFilters( filterBuffer, filterSpans, 1U, "a/b", 3U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, matchTopicFilters( filterBuffer, &( emptyFilterSpan ), 1U, "$b", 2U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, matchTopicFilters( filterBuffer, &( partialFilterSpan ), 1U, "c", 1U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, matchTopicFilters( filterBuffer, filterSpans, 0U, "a/b/c", 5U, &filterIndex ) );
+
+    /* Invalid parameters. */
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, Shadow_FilterIndexInit( &filterIndexTable, filterBuffer, filterSpans, 6U,
+                                                                   filterSlots, TEST_FILTER_SLOT_COUNT ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_MatchTopicFilters( NULL, "a", 1U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_MatchTopicFilters( &emptyIndex, "a", 1U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_MatchTopicFilters( &filterIndexTable, NULL, 1U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_MatchTopicFilters( &filterIndexTable, "a", 0U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_MatchTopicFilters( &filterIndexTable, "a", 1U, NULL ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests indexing topic filters by their Thing name level with
+ * Shadow_FilterIndexInit(), and matching topics with them.
+ */
+void test_Shadow_FilterIndexInit( void )
+{
+    static const char filterBuffer[] = "$aws/things/thingA/x" "$aws/things/+/x" "$aws/things/thingA/y"
+                                       "$aws/things/#" "$aws/things/thingB";
+    static const ShadowTopicSpan_t filterSpans[ 5 ] =
+    {
+        { 0U,  20U },
+        { 20U, 15U },
+        { 35U, 20U },
+        { 55U, 13U },
+        { 68U, 18U }
+    };
+    static const ShadowTopicSpan_t reversedFilterSpans[ 2 ] =
+    {
+        { 20U, 15U },
+        { 0U,  20U }
+    };
+    static const ShadowTopicSpan_t thingFilterSpans[ 2 ] =
+    {
+        { 0U,  20U },
+        { 68U, 18U }
+    };
+    ShadowFilterSlot_t filterSlots[ TEST_FILTER_SLOT_COUNT ];
+    ShadowFilterIndex_t filterIndexTable;
+    char longLevelTopic[ SHADOW_PREFIX_LENGTH + 129U + 2U ];
+    uint32_t filterIndex = 0U;
+
+    /* A topic filter of the Thing name of the topic comes before a topic
+     * filter with a wildcard Thing name, and the other way around. */
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 5U, "$aws/things/thingA/x", 20U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, reversedFilterSpans, 2U, "$aws/things/thingA/x", 20U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 0U, filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 5U, "$aws/things/thingA/y", 20U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 2U, filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 5U, "$aws/things/thingB", 18U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 3U, filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 5U, "$aws/things/thingC/x", 20U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 1U, filterIndex );
+
+    /* Levels that are not Thing names are matched by the topic filters with
+     * a wildcard Thing name. */
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 5U, "$aws/things//x", 14U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 1U, filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 5U, "$aws/things/thing+/x", 20U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 1U, filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 5U, "$aws/things/", 12U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 3U, filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, matchTopicFilters( filterBuffer, filterSpans, 5U, "$aws/shadows/x", 14U, &filterIndex ) );
+
+    ( void ) memcpy( longLevelTopic, SHADOW_PREFIX, SHADOW_PREFIX_LENGTH );
+    ( void ) memset( &( longLevelTopic[ SHADOW_PREFIX_LENGTH ] ), 'T', 129U );
+    ( void ) memcpy( &( longLevelTopic[ SHADOW_PREFIX_LENGTH + 129U ] ), "/x", 2U );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 5U, longLevelTopic,
+                                                              SHADOW_PREFIX_LENGTH + 129U + 2U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 1U, filterIndex );
+    ( void ) memcpy( &( longLevelTopic[ SHADOW_PREFIX_LENGTH + 128U ] ), "/x", 2U );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, matchTopicFilters( filterBuffer, filterSpans, 5U, longLevelTopic,
+                                                              SHADOW_PREFIX_LENGTH + 128U + 2U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 1U, filterIndex );
+
+    /* A full index, whose slots hold topic filters of other Thing names. */
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, Shadow_FilterIndexInit( &filterIndexTable, filterBuffer, thingFilterSpans, 2U,
+                                                                   filterSlots, 2U ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, Shadow_MatchTopicFilters( &filterIndexTable, "$aws/things/thingB", 18U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_UINT32( 1U, filterIndex );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, Shadow_MatchTopicFilters( &filterIndexTable, "$aws/things/thingC", 18U, &filterIndex ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_NOT_FOUND, Shadow_MatchTopicFilters( &filterIndexTable, "$aws/things/+", 13U, &filterIndex ) );
+
+    /* Too few slots. */
+    TEST_ASSERT_EQUAL_INT( SHADOW_BUFFER_TOO_SMALL, Shadow_FilterIndexInit( &filterIndexTable, filterBuffer, filterSpans, 5U,
+                                                                            filterSlots, 4U ) );
+
+    /* Invalid parameters. */
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_FilterIndexInit( NULL, filterBuffer, filterSpans, 5U,
+                                                                         filterSlots, TEST_FILTER_SLOT_COUNT ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_FilterIndexInit( &filterIndexTable, NULL, filterSpans, 5U,
+                                                                         filterSlots, TEST_FILTER_SLOT_COUNT ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_FilterIndexInit( &filterIndexTable, filterBuffer, NULL, 5U,
+                                                                         filterSlots, TEST_FILTER_SLOT_COUNT ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_FilterIndexInit( &filterIndexTable, filterBuffer, filterSpans, 5U,
+                                                                         NULL, TEST_FILTER_SLOT_COUNT ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_FilterIndexInit( &filterIndexTable, filterBuffer, filterSpans, 5U,
+                                                                         filterSlots, 0U ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_FilterIndexInit( &filterIndexTable, filterBuffer, filterSpans, 5U,
+                                                                         filterSlots, 6U ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Check that a SUBSCRIBE or UNSUBSCRIBE payload holds the topics of
+ * Shadow_AssembleTopicsBulk(), each with its length and options byte.
+ */
+static void verifyTopicPayload( const ShadowNames_t * pNames,
+                                uint32_t nameCount,
+                                uint16_t topicTypeMask,
+                                const uint8_t * pPayload,
+                                uint32_t payloadLength,
+                                bool hasOptions,
+                                uint8_t options )
+{
+    char topicBuffer[ 3U * SHADOW_TOPIC_LEN_ALL( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) ];
+    ShadowTopicSpan_t topicSpans[ 3U * ( uint32_t ) ShadowTopicStringTypeMaxNum ];
+    uint32_t topicsLength = 0U;
+    uint32_t topicCount = 0U;
+    uint32_t index = 0U;
+    uint32_t offset = 0U;
+
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, Shadow_AssembleTopicsBulk( pNames, nameCount, topicTypeMask,
+                                                                      topicBuffer, ( uint32_t ) sizeof( topicBuffer ),
+                                                                      topicSpans, &topicsLength ) );
+
+    for( index = 0U; index < ( uint32_t ) ShadowTopicStringTypeMaxNum; index++ )
+    {
+        if( ( topicTypeMask & SHADOW_TOPIC_TYPE_BIT( index ) ) != 0U )
+        {
+            topicCount++;
+        }
+    }
+
+    for( index = 0U; index < ( nameCount * topicCount ); index++ )
+    {
+        TEST_ASSERT_TRUE( ( offset + 2U + topicSpans[ index ].length ) <= payloadLength );
+        TEST_ASSERT_EQUAL_UINT8( topicSpans[ index ].length >> 8U, pPayload[ offset ] );
+        TEST_ASSERT_EQUAL_UINT8( topicSpans[ index ].length & 0xFFU, pPayload[ offset + 1U ] );
+        offset += 2U;
+        TEST_ASSERT_EQUAL_MEMORY( &( topicBuffer[ topicSpans[ index ].offset ] ),
+                                  &( pPayload[ offset ] ),
+                                  topicSpans[ index ].length );
+        offset += topicSpans[ index ].length;
+
+        if( hasOptions == true )
+        {
+            TEST_ASSERT_EQUAL_UINT8( options, pPayload[ offset ] );
+            offset++;
+        }
+    }
+
+    /* The entries are packed without gaps. */
+    TEST_ASSERT_EQUAL_UINT32( payloadLength, offset );
+}
+
+/**
+ * @brief Tests serializing MQTT SUBSCRIBE payloads with
+ * Shadow_SerializeSubscribePayload().
+ */
+void test_Shadow_SerializeSubscribePayload( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowNames_t names[ 3 ] =
+    {
+        { TEST_THING_NAME, SHADOW_NAME_CLASSIC, TEST_THING_NAME_LENGTH, SHADOW_NAME_CLASSIC_LENGTH },
+        { TEST_THING_NAME, TEST_SHADOW_NAME,    TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH    },
+        { "otherThing",    SHADOW_NAME_CLASSIC, 10U,                    SHADOW_NAME_CLASSIC_LENGTH }
+    };
+    const uint16_t topicTypeMasks[] =
+    {
+        SHADOW_TOPIC_TYPE_ALL,
+        SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeGet ),
+        SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdate ) | SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateAccepted ) |
+        SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta ),
+        SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeUpdateDelta )
+    };
+    uint8_t payload[ 3U * SHADOW_SUBSCRIBE_PAYLOAD_LEN_ALL( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) ];
+    uint32_t outLength = 0U;
+    uint32_t requiredLength = 0U;
+    uint32_t maskIndex = 0U;
+    uint8_t qos = 0U;
+
+    for( maskIndex = 0U; maskIndex < ( sizeof( topicTypeMasks ) / sizeof( topicTypeMasks[ 0 ] ) ); maskIndex++ )
+    {
+        for( qos = 0U; qos <= 2U; qos++ )
+        {
+            shadowStatus = Shadow_SerializeSubscribePayload( names, 3U, topicTypeMasks[ maskIndex ], qos,
+                                                             payload, ( uint32_t ) sizeof( payload ),
+                                                             &outLength );
+            TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+            verifyTopicPayload( names, 3U, topicTypeMasks[ maskIndex ], payload, outLength, true, qos );
+        }
+    }
+
+    /* The exact length is returned up front when the buffer is empty. */
+    shadowStatus = Shadow_SerializeSubscribePayload( &( names[ 1 ] ), 1U, SHADOW_TOPIC_TYPE_ALL, 1U,
+                                                     payload, 0U, &requiredLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BUFFER_TOO_SMALL, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( SHADOW_SUBSCRIBE_PAYLOAD_LEN_ALL( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ),
+                              requiredLength );
+
+    shadowStatus = Shadow_SerializeSubscribePayload( &( names[ 1 ] ), 1U, SHADOW_TOPIC_TYPE_ALL, 1U,
+                                                     payload, requiredLength - 1U, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BUFFER_TOO_SMALL, shadowStatus );
+
+    shadowStatus = Shadow_SerializeSubscribePayload( &( names[ 1 ] ), 1U, SHADOW_TOPIC_TYPE_ALL, 1U,
+                                                     payload, requiredLength, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( requiredLength, outLength );
+
+    /* Invalid parameters. */
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_SerializeSubscribePayload( names, 3U, SHADOW_TOPIC_TYPE_ALL, 3U,
+                                                                                   payload, ( uint32_t ) sizeof( payload ), &outLength ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_SerializeSubscribePayload( NULL, 3U, SHADOW_TOPIC_TYPE_ALL, 0U,
+                                                                                   payload, ( uint32_t ) sizeof( payload ), &outLength ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_SerializeSubscribePayload( names, 0U, SHADOW_TOPIC_TYPE_ALL, 0U,
+                                                                                   payload, ( uint32_t ) sizeof( payload ), &outLength ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_SerializeSubscribePayload( names, UINT32_MAX, SHADOW_TOPIC_TYPE_ALL, 0U,
+                                                                                   payload, ( uint32_t ) sizeof( payload ), &outLength ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_SerializeSubscribePayload( names, 3U, 0U, 0U,
+                                                                                   payload, ( uint32_t ) sizeof( payload ), &outLength ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_SerializeSubscribePayload( names, 3U, SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeMaxNum ), 0U,
+                                                                                   payload, ( uint32_t ) sizeof( payload ), &outLength ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_SerializeSubscribePayload( names, 3U, SHADOW_TOPIC_TYPE_ALL, 0U,
+                                                                                   NULL, ( uint32_t ) sizeof( payload ), &outLength ) );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_SerializeSubscribePayload( names, 3U, SHADOW_TOPIC_TYPE_ALL, 0U,
+                                                                                   payload, ( uint32_t ) sizeof( payload ), NULL ) );
+
+    /* An invalid name anywhere in the array fails the whole call. */
+    names[ 2 ].thingNameLength = 0U;
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, Shadow_SerializeSubscribePayload( names, 3U, SHADOW_TOPIC_TYPE_ALL, 0U,
+                                                                                   payload, ( uint32_t ) sizeof( payload ), &outLength ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests serializing MQTT UNSUBSCRIBE payloads with
+ * Shadow_SerializeUnsubscribePayload().
+ */
+void test_Shadow_SerializeUnsubscribePayload( void )
+{
+    ShadowStatus_t shadowStatus = SHADOW_SUCCESS;
+    ShadowNames_t names[ 2 ] =
+    {
+        { TEST_THING_NAME, TEST_SHADOW_NAME,    TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH    },
+        { "otherThing",    SHADOW_NAME_CLASSIC, 10U,                    SHADOW_NAME_CLASSIC_LENGTH }
+    };
+    uint8_t payload[ SHADOW_SUBSCRIBE_PAYLOAD_LEN_ALL( TEST_THING_NAME_LENGTH, TEST_SHADOW_NAME_LENGTH ) +
+                     SHADOW_SUBSCRIBE_PAYLOAD_LEN_ALL( 10U, SHADOW_NAME_CLASSIC_LENGTH ) -
+                     ( 2U * ( uint32_t ) ShadowTopicStringTypeMaxNum ) ];
+    uint32_t outLength = 0U;
+
+    shadowStatus = Shadow_SerializeUnsubscribePayload( names, 2U, SHADOW_TOPIC_TYPE_ALL,
+                                                       payload, ( uint32_t ) sizeof( payload ), &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( sizeof( payload ), outLength );
+    verifyTopicPayload( names, 2U, SHADOW_TOPIC_TYPE_ALL, payload, outLength, false, 0U );
+
+    shadowStatus = Shadow_SerializeUnsubscribePayload( names, 2U, SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeDeleteRejected ),
+                                                       payload, ( uint32_t ) sizeof( payload ), &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_SUCCESS, shadowStatus );
+    verifyTopicPayload( names, 2U, SHADOW_TOPIC_TYPE_BIT( ShadowTopicStringTypeDeleteRejected ), payload, outLength, false, 0U );
+
+    shadowStatus = Shadow_SerializeUnsubscribePayload( names, 2U, SHADOW_TOPIC_TYPE_ALL,
+                                                       payload, ( uint32_t ) sizeof( payload ) - 1U, &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BUFFER_TOO_SMALL, shadowStatus );
+    TEST_ASSERT_EQUAL_UINT32( sizeof( payload ), outLength );
+
+    shadowStatus = Shadow_SerializeUnsubscribePayload( names, 2U, SHADOW_TOPIC_TYPE_ALL,
+                                                       NULL, ( uint32_t ) sizeof( payload ), &outLength );
+    TEST_ASSERT_EQUAL_INT( SHADOW_BAD_PARAMETER, shadowStatus );
+}
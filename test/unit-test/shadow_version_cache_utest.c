@@ -0,0 +1,250 @@
+/*
+ * AWS IoT Device Shadow
+ * Copyright (C) 2020 Amazon.com, Inc. or its affiliates.  All Rights Reserved.
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ */
+
+/**
+ * @file shadow_version_cache_utest.c
+ * @brief Tests for the Shadow version cache functions (declared in shadow_version_cache.h).
+ */
+
+/* Standard includes. */
+#include <stdint.h>
+#include <string.h>
+
+/* Test framework includes. */
+#include "unity.h"
+
+/* Shadow include. */
+#include "shadow_version_cache.h"
+
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief The number of slots of the registry used by the tests.
+ */
+#define TEST_SLOT_COUNT    ( 4U )
+
+/**
+ * @brief Slots of the registry used by the tests.
+ */
+static ShadowRegistrySlot_t slots[ TEST_SLOT_COUNT ];
+
+/**
+ * @brief The registry used by the tests.
+ */
+static ShadowRegistry_t registry;
+
+/**
+ * @brief Versions of the cache used by the tests.
+ */
+static uint32_t versions[ TEST_SLOT_COUNT ];
+
+/**
+ * @brief The cache used by the tests.
+ */
+static ShadowVersionCache_t versionCache;
+
+/**
+ * @brief The handle of the Classic shadow of "thing" in the registry.
+ */
+static uint32_t classicHandle;
+
+/**
+ * @brief The handle of the "config" shadow of "thing" in the registry.
+ */
+static uint32_t namedHandle;
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Match a null-terminated topic and payload with the cache.
+ */
+static ShadowStatus_t matchMessage( const char * pTopic,
+                                    const char * pPayload,
+                                    uint32_t * pHandle )
+{
+    ShadowMessageType_t messageType = ShadowMessageTypeMaxNum;
+
+    return Shadow_VersionCacheMatch( &versionCache, &registry,
+                                     pTopic, ( uint16_t ) strlen( pTopic ),
+                                     pPayload, ( uint32_t ) strlen( pPayload ),
+                                     pHandle, &messageType );
+}
+
+/*-----------------------------------------------------------*/
+
+/* ============================   UNITY FIXTURES ============================ */
+
+/* Called before each test method. */
+void setUp()
+{
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_RegistryInit( &registry, slots, TEST_SLOT_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_RegistryAdd( &registry, "thing", 5U, SHADOW_NAME_CLASSIC, 0U, &classicHandle ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_RegistryAdd( &registry, "thing", 5U, "config", 6U, &namedHandle ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_VersionCacheInit( &versionCache, versions, TEST_SLOT_COUNT ) );
+}
+
+/* Called after each test method. */
+void tearDown()
+{
+}
+
+/* Called at the beginning of the whole suite. */
+void suiteSetUp()
+{
+}
+
+/* Called at the end of the whole suite. */
+int suiteTearDown( int numFailures )
+{
+    return numFailures;
+}
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests the version cache functions with invalid parameters.
+ */
+void test_Shadow_VersionCache_Invalid_Parameters( void )
+{
+    ShadowVersionCache_t emptyCache = { NULL, 0U, 0U };
+    ShadowMessageType_t messageType;
+    uint32_t handle = 0U;
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheInit( NULL, versions, TEST_SLOT_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheInit( &versionCache, NULL, TEST_SLOT_COUNT ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheInit( &versionCache, versions, 0U ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheAccept( NULL, 0U, 1U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheAccept( &emptyCache, 0U, 1U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheAccept( &versionCache, TEST_SLOT_COUNT, 1U ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheReset( NULL, 0U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheReset( &emptyCache, 0U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheReset( &versionCache, TEST_SLOT_COUNT ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheMatch( NULL, &registry, "t", 1U, "{}", 2U, &handle, &messageType ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheMatch( &emptyCache, &registry, "t", 1U, "{}", 2U, &handle, &messageType ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheMatch( &versionCache, NULL, "t", 1U, "{}", 2U, &handle, &messageType ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheMatch( &versionCache, &registry, "t", 1U, "{}", 2U, NULL, &messageType ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheMatch( &versionCache, &registry, "t", 1U, "{}", 2U, &handle, NULL ) );
+
+    /* The cache has fewer versions than the registry has slots. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_VersionCacheInit( &versionCache, versions, TEST_SLOT_COUNT - 1U ) );
+    TEST_ASSERT_EQUAL( SHADOW_BAD_PARAMETER, Shadow_VersionCacheMatch( &versionCache, &registry, "t", 1U, "{}", 2U, &handle, &messageType ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that messages that are older than the last one applied are
+ * dropped.
+ */
+void test_Shadow_VersionCacheAccept( void )
+{
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_VersionCacheAccept( &versionCache, classicHandle, 5U ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_VersionCacheAccept( &versionCache, classicHandle, 5U ) );
+    TEST_ASSERT_EQUAL( SHADOW_VERSION_STALE, Shadow_VersionCacheAccept( &versionCache, classicHandle, 4U ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_VersionCacheAccept( &versionCache, classicHandle, 7U ) );
+    TEST_ASSERT_EQUAL( SHADOW_VERSION_STALE, Shadow_VersionCacheAccept( &versionCache, classicHandle, 6U ) );
+    TEST_ASSERT_EQUAL_UINT32( 2U, versionCache.staleCount );
+
+    /* The shadows are tracked separately. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_VersionCacheAccept( &versionCache, namedHandle, 1U ) );
+
+    /* After a reset, any version is applied. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_VersionCacheReset( &versionCache, classicHandle ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, Shadow_VersionCacheAccept( &versionCache, classicHandle, 1U ) );
+    TEST_ASSERT_EQUAL( SHADOW_VERSION_STALE, Shadow_VersionCacheAccept( &versionCache, namedHandle, 0U ) );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests matching messages and dropping the stale ones.
+ */
+void test_Shadow_VersionCacheMatch( void )
+{
+    uint32_t handle = TEST_SLOT_COUNT;
+
+    /* Deltas received out of order after a reconnect. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, matchMessage( "$aws/things/thing/shadow/update/delta",
+                                                     "{\"state\":{\"on\":true},\"version\":12}", &handle ) );
+    TEST_ASSERT_EQUAL_UINT32( classicHandle, handle );
+    TEST_ASSERT_EQUAL( SHADOW_VERSION_STALE, matchMessage( "$aws/things/thing/shadow/update/delta",
+                                                           "{\"state\":{\"on\":false},\"version\":11}", &handle ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, matchMessage( "$aws/things/thing/shadow/get/accepted",
+                                                     "{\"state\":{\"desired\":{\"on\":true}},\"version\":12}", &handle ) );
+    TEST_ASSERT_EQUAL( SHADOW_VERSION_STALE, matchMessage( "$aws/things/thing/shadow/get/accepted",
+                                                           "{\"state\":{\"desired\":{\"on\":false}},\"version\":11}", &handle ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, matchMessage( "$aws/things/thing/shadow/update/documents",
+                                                     "{\"previous\":{\"version\":12},\"current\":{\"version\":13}}", &handle ) );
+    TEST_ASSERT_EQUAL_UINT32( 13U, versions[ classicHandle ] );
+
+    /* The named shadow has its own versions. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, matchMessage( "$aws/things/thing/shadow/name/config/update/accepted",
+                                                     "{\"state\":{},\"version\":2}", &handle ) );
+    TEST_ASSERT_EQUAL_UINT32( namedHandle, handle );
+
+    /* Rejected messages and messages without a version are not dropped. */
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, matchMessage( "$aws/things/thing/shadow/name/config/update/rejected",
+                                                     "{\"code\":409}", &handle ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, matchMessage( "$aws/things/thing/shadow/name/config/update/delta",
+                                                     "{\"state\":{}}", &handle ) );
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, matchMessage( "$aws/things/thing/shadow/get/rejected",
+                                                     "{\"code\":404}", &handle ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, matchMessage( "$aws/things/thing/shadow/delete/accepted",
+                                                     "{\"version\":14}", &handle ) );
+
+    /* Errors of the registry and of the payload. */
+    TEST_ASSERT_EQUAL( SHADOW_NOT_FOUND, matchMessage( "$aws/things/other/shadow/update/delta",
+                                                       "{\"version\":1}", &handle ) );
+    TEST_ASSERT_EQUAL( SHADOW_PAYLOAD_PARSE_FAILED, matchMessage( "$aws/things/thing/shadow/update/delta",
+                                                                  "{\"version\":14.5}", &handle ) );
+    TEST_ASSERT_EQUAL_UINT32( 14U, versions[ classicHandle ] );
+}
+
+/*-----------------------------------------------------------*/
+
+/**
+ * @brief Tests that the messages the service publishes for one update, which
+ * all carry the version of the update, are all applied.
+ */
+void test_Shadow_VersionCacheMatch_SameVersion( void )
+{
+    uint32_t handle = TEST_SLOT_COUNT;
+
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, matchMessage( "$aws/things/thing/shadow/update/accepted",
+                                                     "{\"state\":{\"desired\":{\"on\":true}},\"version\":7}", &handle ) );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, matchMessage( "$aws/things/thing/shadow/update/delta",
+                                                     "{\"state\":{\"on\":true},\"version\":7}", &handle ) );
+    TEST_ASSERT_EQUAL_UINT32( classicHandle, handle );
+    TEST_ASSERT_EQUAL( SHADOW_SUCCESS, matchMessage( "$aws/things/thing/shadow/update/documents",
+                                                     "{\"previous\":{\"version\":6},\"current\":{\"version\":7}}", &handle ) );
+    TEST_ASSERT_EQUAL_UINT32( 7U, versions[ classicHandle ] );
+    TEST_ASSERT_EQUAL_UINT32( 0U, versionCache.staleCount );
+}
+
+/*-----------------------------------------------------------*/